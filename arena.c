@@ -0,0 +1,121 @@
+#include "arena.h"
+#include "../shared.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/mman.h>
+
+// Carves an aligned block out of the arena, or just sizes it
+static void* arena_carve(Arena* arena, const size_t nbytes);
+
+// Rounds a size up to a power of two alignment
+static size_t align_up(const size_t size, const size_t align);
+
+// Prepares an empty arena for the sizing pass
+void init_arena(Arena* arena, const int huge_pages) {
+  arena->base = NULL;
+  arena->raw = NULL;
+  arena->raw_size = 0;
+  arena->capacity = 0;
+  arena->used = 0;
+  arena->huge_pages = huge_pages;
+  arena->mapped = 0;
+}
+
+// Commits the memory for all of the arrays carved during the sizing pass
+size_t commit_arena(Arena* arena) {
+  arena->capacity = align_up(arena->used, ARENA_PAGE_SIZE);
+  arena->used = 0;
+
+  if (arena->huge_pages == ARENA_PAGES) {
+    // Go through the regular allocator, with room to page align the base
+    double* raw;
+    const size_t ndoubles =
+        (arena->capacity + ARENA_PAGE_SIZE) / sizeof(double);
+    arena->raw_size = allocate_data(&raw, ndoubles);
+    arena->raw = (char*)raw;
+    arena->base = (char*)align_up((uintptr_t)arena->raw, ARENA_PAGE_SIZE);
+    return arena->capacity;
+  }
+
+  // Huge pages are only worthwhile if the arena starts on a huge page
+  arena->capacity = align_up(arena->capacity, ARENA_HUGE_PAGE_SIZE);
+  arena->mapped = 1;
+
+#ifdef MAP_HUGETLB
+  if (arena->huge_pages == ARENA_EXPLICIT_HUGE_PAGES) {
+    arena->raw_size = arena->capacity;
+    arena->raw = mmap(NULL, arena->raw_size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (arena->raw != MAP_FAILED) {
+      arena->base = arena->raw;
+      return arena->capacity;
+    }
+    printf("Warning. Could not map explicit huge pages, falling back to "
+           "transparent huge pages.\n");
+  }
+#endif
+
+  arena->raw_size = arena->capacity + ARENA_HUGE_PAGE_SIZE;
+  arena->raw = mmap(NULL, arena->raw_size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (arena->raw == MAP_FAILED) {
+    TERMINATE("Could not map %zu bytes for the arena.\n", arena->raw_size);
+  }
+  arena->base = (char*)align_up((uintptr_t)arena->raw, ARENA_HUGE_PAGE_SIZE);
+
+#ifdef MADV_HUGEPAGE
+  if (madvise(arena->base, arena->capacity, MADV_HUGEPAGE)) {
+    printf("Warning. Transparent huge pages were not enabled for the "
+           "arena.\n");
+  }
+#endif
+
+  return arena->capacity;
+}
+
+// Carves a zeroed double array out of the arena
+size_t arena_data(Arena* arena, double** buf, const size_t len) {
+  *buf = (double*)arena_carve(arena, len * sizeof(double));
+  return len * sizeof(double);
+}
+
+// Carves a zeroed int array out of the arena
+size_t arena_int_data(Arena* arena, int** buf, const size_t len) {
+  *buf = (int*)arena_carve(arena, len * sizeof(int));
+  return len * sizeof(int);
+}
+
+// Releases the memory backing the arena
+void release_arena(Arena* arena) {
+  if (arena->mapped) {
+    munmap(arena->raw, arena->raw_size);
+  } else if (arena->raw) {
+    deallocate_data((double*)arena->raw);
+  }
+  init_arena(arena, arena->huge_pages);
+}
+
+// Carves an aligned block out of the arena, or just sizes it
+static void* arena_carve(Arena* arena, const size_t nbytes) {
+  // Large arrays start on a page so they never share one with a neighbour
+  const size_t align =
+      (nbytes >= ARENA_PAGE_SIZE) ? ARENA_PAGE_SIZE : ARENA_CACHE_LINE;
+  const size_t offset = align_up(arena->used, align);
+  arena->used = offset + nbytes;
+
+  if (!arena->base) {
+    return NULL;
+  }
+
+  if (arena->used > arena->capacity) {
+    TERMINATE("Arena exhausted, carving %zu bytes with %zu of %zu used.\n",
+              nbytes, offset, arena->capacity);
+  }
+
+  return arena->base + offset;
+}
+
+// Rounds a size up to a power of two alignment
+static size_t align_up(const size_t size, const size_t align) {
+  return (size + align - 1) & ~(align - 1);
+}
@@ -0,0 +1,50 @@
+#ifndef __ARENAHDR
+#define __ARENAHDR
+
+#pragma once
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ARENA_CACHE_LINE 64
+#define ARENA_PAGE_SIZE 4096
+#define ARENA_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// The backing used for the arena memory
+enum { ARENA_PAGES, ARENA_TRANSPARENT_HUGE_PAGES, ARENA_EXPLICIT_HUGE_PAGES };
+
+// A single block of memory that arrays are carved out of. The arena is first
+// sized by carving with no backing, then committed and carved again.
+typedef struct {
+  char* base;
+  char* raw;
+  size_t raw_size;
+  size_t capacity;
+  size_t used;
+  int huge_pages;
+  int mapped;
+} Arena;
+
+// Prepares an empty arena for the sizing pass
+void init_arena(Arena* arena, const int huge_pages);
+
+// Commits the memory for all of the arrays carved during the sizing pass
+size_t commit_arena(Arena* arena);
+
+// Carves a zeroed double array out of the arena
+size_t arena_data(Arena* arena, double** buf, const size_t len);
+
+// Carves a zeroed int array out of the arena
+size_t arena_int_data(Arena* arena, int** buf, const size_t len);
+
+// Releases the memory backing the arena
+void release_arena(Arena* arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -12,20 +12,15 @@
 void solve_unstructured_hydro_3d(Mesh* mesh, HaleData* hale_data,
                                  UnstructuredMesh* umesh, const int timestep) {
 
-  // On the first timestep we need to determine dt, and store the rezoned mesh
+  // On the first timestep we need to determine dt
   if (timestep == 0) {
-    printf("\nInitialising timestep and storing initial mesh.\n");
+    printf("\nInitialising timestep.\n");
 
     set_timestep(umesh->ncells, umesh->nodes_x0, umesh->nodes_y0,
                  umesh->nodes_z0, hale_data->energy0, &mesh->dt,
                  umesh->cells_to_faces_offsets, umesh->cells_to_faces,
                  umesh->faces_to_nodes_offsets, umesh->faces_to_nodes, 
                  hale_data->reduce_array);
-
-    // We are storing our original mesh to allow an Eulerian remap
-    store_rezoned_mesh(umesh->nnodes, umesh->nodes_x0, umesh->nodes_y0,
-                       umesh->nodes_z0, hale_data->rezoned_nodes_x,
-                       hale_data->rezoned_nodes_y, hale_data->rezoned_nodes_z);
   }
 
   // Describe the subcell node layout
@@ -37,6 +32,7 @@ void solve_unstructured_hydro_3d(Mesh* mesh, HaleData* hale_data,
   // move
   // due to the pressure (ideal gas) and artificial viscous forces
   START_PROFILING(&out);
+  enter_scratch_phase(&hale_data->scratch_pool, PHASE_LAGRANGIAN);
   lagrangian_phase(mesh, umesh, hale_data);
   STOP_PROFILING(&out, "Lagrangian phase");
 
@@ -57,6 +53,7 @@ void solve_unstructured_hydro_3d(Mesh* mesh, HaleData* hale_data,
 
     // gathers all of the subcell quantities on the mesh
     START_PROFILING(&out);
+    enter_scratch_phase(&hale_data->scratch_pool, PHASE_REMAP);
     gather_subcell_quantities(umesh, hale_data, &initial_momentum,
                               &initial_mass, &initial_ie_mass,
                               &initial_ke_mass);
@@ -99,3 +96,59 @@ void solve_unstructured_hydro_3d(Mesh* mesh, HaleData* hale_data,
     PRINT_PROFILING_RESULTS(&out);
   }
 }
+
+// The node state is only laid out by the omp3 kernels, so there are no
+// layouts to weigh against each other
+void benchmark_node_state(UnstructuredMesh* umesh, HaleData* hale_data) {
+  TERMINATE("layout_benchmark is only available with the omp3 kernels.\n");
+}
+
+// The hale arrays live on the device, so there are no host pages to place
+void place_hale_data(HaleData* hale_data, UnstructuredMesh* umesh) {}
+
+// The mesh arrays live on the device, so there are no host pages to migrate
+void place_mesh_data(HaleData* hale_data, UnstructuredMesh* umesh) {}
+
+// The arrays live on the device, so there is no NUMA placement to report
+void print_hale_placement(HaleData* hale_data, UnstructuredMesh* umesh) {}
+
+// The cuda Lagrangian phase moves the nodes in place, so the rezoned mesh is a
+// copy of the initial mesh, held for the whole run
+void init_rezoned_mesh(HaleData* hale_data, UnstructuredMesh* umesh) {
+  double* rezoned_nodes_x;
+  double* rezoned_nodes_y;
+  double* rezoned_nodes_z;
+  allocate_data(&rezoned_nodes_x, umesh->nnodes);
+  allocate_data(&rezoned_nodes_y, umesh->nnodes);
+  allocate_data(&rezoned_nodes_z, umesh->nnodes);
+  store_rezoned_mesh(umesh->nnodes, umesh->nodes_x0, umesh->nodes_y0,
+                     umesh->nodes_z0, rezoned_nodes_x, rezoned_nodes_y,
+                     rezoned_nodes_z);
+  hale_data->rezoned_nodes_x = rezoned_nodes_x;
+  hale_data->rezoned_nodes_y = rezoned_nodes_y;
+  hale_data->rezoned_nodes_z = rezoned_nodes_z;
+}
+
+// Initialises the stamp of some derived geometry that has never been evaluated
+void init_geometry_stamp(GeometryStamp* stamp, const char* name) {
+  stamp->name = name;
+  stamp->epoch = -1;
+  stamp->nevaluated = 0;
+  stamp->nreused = 0;
+}
+
+// The cuda advection evaluates the geometry of the rezoned mesh as it sweeps,
+// so only the epoch of the rezoned mesh is kept
+void store_rezoned_geometry(HaleData* hale_data, UnstructuredMesh* umesh) {
+  hale_data->rezoned_geometry_epoch =
+      (hale_data->rezoned_nodes_x == umesh->nodes_x0)
+          ? hale_data->geometry_epoch
+          : ++hale_data->ngeometry_epochs;
+}
+
+// The cuda kernels only evaluate the ideal gas, so there is no table to weigh
+// against it
+void benchmark_equation_of_state(UnstructuredMesh* umesh,
+                                 HaleData* hale_data) {
+  TERMINATE("layout_benchmark is only available with the omp3 kernels.\n");
+}
@@ -302,3 +302,13 @@ void set_timestep(const int ncells, const double* nodes_x,
   printf("Timestep %.8fs\n", *dt);
   STOP_PROFILING(&compute_profile, __func__);
 }
+
+// Zeroes a scratch array on the device
+void zero_scratch_data(double* buf, const size_t len) {
+  const int nblocks = ceil(len / (double)NTHREADS);
+
+  START_PROFILING(&compute_profile);
+  zero_scratch<<<nblocks, NTHREADS>>>(len, buf);
+  gpu_check(cudaDeviceSynchronize());
+  STOP_PROFILING(&compute_profile, "zero_scratch");
+}
@@ -0,0 +1,188 @@
+#include "eos_table.h"
+#include "../shared.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Builds an axis and its lookup index from ascending values
+static void init_eos_axis(EosAxis* axis, const char* name, const int nvalues,
+                          const double* values);
+
+// Finds the interval of an axis that holds a value, clamped to the axis, and
+// the weight of the upper end of the interval
+static inline int locate_interval(const EosAxis* axis, const double value,
+                                  double* weight);
+
+// Builds a table from the values at each density and energy, where the
+// pressure and soundspeed are laid out as p[(dd * nenergies + ee)]
+void init_eos_table(EosTable* table, const int ndensities,
+                    const int nenergies, const double* densities,
+                    const double* energies, const double* pressure,
+                    const double* soundspeed) {
+  init_eos_axis(&table->density, "density", ndensities, densities);
+  init_eos_axis(&table->energy, "energy", nenergies, energies);
+
+  // Each interval keeps its own copy of its corners, so that an interpolation
+  // only touches one cache line
+  const int nintervals = (ndensities - 1) * (nenergies - 1);
+  allocate_data(&table->patches, (size_t)nintervals * EOS_PATCH);
+  for (int dd = 0; dd < ndensities - 1; ++dd) {
+    for (int ee = 0; ee < nenergies - 1; ++ee) {
+      const int lo = dd * nenergies + ee;
+      const int hi = lo + nenergies;
+      double* patch =
+          &table->patches[((dd * (nenergies - 1) + ee) * EOS_PATCH)];
+      patch[(EOS_P00)] = pressure[(lo)];
+      patch[(EOS_P01)] = pressure[(lo + 1)];
+      patch[(EOS_P10)] = pressure[(hi)];
+      patch[(EOS_P11)] = pressure[(hi + 1)];
+      patch[(EOS_C00)] = soundspeed[(lo)];
+      patch[(EOS_C01)] = soundspeed[(lo + 1)];
+      patch[(EOS_C10)] = soundspeed[(hi)];
+      patch[(EOS_C11)] = soundspeed[(hi + 1)];
+    }
+  }
+}
+
+// Reads a table from a binary file holding the int number of densities and
+// energies, then the double densities, energies, pressures and soundspeeds,
+// with the pressures and soundspeeds laid out as p[(dd * nenergies + ee)]
+void read_eos_table(EosTable* table, const char* filename) {
+  FILE* fp = fopen(filename, "rb");
+  if (!fp) {
+    TERMINATE("Could not open the EOS table %s.\n", filename);
+  }
+
+  int dims[2];
+  if (fread(dims, sizeof(int), 2, fp) != 2 || dims[0] < 2 || dims[1] < 2) {
+    TERMINATE("The EOS table %s has a malformed header.\n", filename);
+  }
+  const int ndensities = dims[0];
+  const int nenergies = dims[1];
+  const size_t nentries = (size_t)ndensities * nenergies;
+
+  double* densities;
+  double* energies;
+  double* pressure;
+  double* soundspeed;
+  allocate_data(&densities, ndensities);
+  allocate_data(&energies, nenergies);
+  allocate_data(&pressure, nentries);
+  allocate_data(&soundspeed, nentries);
+  if (fread(densities, sizeof(double), ndensities, fp) != (size_t)ndensities ||
+      fread(energies, sizeof(double), nenergies, fp) != (size_t)nenergies ||
+      fread(pressure, sizeof(double), nentries, fp) != nentries ||
+      fread(soundspeed, sizeof(double), nentries, fp) != nentries) {
+    TERMINATE("The EOS table %s is truncated.\n", filename);
+  }
+  fclose(fp);
+
+  init_eos_table(table, ndensities, nenergies, densities, energies, pressure,
+                 soundspeed);
+
+  deallocate_data(densities);
+  deallocate_data(energies);
+  deallocate_data(pressure);
+  deallocate_data(soundspeed);
+}
+
+// Interpolates the pressure and soundspeed of a batch of at most EOS_BATCH
+// cells from the table
+void eval_eos_table(const EosTable* table, const int nlanes,
+                    const double* density, const double* energy,
+                    double* pressure, double* soundspeed) {
+  const int nenergy_intervals = table->energy.nvalues - 1;
+  const double* patches = table->patches;
+
+  // The searches branch, so are kept out of the vectorised loop
+  int patch_off[EOS_BATCH];
+  double density_weight[EOS_BATCH];
+  double energy_weight[EOS_BATCH];
+  for (int ll = 0; ll < nlanes; ++ll) {
+    const int dd =
+        locate_interval(&table->density, density[(ll)], &density_weight[(ll)]);
+    const int ee =
+        locate_interval(&table->energy, energy[(ll)], &energy_weight[(ll)]);
+    patch_off[(ll)] = (dd * nenergy_intervals + ee) * EOS_PATCH;
+  }
+
+#pragma omp simd
+  for (int ll = 0; ll < nlanes; ++ll) {
+    const double* patch = &patches[(patch_off[(ll)])];
+    const double wd = density_weight[(ll)];
+    const double we = energy_weight[(ll)];
+    pressure[(ll)] =
+        (1.0 - wd) * ((1.0 - we) * patch[(EOS_P00)] + we * patch[(EOS_P01)]) +
+        wd * ((1.0 - we) * patch[(EOS_P10)] + we * patch[(EOS_P11)]);
+    soundspeed[(ll)] =
+        (1.0 - wd) * ((1.0 - we) * patch[(EOS_C00)] + we * patch[(EOS_C01)]) +
+        wd * ((1.0 - we) * patch[(EOS_C10)] + we * patch[(EOS_C11)]);
+  }
+}
+
+// Deallocates a table
+void deallocate_eos_table(EosTable* table) {
+  deallocate_data(table->density.values);
+  deallocate_int_data(table->density.buckets);
+  deallocate_data(table->energy.values);
+  deallocate_int_data(table->energy.buckets);
+  deallocate_data(table->patches);
+}
+
+// Prints the size of a table
+void print_eos_table(const char* name, const EosTable* table) {
+  const size_t nintervals =
+      (size_t)(table->density.nvalues - 1) * (table->energy.nvalues - 1);
+  printf("%-24s %dx%d tabulated EOS, %.3fMB of patches\n", name,
+         table->density.nvalues, table->energy.nvalues,
+         nintervals * EOS_PATCH * sizeof(double) / (1024.0 * 1024.0));
+}
+
+// Builds an axis and its lookup index from ascending values
+static void init_eos_axis(EosAxis* axis, const char* name, const int nvalues,
+                          const double* values) {
+  for (int ii = 0; ii < nvalues - 1; ++ii) {
+    if (!(values[(ii + 1)] > values[(ii)])) {
+      TERMINATE("The %s axis of the EOS table is not ascending.\n", name);
+    }
+  }
+
+  axis->nvalues = nvalues;
+  allocate_data(&axis->values, nvalues);
+  for (int ii = 0; ii < nvalues; ++ii) {
+    axis->values[(ii)] = values[(ii)];
+  }
+
+  // A bucket starts from the last interval that begins in an earlier bucket,
+  // which can't be beyond any value in the bucket
+  const double lo = values[(0)];
+  axis->nbuckets = EOS_BUCKETS_BY_VALUE * nvalues;
+  axis->bucket_scale = axis->nbuckets / (values[(nvalues - 1)] - lo);
+  allocate_int_data(&axis->buckets, axis->nbuckets);
+  int ii = 0;
+  for (int bb = 0; bb < axis->nbuckets; ++bb) {
+    while (ii < nvalues - 2 &&
+           (int)((values[(ii + 1)] - lo) * axis->bucket_scale) < bb) {
+      ii++;
+    }
+    axis->buckets[(bb)] = ii;
+  }
+}
+
+// Finds the interval of an axis that holds a value, clamped to the axis, and
+// the weight of the upper end of the interval
+static inline int locate_interval(const EosAxis* axis, const double value,
+                                  double* weight) {
+  const double* values = axis->values;
+  const double lo = values[(0)];
+  const double x = min(max(value, lo), values[(axis->nvalues - 1)]);
+
+  const int bucket =
+      min((int)((x - lo) * axis->bucket_scale), axis->nbuckets - 1);
+  int ii = axis->buckets[(bucket)];
+  while (ii < axis->nvalues - 2 && x >= values[(ii + 1)]) {
+    ii++;
+  }
+
+  *weight = (x - values[(ii)]) / (values[(ii + 1)] - values[(ii)]);
+  return ii;
+}
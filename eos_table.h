@@ -0,0 +1,84 @@
+#ifndef __EOSTABLEHDR
+#define __EOSTABLEHDR
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The number of cells evaluated together, where the intervals of a batch are
+// located before the batch is interpolated in one vectorised loop
+#ifndef EOS_BATCH
+#define EOS_BATCH 32
+#endif
+
+// The number of buckets in the lookup index of an axis for each of its values
+#define EOS_BUCKETS_BY_VALUE 4
+
+// The corners of an interval of the table that an interpolation reads, which
+// together fill a single cache line
+enum {
+  EOS_P00,
+  EOS_P01,
+  EOS_P10,
+  EOS_P11,
+  EOS_C00,
+  EOS_C01,
+  EOS_C10,
+  EOS_C11,
+  EOS_PATCH
+};
+
+// An axis of the table, with an index that maps equal buckets of the range of
+// the axis onto the interval that holds the start of each bucket, so that an
+// interval is found with a short search from its bucket
+typedef struct {
+  int nvalues;
+  double* values;
+
+  int nbuckets;
+  double bucket_scale;
+  int* buckets;
+} EosAxis;
+
+// The pressure and soundspeed of a material tabulated against density and
+// specific internal energy. The table is stored as one patch per interval,
+// patches[((dd * (nenergies - 1) + ee) * EOS_PATCH + corner)], where the
+// corners are ordered by density then energy. States beyond the edges of the
+// table are clamped to its edges.
+typedef struct {
+  EosAxis density;
+  EosAxis energy;
+  double* patches;
+} EosTable;
+
+// Builds a table from the values at each density and energy, where the
+// pressure and soundspeed are laid out as p[(dd * nenergies + ee)]
+void init_eos_table(EosTable* table, const int ndensities,
+                    const int nenergies, const double* densities,
+                    const double* energies, const double* pressure,
+                    const double* soundspeed);
+
+// Reads a table from a binary file holding the int number of densities and
+// energies, then the double densities, energies, pressures and soundspeeds,
+// with the pressures and soundspeeds laid out as p[(dd * nenergies + ee)]
+void read_eos_table(EosTable* table, const char* filename);
+
+// Interpolates the pressure and soundspeed of a batch of at most EOS_BATCH
+// cells from the table
+void eval_eos_table(const EosTable* table, const int nlanes,
+                    const double* density, const double* energy,
+                    double* pressure, double* soundspeed);
+
+// Deallocates a table
+void deallocate_eos_table(EosTable* table);
+
+// Prints the size of a table
+void print_eos_table(const char* name, const EosTable* table);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
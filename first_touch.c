@@ -0,0 +1,215 @@
+#include "first_touch.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#if defined(__linux__) && defined(SYS_move_pages) && defined(SYS_getcpu)
+#define HAVE_MOVE_PAGES
+#endif
+
+#define MOVE_PAGES_BATCH 1024
+#define MPOL_MF_MOVE_PAGES (1 << 1)
+
+// Counts the NUMA nodes exposed by the system
+static int count_numa_nodes();
+
+// Fetches the NUMA node of the core the calling thread is running on
+static int get_thread_numa_node();
+
+// Moves the pages owned by the byte range [begin, end) of buf to a node
+static void move_owned_pages(const char* buf, const char* begin,
+                             const char* end, const int node);
+
+// Zeroes an array with the kernel partitioning, so that fresh pages are first
+// touched by their owner, and migrates any pages already touched elsewhere
+void first_touch_data(void* buf, const size_t nentities,
+                      const size_t entity_bytes) {
+  char* bytes = (char*)buf;
+  if (!buf) {
+    return;
+  }
+
+  const int nnuma_nodes = count_numa_nodes();
+
+#pragma omp parallel
+  {
+    size_t first = nentities;
+    size_t last = 0;
+
+#pragma omp for
+    for (size_t ee = 0; ee < nentities; ++ee) {
+      memset(bytes + ee * entity_bytes, 0, entity_bytes);
+      first = (ee < first) ? ee : first;
+      last = ee + 1;
+    }
+
+    if (nnuma_nodes > 1 && first < last) {
+      move_owned_pages(bytes, bytes + first * entity_bytes,
+                       bytes + last * entity_bytes, get_thread_numa_node());
+    }
+  }
+}
+
+// Migrates the pages of an initialised array to the owning threads
+void migrate_data(const void* buf, const size_t nentities,
+                  const size_t entity_bytes) {
+  const char* bytes = (const char*)buf;
+  if (!buf || count_numa_nodes() < 2) {
+    return;
+  }
+
+#pragma omp parallel
+  {
+    size_t first = nentities;
+    size_t last = 0;
+
+#pragma omp for
+    for (size_t ee = 0; ee < nentities; ++ee) {
+      first = (ee < first) ? ee : first;
+      last = ee + 1;
+    }
+
+    if (first < last) {
+      move_owned_pages(bytes, bytes + first * entity_bytes,
+                       bytes + last * entity_bytes, get_thread_numa_node());
+    }
+  }
+}
+
+// Migrates the pages of an initialised connectivity list, where the entities
+// own the variable length ranges described by offsets
+void migrate_list_data(const int* buf, const int* offsets,
+                       const size_t nentities) {
+  const char* bytes = (const char*)buf;
+  if (!buf || count_numa_nodes() < 2) {
+    return;
+  }
+
+#pragma omp parallel
+  {
+    size_t first = nentities;
+    size_t last = 0;
+
+#pragma omp for
+    for (size_t ee = 0; ee < nentities; ++ee) {
+      first = (ee < first) ? ee : first;
+      last = ee + 1;
+    }
+
+    if (first < last) {
+      move_owned_pages(bytes, bytes + offsets[(first)] * sizeof(int),
+                       bytes + offsets[(last)] * sizeof(int),
+                       get_thread_numa_node());
+    }
+  }
+}
+
+// Prints the number of pages of an array resident on each NUMA node
+void print_page_placement(const char* name, const void* buf,
+                          const size_t nbytes) {
+#ifdef HAVE_MOVE_PAGES
+  const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+  const uintptr_t begin = (uintptr_t)buf & ~(page_size - 1);
+  const uintptr_t end = (uintptr_t)buf + nbytes;
+
+  size_t npages_by_node[MAX_NUMA_NODES] = {0};
+  size_t nunplaced = 0;
+
+  void* pages[MOVE_PAGES_BATCH];
+  int status[MOVE_PAGES_BATCH];
+  for (uintptr_t pp = begin; pp < end;) {
+    int npages = 0;
+    for (; npages < MOVE_PAGES_BATCH && pp < end; ++npages, pp += page_size) {
+      pages[(npages)] = (void*)pp;
+    }
+
+    // Passing no target nodes queries the current placement
+    if (syscall(SYS_move_pages, 0, npages, pages, NULL, status, 0)) {
+      nunplaced += npages;
+      continue;
+    }
+
+    for (int ii = 0; ii < npages; ++ii) {
+      if (status[(ii)] >= 0 && status[(ii)] < MAX_NUMA_NODES) {
+        npages_by_node[(status[(ii)])]++;
+      } else {
+        nunplaced++;
+      }
+    }
+  }
+
+  printf("%-24s", name);
+  for (int nn = 0; nn < MAX_NUMA_NODES; ++nn) {
+    if (npages_by_node[(nn)]) {
+      printf(" N%d=%zu", nn, npages_by_node[(nn)]);
+    }
+  }
+  if (nunplaced) {
+    printf(" unplaced=%zu", nunplaced);
+  }
+  printf("\n");
+#else
+  printf("%-24s placement unavailable\n", name);
+#endif
+}
+
+// Moves the pages owned by the byte range [begin, end) of buf to a node
+static void move_owned_pages(const char* buf, const char* begin,
+                             const char* end, const int node) {
+#ifdef HAVE_MOVE_PAGES
+  // Each page belongs to the thread that owns the first byte of the array on
+  // that page, so that neighbouring threads never fight over a page
+  const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+  uintptr_t pp = (uintptr_t)begin & ~(page_size - 1);
+  if (begin != buf && pp != (uintptr_t)begin) {
+    pp += page_size;
+  }
+
+  void* pages[MOVE_PAGES_BATCH];
+  int nodes[MOVE_PAGES_BATCH];
+  int status[MOVE_PAGES_BATCH];
+  while (pp < (uintptr_t)end) {
+    int npages = 0;
+    for (; npages < MOVE_PAGES_BATCH && pp < (uintptr_t)end;
+         ++npages, pp += page_size) {
+      pages[(npages)] = (void*)pp;
+      nodes[(npages)] = node;
+    }
+
+    // Failures leave the pages where they are, which is only a performance
+    // concern, so they are deliberately ignored
+    syscall(SYS_move_pages, 0, npages, pages, nodes, status,
+            MPOL_MF_MOVE_PAGES);
+  }
+#endif
+}
+
+// Counts the NUMA nodes exposed by the system
+static int count_numa_nodes() {
+  static int nnuma_nodes = 0;
+  if (!nnuma_nodes) {
+    int nn = 0;
+    char path[64];
+    do {
+      snprintf(path, sizeof(path), "/sys/devices/system/node/node%d", nn);
+    } while (!access(path, F_OK) && ++nn < MAX_NUMA_NODES);
+    nnuma_nodes = (nn > 0) ? nn : 1;
+  }
+  return nnuma_nodes;
+}
+
+// Fetches the NUMA node of the core the calling thread is running on
+static int get_thread_numa_node() {
+#ifdef HAVE_MOVE_PAGES
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (!syscall(SYS_getcpu, &cpu, &node, NULL)) {
+    return node;
+  }
+#endif
+  return 0;
+}
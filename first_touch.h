@@ -0,0 +1,42 @@
+#ifndef __FIRSTTOUCHHDR
+#define __FIRSTTOUCHHDR
+
+#pragma once
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MAX_NUMA_NODES 64
+
+// All of the routines partition the entities with the same default static
+// schedule as the `omp parallel for` kernels that consume the arrays, so the
+// pages end up on the NUMA node of the thread that will stream them. This is
+// only meaningful when the threads are bound, e.g. OMP_PROC_BIND=true.
+// Arrays that were never allocated are skipped.
+
+// Zeroes an array with the kernel partitioning, so that fresh pages are first
+// touched by their owner, and migrates any pages already touched elsewhere
+void first_touch_data(void* buf, const size_t nentities,
+                      const size_t entity_bytes);
+
+// Migrates the pages of an initialised array to the owning threads
+void migrate_data(const void* buf, const size_t nentities,
+                  const size_t entity_bytes);
+
+// Migrates the pages of an initialised connectivity list, where the entities
+// own the variable length ranges described by offsets
+void migrate_list_data(const int* buf, const int* offsets,
+                       const size_t nentities);
+
+// Prints the number of pages of an array resident on each NUMA node
+void print_page_placement(const char* name, const void* buf,
+                          const size_t nbytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
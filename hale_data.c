@@ -2,138 +2,754 @@
 #include "../mesh.h"
 #include "../params.h"
 #include "../shared.h"
+#include "arena.h"
+#include "first_touch.h"
+#include "mesh_cache.h"
+#include "multi_material.h"
+#include "scratch_pool.h"
+#include "sell_adjacency.h"
+#include "tracers.h"
 #include <assert.h>
 #include <float.h>
 #include <math.h>
 #ifdef SILO
 #include <silo.h>
 #endif
+#include <stdio.h>
 #include <stdlib.h>
 
+// Carves all of the hale arrays out of the arena
+static size_t carve_hale_data(HaleData* hale_data, UnstructuredMesh* umesh,
+                              Arena* arena);
+
+#ifdef SELL_ADJACENCY
+// Builds the SELL-C-sigma copies of the node adjacency
+static void init_node_sell_adjacency(HaleData* hale_data,
+                                     UnstructuredMesh* umesh);
+#endif
+
+#ifdef PACKED_CELL_NODES
+// Builds the cell-local view of the faces, and packs the initial mesh
+static void init_packed_cell_nodes(HaleData* hale_data,
+                                   UnstructuredMesh* umesh);
+#endif
+
+#ifdef NODE_FORCE_ACCUMULATION
+// Colours the cells greedily, so that no two cells of a colour share a node
+static void init_cell_colours(HaleData* hale_data, UnstructuredMesh* umesh);
+#endif
+
+// Identifies a material with each distinct initial state of the problem
+static void init_materials(HaleData* hale_data, UnstructuredMesh* umesh);
+
+// Registers the passive scalars as dyes, before they are carved
+static void register_dyes(HaleData* hale_data, UnstructuredMesh* umesh);
+
+// Fills the dyes into bands of the mesh
+static void init_tracers(HaleData* hale_data, UnstructuredMesh* umesh);
+
 // Initialises the shared_data variables for two dimensional applications
 size_t init_hale_data(HaleData* hale_data, UnstructuredMesh* umesh) {
-  const int nsubcell_faces_by_node = NSUBCELL_FACES_BY_NODE;
   hale_data->nnodes_by_subcell = NNODES_BY_SUBCELL;
   hale_data->nsubcells_by_cell = NSUBCELLS_BY_CELL;
   hale_data->nsubcells = umesh->ncells * hale_data->nsubcells_by_cell;
 
-  size_t allocated = allocate_data(&hale_data->pressure0, umesh->ncells);
-  allocated += allocate_data(&hale_data->velocity_x0, umesh->nnodes);
-  allocated += allocate_data(&hale_data->velocity_y0, umesh->nnodes);
-  allocated += allocate_data(&hale_data->velocity_z0, umesh->nnodes);
-  allocated += allocate_data(&hale_data->velocity_x1, umesh->nnodes);
-  allocated += allocate_data(&hale_data->velocity_y1, umesh->nnodes);
-  allocated += allocate_data(&hale_data->velocity_z1, umesh->nnodes);
-  allocated += allocate_data(&hale_data->energy1, umesh->ncells);
-  allocated += allocate_data(&hale_data->ke_mass, umesh->ncells);
-  allocated += allocate_data(&hale_data->density1, umesh->ncells);
-  allocated += allocate_data(&hale_data->pressure1, umesh->ncells);
-  allocated += allocate_data(&hale_data->cell_mass, umesh->ncells);
-  allocated += allocate_data(&hale_data->nodal_mass, umesh->nnodes);
-  allocated += allocate_data(&hale_data->nodal_volumes, umesh->nnodes);
-  allocated += allocate_data(&hale_data->nodal_soundspeed, umesh->nnodes);
-  allocated += allocate_data(&hale_data->limiter, umesh->nnodes);
-  allocated += allocate_data(&hale_data->rezoned_nodes_x, umesh->nnodes);
-  allocated += allocate_data(&hale_data->rezoned_nodes_y, umesh->nnodes);
-  allocated += allocate_data(&hale_data->rezoned_nodes_z, umesh->nnodes);
-  allocated += allocate_data(&hale_data->cell_volume, umesh->ncells);
-
-  allocated +=
-      allocate_int_data(&hale_data->subcells_to_subcells,
-                        hale_data->nsubcells * nsubcell_faces_by_node * 2);
-  allocated += allocate_int_data(&hale_data->subcells_to_subcells_offsets,
-                                 hale_data->nsubcells + 1);
-  allocated += allocate_int_data(&hale_data->subcells_to_faces,
-                                 hale_data->nsubcells * nsubcell_faces_by_node);
-  allocated += allocate_int_data(&hale_data->subcells_to_faces_offsets,
-                                 hale_data->nsubcells + 1);
-
-  allocated +=
-      allocate_data(&hale_data->subcell_momentum_x, hale_data->nsubcells);
-  allocated +=
-      allocate_data(&hale_data->subcell_momentum_y, hale_data->nsubcells);
-  allocated +=
-      allocate_data(&hale_data->subcell_momentum_z, hale_data->nsubcells);
-  allocated +=
-      allocate_data(&hale_data->subcell_momentum_flux_x, hale_data->nsubcells);
-  allocated +=
-      allocate_data(&hale_data->subcell_momentum_flux_y, hale_data->nsubcells);
-  allocated +=
-      allocate_data(&hale_data->subcell_momentum_flux_z, hale_data->nsubcells);
-
-  allocated += allocate_data(&hale_data->subcell_mass, hale_data->nsubcells);
-  allocated +=
-      allocate_data(&hale_data->subcell_mass_flux, hale_data->nsubcells);
-  allocated += allocate_data(&hale_data->subcell_ie_mass, hale_data->nsubcells);
-  allocated +=
-      allocate_data(&hale_data->subcell_ie_mass_flux, hale_data->nsubcells);
-  allocated += allocate_data(&hale_data->subcell_ke_mass, hale_data->nsubcells);
-  allocated +=
-      allocate_data(&hale_data->subcell_ke_mass_flux, hale_data->nsubcells);
-  allocated += allocate_data(&hale_data->subcell_volume, hale_data->nsubcells);
-  allocated += allocate_data(&hale_data->subcell_force_x, hale_data->nsubcells);
-  allocated += allocate_data(&hale_data->subcell_force_y, hale_data->nsubcells);
-  allocated += allocate_data(&hale_data->subcell_force_z, hale_data->nsubcells);
-  allocated +=
-      allocate_data(&hale_data->subcell_centroids_x, hale_data->nsubcells);
-  allocated +=
-      allocate_data(&hale_data->subcell_centroids_y, hale_data->nsubcells);
-  allocated +=
-      allocate_data(&hale_data->subcell_centroids_z, hale_data->nsubcells);
-
-  // In hale, the fundamental principle is that the mass at the cell and
-  // sub-cell are conserved, so we can initialise them from the mesh
-  // and then only the remapping step will ever adjust them
-  init_cell_centroids(umesh->ncells, umesh->cells_to_nodes_offsets,
-                      umesh->cells_to_nodes, umesh->nodes_x0, umesh->nodes_y0,
-                      umesh->nodes_z0, umesh->cell_centroids_x,
-                      umesh->cell_centroids_y, umesh->cell_centroids_z);
-
-  init_subcells_to_faces(
-      umesh->ncells, umesh->ncells * umesh->nnodes_by_cell,
-      umesh->cells_to_nodes_offsets, umesh->nodes_to_faces_offsets,
-      umesh->cells_to_nodes, umesh->faces_to_cells0, umesh->faces_to_cells1,
-      umesh->nodes_to_faces, umesh->faces_to_nodes,
-      umesh->faces_to_nodes_offsets, umesh->faces_cclockwise_cell,
-      hale_data->subcells_to_faces, umesh->nodes_x0, umesh->nodes_y0,
-      umesh->nodes_z0, hale_data->subcells_to_faces_offsets);
-
-  // Initialises the list of neighbours to a subcell
-  init_subcells_to_subcells(
-      umesh->ncells, umesh->ncells * umesh->nnodes_by_cell,
-      umesh->faces_to_cells0, umesh->faces_to_cells1,
-      umesh->faces_to_nodes_offsets, umesh->faces_to_nodes,
-      umesh->faces_cclockwise_cell, umesh->nodes_x0, umesh->nodes_y0,
-      umesh->nodes_z0, hale_data->subcells_to_subcells,
-      hale_data->subcells_to_subcells_offsets, umesh->cells_to_nodes_offsets,
-      umesh->nodes_to_faces_offsets, umesh->nodes_to_faces,
-      umesh->cells_to_nodes, hale_data->subcells_to_faces,
-      hale_data->subcells_to_faces_offsets);
-
-  // Initialises the cell mass, sub-cell mass and sub-cell volume
-  init_mesh_mass(umesh->ncells, umesh->nnodes, hale_data->nnodes_by_subcell,
-                 hale_data->density0, umesh->nodes_x0, umesh->nodes_y0,
-                 umesh->nodes_z0, hale_data->subcell_mass,
-                 hale_data->nodal_mass, umesh->faces_to_nodes_offsets,
-                 umesh->faces_to_nodes, umesh->faces_cclockwise_cell,
-                 umesh->cells_to_nodes_offsets, umesh->cells_to_nodes,
-                 hale_data->subcells_to_faces_offsets,
-                 hale_data->subcells_to_faces, umesh->nodes_to_cells_offsets,
-                 umesh->nodes_to_cells, hale_data->subcell_centroids_x,
-                 hale_data->subcell_centroids_y, hale_data->subcell_centroids_z,
-                 hale_data->subcell_volume, hale_data->cell_volume,
-                 hale_data->nodal_volumes, hale_data->cell_mass);
-
-  store_rezoned_mesh(umesh->nnodes, umesh->nodes_x0, umesh->nodes_y0,
-                     umesh->nodes_z0, hale_data->rezoned_nodes_x,
-                     hale_data->rezoned_nodes_y, hale_data->rezoned_nodes_z);
+  if (hale_data->remap_order != FIRST_ORDER_REMAP &&
+      hale_data->remap_order != SECOND_ORDER_REMAP) {
+    TERMINATE("The remap order must be %d or %d, not %d.\n",
+              FIRST_ORDER_REMAP, SECOND_ORDER_REMAP, hale_data->remap_order);
+  }
+  if (hale_data->perform_remap &&
+      hale_data->remap_order == FIRST_ORDER_REMAP) {
+    printf("Performing a first order donor cell remap\n");
+  }
+  if (hale_data->perform_remap && hale_data->cell_remap) {
+    printf("Performing a cell remap through the faces of the cells\n");
+  }
+  if (hale_data->huge_pages) {
+#ifdef CUDA_KERNELS
+    TERMINATE("huge_pages only backs the arena of the omp3 kernels.\n");
+#endif
+  }
+  if (hale_data->quiescent_skip) {
+#if defined(PACKED_CELL_NODES) || defined(NODE_FORCE_ACCUMULATION) ||         \
+    defined(SELL_ADJACENCY)
+    TERMINATE("quiescent_skip only drives the default Lagrangian kernels.\n");
+#endif
+    printf("Skipping the quiescent region of the Lagrangian phase\n");
+    hale_data->quiescent_steps = 0;
+    hale_data->skipped_cells = 0.0;
+    hale_data->skipped_nodes = 0.0;
+  }
+
+  // The least squares solves of the remap kernels are counted over the run
+  const char* solve_kernels[NSOLVE_KERNELS] = {
+      "gather_subcell_mass_and_energy", "gather_subcell_momentum",
+      "perform_advection", "reconstruct_cell_quantities"};
+  for (int kk = 0; kk < NSOLVE_KERNELS; ++kk) {
+    hale_data->solve_counts[(kk)].kernel = solve_kernels[(kk)];
+    hale_data->solve_counts[(kk)].ncalls = 0;
+    hale_data->solve_counts[(kk)].nill_conditioned = 0.0;
+    hale_data->solve_counts[(kk)].nsingular = 0.0;
+  }
+
+  if (hale_data->ntracers) {
+    register_dyes(hale_data, umesh);
+  }
+
+  // Size the arena with a dry run, then commit it and carve the arrays
+  Arena* arena = &hale_data->arena;
+  init_arena(arena, hale_data->huge_pages);
+  carve_hale_data(hale_data, umesh, arena);
+  const size_t allocated = commit_arena(arena);
+  carve_hale_data(hale_data, umesh, arena);
+  print_scratch_pool(&hale_data->scratch_pool, allocated);
+
+  // Place the pages before anything writes to them, so that they live on the
+  // NUMA node of the threads that will be streaming them
+  place_hale_data(hale_data, umesh);
+  place_mesh_data(hale_data, umesh);
+
+  // The initial mesh is the first geometry epoch
+  hale_data->geometry_epoch = 0;
+  hale_data->ngeometry_epochs = 0;
+  hale_data->rezoned_geometry_epoch = -1;
+  init_geometry_stamp(&hale_data->cell_centroids_stamp, "cell_centroids");
+  init_geometry_stamp(&hale_data->cell_volume_stamp, "cell_volume");
+  init_geometry_stamp(&hale_data->subcell_geometry_stamp, "subcell_geometry");
+
+  // The derived connectivity and initial geometry only depend upon the mesh
+  // and the initial state, so can be reused from a previous run
+  const int cached = hale_data->mesh_cache &&
+                     load_mesh_cache(HALE_MESH_CACHE, hale_data, umesh);
+
+  if (!cached) {
+    // In hale, the fundamental principle is that the mass at the cell and
+    // sub-cell are conserved, so we can initialise them from the mesh
+    // and then only the remapping step will ever adjust them
+    init_cell_centroids(umesh->ncells, umesh->cells_to_nodes_offsets,
+                        umesh->cells_to_nodes, umesh->nodes_x0,
+                        umesh->nodes_y0, umesh->nodes_z0,
+                        umesh->cell_centroids_x, umesh->cell_centroids_y,
+                        umesh->cell_centroids_z);
+
+    init_subcells_to_faces(
+        umesh->ncells, umesh->ncells * umesh->nnodes_by_cell,
+        umesh->cells_to_nodes_offsets, umesh->nodes_to_faces_offsets,
+        umesh->cells_to_nodes, umesh->faces_to_cells0, umesh->faces_to_cells1,
+        umesh->nodes_to_faces, umesh->faces_to_nodes,
+        umesh->faces_to_nodes_offsets, umesh->faces_cclockwise_cell,
+        hale_data->subcells_to_faces, umesh->nodes_x0, umesh->nodes_y0,
+        umesh->nodes_z0, hale_data->subcells_to_faces_offsets);
+
+    // Initialises the list of neighbours to a subcell, only used by the remap
+    if (hale_data->perform_remap) {
+      init_subcells_to_subcells(
+          umesh->ncells, umesh->ncells * umesh->nnodes_by_cell,
+          umesh->faces_to_cells0, umesh->faces_to_cells1,
+          umesh->faces_to_nodes_offsets, umesh->faces_to_nodes,
+          umesh->faces_cclockwise_cell, umesh->nodes_x0, umesh->nodes_y0,
+          umesh->nodes_z0, hale_data->subcells_to_subcells,
+          hale_data->subcells_to_subcells_offsets,
+          umesh->cells_to_nodes_offsets, umesh->nodes_to_faces_offsets,
+          umesh->nodes_to_faces, umesh->cells_to_nodes,
+          hale_data->subcells_to_faces, hale_data->subcells_to_faces_offsets);
+    }
+
+    // Initialises the cell mass, sub-cell mass and sub-cell volume
+    init_mesh_mass(umesh->ncells, umesh->nnodes, hale_data->nnodes_by_subcell,
+                   hale_data->density0, umesh->nodes_x0, umesh->nodes_y0,
+                   umesh->nodes_z0, hale_data->subcell_mass,
+                   hale_data->nodal_mass, umesh->faces_to_nodes_offsets,
+                   umesh->faces_to_nodes, umesh->faces_cclockwise_cell,
+                   umesh->cells_to_nodes_offsets, umesh->cells_to_nodes,
+                   hale_data->subcells_to_faces_offsets,
+                   hale_data->subcells_to_faces, umesh->nodes_to_cells_offsets,
+                   umesh->nodes_to_cells, hale_data->subcell_centroids_x,
+                   hale_data->subcell_centroids_y,
+                   hale_data->subcell_centroids_z, hale_data->subcell_volume,
+                   hale_data->cell_volume, hale_data->nodal_volumes,
+                   hale_data->cell_mass);
+
+    if (hale_data->mesh_cache) {
+      store_mesh_cache(HALE_MESH_CACHE, hale_data, umesh);
+    }
+  }
+
+  // Either way, the centroids and subcell geometry describe the initial mesh
+  hale_data->cell_centroids_stamp.epoch = hale_data->geometry_epoch;
+  hale_data->subcell_geometry_stamp.epoch = hale_data->geometry_epoch;
+
+  // The rezoned mesh is the initial mesh, for an Eulerian remap
+  if (hale_data->perform_remap) {
+    init_rezoned_mesh(hale_data, umesh);
+    store_rezoned_geometry(hale_data, umesh);
+  }
+
+#ifdef SELL_ADJACENCY
+  init_node_sell_adjacency(hale_data, umesh);
+#endif
+
+#ifdef PACKED_CELL_NODES
+  init_packed_cell_nodes(hale_data, umesh);
+#endif
+
+#ifdef NODE_FORCE_ACCUMULATION
+  init_cell_colours(hale_data, umesh);
+#endif
+
+  if (hale_data->tabulated_eos) {
+    read_eos_table(&hale_data->eos_table, EOS_TABLE);
+    print_eos_table("equation of state", &hale_data->eos_table);
+  }
+
+  if (hale_data->multi_material) {
+    init_materials(hale_data, umesh);
+  }
+
+  if (hale_data->ntracers) {
+    init_tracers(hale_data, umesh);
+  }
+
+  if (hale_data->layout_benchmark) {
+    benchmark_node_state(umesh, hale_data);
+    benchmark_equation_of_state(umesh, hale_data);
+  }
+
+  print_hale_placement(hale_data, umesh);
+
+  return allocated;
+}
+
+// Carves all of the hale arrays out of the arena
+static size_t carve_hale_data(HaleData* hale_data, UnstructuredMesh* umesh,
+                              Arena* arena) {
+  const int nsubcell_faces_by_node = NSUBCELL_FACES_BY_NODE;
+  const int nsubcells = hale_data->nsubcells;
+  ScratchPool* pool = &hale_data->scratch_pool;
+  init_scratch_pool(pool);
+
+  size_t allocated = arena_data(arena, &hale_data->pressure0, umesh->ncells);
+  allocated += arena_data(arena, &hale_data->soundspeed0, umesh->ncells);
+  allocated += arena_data(arena, &hale_data->velocity_x0, umesh->nnodes);
+  allocated += arena_data(arena, &hale_data->velocity_y0, umesh->nnodes);
+  allocated += arena_data(arena, &hale_data->velocity_z0, umesh->nnodes);
+  allocated += arena_data(arena, &hale_data->cell_mass, umesh->ncells);
+  allocated += arena_data(arena, &hale_data->nodal_mass, umesh->nnodes);
+  allocated += arena_data(arena, &hale_data->nodal_volumes, umesh->nnodes);
+  allocated += arena_data(arena, &hale_data->nodal_soundspeed, umesh->nnodes);
+  allocated += arena_data(arena, &hale_data->limiter, umesh->nnodes);
+  allocated += arena_data(arena, &hale_data->cell_volume, umesh->ncells);
+
+  allocated += arena_int_data(arena, &hale_data->subcells_to_faces,
+                              nsubcells * nsubcell_faces_by_node);
+  allocated += arena_int_data(arena, &hale_data->subcells_to_faces_offsets,
+                              nsubcells + 1);
+
+  allocated += arena_data(arena, &hale_data->subcell_mass, nsubcells);
+  allocated += arena_data(arena, &hale_data->subcell_volume, nsubcells);
+  allocated += arena_data(arena, &hale_data->subcell_centroids_x, nsubcells);
+  allocated += arena_data(arena, &hale_data->subcell_centroids_y, nsubcells);
+  allocated += arena_data(arena, &hale_data->subcell_centroids_z, nsubcells);
+
+  // The cell-local blocks are only needed by the packed kernels, and the
+  // positions outlive the remap, which moves the nodes as it rezones
+  hale_data->cell_nodes = NULL;
+  hale_data->cell_velocity = NULL;
+  hale_data->cells_to_local_face_nodes = NULL;
+#ifdef PACKED_CELL_NODES
+  allocated += arena_data(arena, &hale_data->cell_nodes,
+                          (size_t)umesh->ncells * HEX_BLOCK);
+  allocated += arena_int_data(arena, &hale_data->cells_to_local_face_nodes,
+                              (size_t)umesh->ncells * NFACES_BY_HEX *
+                                  NNODES_BY_HEX_FACE);
+  scratch_data(pool, &hale_data->cell_velocity,
+               (size_t)umesh->ncells * HEX_BLOCK, PHASE_LAGRANGIAN, 0);
+#endif
+
+  // The forces accumulated at the nodes are cleared as they are consumed, so
+  // must outlive each step to start the next one cleared
+  hale_data->node_force_x = NULL;
+  hale_data->node_force_y = NULL;
+  hale_data->node_force_z = NULL;
+#ifdef NODE_FORCE_ACCUMULATION
+  allocated += arena_data(arena, &hale_data->node_force_x, umesh->nnodes);
+  allocated += arena_data(arena, &hale_data->node_force_y, umesh->nnodes);
+  allocated += arena_data(arena, &hale_data->node_force_z, umesh->nnodes);
+#endif
+
+  // The interleaved node state is gathered afresh by each Lagrangian step
+#ifdef AOSOA_NODE_STATE
+  scratch_data(pool, &hale_data->node_state.data,
+               NODE_STATE_LEN((size_t)umesh->nnodes), PHASE_LAGRANGIAN, 0);
+#endif
+
+  // The predictor-corrector temporaries are dead outside of the Lagrangian
+  // phase, and are always written before they are read
+  scratch_data(pool, &hale_data->velocity_x1, umesh->nnodes, PHASE_LAGRANGIAN,
+               0);
+  scratch_data(pool, &hale_data->velocity_y1, umesh->nnodes, PHASE_LAGRANGIAN,
+               0);
+  scratch_data(pool, &hale_data->velocity_z1, umesh->nnodes, PHASE_LAGRANGIAN,
+               0);
+  scratch_data(pool, &hale_data->energy1, umesh->ncells, PHASE_LAGRANGIAN, 0);
+  scratch_data(pool, &hale_data->density1, umesh->ncells, PHASE_LAGRANGIAN, 0);
+  scratch_data(pool, &hale_data->pressure1, umesh->ncells, PHASE_LAGRANGIAN,
+               0);
+  scratch_data(pool, &hale_data->soundspeed1, umesh->ncells, PHASE_LAGRANGIAN,
+               0);
+
+  // The forces accumulated at the nodes find the subcell forces of each cell
+  // again wherever they are needed, so the subcell forces are never stored
+#ifdef NODE_FORCE_ACCUMULATION
+  hale_data->subcell_force_x = NULL;
+  hale_data->subcell_force_y = NULL;
+  hale_data->subcell_force_z = NULL;
+#else
+  scratch_data(pool, &hale_data->subcell_force_x, nsubcells, PHASE_LAGRANGIAN,
+               0);
+  scratch_data(pool, &hale_data->subcell_force_y, nsubcells, PHASE_LAGRANGIAN,
+               0);
+  scratch_data(pool, &hale_data->subcell_force_z, nsubcells, PHASE_LAGRANGIAN,
+               0);
+#endif
+  scratch_data(pool, &hale_data->cell_work, umesh->ncells, PHASE_LAGRANGIAN, 0);
+
+  // The activity front is rebuilt every step, but the shortest edges of the
+  // quiescent cells are kept between steps
+  hale_data->cell_front = NULL;
+  hale_data->node_front = NULL;
+  hale_data->active_cells = NULL;
+  hale_data->front_nodes = NULL;
+  hale_data->moving_nodes = NULL;
+  hale_data->cell_quiescent = NULL;
+  hale_data->compact_offsets = NULL;
+  hale_data->quiescent_edge = NULL;
+  if (hale_data->quiescent_skip) {
+    const int nblocks =
+        (max(umesh->ncells, umesh->nnodes) + COMPACT_BLOCK - 1) / COMPACT_BLOCK;
+    allocated += arena_int_data(arena, &hale_data->cell_front, umesh->ncells);
+    allocated += arena_int_data(arena, &hale_data->node_front, umesh->nnodes);
+    allocated += arena_int_data(arena, &hale_data->active_cells, umesh->ncells);
+    allocated += arena_int_data(arena, &hale_data->front_nodes, umesh->nnodes);
+    allocated += arena_int_data(arena, &hale_data->moving_nodes, umesh->nnodes);
+    allocated +=
+        arena_int_data(arena, &hale_data->cell_quiescent, umesh->ncells);
+    allocated +=
+        arena_int_data(arena, &hale_data->compact_offsets, nblocks + 1);
+    allocated += arena_data(arena, &hale_data->quiescent_edge, umesh->ncells);
+  }
+
+  // The mixed cells are laid out by blocks of cells
+  hale_data->mixed_block_offsets = NULL;
+  hale_data->entry_block_offsets = NULL;
+  if (hale_data->multi_material) {
+    const int nblocks = (umesh->ncells + COMPACT_BLOCK - 1) / COMPACT_BLOCK;
+    allocated +=
+        arena_int_data(arena, &hale_data->mixed_block_offsets, nblocks + 1);
+    allocated +=
+        arena_int_data(arena, &hale_data->entry_block_offsets, nblocks + 1);
+  }
+
+  // The remap-only state is never needed in a purely Lagrangian run
+  hale_data->rezoned_nodes_x = NULL;
+  hale_data->rezoned_nodes_y = NULL;
+  hale_data->rezoned_nodes_z = NULL;
+  hale_data->rezoned_cell_centroids_x = NULL;
+  hale_data->rezoned_cell_centroids_y = NULL;
+  hale_data->rezoned_cell_centroids_z = NULL;
+  hale_data->rezoned_face_centroids_x = NULL;
+  hale_data->rezoned_face_centroids_y = NULL;
+  hale_data->rezoned_face_centroids_z = NULL;
+  hale_data->rezoned_cell_volume = NULL;
+  hale_data->subcells_to_subcells = NULL;
+  hale_data->subcells_to_subcells_offsets = NULL;
+  hale_data->ke_mass = NULL;
+  hale_data->subcell_momentum_x = NULL;
+  hale_data->subcell_momentum_y = NULL;
+  hale_data->subcell_momentum_z = NULL;
+  hale_data->subcell_ie_mass = NULL;
+  hale_data->subcell_ke_mass = NULL;
+  hale_data->subcell_momentum_flux_x = NULL;
+  hale_data->subcell_momentum_flux_y = NULL;
+  hale_data->subcell_momentum_flux_z = NULL;
+  hale_data->subcell_mass_flux = NULL;
+  hale_data->subcell_ie_mass_flux = NULL;
+  hale_data->subcell_ke_mass_flux = NULL;
+  hale_data->face_flux = NULL;
+  hale_data->subcell_tracer_mass = NULL;
+  hale_data->subcell_tracer_flux = NULL;
+  hale_data->cell_reconstruction = NULL;
+  if (hale_data->perform_remap) {
+    allocated += arena_data(arena, &hale_data->rezoned_cell_centroids_x,
+                            umesh->ncells);
+    allocated += arena_data(arena, &hale_data->rezoned_cell_centroids_y,
+                            umesh->ncells);
+    allocated += arena_data(arena, &hale_data->rezoned_cell_centroids_z,
+                            umesh->ncells);
+    allocated += arena_data(arena, &hale_data->rezoned_face_centroids_x,
+                            umesh->nfaces);
+    allocated += arena_data(arena, &hale_data->rezoned_face_centroids_y,
+                            umesh->nfaces);
+    allocated += arena_data(arena, &hale_data->rezoned_face_centroids_z,
+                            umesh->nfaces);
+    allocated +=
+        arena_data(arena, &hale_data->rezoned_cell_volume, umesh->ncells);
+    allocated += arena_int_data(arena, &hale_data->subcells_to_subcells,
+                                nsubcells * nsubcell_faces_by_node * 2);
+    allocated +=
+        arena_int_data(arena, &hale_data->subcells_to_subcells_offsets,
+                       nsubcells + 1);
+
+    // The gathered quantities are rebuilt at the start of every remap
+    scratch_data(pool, &hale_data->ke_mass, umesh->ncells, PHASE_REMAP, 0);
+    scratch_data(pool, &hale_data->subcell_momentum_x, nsubcells, PHASE_REMAP,
+                 0);
+    scratch_data(pool, &hale_data->subcell_momentum_y, nsubcells, PHASE_REMAP,
+                 0);
+    scratch_data(pool, &hale_data->subcell_momentum_z, nsubcells, PHASE_REMAP,
+                 0);
+    scratch_data(pool, &hale_data->subcell_ie_mass, nsubcells, PHASE_REMAP,
+                 0);
+    scratch_data(pool, &hale_data->subcell_ke_mass, nsubcells, PHASE_REMAP,
+                 0);
+
+    // The fluxes are reduced into, so must be cleared as the remap begins
+    scratch_data(pool, &hale_data->subcell_momentum_flux_x, nsubcells,
+                 PHASE_REMAP, 1);
+    scratch_data(pool, &hale_data->subcell_momentum_flux_y, nsubcells,
+                 PHASE_REMAP, 1);
+    scratch_data(pool, &hale_data->subcell_momentum_flux_z, nsubcells,
+                 PHASE_REMAP, 1);
+    scratch_data(pool, &hale_data->subcell_mass_flux, nsubcells,
+                 PHASE_REMAP, 1);
+    scratch_data(pool, &hale_data->subcell_ie_mass_flux, nsubcells,
+                 PHASE_REMAP, 1);
+    scratch_data(pool, &hale_data->subcell_ke_mass_flux, nsubcells,
+                 PHASE_REMAP, 1);
+
+    // The materials are advected with the fluxes through the faces
+    if (hale_data->multi_material) {
+      scratch_data(pool, &hale_data->face_flux,
+                   (size_t)umesh->nfaces * 2 * NFACE_FLUXES, PHASE_REMAP, 1);
+    }
+
+    // The tracers of each subcell are gathered, and their fluxes reduced into
+    if (hale_data->ntracers) {
+      scratch_data(pool, &hale_data->subcell_tracer_mass,
+                   (size_t)nsubcells * hale_data->ntracers, PHASE_REMAP, 0);
+      scratch_data(pool, &hale_data->subcell_tracer_flux,
+                   (size_t)nsubcells * hale_data->ntracers, PHASE_REMAP, 1);
+    }
+
+    // The cell remap reconstructs every cell before sweeping its faces
+    if (hale_data->cell_remap) {
+      scratch_data(pool, &hale_data->cell_reconstruction,
+                   (size_t)umesh->ncells * CELL_RECONSTRUCTION_STRIDE,
+                   PHASE_REMAP, 0);
+    }
+  }
+
+  // The tracers are carried over steps, so they are not scratch
+  hale_data->tracers.concentration = NULL;
+  if (hale_data->ntracers) {
+    allocated += carve_tracers(&hale_data->tracers, arena);
+  }
+
+  allocated += carve_scratch_pool(pool, arena);
 
   return allocated;
 }
 
+#ifdef SELL_ADJACENCY
+// Builds the SELL-C-sigma copies of the node adjacency
+static void init_node_sell_adjacency(HaleData* hale_data,
+                                     UnstructuredMesh* umesh) {
+  const int nnodes = umesh->nnodes;
+
+  init_sell_adjacency(&hale_data->nodes_to_cells_sell, nnodes,
+                      umesh->nodes_to_cells_offsets, umesh->nodes_to_cells);
+  init_sell_adjacency(&hale_data->nodes_to_nodes_sell, nnodes,
+                      umesh->nodes_to_nodes_offsets, umesh->nodes_to_nodes);
+
+  // The subcell of a node in each of its cells saves the kernels from
+  // searching the nodes of the cell
+  int* nodes_to_subcells;
+  allocate_int_data(&nodes_to_subcells,
+                    umesh->nodes_to_cells_offsets[(nnodes)]);
+  for (int nn = 0; nn < nnodes; ++nn) {
+    for (int cc = umesh->nodes_to_cells_offsets[(nn)];
+         cc < umesh->nodes_to_cells_offsets[(nn + 1)]; ++cc) {
+      const int cell_index = umesh->nodes_to_cells[(cc)];
+      nodes_to_subcells[(cc)] = -1;
+      if (cell_index == -1) {
+        continue;
+      }
+
+      const int cell_to_nodes_off = umesh->cells_to_nodes_offsets[(cell_index)];
+      const int nnodes_by_cell =
+          umesh->cells_to_nodes_offsets[(cell_index + 1)] - cell_to_nodes_off;
+      for (int nn2 = 0; nn2 < nnodes_by_cell; ++nn2) {
+        if (umesh->cells_to_nodes[(cell_to_nodes_off + nn2)] == nn) {
+          nodes_to_subcells[(cc)] = cell_to_nodes_off + nn2;
+          break;
+        }
+      }
+    }
+  }
+  init_sell_values(&hale_data->nodes_to_cells_sell,
+                   umesh->nodes_to_cells_offsets, nodes_to_subcells,
+                   &hale_data->nodes_to_subcells_sell);
+  deallocate_int_data(nodes_to_subcells);
+
+  // The slices are consumed by loops over slices
+  SellAdjacency* sells[] = {&hale_data->nodes_to_cells_sell,
+                            &hale_data->nodes_to_nodes_sell};
+  for (size_t ii = 0; ii < sizeof(sells) / sizeof(*sells); ++ii) {
+    const size_t nslices = sells[(ii)]->nslices;
+    migrate_data(sells[(ii)]->rows, nslices, SELL_CHUNK * sizeof(int));
+    migrate_data(sells[(ii)]->degree, nslices, SELL_CHUNK * sizeof(int));
+    migrate_list_data(sells[(ii)]->entries, sells[(ii)]->slice_offsets,
+                      nslices);
+  }
+  migrate_list_data(hale_data->nodes_to_subcells_sell,
+                    hale_data->nodes_to_cells_sell.slice_offsets,
+                    hale_data->nodes_to_cells_sell.nslices);
+
+  print_sell_adjacency("nodes_to_cells", &hale_data->nodes_to_cells_sell);
+  print_sell_adjacency("nodes_to_nodes", &hale_data->nodes_to_nodes_sell);
+}
+#endif
+
+#ifdef PACKED_CELL_NODES
+// Builds the cell-local view of the faces, and packs the initial mesh
+static void init_packed_cell_nodes(HaleData* hale_data,
+                                   UnstructuredMesh* umesh) {
+  for (int cc = 0; cc < umesh->ncells; ++cc) {
+    const int cell_to_nodes_off = umesh->cells_to_nodes_offsets[(cc)];
+    const int cell_to_faces_off = umesh->cells_to_faces_offsets[(cc)];
+    if (umesh->cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off !=
+            NNODES_BY_HEX ||
+        umesh->cells_to_faces_offsets[(cc + 1)] - cell_to_faces_off !=
+            NFACES_BY_HEX) {
+      TERMINATE("PACKED_CELL_NODES requires a hexahedral mesh.\n");
+    }
+
+    for (int ff = 0; ff < NFACES_BY_HEX; ++ff) {
+      const int face_index = umesh->cells_to_faces[(cell_to_faces_off + ff)];
+      const int face_to_nodes_off = umesh->faces_to_nodes_offsets[(face_index)];
+      if (umesh->faces_to_nodes_offsets[(face_index + 1)] - face_to_nodes_off !=
+          NNODES_BY_HEX_FACE) {
+        TERMINATE("PACKED_CELL_NODES requires a hexahedral mesh.\n");
+      }
+
+      // Each face node is found by its position in the cell's nodes
+      for (int nn = 0; nn < NNODES_BY_HEX_FACE; ++nn) {
+        const int node_index =
+            umesh->faces_to_nodes[(face_to_nodes_off + nn)];
+        int local_index = -1;
+        for (int nn2 = 0; nn2 < NNODES_BY_HEX; ++nn2) {
+          if (umesh->cells_to_nodes[(cell_to_nodes_off + nn2)] == node_index) {
+            local_index = nn2;
+            break;
+          }
+        }
+        if (local_index == -1) {
+          TERMINATE("Face node %d is not a node of cell %d.\n", node_index,
+                    cc);
+        }
+        hale_data->cells_to_local_face_nodes[(
+            (cc * NFACES_BY_HEX + ff) * NNODES_BY_HEX_FACE + nn)] =
+            local_index;
+      }
+    }
+  }
+
+  pack_cell_nodes(umesh->ncells, umesh->cells_to_nodes_offsets,
+                  umesh->cells_to_nodes, umesh->nodes_x0, umesh->nodes_y0,
+                  umesh->nodes_z0, hale_data->cell_nodes);
+
+  // Reports the trade, and leaves the blocks holding the initial mesh
+  if (hale_data->layout_benchmark) {
+    benchmark_packed_cell_nodes(umesh, hale_data);
+  }
+}
+#endif
+
+#ifdef NODE_FORCE_ACCUMULATION
+// Colours the cells greedily, so that no two cells of a colour share a node
+static void init_cell_colours(HaleData* hale_data, UnstructuredMesh* umesh) {
+  const int ncells = umesh->ncells;
+
+  // The colours taken by the neighbours of a cell are marked with the cell
+  int* cell_colour;
+  int* colour_mark;
+  allocate_int_data(&cell_colour, ncells);
+  allocate_int_data(&colour_mark, ncells + 1);
+  for (int cc = 0; cc < ncells; ++cc) {
+    cell_colour[(cc)] = -1;
+    colour_mark[(cc)] = -1;
+  }
+  colour_mark[(ncells)] = -1;
+
+  int ncell_colours = 0;
+  for (int cc = 0; cc < ncells; ++cc) {
+    // The forces on the subcells of a cell are held in buffers of a hex
+    if (umesh->cells_to_nodes_offsets[(cc + 1)] -
+            umesh->cells_to_nodes_offsets[(cc)] >
+        NSUBCELLS_BY_CELL) {
+      TERMINATE("NODE_FORCE_ACCUMULATION only supports cells of up to %d "
+                "nodes.\n",
+                NSUBCELLS_BY_CELL);
+    }
+
+    for (int nn = umesh->cells_to_nodes_offsets[(cc)];
+         nn < umesh->cells_to_nodes_offsets[(cc + 1)]; ++nn) {
+      const int node_index = umesh->cells_to_nodes[(nn)];
+      for (int cc2 = umesh->nodes_to_cells_offsets[(node_index)];
+           cc2 < umesh->nodes_to_cells_offsets[(node_index + 1)]; ++cc2) {
+        const int cell_index = umesh->nodes_to_cells[(cc2)];
+        if (cell_index != -1 && cell_colour[(cell_index)] != -1) {
+          colour_mark[(cell_colour[(cell_index)])] = cc;
+        }
+      }
+    }
+
+    int colour = 0;
+    while (colour_mark[(colour)] == cc) {
+      colour++;
+    }
+    cell_colour[(cc)] = colour;
+    ncell_colours = max(ncell_colours, colour + 1);
+  }
+
+  // Sort the cells by colour, keeping the cells of a colour in order
+  hale_data->ncell_colours = ncell_colours;
+  allocate_int_data(&hale_data->cell_colours_offsets, ncell_colours + 1);
+  allocate_int_data(&hale_data->cells_by_colour, max(ncells, 1));
+  for (int cl = 0; cl <= ncell_colours; ++cl) {
+    hale_data->cell_colours_offsets[(cl)] = 0;
+  }
+  for (int cc = 0; cc < ncells; ++cc) {
+    hale_data->cell_colours_offsets[(cell_colour[(cc)] + 1)]++;
+  }
+  for (int cl = 0; cl < ncell_colours; ++cl) {
+    hale_data->cell_colours_offsets[(cl + 1)] +=
+        hale_data->cell_colours_offsets[(cl)];
+    colour_mark[(cl)] = hale_data->cell_colours_offsets[(cl)];
+  }
+  for (int cc = 0; cc < ncells; ++cc) {
+    hale_data->cells_by_colour[(colour_mark[(cell_colour[(cc)])]++)] = cc;
+  }
+
+  deallocate_int_data(cell_colour);
+  deallocate_int_data(colour_mark);
+
+  printf("Accumulating the node forces over %d cell colours\n", ncell_colours);
+}
+#endif
+
+// Identifies a material with each distinct initial state of the problem, so
+// that every cell begins pure
+static void init_materials(HaleData* hale_data, UnstructuredMesh* umesh) {
+  const int ncells = umesh->ncells;
+
+  double material_density[MAX_MATERIALS];
+  double material_energy[MAX_MATERIALS];
+  int* cell_material;
+  allocate_int_data(&cell_material, ncells);
+
+  int nmaterials = 0;
+  for (int cc = 0; cc < ncells; ++cc) {
+    int mat;
+    for (mat = 0; mat < nmaterials; ++mat) {
+      if (hale_data->density0[(cc)] == material_density[(mat)] &&
+          hale_data->energy0[(cc)] == material_energy[(mat)]) {
+        break;
+      }
+    }
+
+    if (mat == nmaterials) {
+      if (nmaterials == MAX_MATERIALS) {
+        TERMINATE("The problem has more than the %d supported materials.\n",
+                  MAX_MATERIALS);
+      }
+      material_density[(mat)] = hale_data->density0[(cc)];
+      material_energy[(mat)] = hale_data->energy0[(cc)];
+      nmaterials++;
+    }
+    cell_material[(cc)] = mat;
+  }
+
+  init_multi_material(&hale_data->materials, nmaterials, ncells,
+                      cell_material);
+  init_multi_material(&hale_data->next_materials, nmaterials, ncells, NULL);
+  deallocate_int_data(cell_material);
+
+  print_multi_material(&hale_data->materials);
+}
+
+// Registers the passive scalars as dyes, before they are carved
+static void register_dyes(HaleData* hale_data, UnstructuredMesh* umesh) {
+  TracerRegistry* tracers = &hale_data->tracers;
+
+  init_tracer_registry(tracers, umesh->ncells);
+  for (int tt = 0; tt < hale_data->ntracers; ++tt) {
+    char name[MAX_TRACER_NAME];
+    snprintf(name, sizeof(name), "dye%d", tt);
+    register_tracer(tracers, name);
+  }
+}
+
+// Fills the dyes into bands of the mesh, where each tracer marks the cells
+// whose centroids lie in its band along x
+static void init_tracers(HaleData* hale_data, UnstructuredMesh* umesh) {
+  const int ncells = umesh->ncells;
+  TracerRegistry* tracers = &hale_data->tracers;
+
+  double min_x = DBL_MAX;
+  double max_x = -DBL_MAX;
+  for (int cc = 0; cc < ncells; ++cc) {
+    min_x = min(min_x, umesh->cell_centroids_x[(cc)]);
+    max_x = max(max_x, umesh->cell_centroids_x[(cc)]);
+  }
+
+  const double band_width = (max_x - min_x) / tracers->ntracers;
+  for (int cc = 0; cc < ncells; ++cc) {
+    const int band =
+        (band_width > 0.0)
+            ? (int)((umesh->cell_centroids_x[(cc)] - min_x) / band_width)
+            : 0;
+    TRACER(tracers, cc, min(band, tracers->ntracers - 1)) = 1.0;
+  }
+
+  print_tracers(tracers);
+}
+
 // Deallocates all of the hale specific data
 void deallocate_hale_data(HaleData* hale_data) {
-  // TODO: Populate this correctly !
+#ifdef SELL_ADJACENCY
+  deallocate_sell_adjacency(&hale_data->nodes_to_cells_sell);
+  deallocate_sell_adjacency(&hale_data->nodes_to_nodes_sell);
+  deallocate_int_data(hale_data->nodes_to_subcells_sell);
+#endif
+
+#ifdef NODE_FORCE_ACCUMULATION
+  deallocate_int_data(hale_data->cell_colours_offsets);
+  deallocate_int_data(hale_data->cells_by_colour);
+#endif
+
+  if (hale_data->tabulated_eos) {
+    deallocate_eos_table(&hale_data->eos_table);
+  }
+
+  if (hale_data->multi_material) {
+    deallocate_multi_material(&hale_data->materials);
+    deallocate_multi_material(&hale_data->next_materials);
+  }
+
+  // Every hale array lives in the arena
+  release_arena(&hale_data->arena);
 }
 
 // Writes out unstructured mesh data to visit
@@ -5,8 +5,20 @@
 
 #include "../mesh.h"
 #include "../umesh.h"
+#include "arena.h"
+#include "eos_table.h"
+#include "multi_material.h"
+#include "node_state.h"
+#include "scratch_pool.h"
+#include "sell_adjacency.h"
+#include "small_matrix.h"
+#include "tracers.h"
 #include <stdlib.h>
 
+#if defined(NODE_FORCE_ACCUMULATION) && defined(PACKED_CELL_NODES)
+#error "NODE_FORCE_ACCUMULATION only accumulates the unpacked force kernels."
+#endif
+
 // Controllable parameters for the application
 #define GAM 1.4
 #define C_Q 3.0
@@ -18,10 +30,62 @@
 #define ARCH_ROOT_PARAMS "../arch.params"
 #define HALE_PARAMS "hale.params"
 #define HALE_TESTS "hale.tests"
+#define EOS_TABLE "hale.eos"
 #define NNODES_BY_SUBCELL_FACE 4
 #define NSUBCELL_FACES_BY_NODE 3
 #define NNODES_BY_SUBCELL 8
 #define NSUBCELLS_BY_CELL 8
+#define NNODES_BY_HEX 8
+#define NFACES_BY_HEX 6
+#define NNODES_BY_HEX_FACE 4
+
+// The doubles in the cell-local block of a nodal vector, with the x, y and z
+// components of the nodes of a hex in turn
+#define HEX_BLOCK (3 * NNODES_BY_HEX)
+
+// The repetitions of each kernel timed when weighing a data layout
+#define LAYOUT_BENCHMARK_REPS 10
+
+// The values on each axis of the table timed against the ideal gas
+#define EOS_BENCHMARK_TABLE 256
+
+// The relative change in pressure across a face, and the speed relative to the
+// soundspeed, below which a cell is taken to be quiescent. The state of an
+// untouched region is only uniform to roundoff once the solve has run.
+#define QUIESCENT_TOLERANCE 1.0e-10
+
+// The indices counted by each task when compacting a list of the flagged
+// entities of the mesh
+#define COMPACT_BLOCK 4096
+
+// The orders of the remap. The first order remap is a donor cell remap, which
+// takes the quantities of the upwind subcell as constant across each swept
+// region. It is conservative and can't overshoot the upwind values, so skips
+// the repair phases, but it is diffusive, so is meant for screening runs.
+#define FIRST_ORDER_REMAP 1
+#define SECOND_ORDER_REMAP 2
+
+// The quantities of the cell remap, which are reconstructed about the centroid
+// of each cell, and swept through its faces
+enum { CELL_REMAP_M, CELL_REMAP_IE, CELL_REMAP_KE, NCELL_REMAP_QUANTITIES };
+
+// The reconstruction of a cell holds the value and then the gradient of each
+// quantity, followed by the centroid and the volume of the cell
+#define CELL_RECONSTRUCTION_CENTROID (4 * NCELL_REMAP_QUANTITIES)
+#define CELL_RECONSTRUCTION_VOLUME (CELL_RECONSTRUCTION_CENTROID + 3)
+#define CELL_RECONSTRUCTION_STRIDE (CELL_RECONSTRUCTION_VOLUME + 1)
+#define CELL_RECONSTRUCTION(reconstruction, cc, ee)                            \
+  ((reconstruction)[((cc) * CELL_RECONSTRUCTION_STRIDE + (ee))])
+
+// The kernels that fit their gradients by least squares, whose ill-conditioned
+// and singular systems are counted over the run
+enum {
+  ENERGY_GATHER_SOLVES,
+  MOMENTUM_GATHER_SOLVES,
+  SWEEP_SOLVES,
+  CELL_RECONSTRUCTION_SOLVES,
+  NSOLVE_KERNELS
+};
 
 enum { XYZ, YZX, ZXY };
 
@@ -31,6 +95,15 @@ typedef struct {
   double z;
 } vec_t;
 
+// The geometry epoch that some derived geometry was last evaluated at, and the
+// number of times it was evaluated or found to be fresh since the last report
+typedef struct {
+  const char* name;
+  int epoch;
+  int nevaluated;
+  int nreused;
+} GeometryStamp;
+
 typedef struct {
   double* energy0;
   double* energy1;
@@ -39,6 +112,8 @@ typedef struct {
   double* density1;
   double* pressure0;
   double* pressure1;
+  double* soundspeed0;
+  double* soundspeed1;
   double* velocity_x0;
   double* velocity_y0;
   double* velocity_z0;
@@ -77,9 +152,29 @@ typedef struct {
   double* subcell_force_x;
   double* subcell_force_y;
   double* subcell_force_z;
-  double* rezoned_nodes_x;
-  double* rezoned_nodes_y;
-  double* rezoned_nodes_z;
+  double* cell_work;
+  const double* rezoned_nodes_x;
+  const double* rezoned_nodes_y;
+  const double* rezoned_nodes_z;
+
+  // The centroids of the cells and faces of the rezoned mesh, which only
+  // change when a rezone moves the rezoned nodes
+  double* rezoned_cell_centroids_x;
+  double* rezoned_cell_centroids_y;
+  double* rezoned_cell_centroids_z;
+  double* rezoned_face_centroids_x;
+  double* rezoned_face_centroids_y;
+  double* rezoned_face_centroids_z;
+  double* rezoned_cell_volume;
+
+  // The epoch of the current node coordinates, which moves on whenever they
+  // change, so that the derived geometry is only evaluated again when stale
+  int geometry_epoch;
+  int ngeometry_epochs;
+  int rezoned_geometry_epoch;
+  GeometryStamp cell_centroids_stamp;
+  GeometryStamp cell_volume_stamp;
+  GeometryStamp subcell_geometry_stamp;
 
   int nsubcells;
   int nsubcell_nodes;
@@ -91,6 +186,63 @@ typedef struct {
 
   int perform_remap;
   int visit_dump;
+  int mesh_cache;
+  int huge_pages;
+  int remap_schedule;
+  int remap_order;
+  int layout_benchmark;
+  int tabulated_eos;
+
+  // The states of the least squares solves of each remap kernel, where a
+  // singular system leaves the gradients zero
+  SolveCounts solve_counts[NSOLVE_KERNELS];
+
+  // The tabulated equation of state of the material, when tabulated_eos is set
+  EosTable eos_table;
+
+  // The materials of the cells, when multi_material is set, where the remap
+  // builds the next materials from the current ones, and the fluxes that it
+  // advects them with. The mixed cells and their entries are counted by blocks
+  // of cells, to lay them out in parallel.
+  int multi_material;
+  MultiMaterial materials;
+  MultiMaterial next_materials;
+  double* face_flux;
+  int* mixed_block_offsets;
+  int* entry_block_offsets;
+
+  // The passive scalars carried through the remap, when ntracers is set, with
+  // the tracers of each subcell contiguous
+  int ntracers;
+  TracerRegistry tracers;
+  double* subcell_tracer_mass;
+  double* subcell_tracer_flux;
+
+  // The cell remap sweeps the faces of the cells rather than the subcells,
+  // when cell_remap is set, with each cell reconstructed about its centroid
+  int cell_remap;
+  double* cell_reconstruction;
+
+  // The cells within two rings of the moving or non-uniform cells, and the
+  // nodes that they gather and move, when quiescent_skip is set. The rest of
+  // the mesh is held in its current state through the Lagrangian phase, and
+  // the shortest edge of each quiescent cell is kept until it is reactivated.
+  int quiescent_skip;
+  int nactive_cells;
+  int nfront_nodes;
+  int nmoving_nodes;
+  int* cell_front;
+  int* node_front;
+  int* active_cells;
+  int* front_nodes;
+  int* moving_nodes;
+  int* cell_quiescent;
+  int* compact_offsets;
+  double* quiescent_edge;
+  double quiescent_dt;
+  int quiescent_steps;
+  double skipped_cells;
+  double skipped_nodes;
 
   int* subcells_to_nodes;
   int* subcells_to_subcells_offsets;
@@ -98,6 +250,28 @@ typedef struct {
   int* subcells_to_faces;
   int* subcells_to_faces_offsets;
 
+  // SELL-C-sigma copies of the node adjacency, where the subcells of a node
+  // are laid out exactly as its cells
+  SellAdjacency nodes_to_cells_sell;
+  SellAdjacency nodes_to_nodes_sell;
+  int* nodes_to_subcells_sell;
+
+  // The cells of each colour, where no two cells of a colour share a node, so
+  // that the forces of a colour can be accumulated straight into the nodes
+  int ncell_colours;
+  int* cell_colours_offsets;
+  int* cells_by_colour;
+
+  // Cell-local blocks of the node positions and velocities of each hex, in the
+  // order of cells_to_nodes, and the position in the block of each node of the
+  // faces of a cell, in the order of cells_to_faces and faces_to_nodes
+  double* cell_nodes;
+  double* cell_velocity;
+  int* cells_to_local_face_nodes;
+
+  // The state of the nodes read by the gather-heavy Lagrangian kernels
+  NodeState node_state;
+
   // Only intended for testing purposes
   double* subcell_nodes_x;
   double* subcell_nodes_y;
@@ -105,6 +279,12 @@ typedef struct {
 
   // Array used for CUDA reductions generally
   double* reduce_array;
+
+  // Backs all of the hale specific arrays
+  Arena arena;
+
+  // Shares storage between arrays that are live in different phases
+  ScratchPool scratch_pool;
 } HaleData;
 
 // Initialises the shared_data variables for two dimensional applications
@@ -137,6 +317,84 @@ void init_cell_centroids(const int ncells, const int* cells_offsets,
                          double* cell_centroids_x, double* cell_centroids_y,
                          double* cell_centroids_z);
 
+// Calculates the centroids of the listed cells
+void init_cell_centroids_active(const int nlisted, const int* cell_list,
+                                const int* cells_to_nodes_offsets,
+                                const int* cells_to_nodes,
+                                const double* nodes_x, const double* nodes_y,
+                                const double* nodes_z,
+                                double* cell_centroids_x,
+                                double* cell_centroids_y,
+                                double* cell_centroids_z);
+
+// Initialises the centroids for each face
+void init_face_centroids(const int nfaces, const int* faces_to_nodes_offsets,
+                         const int* faces_to_nodes, const double* nodes_x,
+                         const double* nodes_y, const double* nodes_z,
+                         double* face_centroids_x, double* face_centroids_y,
+                         double* face_centroids_z);
+
+// Initialises the volume of each cell
+void init_cell_volumes(const int ncells, const int* cells_to_nodes_offsets,
+                       const int* cells_to_nodes,
+                       const int* cells_to_faces_offsets,
+                       const int* cells_to_faces,
+                       const int* faces_to_nodes_offsets,
+                       const int* faces_to_nodes, const double* nodes_x,
+                       const double* nodes_y, const double* nodes_z,
+                       double* cell_volume);
+
+// Initialises the stamp of some derived geometry that has never been evaluated
+void init_geometry_stamp(GeometryStamp* stamp, const char* name);
+
+// First touches the hale arrays with the partitioning of their kernels
+void place_hale_data(HaleData* hale_data, UnstructuredMesh* umesh);
+
+// Migrates the mesh arrays to the threads that consume them
+void place_mesh_data(HaleData* hale_data, UnstructuredMesh* umesh);
+
+// Reports the NUMA placement of a representative set of arrays
+void print_hale_placement(HaleData* hale_data, UnstructuredMesh* umesh);
+
+// Points the rezoned mesh at the initial mesh
+void init_rezoned_mesh(HaleData* hale_data, UnstructuredMesh* umesh);
+
+// Stores the geometry of the rezoned mesh, which must be called again by any
+// rezone that moves the rezoned nodes
+void store_rezoned_geometry(HaleData* hale_data, UnstructuredMesh* umesh);
+
+// Copies the nodal vector of each hex into its cell-local block
+void pack_cell_nodes(const int ncells, const int* cells_to_nodes_offsets,
+                     const int* cells_to_nodes, const double* nodes_x,
+                     const double* nodes_y, const double* nodes_z,
+                     double* cell_nodes);
+
+// Initialises the centroids for each cell from the cell-local blocks
+void init_cell_centroids_packed(const int ncells, const double* cell_nodes,
+                                double* cell_centroids_x,
+                                double* cell_centroids_y,
+                                double* cell_centroids_z);
+
+// Weighs the memory of the cell-local blocks against the time the density
+// kernels save by reading them
+void benchmark_packed_cell_nodes(UnstructuredMesh* umesh, HaleData* hale_data);
+
+// Points the node state at a time level, interleaving a copy of the nodal
+// arrays with AOSOA_NODE_STATE
+void sync_node_state(const int nnodes, const double* nodes_x,
+                     const double* nodes_y, const double* nodes_z,
+                     const double* velocity_x, const double* velocity_y,
+                     const double* velocity_z, const double* nodal_mass,
+                     const double* nodal_volumes, NodeState* node_state);
+
+// Times the gather-heavy kernels that read the node state, in the layout of
+// the build
+void benchmark_node_state(UnstructuredMesh* umesh, HaleData* hale_data);
+
+// Times the tabulated equation of state against the ideal gas, over a table
+// of the ideal gas that spans the initial state
+void benchmark_equation_of_state(UnstructuredMesh* umesh, HaleData* hale_data);
+
 // Initialises the list of neighbours to a subcell
 void init_subcells_to_subcells(
     const int ncells, const int nsubcells, const int* faces_to_cells0,
@@ -157,13 +415,6 @@ void init_subcells_to_faces(
     int* subcells_to_faces, const double* nodes_x, const double* nodes_y,
     const double* nodes_z, int* subcells_to_faces_offsets);
 
-// Stores the rezoned grid specification, in case we aren't going to use a
-// rezoning strategy and want to perform an Eulerian remap
-void store_rezoned_mesh(const int nnodes, const double* nodes_x,
-                        const double* nodes_y, const double* nodes_z,
-                        double* rezoned_nodes_x, double* rezoned_nodes_y,
-                        double* rezoned_nodes_z);
-
 // Deallocates all of the hale specific data
 void deallocate_hale_data(HaleData* hale_data);
 
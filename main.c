@@ -69,6 +69,17 @@ int main(int argc, char** argv) {
   hale_data.visc_coeff2 = get_double_parameter("visc_coeff2", hale_params);
   hale_data.perform_remap = get_int_parameter("perform_remap", hale_params);
   hale_data.visit_dump = get_int_parameter("visit_dump", hale_params);
+  hale_data.mesh_cache = get_int_parameter("mesh_cache", hale_params);
+  hale_data.huge_pages = get_int_parameter("huge_pages", hale_params);
+  hale_data.remap_schedule = get_int_parameter("remap_schedule", hale_params);
+  hale_data.remap_order = get_int_parameter("remap_order", hale_params);
+  hale_data.layout_benchmark =
+      get_int_parameter("layout_benchmark", hale_params);
+  hale_data.tabulated_eos = get_int_parameter("tabulated_eos", hale_params);
+  hale_data.multi_material = get_int_parameter("multi_material", hale_params);
+  hale_data.ntracers = get_int_parameter("ntracers", hale_params);
+  hale_data.cell_remap = get_int_parameter("cell_remap", hale_params);
+  hale_data.quiescent_skip = get_int_parameter("quiescent_skip", hale_params);
   allocated += init_hale_data(&hale_data, &umesh);
 
   printf("Initialisation time %.4lfs\n", omp_get_wtime() - i0);
@@ -123,10 +134,28 @@ int main(int argc, char** argv) {
   if (mesh.rank == MASTER) {
     PRINT_PROFILING_RESULTS(&compute_profile);
     PRINT_PROFILING_RESULTS(&comms_profile);
+    if (hale_data.quiescent_skip && hale_data.quiescent_steps) {
+      printf("Skipped %.2f%% of the cells and %.2f%% of the nodes in the "
+             "quiescent region\n",
+             100.0 * hale_data.skipped_cells /
+                 ((double)umesh.ncells * hale_data.quiescent_steps),
+             100.0 * hale_data.skipped_nodes /
+                 ((double)umesh.nnodes * hale_data.quiescent_steps));
+    }
+    for (int kk = 0; kk < NSOLVE_KERNELS; ++kk) {
+      const SolveCounts* solve_counts = &hale_data.solve_counts[(kk)];
+      if (solve_counts->ncalls) {
+        printf("%s met %.0f ill-conditioned and %.0f singular least squares "
+               "systems over %d calls\n",
+               solve_counts->kernel, solve_counts->nill_conditioned,
+               solve_counts->nsingular, solve_counts->ncalls);
+      }
+    }
     printf("Wallclock %.4fs, Elapsed Simulation Time %.4fs\n", wallclock,
            elapsed_sim_time);
   }
 
+  deallocate_hale_data(&hale_data);
   finalise_mesh(&mesh);
 
   return 0;
@@ -0,0 +1,281 @@
+#include "mesh_cache.h"
+#include "../shared.h"
+#include "../umesh.h"
+#include "hale_data.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+// Accumulates a buffer into a 64 bit FNV-1a style hash, a word at a time
+static uint64_t hash_buffer(uint64_t hash, const void* buffer,
+                            const size_t nbytes);
+
+// Fills the list of arrays that are stored in the cache
+static void get_cache_sections(HaleData* hale_data, UnstructuredMesh* umesh,
+                               void** arrays, uint64_t* nbytes);
+
+// Rounds an offset up to the cache alignment
+static uint64_t align_offset(const uint64_t offset);
+
+// Attempts to map the cache and populate the derived connectivity, centroids
+// and initial masses, returning 0 if the cache is missing or invalid
+int load_mesh_cache(const char* filename, HaleData* hale_data,
+                    UnstructuredMesh* umesh) {
+
+  const int fd = open(filename, O_RDONLY);
+  if (fd < 0) {
+    printf("No mesh cache found at %s, building derived mesh data.\n",
+           filename);
+    return 0;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) || st.st_size < (off_t)sizeof(MeshCacheHeader)) {
+    printf("Mesh cache %s is truncated, rebuilding.\n", filename);
+    close(fd);
+    return 0;
+  }
+
+  const size_t file_size = st.st_size;
+  char* map = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    printf("Could not map mesh cache %s, rebuilding.\n", filename);
+    return 0;
+  }
+
+  void* arrays[MESH_CACHE_NSECTIONS];
+  uint64_t nbytes[MESH_CACHE_NSECTIONS];
+  get_cache_sections(hale_data, umesh, arrays, nbytes);
+
+  // Validate the header against the mesh we are about to run
+  MeshCacheHeader header;
+  memcpy(&header, map, sizeof(MeshCacheHeader));
+  const char* reason = NULL;
+  if (memcmp(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic))) {
+    reason = "bad magic";
+  } else if (header.version != MESH_CACHE_VERSION) {
+    reason = "version mismatch";
+  } else if (header.nsections != MESH_CACHE_NSECTIONS ||
+             header.file_size != file_size) {
+    reason = "bad layout";
+  } else if (header.nnodes != umesh->nnodes ||
+             header.ncells != umesh->ncells ||
+             header.nfaces != umesh->nfaces ||
+             header.nsubcells != hale_data->nsubcells) {
+    reason = "mesh dimensions changed";
+  } else if (header.key != calc_mesh_cache_key(hale_data, umesh)) {
+    reason = "key changed";
+  }
+
+  // Every section must be aligned, in bounds and match its checksum
+  for (int ii = 0; ii < MESH_CACHE_NSECTIONS && !reason; ++ii) {
+    const MeshCacheSection* section = &header.sections[(ii)];
+    if (section->nbytes != nbytes[(ii)] ||
+        section->offset % MESH_CACHE_ALIGN ||
+        section->offset + section->nbytes > file_size) {
+      reason = "bad section";
+    } else if (hash_buffer(FNV_OFFSET, map + section->offset,
+                           section->nbytes) != section->checksum) {
+      reason = "checksum mismatch";
+    }
+  }
+
+  if (reason) {
+    printf("Mesh cache %s is stale (%s), rebuilding.\n", filename, reason);
+    munmap(map, file_size);
+    return 0;
+  }
+
+  for (int ii = 0; ii < MESH_CACHE_NSECTIONS; ++ii) {
+    if (nbytes[(ii)]) {
+      memcpy(arrays[(ii)], map + header.sections[(ii)].offset, nbytes[(ii)]);
+    }
+  }
+
+  munmap(map, file_size);
+
+  printf("Loaded derived mesh data from %s.\n", filename);
+  return 1;
+}
+
+// Writes the derived connectivity, centroids and initial masses to the cache
+void store_mesh_cache(const char* filename, HaleData* hale_data,
+                      UnstructuredMesh* umesh) {
+
+  void* arrays[MESH_CACHE_NSECTIONS];
+  uint64_t nbytes[MESH_CACHE_NSECTIONS];
+  get_cache_sections(hale_data, umesh, arrays, nbytes);
+
+  MeshCacheHeader header;
+  memset(&header, 0, sizeof(MeshCacheHeader));
+  memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic));
+  header.version = MESH_CACHE_VERSION;
+  header.nsections = MESH_CACHE_NSECTIONS;
+  header.key = calc_mesh_cache_key(hale_data, umesh);
+  header.nnodes = umesh->nnodes;
+  header.ncells = umesh->ncells;
+  header.nfaces = umesh->nfaces;
+  header.nsubcells = hale_data->nsubcells;
+
+  uint64_t offset = align_offset(sizeof(MeshCacheHeader));
+  for (int ii = 0; ii < MESH_CACHE_NSECTIONS; ++ii) {
+    header.sections[(ii)].offset = offset;
+    header.sections[(ii)].nbytes = nbytes[(ii)];
+    header.sections[(ii)].checksum =
+        hash_buffer(FNV_OFFSET, arrays[(ii)], nbytes[(ii)]);
+    offset = align_offset(offset + nbytes[(ii)]);
+  }
+  header.file_size = offset;
+
+  // Write to a temporary file and rename so a partial cache is never seen
+  char tmp_filename[MAX_STR_LEN];
+  snprintf(tmp_filename, MAX_STR_LEN, "%s.tmp", filename);
+  FILE* fp = fopen(tmp_filename, "wb");
+  if (!fp) {
+    printf("Warning. Could not open %s to store the mesh cache.\n",
+           tmp_filename);
+    return;
+  }
+
+  static const char padding[MESH_CACHE_ALIGN] = {0};
+  int failed = (fwrite(&header, sizeof(MeshCacheHeader), 1, fp) != 1);
+  uint64_t written = sizeof(MeshCacheHeader);
+  for (int ii = 0; ii < MESH_CACHE_NSECTIONS && !failed; ++ii) {
+    const uint64_t npad = header.sections[(ii)].offset - written;
+    failed |= (fwrite(padding, 1, npad, fp) != npad);
+    failed |= (fwrite(arrays[(ii)], 1, nbytes[(ii)], fp) != nbytes[(ii)]);
+    written = header.sections[(ii)].offset + nbytes[(ii)];
+  }
+  const uint64_t npad = header.file_size - written;
+  failed |= (fwrite(padding, 1, npad, fp) != npad);
+  failed |= fclose(fp);
+
+  if (failed || rename(tmp_filename, filename)) {
+    printf("Warning. Failed to store the mesh cache at %s.\n", filename);
+    remove(tmp_filename);
+    return;
+  }
+
+  printf("Stored derived mesh data in %s.\n", filename);
+}
+
+// Hashes the mesh dimensions, topology and initial state to key the cache
+uint64_t calc_mesh_cache_key(HaleData* hale_data, UnstructuredMesh* umesh) {
+
+  const int64_t dims[] = {MESH_CACHE_VERSION,       NSUBCELLS_BY_CELL,
+                          NNODES_BY_SUBCELL,        NSUBCELL_FACES_BY_NODE,
+                          umesh->nnodes,            umesh->ncells,
+                          umesh->nfaces,            umesh->nnodes_by_cell,
+                          hale_data->nsubcells,     hale_data->perform_remap};
+
+  const size_t nnodes = umesh->nnodes;
+  const size_t ncells = umesh->ncells;
+  const size_t nfaces = umesh->nfaces;
+  const size_t ncells_to_nodes = umesh->cells_to_nodes_offsets[(ncells)];
+  const size_t nfaces_to_nodes = umesh->faces_to_nodes_offsets[(nfaces)];
+  const size_t nnodes_to_faces = umesh->nodes_to_faces_offsets[(nnodes)];
+  const size_t nnodes_to_cells = umesh->nodes_to_cells_offsets[(nnodes)];
+
+  uint64_t key = hash_buffer(FNV_OFFSET, dims, sizeof(dims));
+  key = hash_buffer(key, umesh->nodes_x0, nnodes * sizeof(double));
+  key = hash_buffer(key, umesh->nodes_y0, nnodes * sizeof(double));
+  key = hash_buffer(key, umesh->nodes_z0, nnodes * sizeof(double));
+  key = hash_buffer(key, hale_data->density0, ncells * sizeof(double));
+  key = hash_buffer(key, umesh->cells_to_nodes_offsets,
+                    (ncells + 1) * sizeof(int));
+  key = hash_buffer(key, umesh->cells_to_nodes, ncells_to_nodes * sizeof(int));
+  key = hash_buffer(key, umesh->faces_to_nodes_offsets,
+                    (nfaces + 1) * sizeof(int));
+  key = hash_buffer(key, umesh->faces_to_nodes, nfaces_to_nodes * sizeof(int));
+  key = hash_buffer(key, umesh->faces_to_cells0, nfaces * sizeof(int));
+  key = hash_buffer(key, umesh->faces_to_cells1, nfaces * sizeof(int));
+  key = hash_buffer(key, umesh->faces_cclockwise_cell, nfaces * sizeof(int));
+  key = hash_buffer(key, umesh->nodes_to_faces_offsets,
+                    (nnodes + 1) * sizeof(int));
+  key = hash_buffer(key, umesh->nodes_to_faces, nnodes_to_faces * sizeof(int));
+  key = hash_buffer(key, umesh->nodes_to_cells_offsets,
+                    (nnodes + 1) * sizeof(int));
+  key = hash_buffer(key, umesh->nodes_to_cells, nnodes_to_cells * sizeof(int));
+  return key;
+}
+
+// Fills the list of arrays that are stored in the cache
+static void get_cache_sections(HaleData* hale_data, UnstructuredMesh* umesh,
+                               void** arrays, uint64_t* nbytes) {
+
+  const uint64_t nsubcells = hale_data->nsubcells;
+  const uint64_t ncells = umesh->ncells;
+  const uint64_t nnodes = umesh->nnodes;
+
+  void* section_arrays[MESH_CACHE_NSECTIONS] = {
+      hale_data->subcells_to_faces_offsets,
+      hale_data->subcells_to_faces,
+      hale_data->subcells_to_subcells_offsets,
+      hale_data->subcells_to_subcells,
+      umesh->cell_centroids_x,
+      umesh->cell_centroids_y,
+      umesh->cell_centroids_z,
+      hale_data->subcell_centroids_x,
+      hale_data->subcell_centroids_y,
+      hale_data->subcell_centroids_z,
+      hale_data->subcell_volume,
+      hale_data->subcell_mass,
+      hale_data->cell_volume,
+      hale_data->cell_mass,
+      hale_data->nodal_volumes,
+      hale_data->nodal_mass};
+
+  const uint64_t section_nbytes[MESH_CACHE_NSECTIONS] = {
+      (nsubcells + 1) * sizeof(int),
+      nsubcells * NSUBCELL_FACES_BY_NODE * sizeof(int),
+      (nsubcells + 1) * sizeof(int),
+      nsubcells * NSUBCELL_FACES_BY_NODE * 2 * sizeof(int),
+      ncells * sizeof(double),
+      ncells * sizeof(double),
+      ncells * sizeof(double),
+      nsubcells * sizeof(double),
+      nsubcells * sizeof(double),
+      nsubcells * sizeof(double),
+      nsubcells * sizeof(double),
+      nsubcells * sizeof(double),
+      ncells * sizeof(double),
+      ncells * sizeof(double),
+      nnodes * sizeof(double),
+      nnodes * sizeof(double)};
+
+  // Arrays that are not allocated for this run are stored empty
+  for (int ii = 0; ii < MESH_CACHE_NSECTIONS; ++ii) {
+    arrays[(ii)] = section_arrays[(ii)];
+    nbytes[(ii)] = section_arrays[(ii)] ? section_nbytes[(ii)] : 0;
+  }
+}
+
+// Accumulates a buffer into a 64 bit FNV-1a style hash, a word at a time
+static uint64_t hash_buffer(uint64_t hash, const void* buffer,
+                            const size_t nbytes) {
+
+  const char* bytes = (const char*)buffer;
+  const size_t nwords = nbytes / sizeof(uint64_t);
+  for (size_t ii = 0; ii < nwords; ++ii) {
+    uint64_t word;
+    memcpy(&word, bytes + ii * sizeof(uint64_t), sizeof(uint64_t));
+    hash = (hash ^ word) * FNV_PRIME;
+  }
+  for (size_t ii = nwords * sizeof(uint64_t); ii < nbytes; ++ii) {
+    hash = (hash ^ (uint64_t)(unsigned char)bytes[(ii)]) * FNV_PRIME;
+  }
+  return hash;
+}
+
+// Rounds an offset up to the cache alignment
+static uint64_t align_offset(const uint64_t offset) {
+  return ((offset + MESH_CACHE_ALIGN - 1) / MESH_CACHE_ALIGN) *
+         MESH_CACHE_ALIGN;
+}
@@ -0,0 +1,62 @@
+#ifndef __MESHCACHEHDR
+#define __MESHCACHEHDR
+
+#pragma once
+
+#include "../umesh.h"
+#include "hale_data.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The on-disk cache of the derived mesh data, which is only valid for the
+// mesh and problem description it was built from
+#define HALE_MESH_CACHE "hale_mesh.cache"
+#define MESH_CACHE_MAGIC "HALECACH"
+#define MESH_CACHE_VERSION 1
+#define MESH_CACHE_ALIGN 4096
+#define MESH_CACHE_NSECTIONS 16
+
+// Describes a single contiguous array stored in the cache
+typedef struct {
+  uint64_t offset;
+  uint64_t nbytes;
+  uint64_t checksum;
+} MeshCacheSection;
+
+// The header at the front of the cache file, all sections start on
+// MESH_CACHE_ALIGN boundaries after the header
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t nsections;
+  uint64_t key;
+  uint64_t file_size;
+  int64_t nnodes;
+  int64_t ncells;
+  int64_t nfaces;
+  int64_t nsubcells;
+  MeshCacheSection sections[MESH_CACHE_NSECTIONS];
+} MeshCacheHeader;
+
+// Attempts to map the cache and populate the derived connectivity, centroids
+// and initial masses, returning 0 if the cache is missing or invalid. The
+// arrays are copied directly, so this expects host resident data, and is only
+// used when mesh_cache is set.
+int load_mesh_cache(const char* filename, HaleData* hale_data,
+                    UnstructuredMesh* umesh);
+
+// Writes the derived connectivity, centroids and initial masses to the cache
+void store_mesh_cache(const char* filename, HaleData* hale_data,
+                      UnstructuredMesh* umesh);
+
+// Hashes the mesh dimensions, topology and initial state to key the cache
+uint64_t calc_mesh_cache_key(HaleData* hale_data, UnstructuredMesh* umesh);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,154 @@
+#include "multi_material.h"
+#include "../shared.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// The fewest mixed cells and entries that storage is allocated for
+#define MIN_MATERIAL_CAPACITY 64
+
+// Deallocates the storage of the mixed cells and entries
+static void deallocate_mixed_storage(MultiMaterial* mm);
+
+// Initialises the materials of a problem, with every cell pure
+void init_multi_material(MultiMaterial* mm, const int nmaterials,
+                         const int ncells, const int* cell_material) {
+  if (nmaterials > MAX_MATERIALS) {
+    TERMINATE("The problem has %d materials, more than the %d supported.\n",
+              nmaterials, MAX_MATERIALS);
+  }
+
+  mm->nmaterials = nmaterials;
+  mm->ncells = ncells;
+  allocate_int_data(&mm->cell_material, ncells);
+  for (int cc = 0; cc < ncells; ++cc) {
+    mm->cell_material[(cc)] = cell_material ? cell_material[(cc)] : 0;
+  }
+
+  mm->nmixed = 0;
+  mm->nentries = 0;
+  for (int mat = 0; mat < MAX_MATERIALS + 1; ++mat) {
+    mm->material_offsets[(mat)] = 0;
+  }
+
+  mm->mixed_capacity = 0;
+  mm->entry_capacity = 0;
+  reserve_multi_material(mm, MIN_MATERIAL_CAPACITY, MIN_MATERIAL_CAPACITY);
+  mm->mixed_offsets[(0)] = 0;
+}
+
+// Ensures that there is storage for a number of mixed cells and entries
+void reserve_multi_material(MultiMaterial* mm, const int nmixed,
+                            const int nentries) {
+  if (nmixed <= mm->mixed_capacity && nentries <= mm->entry_capacity) {
+    return;
+  }
+
+  // The storage is rebuilt by every remap, so it is grown without copying
+  if (mm->mixed_capacity) {
+    deallocate_mixed_storage(mm);
+  }
+
+  mm->mixed_capacity =
+      max(max(nmixed, mm->mixed_capacity + mm->mixed_capacity / 2),
+          MIN_MATERIAL_CAPACITY);
+  mm->entry_capacity =
+      max(max(nentries, mm->entry_capacity + mm->entry_capacity / 2),
+          MIN_MATERIAL_CAPACITY);
+
+  allocate_int_data(&mm->mixed_cells, mm->mixed_capacity);
+  allocate_int_data(&mm->mixed_offsets, mm->mixed_capacity + 1);
+  allocate_data(&mm->mixed_mass, mm->mixed_capacity);
+  allocate_data(&mm->mixed_volume, mm->mixed_capacity);
+  allocate_data(&mm->mixed_ie_mass, mm->mixed_capacity);
+
+  allocate_int_data(&mm->mixed_entries, mm->entry_capacity);
+  allocate_int_data(&mm->entry_cells, mm->entry_capacity);
+  allocate_int_data(&mm->entry_mixed, mm->entry_capacity);
+  allocate_data(&mm->volume_fraction, mm->entry_capacity);
+  allocate_data(&mm->mass_fraction, mm->entry_capacity);
+  allocate_data(&mm->ie_fraction, mm->entry_capacity);
+  allocate_data(&mm->volume, mm->entry_capacity);
+  allocate_data(&mm->mass, mm->entry_capacity);
+  allocate_data(&mm->ie_mass, mm->entry_capacity);
+  allocate_data(&mm->density, mm->entry_capacity);
+  allocate_data(&mm->energy, mm->entry_capacity);
+  allocate_data(&mm->pressure, mm->entry_capacity);
+  allocate_data(&mm->soundspeed, mm->entry_capacity);
+  allocate_int_data(&mm->staged_material, mm->entry_capacity);
+  allocate_data(&mm->staged_volume, mm->entry_capacity);
+  allocate_data(&mm->staged_mass, mm->entry_capacity);
+  allocate_data(&mm->staged_ie_mass, mm->entry_capacity);
+}
+
+// Sorts the staged entries of the mixed cells by material, keeping the
+// entries of each material in the order of their mixed cells
+void sort_material_entries(MultiMaterial* mm) {
+  int cursor[MAX_MATERIALS + 1] = {0};
+  for (int ee = 0; ee < mm->nentries; ++ee) {
+    cursor[(mm->staged_material[(ee)] + 1)]++;
+  }
+  for (int mat = 0; mat < mm->nmaterials; ++mat) {
+    cursor[(mat + 1)] += cursor[(mat)];
+  }
+  for (int mat = 0; mat < MAX_MATERIALS + 1; ++mat) {
+    mm->material_offsets[(mat)] = cursor[(min(mat, mm->nmaterials))];
+  }
+
+  for (int kk = 0; kk < mm->nmixed; ++kk) {
+    for (int ss = mm->mixed_offsets[(kk)]; ss < mm->mixed_offsets[(kk + 1)];
+         ++ss) {
+      const int ee = cursor[(mm->staged_material[(ss)])]++;
+      mm->mixed_entries[(ss)] = ee;
+      mm->entry_cells[(ee)] = mm->mixed_cells[(kk)];
+      mm->entry_mixed[(ee)] = kk;
+      mm->volume[(ee)] = mm->staged_volume[(ss)];
+      mm->mass[(ee)] = mm->staged_mass[(ss)];
+      mm->ie_mass[(ee)] = mm->staged_ie_mass[(ss)];
+    }
+  }
+}
+
+// Deallocates the materials
+void deallocate_multi_material(MultiMaterial* mm) {
+  deallocate_int_data(mm->cell_material);
+  deallocate_mixed_storage(mm);
+}
+
+// Prints the mixing of the materials and the storage that it occupies
+void print_multi_material(const MultiMaterial* mm) {
+  const size_t mixed_bytes =
+      (size_t)mm->mixed_capacity * (2 * sizeof(int) + 3 * sizeof(double));
+  const size_t entry_bytes =
+      (size_t)mm->entry_capacity * (4 * sizeof(int) + 13 * sizeof(double));
+  printf("Materials %d, mixed cells %d of %d (%.2f%%), %d entries, %.3fMB\n",
+         mm->nmaterials, mm->nmixed, mm->ncells,
+         100.0 * mm->nmixed / mm->ncells, mm->nentries,
+         (mixed_bytes + entry_bytes) / (1024.0 * 1024.0));
+}
+
+// Deallocates the storage of the mixed cells and entries
+static void deallocate_mixed_storage(MultiMaterial* mm) {
+  deallocate_int_data(mm->mixed_cells);
+  deallocate_int_data(mm->mixed_offsets);
+  deallocate_data(mm->mixed_mass);
+  deallocate_data(mm->mixed_volume);
+  deallocate_data(mm->mixed_ie_mass);
+
+  deallocate_int_data(mm->mixed_entries);
+  deallocate_int_data(mm->entry_cells);
+  deallocate_int_data(mm->entry_mixed);
+  deallocate_data(mm->volume_fraction);
+  deallocate_data(mm->mass_fraction);
+  deallocate_data(mm->ie_fraction);
+  deallocate_data(mm->volume);
+  deallocate_data(mm->mass);
+  deallocate_data(mm->ie_mass);
+  deallocate_data(mm->density);
+  deallocate_data(mm->energy);
+  deallocate_data(mm->pressure);
+  deallocate_data(mm->soundspeed);
+  deallocate_int_data(mm->staged_material);
+  deallocate_data(mm->staged_volume);
+  deallocate_data(mm->staged_mass);
+  deallocate_data(mm->staged_ie_mass);
+}
@@ -0,0 +1,104 @@
+#ifndef __MULTIMATERIALHDR
+#define __MULTIMATERIALHDR
+
+#pragma once
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The most materials that a problem can hold
+#define MAX_MATERIALS 8
+
+// The smallest fraction of the mass of a cell that a material can hold before
+// it is dropped from the cell
+#define MIX_CUTOFF 1.0e-8
+
+// The fluxes through each side of a face that the materials are advected with
+enum { FACE_VOLUME_FLUX, FACE_MASS_FLUX, FACE_IE_FLUX, NFACE_FLUXES };
+
+// The flux leaving a cell through one of its faces, where the side of the face
+// is 0 for the counter-clockwise cell of the face and 1 for the other
+#define FACE_FLUX(face_flux, ff, side, q)                                      \
+  ((face_flux)[((((ff) * 2) + (side)) * NFACE_FLUXES + (q))])
+
+// The materials of each cell, stored compactly so that the per-material state
+// only exists for the cells that hold more than one material. Each cell holds
+// the material of a pure cell, or -(1 + mixed) for its index in the mixed
+// cells. The materials of the mixed cells are entries sorted by material, so
+// that the entries of each material are contiguous, and each mixed cell lists
+// its entries.
+typedef struct {
+  int nmaterials;
+  int ncells;
+  int* cell_material;
+
+  // The cell of each mixed cell, the totals of its materials through the
+  // remap, and the offset of its list of entries
+  int nmixed;
+  int* mixed_cells;
+  int* mixed_offsets;
+  int* mixed_entries;
+  double* mixed_mass;
+  double* mixed_volume;
+  double* mixed_ie_mass;
+
+  // The entries of each material, material_offsets[(mm)] onwards
+  int nentries;
+  int material_offsets[MAX_MATERIALS + 1];
+  int* entry_cells;
+  int* entry_mixed;
+
+  // The fractions of the volume, mass and internal energy of its cell that
+  // each entry holds, which the Lagrangian phase keeps fixed
+  double* volume_fraction;
+  double* mass_fraction;
+  double* ie_fraction;
+
+  // The volume, mass and internal energy of each entry through the remap
+  double* volume;
+  double* mass;
+  double* ie_mass;
+
+  // The state of each entry, as evaluated by the equation of state
+  double* density;
+  double* energy;
+  double* pressure;
+  double* soundspeed;
+
+  // The material and amounts of each entry of each mixed cell, in the order
+  // of the mixed cells, before the entries are sorted by material
+  int* staged_material;
+  double* staged_volume;
+  double* staged_mass;
+  double* staged_ie_mass;
+
+  // The mixed cells and entries that fit in the storage, which only grows
+  int mixed_capacity;
+  int entry_capacity;
+} MultiMaterial;
+
+// Initialises the materials of a problem, with every cell pure
+void init_multi_material(MultiMaterial* mm, const int nmaterials,
+                         const int ncells, const int* cell_material);
+
+// Ensures that there is storage for a number of mixed cells and entries
+void reserve_multi_material(MultiMaterial* mm, const int nmixed,
+                            const int nentries);
+
+// Sorts the staged entries of the mixed cells by material
+void sort_material_entries(MultiMaterial* mm);
+
+// Deallocates the materials
+void deallocate_multi_material(MultiMaterial* mm);
+
+// Prints the mixing of the materials and the storage that it occupies
+void print_multi_material(const MultiMaterial* mm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef __NODESTATEHDR
+#define __NODESTATEHDR
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The number of nodes interleaved in each block of the AoSoA layout
+#ifndef NODE_STATE_BLOCK
+#define NODE_STATE_BLOCK 8
+#endif
+
+// The fields of the state of a node that the gather-heavy kernels read
+// together through the node indirection
+enum {
+  NODE_X,
+  NODE_Y,
+  NODE_Z,
+  NODE_VX,
+  NODE_VY,
+  NODE_VZ,
+  NODE_MASS,
+  NODE_VOLUME,
+  NNODE_FIELDS
+};
+
+// A view of the node state at one time level. By default the view points at
+// the separate nodal arrays, while with AOSOA_NODE_STATE the fields of every
+// NODE_STATE_BLOCK nodes are interleaved in one contiguous block, so that a
+// node's state shares a handful of cache lines.
+typedef struct {
+#ifdef AOSOA_NODE_STATE
+  double* data;
+#else
+  const double* field[NNODE_FIELDS];
+#endif
+} NodeState;
+
+// Accesses a field of the state of a node in the layout of the build
+#ifdef AOSOA_NODE_STATE
+#define NODE_STATE(state, f, nn)                                               \
+  ((state)->data[((((nn) / NODE_STATE_BLOCK) * NNODE_FIELDS + (f)) *           \
+                  NODE_STATE_BLOCK) +                                          \
+                 (nn) % NODE_STATE_BLOCK])
+#define NODE_STATE_LAYOUT "AoSoA"
+#else
+#define NODE_STATE(state, f, nn) ((state)->field[(f)][(nn)])
+#define NODE_STATE_LAYOUT "SoA"
+#endif
+
+// The number of doubles that hold the state of the nodes in the AoSoA layout
+#define NODE_STATE_LEN(nnodes)                                                 \
+  ((((nnodes) + NODE_STATE_BLOCK - 1) / NODE_STATE_BLOCK) * NNODE_FIELDS *     \
+   NODE_STATE_BLOCK)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
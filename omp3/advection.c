@@ -4,27 +4,413 @@
 #include <float.h>
 #include <math.h>
 
+// Advects the materials with the fluxes that left each cell, building the
+// materials of the remapped cells
+void advect_material_quantities(
+    const int ncells, const int* cells_to_faces_offsets,
+    const int* cells_to_faces, const int* faces_to_cells0,
+    const int* faces_to_cells1, const int* faces_cclockwise_cell,
+    const double* cell_mass, const double* cell_volume, const double* energy,
+    const double* face_flux, const MultiMaterial* mm, int* mixed_block_offsets,
+    int* entry_block_offsets, MultiMaterial* next_mm);
+
+// Advects the materials of a cell, returning the number of materials that
+// remain, with their volume, mass and internal energy
+int advect_cell_materials(const int cc, const int* cells_to_faces_offsets,
+                          const int* cells_to_faces,
+                          const int* faces_to_cells0,
+                          const int* faces_to_cells1,
+                          const int* faces_cclockwise_cell,
+                          const double* cell_mass, const double* cell_volume,
+                          const double* energy, const double* face_flux,
+                          const MultiMaterial* mm, int* materials,
+                          double amount[MAX_MATERIALS][NFACE_FLUXES]);
+
+// Adds the fractions of some amounts that belong to each material of a cell
+void add_material_fractions(const MultiMaterial* mm, const int cc,
+                            const double* flux, int* present,
+                            double amount[MAX_MATERIALS][NFACE_FLUXES]);
+
 // Performs a remap and some scattering of the subcell values
 void advection_phase(UnstructuredMesh* umesh, HaleData* hale_data) {
 
-  // Advects mass and energy through the subcell faces using swept edge approx
-  perform_advection(
-      umesh->ncells, umesh->cells_to_nodes_offsets, umesh->nodes_x0,
-      umesh->nodes_y0, umesh->nodes_z0, hale_data->rezoned_nodes_x,
-      hale_data->rezoned_nodes_y, hale_data->rezoned_nodes_z,
-      umesh->cells_to_nodes, umesh->faces_to_nodes_offsets,
-      umesh->faces_to_nodes, umesh->faces_cclockwise_cell,
-      hale_data->subcells_to_faces_offsets, hale_data->subcells_to_faces,
-      hale_data->subcells_to_subcells_offsets, hale_data->subcells_to_subcells,
-      hale_data->subcell_centroids_x, hale_data->subcell_centroids_y,
-      hale_data->subcell_centroids_z, umesh->faces_to_cells0,
-      umesh->faces_to_cells1, hale_data->subcell_volume,
-      hale_data->subcell_momentum_flux_x, hale_data->subcell_momentum_flux_y,
-      hale_data->subcell_momentum_flux_z, hale_data->subcell_momentum_x,
-      hale_data->subcell_momentum_y, hale_data->subcell_momentum_z,
-      hale_data->subcell_mass, hale_data->subcell_mass_flux,
-      hale_data->subcell_ie_mass, hale_data->subcell_ie_mass_flux,
-      hale_data->subcell_ke_mass, hale_data->subcell_ke_mass_flux);
+  if (hale_data->cell_remap) {
+    // Advects mass and energy through the cell faces, and momentum through the
+    // faces of the dual mesh, from a reconstruction of every cell
+    reconstruct_cell_quantities(
+        umesh->ncells, umesh->cells_to_nodes_offsets, umesh->cells_to_nodes,
+        umesh->cells_to_faces_offsets, umesh->cells_to_faces,
+        umesh->faces_to_cells0, umesh->faces_to_cells1, umesh->nodes_x0,
+        umesh->nodes_y0, umesh->nodes_z0, hale_data->cell_volume,
+        hale_data->subcell_mass, hale_data->subcell_ie_mass,
+        hale_data->subcell_ke_mass, hale_data->remap_order,
+        hale_data->cell_reconstruction,
+        &hale_data->solve_counts[(CELL_RECONSTRUCTION_SOLVES)]);
+    perform_cell_advection(
+        umesh->ncells, umesh->cells_to_nodes_offsets, umesh->cells_to_nodes,
+        umesh->cells_to_faces_offsets, umesh->cells_to_faces,
+        umesh->faces_to_nodes_offsets, umesh->faces_to_nodes,
+        umesh->faces_to_cells0, umesh->faces_to_cells1,
+        umesh->faces_cclockwise_cell, hale_data->subcells_to_faces_offsets,
+        hale_data->subcells_to_faces, umesh->nodes_x0, umesh->nodes_y0,
+        umesh->nodes_z0, hale_data->rezoned_nodes_x, hale_data->rezoned_nodes_y,
+        hale_data->rezoned_nodes_z, hale_data->rezoned_cell_centroids_x,
+        hale_data->rezoned_cell_centroids_y,
+        hale_data->rezoned_cell_centroids_z,
+        hale_data->rezoned_face_centroids_x,
+        hale_data->rezoned_face_centroids_y,
+        hale_data->rezoned_face_centroids_z, hale_data->subcell_centroids_x,
+        hale_data->subcell_centroids_y, hale_data->subcell_centroids_z,
+        hale_data->nodal_mass, hale_data->nodal_volumes,
+        hale_data->velocity_x0, hale_data->velocity_y0, hale_data->velocity_z0,
+        hale_data->cell_reconstruction, hale_data->subcell_mass_flux,
+        hale_data->subcell_ie_mass_flux, hale_data->subcell_ke_mass_flux,
+        hale_data->subcell_momentum_flux_x, hale_data->subcell_momentum_flux_y,
+        hale_data->subcell_momentum_flux_z, hale_data->face_flux,
+        hale_data->ntracers, hale_data->subcell_tracer_mass,
+        hale_data->subcell_tracer_flux);
+  } else {
+    // Advects mass and energy through the subcell faces using swept edge approx
+    perform_advection(
+        umesh->ncells, umesh->cells_to_nodes_offsets, umesh->nodes_x0,
+        umesh->nodes_y0, umesh->nodes_z0, hale_data->rezoned_nodes_x,
+        hale_data->rezoned_nodes_y, hale_data->rezoned_nodes_z,
+        hale_data->rezoned_cell_centroids_x,
+        hale_data->rezoned_cell_centroids_y,
+        hale_data->rezoned_cell_centroids_z,
+        hale_data->rezoned_face_centroids_x,
+        hale_data->rezoned_face_centroids_y,
+        hale_data->rezoned_face_centroids_z, umesh->cells_to_nodes,
+        umesh->faces_to_nodes_offsets, umesh->faces_to_nodes,
+        umesh->faces_cclockwise_cell, hale_data->subcells_to_faces_offsets,
+        hale_data->subcells_to_faces, hale_data->subcells_to_subcells_offsets,
+        hale_data->subcells_to_subcells, hale_data->subcell_centroids_x,
+        hale_data->subcell_centroids_y, hale_data->subcell_centroids_z,
+        umesh->faces_to_cells0, umesh->faces_to_cells1,
+        hale_data->subcell_volume, hale_data->subcell_momentum_flux_x,
+        hale_data->subcell_momentum_flux_y, hale_data->subcell_momentum_flux_z,
+        hale_data->subcell_momentum_x, hale_data->subcell_momentum_y,
+        hale_data->subcell_momentum_z, hale_data->subcell_mass,
+        hale_data->subcell_mass_flux, hale_data->subcell_ie_mass,
+        hale_data->subcell_ie_mass_flux, hale_data->subcell_ke_mass,
+        hale_data->subcell_ke_mass_flux, hale_data->face_flux,
+        hale_data->ntracers, hale_data->subcell_tracer_mass,
+        hale_data->subcell_tracer_flux, hale_data->remap_order,
+        &hale_data->solve_counts[(SWEEP_SOLVES)]);
+  }
+
+  // Advects the materials with the fluxes that left each cell, and then moves
+  // on to the materials of the remapped cells
+  if (hale_data->multi_material) {
+    advect_material_quantities(
+        umesh->ncells, umesh->cells_to_faces_offsets, umesh->cells_to_faces,
+        umesh->faces_to_cells0, umesh->faces_to_cells1,
+        umesh->faces_cclockwise_cell, hale_data->cell_mass,
+        hale_data->cell_volume, hale_data->energy0, hale_data->face_flux,
+        &hale_data->materials, hale_data->mixed_block_offsets,
+        hale_data->entry_block_offsets, &hale_data->next_materials);
+
+    OMP_SINGLE()
+    {
+      MultiMaterial materials = hale_data->materials;
+      hale_data->materials = hale_data->next_materials;
+      hale_data->next_materials = materials;
+    }
+  }
+}
+
+// Advects the materials with the fluxes that left each cell, building the
+// materials of the remapped cells. The materials that remain in each cell are
+// counted, the mixed cells are laid out, and then their materials are staged
+// and sorted by material. The mixed cells are laid out like compact_flagged,
+// from a scan over the counts of each block of cells.
+void advect_material_quantities(
+    const int ncells, const int* cells_to_faces_offsets,
+    const int* cells_to_faces, const int* faces_to_cells0,
+    const int* faces_to_cells1, const int* faces_cclockwise_cell,
+    const double* cell_mass, const double* cell_volume, const double* energy,
+    const double* face_flux, const MultiMaterial* mm, int* mixed_block_offsets,
+    int* entry_block_offsets, MultiMaterial* next_mm) {
+  const int nblocks = (ncells + COMPACT_BLOCK - 1) / COMPACT_BLOCK;
+
+
+  // The cells hold their material while pure, and minus their number of
+  // materials while mixed, until the mixed cells are laid out
+  OMP_FOR()
+  for (int cc = 0; cc < ncells; ++cc) {
+    int materials[MAX_MATERIALS];
+    double amount[MAX_MATERIALS][NFACE_FLUXES];
+    const int nmaterials = advect_cell_materials(
+        cc, cells_to_faces_offsets, cells_to_faces, faces_to_cells0,
+        faces_to_cells1, faces_cclockwise_cell, cell_mass, cell_volume, energy,
+        face_flux, mm, materials, amount);
+    next_mm->cell_material[(cc)] =
+        (nmaterials == 1) ? materials[(0)] : -nmaterials;
+  }
+  OMP_BARRIER();
+
+  OMP_FOR()
+  for (int bb = 0; bb < nblocks; ++bb) {
+    const int block_end = min(ncells, (bb + 1) * COMPACT_BLOCK);
+
+    int nmixed = 0;
+    int nentries = 0;
+    for (int cc = bb * COMPACT_BLOCK; cc < block_end; ++cc) {
+      if (next_mm->cell_material[(cc)] < 0) {
+        nmixed++;
+        nentries -= next_mm->cell_material[(cc)];
+      }
+    }
+    mixed_block_offsets[(bb + 1)] = nmixed;
+    entry_block_offsets[(bb + 1)] = nentries;
+  }
+  OMP_BARRIER();
+
+  OMP_SINGLE()
+  {
+    mixed_block_offsets[(0)] = 0;
+    entry_block_offsets[(0)] = 0;
+    for (int bb = 0; bb < nblocks; ++bb) {
+      mixed_block_offsets[(bb + 1)] += mixed_block_offsets[(bb)];
+      entry_block_offsets[(bb + 1)] += entry_block_offsets[(bb)];
+    }
+
+    reserve_multi_material(next_mm, mixed_block_offsets[(nblocks)],
+                           entry_block_offsets[(nblocks)]);
+    next_mm->nmixed = mixed_block_offsets[(nblocks)];
+    next_mm->nentries = entry_block_offsets[(nblocks)];
+    next_mm->mixed_offsets[(0)] = 0;
+  }
+
+  OMP_FOR()
+  for (int bb = 0; bb < nblocks; ++bb) {
+    const int block_end = min(ncells, (bb + 1) * COMPACT_BLOCK);
+
+    int kk = mixed_block_offsets[(bb)];
+    int mixed_end = entry_block_offsets[(bb)];
+    for (int cc = bb * COMPACT_BLOCK; cc < block_end; ++cc) {
+      if (next_mm->cell_material[(cc)] < 0) {
+        mixed_end -= next_mm->cell_material[(cc)];
+        next_mm->mixed_cells[(kk)] = cc;
+        next_mm->mixed_offsets[(kk + 1)] = mixed_end;
+        next_mm->cell_material[(cc)] = -(1 + kk);
+        kk++;
+      }
+    }
+  }
+  OMP_BARRIER();
+
+  // The mixed cells repeat their advection to stage their materials
+  OMP_FOR()
+  for (int kk = 0; kk < next_mm->nmixed; ++kk) {
+    int materials[MAX_MATERIALS];
+    double amount[MAX_MATERIALS][NFACE_FLUXES];
+    const int nmaterials = advect_cell_materials(
+        next_mm->mixed_cells[(kk)], cells_to_faces_offsets, cells_to_faces,
+        faces_to_cells0, faces_to_cells1, faces_cclockwise_cell, cell_mass,
+        cell_volume, energy, face_flux, mm, materials, amount);
+
+    double total[NFACE_FLUXES] = {0.0, 0.0, 0.0};
+    const int mixed_off = next_mm->mixed_offsets[(kk)];
+    for (int mat = 0; mat < nmaterials; ++mat) {
+      next_mm->staged_material[(mixed_off + mat)] = materials[(mat)];
+      next_mm->staged_volume[(mixed_off + mat)] =
+          amount[(mat)][(FACE_VOLUME_FLUX)];
+      next_mm->staged_mass[(mixed_off + mat)] = amount[(mat)][(FACE_MASS_FLUX)];
+      next_mm->staged_ie_mass[(mixed_off + mat)] =
+          amount[(mat)][(FACE_IE_FLUX)];
+      for (int qq = 0; qq < NFACE_FLUXES; ++qq) {
+        total[(qq)] += amount[(mat)][(qq)];
+      }
+    }
+    next_mm->mixed_volume[(kk)] = total[(FACE_VOLUME_FLUX)];
+    next_mm->mixed_mass[(kk)] = total[(FACE_MASS_FLUX)];
+    next_mm->mixed_ie_mass[(kk)] = total[(FACE_IE_FLUX)];
+  }
+  OMP_BARRIER();
+
+  OMP_SINGLE()
+  sort_material_entries(next_mm);
+}
+
+// Advects the materials of a cell, returning the number of materials that
+// remain, with their volume, mass and internal energy. Each cell keeps what
+// did not leave it and receives what left its neighbours, with the materials
+// in the proportions of the cell that they left. A pure cell that only
+// receives its own material stays pure without any per-material work.
+int advect_cell_materials(const int cc, const int* cells_to_faces_offsets,
+                          const int* cells_to_faces,
+                          const int* faces_to_cells0,
+                          const int* faces_to_cells1,
+                          const int* faces_cclockwise_cell,
+                          const double* cell_mass, const double* cell_volume,
+                          const double* energy, const double* face_flux,
+                          const MultiMaterial* mm, int* materials,
+                          double amount[MAX_MATERIALS][NFACE_FLUXES]) {
+  const int cell_to_faces_off = cells_to_faces_offsets[(cc)];
+  const int nfaces_by_cell =
+      cells_to_faces_offsets[(cc + 1)] - cell_to_faces_off;
+  const int cell_material = mm->cell_material[(cc)];
+
+  if (cell_material >= 0) {
+    int pure = 1;
+    for (int ff = 0; ff < nfaces_by_cell; ++ff) {
+      const int face_index = cells_to_faces[(cell_to_faces_off + ff)];
+      const int neighbour_cc = (faces_to_cells0[(face_index)] == cc)
+                                   ? faces_to_cells1[(face_index)]
+                                   : faces_to_cells0[(face_index)];
+      if (neighbour_cc != -1 &&
+          mm->cell_material[(neighbour_cc)] != cell_material &&
+          FACE_FLUX(face_flux, face_index,
+                    (faces_cclockwise_cell[(face_index)] != neighbour_cc),
+                    FACE_MASS_FLUX) > 0.0) {
+        pure = 0;
+        break;
+      }
+    }
+
+    if (pure) {
+      materials[(0)] = cell_material;
+      return 1;
+    }
+  }
+
+  int present[MAX_MATERIALS];
+  for (int mat = 0; mat < MAX_MATERIALS; ++mat) {
+    present[(mat)] = 0;
+    for (int qq = 0; qq < NFACE_FLUXES; ++qq) {
+      amount[(mat)][(qq)] = 0.0;
+    }
+  }
+
+  // The cell keeps what did not leave it
+  double outflux[NFACE_FLUXES] = {0.0, 0.0, 0.0};
+  for (int ff = 0; ff < nfaces_by_cell; ++ff) {
+    const int face_index = cells_to_faces[(cell_to_faces_off + ff)];
+    const int side = (faces_cclockwise_cell[(face_index)] != cc);
+    for (int qq = 0; qq < NFACE_FLUXES; ++qq) {
+      outflux[(qq)] -= FACE_FLUX(face_flux, face_index, side, qq);
+    }
+  }
+  if (cell_material >= 0) {
+    const double kept[NFACE_FLUXES] = {
+        cell_volume[(cc)] + outflux[(FACE_VOLUME_FLUX)],
+        cell_mass[(cc)] + outflux[(FACE_MASS_FLUX)],
+        cell_mass[(cc)] * energy[(cc)] + outflux[(FACE_IE_FLUX)]};
+    add_material_fractions(mm, cc, kept, present, amount);
+  } else {
+    const int kk = -(1 + cell_material);
+    for (int ss = mm->mixed_offsets[(kk)]; ss < mm->mixed_offsets[(kk + 1)];
+         ++ss) {
+      const int ee = mm->mixed_entries[(ss)];
+      const int mat = mm->staged_material[(ss)];
+      present[(mat)] = 1;
+      amount[(mat)][(FACE_VOLUME_FLUX)] +=
+          mm->volume[(ee)] +
+          mm->volume_fraction[(ee)] * outflux[(FACE_VOLUME_FLUX)];
+      amount[(mat)][(FACE_MASS_FLUX)] +=
+          mm->mass[(ee)] + mm->mass_fraction[(ee)] * outflux[(FACE_MASS_FLUX)];
+      amount[(mat)][(FACE_IE_FLUX)] +=
+          mm->ie_mass[(ee)] + mm->ie_fraction[(ee)] * outflux[(FACE_IE_FLUX)];
+    }
+  }
+
+  // The cell receives what left its neighbours
+  for (int ff = 0; ff < nfaces_by_cell; ++ff) {
+    const int face_index = cells_to_faces[(cell_to_faces_off + ff)];
+    const int neighbour_cc = (faces_to_cells0[(face_index)] == cc)
+                                 ? faces_to_cells1[(face_index)]
+                                 : faces_to_cells0[(face_index)];
+    if (neighbour_cc == -1) {
+      continue;
+    }
+
+    const int side = (faces_cclockwise_cell[(face_index)] != neighbour_cc);
+    const double influx[NFACE_FLUXES] = {
+        FACE_FLUX(face_flux, face_index, side, FACE_VOLUME_FLUX),
+        FACE_FLUX(face_flux, face_index, side, FACE_MASS_FLUX),
+        FACE_FLUX(face_flux, face_index, side, FACE_IE_FLUX)};
+    if (influx[(FACE_MASS_FLUX)] > 0.0) {
+      add_material_fractions(mm, neighbour_cc, influx, present, amount);
+    }
+  }
+
+  // Materials with a negligible share of the mass are dropped
+  double total_mass = 0.0;
+  for (int mat = 0; mat < MAX_MATERIALS; ++mat) {
+    if (present[(mat)]) {
+      total_mass += max(amount[(mat)][(FACE_MASS_FLUX)], 0.0);
+    }
+  }
+
+  int nmaterials = 0;
+  int heaviest = -1;
+  for (int mat = 0; mat < MAX_MATERIALS; ++mat) {
+    if (!present[(mat)]) {
+      continue;
+    }
+    if (heaviest == -1 || amount[(mat)][(FACE_MASS_FLUX)] >
+                              amount[(heaviest)][(FACE_MASS_FLUX)]) {
+      heaviest = mat;
+    }
+    if (amount[(mat)][(FACE_MASS_FLUX)] > MIX_CUTOFF * total_mass) {
+      materials[(nmaterials++)] = mat;
+    }
+  }
+
+  if (nmaterials <= 1) {
+    materials[(0)] = (nmaterials == 1) ? materials[(0)] : heaviest;
+    return 1;
+  }
+
+  // The remaining materials are compacted, where a material that has lost all
+  // of its volume is given the mean density of the cell
+  double total_volume = 0.0;
+  total_mass = 0.0;
+  for (int mat = 0; mat < nmaterials; ++mat) {
+    for (int qq = 0; qq < NFACE_FLUXES; ++qq) {
+      amount[(mat)][(qq)] = max(amount[(materials[(mat)])][(qq)], 0.0);
+    }
+    total_volume += amount[(mat)][(FACE_VOLUME_FLUX)];
+    total_mass += amount[(mat)][(FACE_MASS_FLUX)];
+  }
+  for (int mat = 0; mat < nmaterials; ++mat) {
+    if (amount[(mat)][(FACE_VOLUME_FLUX)] <= 0.0) {
+      amount[(mat)][(FACE_VOLUME_FLUX)] =
+          amount[(mat)][(FACE_MASS_FLUX)] *
+          ((total_volume > 0.0) ? total_volume / total_mass : 1.0);
+    }
+  }
+
+  return nmaterials;
+}
+
+// Adds the fractions of some amounts that belong to each material of a cell
+void add_material_fractions(const MultiMaterial* mm, const int cc,
+                            const double* flux, int* present,
+                            double amount[MAX_MATERIALS][NFACE_FLUXES]) {
+  const int cell_material = mm->cell_material[(cc)];
+  if (cell_material >= 0) {
+    present[(cell_material)] = 1;
+    for (int qq = 0; qq < NFACE_FLUXES; ++qq) {
+      amount[(cell_material)][(qq)] += flux[(qq)];
+    }
+    return;
+  }
+
+  const int kk = -(1 + cell_material);
+  for (int ss = mm->mixed_offsets[(kk)]; ss < mm->mixed_offsets[(kk + 1)];
+       ++ss) {
+    const int ee = mm->mixed_entries[(ss)];
+    const int mat = mm->staged_material[(ss)];
+    present[(mat)] = 1;
+    amount[(mat)][(FACE_VOLUME_FLUX)] +=
+        mm->volume_fraction[(ee)] * flux[(FACE_VOLUME_FLUX)];
+    amount[(mat)][(FACE_MASS_FLUX)] +=
+        mm->mass_fraction[(ee)] * flux[(FACE_MASS_FLUX)];
+    amount[(mat)][(FACE_IE_FLUX)] +=
+        mm->ie_fraction[(ee)] * flux[(FACE_IE_FLUX)];
+  }
 }
 
 // Advects mass and energy through the subcell faces using swept edge approx
@@ -32,7 +418,13 @@ void perform_advection(
     const int ncells, const int* cells_to_nodes_offsets, const double* nodes_x,
     const double* nodes_y, const double* nodes_z, const double* rezoned_nodes_x,
     const double* rezoned_nodes_y, const double* rezoned_nodes_z,
-    const int* cells_to_nodes, const int* faces_to_nodes_offsets,
+    const double* rezoned_cell_centroids_x,
+    const double* rezoned_cell_centroids_y,
+    const double* rezoned_cell_centroids_z,
+    const double* rezoned_face_centroids_x,
+    const double* rezoned_face_centroids_y,
+    const double* rezoned_face_centroids_z, const int* cells_to_nodes,
+    const int* faces_to_nodes_offsets,
     const int* faces_to_nodes, const int* faces_cclockwise_cell,
     const int* subcells_to_faces_offsets, const int* subcells_to_faces,
     const int* subcells_to_subcells_offsets, const int* subcells_to_subcells,
@@ -44,10 +436,29 @@ void perform_advection(
     const double* subcell_momentum_y, const double* subcell_momentum_z,
     const double* subcell_mass, double* subcell_mass_flux,
     const double* subcell_ie_mass, double* subcell_ie_mass_flux,
-    const double* subcell_ke_mass, double* subcell_ke_mass_flux) {
-
-#pragma omp parallel for
+    const double* subcell_ke_mass, double* subcell_ke_mass_flux,
+    double* face_flux, const int ntracers, const double* subcell_tracer_mass,
+    double* subcell_tracer_flux, const int remap_order,
+    SolveCounts* solve_counts) {
+
+  // The faces of every swept edge prism, in terms of its 8 vertices
+  const int swept_edge_to_faces[] = {0, 1, 2, 3, 4, 5};
+  const int swept_edge_faces_to_nodes[] = {0, 1, 2, 3, 4, 5, 6, 7,
+                                           0, 3, 7, 4, 7, 6, 2, 3,
+                                           1, 5, 6, 2, 0, 4, 5, 1};
+  const int swept_edge_faces_to_nodes_offsets[] = {0, 4, 8, 12, 16, 20, 24};
+
+  // Boundary cells skip their external fluxes, and small swept volumes return
+  // early, so the cost of a cell varies a great deal
+  static KernelSchedule schedule = {"perform_advection", SCHEDULE_DYNAMIC};
+  begin_kernel_schedule(&schedule, ncells);
+
+  double nill_conditioned = 0.0;
+  double nsingular = 0.0;
+
+  OMP_FOR_SCHEDULED_REDUCTION(reduction(+ : nill_conditioned, nsingular))
   for (int cc = 0; cc < ncells; ++cc) {
+    const double cell_start = start_entity_cost(&schedule);
     const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
     const int nnodes_by_cell =
         cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
@@ -56,10 +467,16 @@ void perform_advection(
     calc_centroid(nnodes_by_cell, nodes_x, nodes_y, nodes_z, cells_to_nodes,
                   cell_to_nodes_off, &cell_c);
 
-    vec_t rz_cell_c = {0.0, 0.0, 0.0};
-    calc_centroid(nnodes_by_cell, rezoned_nodes_x, rezoned_nodes_y,
-                  rezoned_nodes_z, cells_to_nodes, cell_to_nodes_off,
-                  &rz_cell_c);
+    // The rezoned geometry is stored, as the rezoned mesh rarely moves
+    vec_t rz_cell_c = {rezoned_cell_centroids_x[(cc)],
+                       rezoned_cell_centroids_y[(cc)],
+                       rezoned_cell_centroids_z[(cc)]};
+
+#ifdef BATCHED_ADVECTION
+    // The swept edge prisms of the cell are evaluated in batches
+    SweptEdgeBatch batch;
+    batch.nprisms = 0;
+#endif
 
     // Looping over corner subcells here
     for (int nn = 0; nn < nnodes_by_cell; ++nn) {
@@ -70,9 +487,11 @@ void perform_advection(
       const int nfaces_by_subcell =
           subcells_to_faces_offsets[(subcell_index + 1)] - subcell_to_faces_off;
 
+#ifndef BATCHED_ADVECTION
       vec_t subcell_c = {subcell_centroids_x[(subcell_index)],
                          subcell_centroids_y[(subcell_index)],
                          subcell_centroids_z[(subcell_index)]};
+#endif
 
       // Consider all faces attached to node
       for (int ff = 0; ff < nfaces_by_subcell; ++ff) {
@@ -88,10 +507,9 @@ void perform_advection(
         vec_t face_c = {0.0, 0.0, 0.0};
         calc_centroid(nnodes_by_face, nodes_x, nodes_y, nodes_z, faces_to_nodes,
                       face_to_nodes_off, &face_c);
-        vec_t rz_face_c = {0.0, 0.0, 0.0};
-        calc_centroid(nnodes_by_face, rezoned_nodes_x, rezoned_nodes_y,
-                      rezoned_nodes_z, faces_to_nodes, face_to_nodes_off,
-                      &rz_face_c);
+        vec_t rz_face_c = {rezoned_face_centroids_x[(face_index)],
+                           rezoned_face_centroids_y[(face_index)],
+                           rezoned_face_centroids_z[(face_index)]};
 
         // Determine the position of the node in the face list of nodes
         int nn2;
@@ -108,12 +526,6 @@ void perform_advection(
         const int lnode_off = (face_clockwise ? next_node : prev_node);
         const int rnode_index = faces_to_nodes[(face_to_nodes_off + rnode_off)];
         const int lnode_index = faces_to_nodes[(face_to_nodes_off + lnode_off)];
-        const int swept_edge_to_faces[] = {0, 1, 2, 3, 4, 5};
-        const int swept_edge_faces_to_nodes[] = {0, 1, 2, 3, 4, 5, 6, 7,
-                                                 0, 3, 7, 4, 7, 6, 2, 3,
-                                                 1, 5, 6, 2, 0, 4, 5, 1};
-        const int swept_edge_faces_to_nodes_offsets[] = {0,  4,  8, 12,
-                                                         16, 20, 24};
 
         /* INTERNAL FACE */
 
@@ -156,14 +568,12 @@ void perform_advection(
         vec_t l_iface_c = {0.0, 0.0, 0.0};
         calc_centroid(nnodes_by_lface, nodes_x, nodes_y, nodes_z,
                       faces_to_nodes, lface_to_nodes_off, &l_iface_c);
-        vec_t rz_r_iface_c = {0.0, 0.0, 0.0};
-        calc_centroid(nnodes_by_r_face, rezoned_nodes_x, rezoned_nodes_y,
-                      rezoned_nodes_z, faces_to_nodes, r_face_to_nodes_off,
-                      &rz_r_iface_c);
-        vec_t rz_l_iface_c = {0.0, 0.0, 0.0};
-        calc_centroid(nnodes_by_lface, rezoned_nodes_x, rezoned_nodes_y,
-                      rezoned_nodes_z, faces_to_nodes, lface_to_nodes_off,
-                      &rz_l_iface_c);
+        vec_t rz_r_iface_c = {rezoned_face_centroids_x[(r_face_index)],
+                              rezoned_face_centroids_y[(r_face_index)],
+                              rezoned_face_centroids_z[(r_face_index)]};
+        vec_t rz_l_iface_c = {rezoned_face_centroids_x[(lface_index)],
+                              rezoned_face_centroids_y[(lface_index)],
+                              rezoned_face_centroids_z[(lface_index)]};
 
         double inodes_x[2 * NNODES_BY_SUBCELL_FACE] = {
             0.5 * (nodes_x[(node_index)] + nodes_x[(r_face_rnode_index)]),
@@ -184,6 +594,28 @@ void perform_advection(
                    rezoned_nodes_z[(r_face_rnode_index)]),
             rz_r_iface_c.z, rz_cell_c.z, rz_l_iface_c.z};
 
+#ifdef BATCHED_ADVECTION
+        // Make room for the internal and external prisms of the face
+        if (batch.nprisms > SWEPT_EDGE_BATCH - 2) {
+          flux_swept_edge_batch(
+              cc, &cell_c, &batch, subcell_mass, subcell_mass_flux,
+              subcell_ie_mass, subcell_ie_mass_flux, subcell_ke_mass,
+              subcell_ke_mass_flux, subcell_volume, subcell_momentum_x,
+              subcell_momentum_y, subcell_momentum_z, subcell_momentum_flux_x,
+              subcell_momentum_flux_y, subcell_momentum_flux_z,
+              swept_edge_faces_to_nodes, subcell_centroids_x,
+              subcell_centroids_y, subcell_centroids_z, swept_edge_to_faces,
+              swept_edge_faces_to_nodes_offsets, subcells_to_subcells_offsets,
+              subcells_to_subcells, subcells_to_faces_offsets,
+              subcells_to_faces, faces_to_nodes_offsets, faces_to_nodes,
+              cells_to_nodes_offsets, cells_to_nodes, faces_cclockwise_cell,
+              nodes_x, nodes_y, nodes_z, face_flux, ntracers,
+              subcell_tracer_mass, subcell_tracer_flux, remap_order,
+              &nill_conditioned, &nsingular);
+        }
+        add_swept_edge_prism(&batch, inodes_x, inodes_y, inodes_z,
+                             subcell_index, ff, neighbour_cc, 1);
+#else
         // Contributes the local mass, energy and momentum flux for a given
         // subcell face
         flux_mass_energy_momentum(
@@ -199,7 +631,9 @@ void perform_advection(
             subcells_to_subcells, subcells_to_faces_offsets, subcells_to_faces,
             faces_to_nodes_offsets, faces_to_nodes, cells_to_nodes_offsets,
             cells_to_nodes, faces_cclockwise_cell, nodes_x, nodes_y, nodes_z,
-            1);
+            face_flux, ntracers, subcell_tracer_mass, subcell_tracer_flux,
+            remap_order, 1, &nill_conditioned, &nsingular);
+#endif
 
         /* EXTERNAL FACE */
 
@@ -238,6 +672,10 @@ void perform_advection(
             rz_face_c.z, 0.5 * (rezoned_nodes_z[(node_index)] +
                                 rezoned_nodes_z[(lnode_index)])};
 
+#ifdef BATCHED_ADVECTION
+        add_swept_edge_prism(&batch, enodes_x, enodes_y, enodes_z,
+                             subcell_index, ff, neighbour_cc, 0);
+#else
         // Contributes the local mass, energy and momentum flux for a given
         // subcell face
         flux_mass_energy_momentum(
@@ -253,9 +691,39 @@ void perform_advection(
             subcells_to_subcells, subcells_to_faces_offsets, subcells_to_faces,
             faces_to_nodes_offsets, faces_to_nodes, cells_to_nodes_offsets,
             cells_to_nodes, faces_cclockwise_cell, nodes_x, nodes_y, nodes_z,
-            0);
+            face_flux, ntracers, subcell_tracer_mass, subcell_tracer_flux,
+            remap_order, 0, &nill_conditioned, &nsingular);
+#endif
       }
     }
+
+#ifdef BATCHED_ADVECTION
+    // Flux the prisms that remain in the batch
+    flux_swept_edge_batch(
+        cc, &cell_c, &batch, subcell_mass, subcell_mass_flux, subcell_ie_mass,
+        subcell_ie_mass_flux, subcell_ke_mass, subcell_ke_mass_flux,
+        subcell_volume, subcell_momentum_x, subcell_momentum_y,
+        subcell_momentum_z, subcell_momentum_flux_x, subcell_momentum_flux_y,
+        subcell_momentum_flux_z, swept_edge_faces_to_nodes, subcell_centroids_x,
+        subcell_centroids_y, subcell_centroids_z, swept_edge_to_faces,
+        swept_edge_faces_to_nodes_offsets, subcells_to_subcells_offsets,
+        subcells_to_subcells, subcells_to_faces_offsets, subcells_to_faces,
+        faces_to_nodes_offsets, faces_to_nodes, cells_to_nodes_offsets,
+        cells_to_nodes, faces_cclockwise_cell, nodes_x, nodes_y, nodes_z,
+        face_flux, ntracers, subcell_tracer_mass, subcell_tracer_flux,
+        remap_order, &nill_conditioned, &nsingular);
+#endif
+
+    record_entity_cost(&schedule, cc, cell_start);
+  }
+  TEAM_SUM(&nill_conditioned, &nsingular);
+  end_kernel_schedule(&schedule);
+
+  OMP_MASTER()
+  {
+    solve_counts->ncalls++;
+    solve_counts->nill_conditioned += nill_conditioned;
+    solve_counts->nsingular += nsingular;
   }
 }
 
@@ -279,7 +747,10 @@ void flux_mass_energy_momentum(
     const int* faces_to_nodes_offsets, const int* faces_to_nodes,
     const int* cells_to_nodes_offsets, const int* cells_to_nodes,
     const int* faces_cclockwise_cell, const double* nodes_x,
-    const double* nodes_y, const double* nodes_z, const int internal) {
+    const double* nodes_y, const double* nodes_z, double* face_flux,
+    const int ntracers, const double* subcell_tracer_mass,
+    double* subcell_tracer_flux, const int remap_order, const int internal,
+    double* nill_conditioned, double* nsingular) {
 
   // Get the centroids for the swept edge prism and faces
   vec_t face_c = {0.0, 0.0, 0.0};
@@ -315,6 +786,498 @@ void flux_mass_energy_momentum(
               subcell_c->z - face_c.z};
   const int is_outflux = (ab.x * ac.x + ab.y * ac.y + ab.z * ac.z > 0.0);
 
+  // Reconstruct the quantities in the upwind subcell, which the swept edge
+  // region is taking its mass, energy and momentum from
+  SweepSubcell sweep;
+  if (remap_order == FIRST_ORDER_REMAP) {
+    select_donor_subcell(ff, subcell_index, internal, is_outflux,
+                         swept_edge_vol, subcell_mass, subcell_ie_mass,
+                         subcell_ke_mass, subcell_volume, subcell_momentum_x,
+                         subcell_momentum_y, subcell_momentum_z,
+                         subcell_centroids_x, subcell_centroids_y,
+                         subcell_centroids_z, subcells_to_subcells_offsets,
+                         subcells_to_subcells, &sweep);
+  } else {
+    const int state = reconstruct_sweep_subcell(
+        cc, neighbour_cc, ff, subcell_index, internal, is_outflux,
+        swept_edge_vol, cell_c, subcell_mass, subcell_ie_mass, subcell_ke_mass,
+        subcell_volume, subcell_momentum_x, subcell_momentum_y,
+        subcell_momentum_z, subcell_centroids_x, subcell_centroids_y,
+        subcell_centroids_z, subcells_to_subcells_offsets,
+        subcells_to_subcells, subcells_to_faces_offsets, subcells_to_faces,
+        faces_to_nodes_offsets, faces_to_nodes, cells_to_nodes_offsets,
+        cells_to_nodes, faces_cclockwise_cell, nodes_x, nodes_y, nodes_z,
+        &sweep);
+    count_solve_state(state, nill_conditioned, nsingular);
+  }
+
+  const double dx = swept_edge_c.x - sweep.c.x;
+  const double dy = swept_edge_c.y - sweep.c.y;
+  const double dz = swept_edge_c.z - sweep.c.z;
+
+  // Calculate the fluxes for the different quantities
+  const double local_mass_flux =
+      swept_edge_vol * (sweep.density + sweep.grad_m.x * dx +
+                        sweep.grad_m.y * dy + sweep.grad_m.z * dz);
+  const double local_ie_flux =
+      swept_edge_vol * (sweep.ie_density + sweep.grad_ie.x * dx +
+                        sweep.grad_ie.y * dy + sweep.grad_ie.z * dz);
+  const double local_ke_flux =
+      swept_edge_vol * (sweep.ke_density + sweep.grad_ke.x * dx +
+                        sweep.grad_ke.y * dy + sweep.grad_ke.z * dz);
+  const double local_x_momentum_flux =
+      swept_edge_vol * (sweep.v.x + sweep.grad_vx.x * dx +
+                        sweep.grad_vx.y * dy + sweep.grad_vx.z * dz);
+  const double local_y_momentum_flux =
+      swept_edge_vol * (sweep.v.y + sweep.grad_vy.x * dx +
+                        sweep.grad_vy.y * dy + sweep.grad_vy.z * dz);
+  const double local_z_momentum_flux =
+      swept_edge_vol * (sweep.v.z + sweep.grad_vz.x * dx +
+                        sweep.grad_vz.y * dy + sweep.grad_vz.z * dz);
+
+  // Mass and energy are either flowing into or out of the subcell
+  if (is_outflux) {
+    subcell_mass_flux[(subcell_index)] += local_mass_flux;
+    subcell_ie_mass_flux[(subcell_index)] += local_ie_flux;
+    subcell_ke_mass_flux[(subcell_index)] += local_ke_flux;
+    subcell_momentum_flux_x[(subcell_index)] += local_x_momentum_flux;
+    subcell_momentum_flux_y[(subcell_index)] += local_y_momentum_flux;
+    subcell_momentum_flux_z[(subcell_index)] += local_z_momentum_flux;
+  } else {
+    subcell_mass_flux[(subcell_index)] -= local_mass_flux;
+    subcell_ie_mass_flux[(subcell_index)] -= local_ie_flux;
+    subcell_ke_mass_flux[(subcell_index)] -= local_ke_flux;
+    subcell_momentum_flux_x[(subcell_index)] -= local_x_momentum_flux;
+    subcell_momentum_flux_y[(subcell_index)] -= local_y_momentum_flux;
+    subcell_momentum_flux_z[(subcell_index)] -= local_z_momentum_flux;
+  }
+
+  // The materials are advected with the fluxes that leave the cell
+  if (face_flux && !internal && is_outflux) {
+    record_face_flux(cc, ff, subcell_index, swept_edge_vol, local_mass_flux,
+                     local_ie_flux, subcells_to_faces_offsets,
+                     subcells_to_faces, faces_cclockwise_cell, face_flux);
+  }
+
+  // The tracers share the swept region and the sweep subcell
+  if (ntracers) {
+    flux_sweep_tracers(ntracers, subcell_index, is_outflux, swept_edge_vol,
+                       &swept_edge_c, &sweep, subcell_volume,
+                       subcell_centroids_x, subcell_centroids_y,
+                       subcell_centroids_z, subcells_to_subcells_offsets,
+                       subcells_to_subcells, subcell_tracer_mass,
+                       subcell_tracer_flux);
+  }
+}
+
+// Records the flux leaving a cell through the external face of a subcell
+void record_face_flux(const int cc, const int ff, const int subcell_index,
+                      const double volume_flux, const double mass_flux,
+                      const double ie_flux,
+                      const int* subcells_to_faces_offsets,
+                      const int* subcells_to_faces,
+                      const int* faces_cclockwise_cell, double* face_flux) {
+  const int face_index =
+      subcells_to_faces[(subcells_to_faces_offsets[(subcell_index)] + ff)];
+  const int side = (faces_cclockwise_cell[(face_index)] != cc);
+  FACE_FLUX(face_flux, face_index, side, FACE_VOLUME_FLUX) += volume_flux;
+  FACE_FLUX(face_flux, face_index, side, FACE_MASS_FLUX) += mass_flux;
+  FACE_FLUX(face_flux, face_index, side, FACE_IE_FLUX) += ie_flux;
+}
+
+// Gathers the vertices of a swept edge prism into the next lane of a batch
+void add_swept_edge_prism(SweptEdgeBatch* batch, const double* se_nodes_x,
+                          const double* se_nodes_y, const double* se_nodes_z,
+                          const int subcell_index, const int ff,
+                          const int neighbour_cc, const int internal) {
+
+  const int ll = batch->nprisms++;
+  for (int nn = 0; nn < 2 * NNODES_BY_SUBCELL_FACE; ++nn) {
+    batch->x[(nn)][(ll)] = se_nodes_x[(nn)];
+    batch->y[(nn)][(ll)] = se_nodes_y[(nn)];
+    batch->z[(nn)][(ll)] = se_nodes_z[(nn)];
+  }
+  batch->subcell_index[(ll)] = subcell_index;
+  batch->ff[(ll)] = ff;
+  batch->neighbour_cc[(ll)] = neighbour_cc;
+  batch->internal[(ll)] = internal;
+}
+
+// Contributes the local mass, energy and momentum flux for a batch of swept
+// edge prisms, evaluating the prisms across the vector lanes
+void flux_swept_edge_batch(
+    const int cc, vec_t* cell_c, SweptEdgeBatch* batch,
+    const double* subcell_mass, double* subcell_mass_flux,
+    const double* subcell_ie_mass, double* subcell_ie_mass_flux,
+    const double* subcell_ke_mass, double* subcell_ke_mass_flux,
+    const double* subcell_volume, const double* subcell_momentum_x,
+    const double* subcell_momentum_y, const double* subcell_momentum_z,
+    double* subcell_momentum_flux_x, double* subcell_momentum_flux_y,
+    double* subcell_momentum_flux_z, const int* swept_edge_faces_to_nodes,
+    const double* subcell_centroids_x, const double* subcell_centroids_y,
+    const double* subcell_centroids_z, const int* swept_edge_to_faces,
+    const int* swept_edge_faces_to_nodes_offsets,
+    const int* subcells_to_subcells_offsets, const int* subcells_to_subcells,
+    const int* subcells_to_faces_offsets, const int* subcells_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const int* cells_to_nodes_offsets, const int* cells_to_nodes,
+    const int* faces_cclockwise_cell, const double* nodes_x,
+    const double* nodes_y, const double* nodes_z, double* face_flux,
+    const int ntracers, const double* subcell_tracer_mass,
+    double* subcell_tracer_flux, const int remap_order,
+    double* nill_conditioned, double* nsingular) {
+
+  const int nprisms = batch->nprisms;
+  batch->nprisms = 0;
+
+  double face_c_x[SWEPT_EDGE_BATCH];
+  double face_c_y[SWEPT_EDGE_BATCH];
+  double face_c_z[SWEPT_EDGE_BATCH];
+  double rz_face_c_x[SWEPT_EDGE_BATCH];
+  double rz_face_c_y[SWEPT_EDGE_BATCH];
+  double rz_face_c_z[SWEPT_EDGE_BATCH];
+  double swept_edge_c_x[SWEPT_EDGE_BATCH];
+  double swept_edge_c_y[SWEPT_EDGE_BATCH];
+  double swept_edge_c_z[SWEPT_EDGE_BATCH];
+  double swept_edge_vol[SWEPT_EDGE_BATCH];
+  int is_outflux[SWEPT_EDGE_BATCH];
+
+  // Every prism has the same topology, so the loops over the vertices and
+  // faces are shared and the lanes are innermost. Each lane sees the same
+  // operations in the same order as the scalar path.
+#pragma omp simd
+  for (int ll = 0; ll < nprisms; ++ll) {
+    face_c_x[(ll)] = 0.0;
+    face_c_y[(ll)] = 0.0;
+    face_c_z[(ll)] = 0.0;
+    rz_face_c_x[(ll)] = 0.0;
+    rz_face_c_y[(ll)] = 0.0;
+    rz_face_c_z[(ll)] = 0.0;
+    swept_edge_c_x[(ll)] = 0.0;
+    swept_edge_c_y[(ll)] = 0.0;
+    swept_edge_c_z[(ll)] = 0.0;
+    swept_edge_vol[(ll)] = 0.0;
+  }
+
+  // Get the centroids for the swept edge prisms and faces
+  for (int nn = 0; nn < NNODES_BY_SUBCELL_FACE; ++nn) {
+    const int rz_nn = NNODES_BY_SUBCELL_FACE + nn;
+#pragma omp simd
+    for (int ll = 0; ll < nprisms; ++ll) {
+      face_c_x[(ll)] += batch->x[(nn)][(ll)] / NNODES_BY_SUBCELL_FACE;
+      face_c_y[(ll)] += batch->y[(nn)][(ll)] / NNODES_BY_SUBCELL_FACE;
+      face_c_z[(ll)] += batch->z[(nn)][(ll)] / NNODES_BY_SUBCELL_FACE;
+      rz_face_c_x[(ll)] += batch->x[(rz_nn)][(ll)] / NNODES_BY_SUBCELL_FACE;
+      rz_face_c_y[(ll)] += batch->y[(rz_nn)][(ll)] / NNODES_BY_SUBCELL_FACE;
+      rz_face_c_z[(ll)] += batch->z[(rz_nn)][(ll)] / NNODES_BY_SUBCELL_FACE;
+    }
+  }
+  for (int nn = 0; nn < 2 * NNODES_BY_SUBCELL_FACE; ++nn) {
+#pragma omp simd
+    for (int ll = 0; ll < nprisms; ++ll) {
+      swept_edge_c_x[(ll)] +=
+          batch->x[(nn)][(ll)] / (2 * NNODES_BY_SUBCELL_FACE);
+      swept_edge_c_y[(ll)] +=
+          batch->y[(nn)][(ll)] / (2 * NNODES_BY_SUBCELL_FACE);
+      swept_edge_c_z[(ll)] +=
+          batch->z[(nn)][(ll)] / (2 * NNODES_BY_SUBCELL_FACE);
+    }
+  }
+
+  // Calculate the volume of the swept edge prisms
+  for (int ff = 0; ff < 2 + NNODES_BY_SUBCELL_FACE; ++ff) {
+    const int face_to_nodes_off =
+        swept_edge_faces_to_nodes_offsets[(swept_edge_to_faces[(ff)])];
+
+    double pface_c_x[SWEPT_EDGE_BATCH];
+    double pface_c_y[SWEPT_EDGE_BATCH];
+    double pface_c_z[SWEPT_EDGE_BATCH];
+#pragma omp simd
+    for (int ll = 0; ll < nprisms; ++ll) {
+      pface_c_x[(ll)] = 0.0;
+      pface_c_y[(ll)] = 0.0;
+      pface_c_z[(ll)] = 0.0;
+    }
+    for (int nn = 0; nn < NNODES_BY_SUBCELL_FACE; ++nn) {
+      const int node = swept_edge_faces_to_nodes[(face_to_nodes_off + nn)];
+      const double* node_x = batch->x[(node)];
+      const double* node_y = batch->y[(node)];
+      const double* node_z = batch->z[(node)];
+#pragma omp simd
+      for (int ll = 0; ll < nprisms; ++ll) {
+        pface_c_x[(ll)] += node_x[(ll)] / NNODES_BY_SUBCELL_FACE;
+        pface_c_y[(ll)] += node_y[(ll)] / NNODES_BY_SUBCELL_FACE;
+        pface_c_z[(ll)] += node_z[(ll)] / NNODES_BY_SUBCELL_FACE;
+      }
+    }
+
+    for (int nn = 0; nn < NNODES_BY_SUBCELL_FACE; ++nn) {
+      const int current_node =
+          swept_edge_faces_to_nodes[(face_to_nodes_off + nn)];
+      const int next_node = swept_edge_faces_to_nodes[(
+          face_to_nodes_off + (nn + 1) % NNODES_BY_SUBCELL_FACE)];
+      const double* current_x = batch->x[(current_node)];
+      const double* current_y = batch->y[(current_node)];
+      const double* current_z = batch->z[(current_node)];
+      const double* next_x = batch->x[(next_node)];
+      const double* next_y = batch->y[(next_node)];
+      const double* next_z = batch->z[(next_node)];
+
+#pragma omp simd
+      for (int ll = 0; ll < nprisms; ++ll) {
+        // Get the halfway point on the right edge
+        const double half_edge_x = 0.5 * (current_x[(ll)] + next_x[(ll)]);
+        const double half_edge_y = 0.5 * (current_y[(ll)] + next_y[(ll)]);
+        const double half_edge_z = 0.5 * (current_z[(ll)] + next_z[(ll)]);
+
+        // Setup basis on plane of tetrahedron
+        const double a_x = (half_edge_x - pface_c_x[(ll)]);
+        const double a_y = (half_edge_y - pface_c_y[(ll)]);
+        const double a_z = (half_edge_z - pface_c_z[(ll)]);
+        const double b_x = (swept_edge_c_x[(ll)] - pface_c_x[(ll)]);
+        const double b_y = (swept_edge_c_y[(ll)] - pface_c_y[(ll)]);
+        const double b_z = (swept_edge_c_z[(ll)] - pface_c_z[(ll)]);
+        const double ab_x = (half_edge_x - current_x[(ll)]);
+        const double ab_y = (half_edge_y - current_y[(ll)]);
+        const double ab_z = (half_edge_z - current_z[(ll)]);
+
+        // Calculate the area vector S using cross product
+        const double S_x = 0.5 * (a_y * b_z - a_z * b_y);
+        const double S_y = -0.5 * (a_x * b_z - a_z * b_x);
+        const double S_z = 0.5 * (a_x * b_y - a_y * b_x);
+
+        swept_edge_vol[(ll)] +=
+            2.0 * fabs(ab_x * S_x + ab_y * S_y + ab_z * S_z) / 3.0;
+      }
+    }
+  }
+
+#pragma omp simd
+  for (int ll = 0; ll < nprisms; ++ll) {
+    // A degenerate prism has no volume, as in calc_volume
+    const double vol = swept_edge_vol[(ll)];
+    swept_edge_vol[(ll)] = isnan(vol) ? 0.0 : fabs(vol);
+
+    // The swept region leaves the subcell if it is on the far side of the face
+    const int subcell_index = batch->subcell_index[(ll)];
+    const double ab_x = rz_face_c_x[(ll)] - face_c_x[(ll)];
+    const double ab_y = rz_face_c_y[(ll)] - face_c_y[(ll)];
+    const double ab_z = rz_face_c_z[(ll)] - face_c_z[(ll)];
+    const double ac_x = subcell_centroids_x[(subcell_index)] - face_c_x[(ll)];
+    const double ac_y = subcell_centroids_y[(subcell_index)] - face_c_y[(ll)];
+    const double ac_z = subcell_centroids_z[(subcell_index)] - face_c_z[(ll)];
+    is_outflux[(ll)] = (ab_x * ac_x + ab_y * ac_y + ab_z * ac_z > 0.0);
+  }
+
+  double sweep_c_x[SWEPT_EDGE_BATCH];
+  double sweep_c_y[SWEPT_EDGE_BATCH];
+  double sweep_c_z[SWEPT_EDGE_BATCH];
+  double sweep_value[NSWEEP_QUANTITIES][SWEPT_EDGE_BATCH];
+  double sweep_grad_x[NSWEEP_QUANTITIES][SWEPT_EDGE_BATCH];
+  double sweep_grad_y[NSWEEP_QUANTITIES][SWEPT_EDGE_BATCH];
+  double sweep_grad_z[NSWEEP_QUANTITIES][SWEPT_EDGE_BATCH];
+
+  // The upwind subcells are found through the irregular connectivity, so
+  // their least squares systems are assembled one prism at a time
+  SweepSubcell sweep[SWEPT_EDGE_BATCH];
+  double coeff[NSYM_3X3][SWEPT_EDGE_BATCH];
+  double rhs_x[NSWEEP_QUANTITIES][SWEPT_EDGE_BATCH];
+  double rhs_y[NSWEEP_QUANTITIES][SWEPT_EDGE_BATCH];
+  double rhs_z[NSWEEP_QUANTITIES][SWEPT_EDGE_BATCH];
+  for (int ll = 0; ll < nprisms; ++ll) {
+    sweep[(ll)] = (SweepSubcell){0};
+
+    // Ignore the special case of an empty swept edge region, leaving the lane
+    // empty so that it is not scattered
+    if (swept_edge_vol[(ll)] < EPS) {
+      if (swept_edge_vol[(ll)] < -EPS) {
+        printf("Negative swept edge volume %d %.12f\n", cc,
+               swept_edge_vol[(ll)]);
+      }
+      swept_edge_vol[(ll)] = 0.0;
+    } else if (remap_order == FIRST_ORDER_REMAP) {
+      select_donor_subcell(
+          batch->ff[(ll)], batch->subcell_index[(ll)], batch->internal[(ll)],
+          is_outflux[(ll)], swept_edge_vol[(ll)], subcell_mass,
+          subcell_ie_mass, subcell_ke_mass, subcell_volume, subcell_momentum_x,
+          subcell_momentum_y, subcell_momentum_z, subcell_centroids_x,
+          subcell_centroids_y, subcell_centroids_z,
+          subcells_to_subcells_offsets, subcells_to_subcells, &sweep[(ll)]);
+    } else {
+      assemble_sweep_subcell(
+          batch->ff[(ll)], batch->subcell_index[(ll)], batch->internal[(ll)],
+          is_outflux[(ll)], swept_edge_vol[(ll)], subcell_mass,
+          subcell_ie_mass, subcell_ke_mass, subcell_volume, subcell_momentum_x,
+          subcell_momentum_y, subcell_momentum_z, subcell_centroids_x,
+          subcell_centroids_y, subcell_centroids_z,
+          subcells_to_subcells_offsets, subcells_to_subcells, &sweep[(ll)]);
+    }
+
+    for (int ee = 0; ee < NSYM_3X3; ++ee) {
+      coeff[(ee)][(ll)] = sweep[(ll)].coeff[(ee)];
+    }
+    for (int qq = 0; qq < NSWEEP_QUANTITIES; ++qq) {
+      rhs_x[(qq)][(ll)] = sweep[(ll)].rhs_x[(qq)];
+      rhs_y[(qq)][(ll)] = sweep[(ll)].rhs_y[(qq)];
+      rhs_z[(qq)][(ll)] = sweep[(ll)].rhs_z[(qq)];
+    }
+  }
+
+  // Solve for the gradients of every quantity in every lane at once, where
+  // the empty lanes are singular and solve to zero, unless the remap is first
+  // order and has no gradients
+  double grad_x[NSWEEP_QUANTITIES][SWEPT_EDGE_BATCH];
+  double grad_y[NSWEEP_QUANTITIES][SWEPT_EDGE_BATCH];
+  double grad_z[NSWEEP_QUANTITIES][SWEPT_EDGE_BATCH];
+  int status[SWEPT_EDGE_BATCH];
+  const int second_order = (remap_order != FIRST_ORDER_REMAP);
+  if (second_order) {
+    solve_sym_3x3_batch(nprisms, SWEPT_EDGE_BATCH, NSWEEP_QUANTITIES,
+                        coeff[0], rhs_x[0], rhs_y[0], rhs_z[0], grad_x[0],
+                        grad_y[0], grad_z[0], status);
+  }
+
+  for (int ll = 0; ll < nprisms; ++ll) {
+    if (second_order && swept_edge_vol[(ll)] != 0.0) {
+      count_solve_state(status[(ll)], nill_conditioned, nsingular);
+
+      unpack_sweep_gradients(SWEPT_EDGE_BATCH, ll, grad_x[0], grad_y[0],
+                             grad_z[0], &sweep[(ll)]);
+      limit_sweep_subcell(
+          cc, batch->neighbour_cc[(ll)], batch->ff[(ll)], batch->internal[(ll)],
+          is_outflux[(ll)], cell_c, subcells_to_faces_offsets,
+          subcells_to_faces, faces_to_nodes_offsets, faces_to_nodes,
+          cells_to_nodes_offsets, cells_to_nodes, faces_cclockwise_cell,
+          nodes_x, nodes_y, nodes_z, &sweep[(ll)]);
+    }
+
+    // Transpose the reconstruction into the lane
+    const double values[NSWEEP_QUANTITIES] = {
+        sweep[(ll)].density, sweep[(ll)].ie_density, sweep[(ll)].ke_density,
+        sweep[(ll)].v.x,     sweep[(ll)].v.y,        sweep[(ll)].v.z};
+    const vec_t grads[NSWEEP_QUANTITIES] = {
+        sweep[(ll)].grad_m,  sweep[(ll)].grad_ie, sweep[(ll)].grad_ke,
+        sweep[(ll)].grad_vx, sweep[(ll)].grad_vy, sweep[(ll)].grad_vz};
+    sweep_c_x[(ll)] = sweep[(ll)].c.x;
+    sweep_c_y[(ll)] = sweep[(ll)].c.y;
+    sweep_c_z[(ll)] = sweep[(ll)].c.z;
+    for (int qq = 0; qq < NSWEEP_QUANTITIES; ++qq) {
+      sweep_value[(qq)][(ll)] = values[(qq)];
+      sweep_grad_x[(qq)][(ll)] = grads[(qq)].x;
+      sweep_grad_y[(qq)][(ll)] = grads[(qq)].y;
+      sweep_grad_z[(qq)][(ll)] = grads[(qq)].z;
+    }
+  }
+
+  // Evaluate the reconstructions at the centroids of the swept regions
+  double flux[NSWEEP_QUANTITIES][SWEPT_EDGE_BATCH];
+  for (int qq = 0; qq < NSWEEP_QUANTITIES; ++qq) {
+#pragma omp simd
+    for (int ll = 0; ll < nprisms; ++ll) {
+      const double dx = swept_edge_c_x[(ll)] - sweep_c_x[(ll)];
+      const double dy = swept_edge_c_y[(ll)] - sweep_c_y[(ll)];
+      const double dz = swept_edge_c_z[(ll)] - sweep_c_z[(ll)];
+      flux[(qq)][(ll)] =
+          swept_edge_vol[(ll)] *
+          (sweep_value[(qq)][(ll)] + sweep_grad_x[(qq)][(ll)] * dx +
+           sweep_grad_y[(qq)][(ll)] * dy + sweep_grad_z[(qq)][(ll)] * dz);
+    }
+  }
+
+  // Several prisms of a batch share a subcell, so the fluxes are scattered in
+  // the order of the scalar path
+  double* subcell_flux[NSWEEP_QUANTITIES] = {
+      subcell_mass_flux,       subcell_ie_mass_flux,
+      subcell_ke_mass_flux,    subcell_momentum_flux_x,
+      subcell_momentum_flux_y, subcell_momentum_flux_z};
+  for (int ll = 0; ll < nprisms; ++ll) {
+    if (swept_edge_vol[(ll)] == 0.0) {
+      continue;
+    }
+
+    const int subcell_index = batch->subcell_index[(ll)];
+    for (int qq = 0; qq < NSWEEP_QUANTITIES; ++qq) {
+      if (is_outflux[(ll)]) {
+        subcell_flux[(qq)][(subcell_index)] += flux[(qq)][(ll)];
+      } else {
+        subcell_flux[(qq)][(subcell_index)] -= flux[(qq)][(ll)];
+      }
+    }
+
+    // The materials are advected with the fluxes that leave the cell
+    if (face_flux && !batch->internal[(ll)] && is_outflux[(ll)]) {
+      record_face_flux(cc, batch->ff[(ll)], subcell_index,
+                       swept_edge_vol[(ll)], flux[(SWEEP_M)][(ll)],
+                       flux[(SWEEP_IE)][(ll)], subcells_to_faces_offsets,
+                       subcells_to_faces, faces_cclockwise_cell, face_flux);
+    }
+
+    // The tracers share the swept region and the sweep subcell
+    if (ntracers) {
+      const vec_t swept_edge_c = {swept_edge_c_x[(ll)], swept_edge_c_y[(ll)],
+                                  swept_edge_c_z[(ll)]};
+      flux_sweep_tracers(ntracers, subcell_index, is_outflux[(ll)],
+                         swept_edge_vol[(ll)], &swept_edge_c, &sweep[(ll)],
+                         subcell_volume, subcell_centroids_x,
+                         subcell_centroids_y, subcell_centroids_z,
+                         subcells_to_subcells_offsets, subcells_to_subcells,
+                         subcell_tracer_mass, subcell_tracer_flux);
+    }
+  }
+}
+
+// Reconstructs the quantities in the subcell that a swept edge region is
+// taking its mass, energy and momentum from, with least squares gradients
+// limited to the extrema of the neighbourhood, returning the state of the solve
+int reconstruct_sweep_subcell(
+    const int cc, const int neighbour_cc, const int ff, const int subcell_index,
+    const int internal, const int is_outflux, const double swept_edge_vol,
+    vec_t* cell_c, const double* subcell_mass, const double* subcell_ie_mass,
+    const double* subcell_ke_mass, const double* subcell_volume,
+    const double* subcell_momentum_x, const double* subcell_momentum_y,
+    const double* subcell_momentum_z, const double* subcell_centroids_x,
+    const double* subcell_centroids_y, const double* subcell_centroids_z,
+    const int* subcells_to_subcells_offsets, const int* subcells_to_subcells,
+    const int* subcells_to_faces_offsets, const int* subcells_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const int* cells_to_nodes_offsets, const int* cells_to_nodes,
+    const int* faces_cclockwise_cell, const double* nodes_x,
+    const double* nodes_y, const double* nodes_z, SweepSubcell* sweep) {
+
+  assemble_sweep_subcell(
+      ff, subcell_index, internal, is_outflux, swept_edge_vol, subcell_mass,
+      subcell_ie_mass, subcell_ke_mass, subcell_volume, subcell_momentum_x,
+      subcell_momentum_y, subcell_momentum_z, subcell_centroids_x,
+      subcell_centroids_y, subcell_centroids_z, subcells_to_subcells_offsets,
+      subcells_to_subcells, sweep);
+
+  // Solve for the gradients of all of the quantities at once
+  double grad_x[NSWEEP_QUANTITIES];
+  double grad_y[NSWEEP_QUANTITIES];
+  double grad_z[NSWEEP_QUANTITIES];
+  const int state = solve_sym_3x3_batch(
+      1, 1, NSWEEP_QUANTITIES, sweep->coeff, sweep->rhs_x, sweep->rhs_y,
+      sweep->rhs_z, grad_x, grad_y, grad_z, NULL);
+  unpack_sweep_gradients(1, 0, grad_x, grad_y, grad_z, sweep);
+
+  limit_sweep_subcell(cc, neighbour_cc, ff, internal, is_outflux, cell_c,
+                      subcells_to_faces_offsets, subcells_to_faces,
+                      faces_to_nodes_offsets, faces_to_nodes,
+                      cells_to_nodes_offsets, cells_to_nodes,
+                      faces_cclockwise_cell, nodes_x, nodes_y, nodes_z, sweep);
+
+  return state;
+}
+
+// Finds the subcell that a swept edge region is taking its mass, energy and
+// momentum from, which is the subcell itself when the region leaves it, and
+// otherwise its neighbour across the face being swept
+int find_sweep_subcell(const int ff, const int subcell_index,
+                       const int internal, const int is_outflux,
+                       const double swept_edge_vol,
+                       const int* subcells_to_subcells_offsets,
+                       const int* subcells_to_subcells) {
+
   // Depending upon which subcell we are sweeping into, choose the
   // subcell index with which to reconstruct the density
   const int subcell_to_subcells_off =
@@ -331,15 +1294,75 @@ void flux_mass_energy_momentum(
         swept_edge_vol);
   }
 
+  return (is_outflux ? subcell_index : subcell_neighbour_index);
+}
+
+// Selects the subcell that a swept edge region is taking its mass, energy and
+// momentum from for a first order donor cell remap, where the quantities of
+// the subcell are constant across it, so there are no gradients to find or
+// limit
+void select_donor_subcell(
+    const int ff, const int subcell_index, const int internal,
+    const int is_outflux, const double swept_edge_vol,
+    const double* subcell_mass, const double* subcell_ie_mass,
+    const double* subcell_ke_mass, const double* subcell_volume,
+    const double* subcell_momentum_x, const double* subcell_momentum_y,
+    const double* subcell_momentum_z, const double* subcell_centroids_x,
+    const double* subcell_centroids_y, const double* subcell_centroids_z,
+    const int* subcells_to_subcells_offsets, const int* subcells_to_subcells,
+    SweepSubcell* sweep) {
+
+  const int sweep_subcell_index = find_sweep_subcell(
+      ff, subcell_index, internal, is_outflux, swept_edge_vol,
+      subcells_to_subcells_offsets, subcells_to_subcells);
+  const double sweep_subcell_vol = subcell_volume[(sweep_subcell_index)];
+
+  sweep->index = sweep_subcell_index;
+  sweep->piecewise_constant = 1;
+  sweep->c.x = subcell_centroids_x[(sweep_subcell_index)];
+  sweep->c.y = subcell_centroids_y[(sweep_subcell_index)];
+  sweep->c.z = subcell_centroids_z[(sweep_subcell_index)];
+  sweep->density = subcell_mass[(sweep_subcell_index)] / sweep_subcell_vol;
+  sweep->ie_density =
+      subcell_ie_mass[(sweep_subcell_index)] / sweep_subcell_vol;
+  sweep->ke_density =
+      subcell_ke_mass[(sweep_subcell_index)] / sweep_subcell_vol;
+  sweep->v.x = subcell_momentum_x[(sweep_subcell_index)] / sweep_subcell_vol;
+  sweep->v.y = subcell_momentum_y[(sweep_subcell_index)] / sweep_subcell_vol;
+  sweep->v.z = subcell_momentum_z[(sweep_subcell_index)] / sweep_subcell_vol;
+
+  const vec_t zero = {0.0, 0.0, 0.0};
+  sweep->grad_m = zero;
+  sweep->grad_ie = zero;
+  sweep->grad_ke = zero;
+  sweep->grad_vx = zero;
+  sweep->grad_vy = zero;
+  sweep->grad_vz = zero;
+  sweep->nlimit_points = 0;
+}
+
+// Assembles the least squares system for the gradients in the subcell that a
+// swept edge region is taking its mass, energy and momentum from
+void assemble_sweep_subcell(
+    const int ff, const int subcell_index, const int internal,
+    const int is_outflux, const double swept_edge_vol,
+    const double* subcell_mass, const double* subcell_ie_mass,
+    const double* subcell_ke_mass, const double* subcell_volume,
+    const double* subcell_momentum_x, const double* subcell_momentum_y,
+    const double* subcell_momentum_z, const double* subcell_centroids_x,
+    const double* subcell_centroids_y, const double* subcell_centroids_z,
+    const int* subcells_to_subcells_offsets, const int* subcells_to_subcells,
+    SweepSubcell* sweep) {
+
   // The sweep subcell index is where we will reconstruct the value of the
   // swept edge region from
-  const int sweep_subcell_index =
-      (is_outflux ? subcell_index : subcell_neighbour_index);
+  const int sweep_subcell_index = find_sweep_subcell(
+      ff, subcell_index, internal, is_outflux, swept_edge_vol,
+      subcells_to_subcells_offsets, subcells_to_subcells);
 
   /* CALCULATE THE SWEEP SUBCELL GRADIENTS FOR MASS AND ENERGY */
 
-  vec_t inv[3] = {{0.0, 0.0, 0.0}};
-  vec_t coeff[3] = {{0.0, 0.0, 0.0}};
+  double coeff[NSYM_3X3] = {0.0};
   vec_t m_rhs = {0.0, 0.0, 0.0};
   vec_t ie_rhs = {0.0, 0.0, 0.0};
   vec_t ke_rhs = {0.0, 0.0, 0.0};
@@ -400,16 +1423,14 @@ void flux_mass_energy_momentum(
         (subcell_centroids_z[(sweep_neighbour_index)] - sweep_subcell_c.z) *
             neighbour_vol};
 
-    // Store the neighbouring cell's contribution to the coefficients
-    coeff[0].x += 2.0 * (i.x * i.x) / (neighbour_vol * neighbour_vol);
-    coeff[0].y += 2.0 * (i.x * i.y) / (neighbour_vol * neighbour_vol);
-    coeff[0].z += 2.0 * (i.x * i.z) / (neighbour_vol * neighbour_vol);
-    coeff[1].x += 2.0 * (i.y * i.x) / (neighbour_vol * neighbour_vol);
-    coeff[1].y += 2.0 * (i.y * i.y) / (neighbour_vol * neighbour_vol);
-    coeff[1].z += 2.0 * (i.y * i.z) / (neighbour_vol * neighbour_vol);
-    coeff[2].x += 2.0 * (i.z * i.x) / (neighbour_vol * neighbour_vol);
-    coeff[2].y += 2.0 * (i.z * i.y) / (neighbour_vol * neighbour_vol);
-    coeff[2].z += 2.0 * (i.z * i.z) / (neighbour_vol * neighbour_vol);
+    // Store the neighbouring cell's contribution to the coefficients, which
+    // are symmetric
+    coeff[(SYM_XX)] += 2.0 * (i.x * i.x) / (neighbour_vol * neighbour_vol);
+    coeff[(SYM_XY)] += 2.0 * (i.x * i.y) / (neighbour_vol * neighbour_vol);
+    coeff[(SYM_XZ)] += 2.0 * (i.x * i.z) / (neighbour_vol * neighbour_vol);
+    coeff[(SYM_YY)] += 2.0 * (i.y * i.y) / (neighbour_vol * neighbour_vol);
+    coeff[(SYM_YZ)] += 2.0 * (i.y * i.z) / (neighbour_vol * neighbour_vol);
+    coeff[(SYM_ZZ)] += 2.0 * (i.z * i.z) / (neighbour_vol * neighbour_vol);
 
     // Get subcell quantities of neighbouring subcell
     const double neighbour_m_density =
@@ -469,43 +1490,47 @@ void flux_mass_energy_momentum(
     gmin_vz = min(gmin_vz, neighbour_v.z);
   }
 
-  calc_3x3_inverse(&coeff, &inv);
-
-  // Calculate the gradients
-  vec_t grad_m = {inv[0].x * m_rhs.x + inv[0].y * m_rhs.y + inv[0].z * m_rhs.z,
-                  inv[1].x * m_rhs.x + inv[1].y * m_rhs.y + inv[1].z * m_rhs.z,
-                  inv[2].x * m_rhs.x + inv[2].y * m_rhs.y + inv[2].z * m_rhs.z};
-  vec_t grad_ie = {
-      inv[0].x * ie_rhs.x + inv[0].y * ie_rhs.y + inv[0].z * ie_rhs.z,
-      inv[1].x * ie_rhs.x + inv[1].y * ie_rhs.y + inv[1].z * ie_rhs.z,
-      inv[2].x * ie_rhs.x + inv[2].y * ie_rhs.y + inv[2].z * ie_rhs.z};
-  vec_t grad_ke = {
-      inv[0].x * ke_rhs.x + inv[0].y * ke_rhs.y + inv[0].z * ke_rhs.z,
-      inv[1].x * ke_rhs.x + inv[1].y * ke_rhs.y + inv[1].z * ke_rhs.z,
-      inv[2].x * ke_rhs.x + inv[2].y * ke_rhs.y + inv[2].z * ke_rhs.z};
-  vec_t grad_vx = {
-      inv[0].x * vx_rhs.x + inv[0].y * vx_rhs.y + inv[0].z * vx_rhs.z,
-      inv[1].x * vx_rhs.x + inv[1].y * vx_rhs.y + inv[1].z * vx_rhs.z,
-      inv[2].x * vx_rhs.x + inv[2].y * vx_rhs.y + inv[2].z * vx_rhs.z};
-  vec_t grad_vy = {
-      inv[0].x * vy_rhs.x + inv[0].y * vy_rhs.y + inv[0].z * vy_rhs.z,
-      inv[1].x * vy_rhs.x + inv[1].y * vy_rhs.y + inv[1].z * vy_rhs.z,
-      inv[2].x * vy_rhs.x + inv[2].y * vy_rhs.y + inv[2].z * vy_rhs.z};
-  vec_t grad_vz = {
-      inv[0].x * vz_rhs.x + inv[0].y * vz_rhs.y + inv[0].z * vz_rhs.z,
-      inv[1].x * vz_rhs.x + inv[1].y * vz_rhs.y + inv[1].z * vz_rhs.z,
-      inv[2].x * vz_rhs.x + inv[2].y * vz_rhs.y + inv[2].z * vz_rhs.z};
-
-  /* LIMIT THE GRADIENT */
+  sweep->index = sweep_subcell_index;
+  sweep->piecewise_constant = 0;
+  sweep->c = sweep_subcell_c;
+  sweep->density = sweep_subcell_density;
+  sweep->ie_density = sweep_subcell_ie_density;
+  sweep->ke_density = sweep_subcell_ke_density;
+  sweep->v = subcell_v;
+  for (int ee = 0; ee < NSYM_3X3; ++ee) {
+    sweep->coeff[(ee)] = coeff[(ee)];
+  }
+
+  const vec_t rhs[NSWEEP_QUANTITIES] = {m_rhs,  ie_rhs, ke_rhs,
+                                        vx_rhs, vy_rhs, vz_rhs};
+  const double gmax[NSWEEP_QUANTITIES] = {gmax_m,  gmax_ie, gmax_ke,
+                                          gmax_vx, gmax_vy, gmax_vz};
+  const double gmin[NSWEEP_QUANTITIES] = {gmin_m,  gmin_ie, gmin_ke,
+                                          gmin_vx, gmin_vy, gmin_vz};
+  for (int qq = 0; qq < NSWEEP_QUANTITIES; ++qq) {
+    sweep->rhs_x[(qq)] = rhs[(qq)].x;
+    sweep->rhs_y[(qq)] = rhs[(qq)].y;
+    sweep->rhs_z[(qq)] = rhs[(qq)].z;
+    sweep->gmax[(qq)] = gmax[(qq)];
+    sweep->gmin[(qq)] = gmin[(qq)];
+  }
+}
+
+// Limits the gradients in the subcell that a swept edge region is taking its
+// mass, energy and momentum from, to the extrema of the neighbourhood
+void limit_sweep_subcell(
+    const int cc, const int neighbour_cc, const int ff, const int internal,
+    const int is_outflux, vec_t* cell_c, const int* subcells_to_faces_offsets,
+    const int* subcells_to_faces, const int* faces_to_nodes_offsets,
+    const int* faces_to_nodes, const int* cells_to_nodes_offsets,
+    const int* cells_to_nodes, const int* faces_cclockwise_cell,
+    const double* nodes_x, const double* nodes_y, const double* nodes_z,
+    SweepSubcell* sweep) {
 
   // Performing the limiting actually requires the sweep subcell's nodes
-  double m_limiter = 1.0;
-  double ie_limiter = 1.0;
-  double ke_limiter = 1.0;
-  double vx_limiter = 1.0;
-  double vy_limiter = 1.0;
-  double vz_limiter = 1.0;
+  double limiter[NSWEEP_QUANTITIES] = {1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
 
+  const int sweep_subcell_index = sweep->index;
   const int sweep_subcell_to_faces_off =
       subcells_to_faces_offsets[(sweep_subcell_index)];
   const int nfaces_by_sweep_subcell =
@@ -517,13 +1542,8 @@ void flux_mass_energy_momentum(
   vec_t sweep_node = {nodes_x[(sweep_node_index)], nodes_y[(sweep_node_index)],
                       nodes_z[(sweep_node_index)]};
 
-  limit_mass_gradients(
-      sweep_node, &sweep_subcell_c, sweep_subcell_density,
-      sweep_subcell_ie_density, sweep_subcell_ke_density, subcell_v.x,
-      subcell_v.y, subcell_v.z, gmax_m, gmin_m, gmax_ie, gmin_ie, gmax_ke,
-      gmin_ke, gmax_vx, gmin_vx, gmax_vy, gmin_vy, gmax_vz, gmin_vz, &grad_m,
-      &grad_ie, &grad_ke, &grad_vx, &grad_vy, &grad_vz, &m_limiter, &ie_limiter,
-      &ke_limiter, &vx_limiter, &vy_limiter, &vz_limiter);
+  sweep->nlimit_points = 0;
+  limit_sweep_gradients(sweep_node, sweep, limiter);
 
   vec_t sweep_cell_c;
   if (internal || is_outflux) {
@@ -538,13 +1558,7 @@ void flux_mass_energy_momentum(
   }
 
   // Limit at cell center
-  limit_mass_gradients(
-      sweep_cell_c, &sweep_subcell_c, sweep_subcell_density,
-      sweep_subcell_ie_density, sweep_subcell_ke_density, subcell_v.x,
-      subcell_v.y, subcell_v.z, gmax_m, gmin_m, gmax_ie, gmin_ie, gmax_ke,
-      gmin_ke, gmax_vx, gmin_vx, gmax_vy, gmin_vy, gmax_vz, gmin_vz, &grad_m,
-      &grad_ie, &grad_ke, &grad_vx, &grad_vy, &grad_vz, &m_limiter, &ie_limiter,
-      &ke_limiter, &vx_limiter, &vy_limiter, &vz_limiter);
+  limit_sweep_gradients(sweep_cell_c, sweep, limiter);
 
   // Limit at half edges and face centers
   for (int ff2 = 0; ff2 < nfaces_by_sweep_subcell; ++ff2) {
@@ -561,13 +1575,7 @@ void flux_mass_energy_momentum(
     calc_centroid(nnodes_by_sweep_face, nodes_x, nodes_y, nodes_z,
                   faces_to_nodes, sweep_face_to_nodes_off, &sweep_face_c);
 
-    limit_mass_gradients(
-        sweep_face_c, &sweep_subcell_c, sweep_subcell_density,
-        sweep_subcell_ie_density, sweep_subcell_ke_density, subcell_v.x,
-        subcell_v.y, subcell_v.z, gmax_m, gmin_m, gmax_ie, gmin_ie, gmax_ke,
-        gmin_ke, gmax_vx, gmin_vx, gmax_vy, gmin_vy, gmax_vz, gmin_vz, &grad_m,
-        &grad_ie, &grad_ke, &grad_vx, &grad_vy, &grad_vz, &m_limiter,
-        &ie_limiter, &ke_limiter, &vx_limiter, &vy_limiter, &vz_limiter);
+    limit_sweep_gradients(sweep_face_c, sweep, limiter);
 
     // Determine the position of the node in the face list of nodes
     int nn2;
@@ -591,73 +1599,199 @@ void flux_mass_energy_momentum(
                        0.5 * (sweep_node.z + nodes_z[(rnode_index)])};
 
     // Limit at cell center
-    limit_mass_gradients(
-        half_edge, &sweep_subcell_c, sweep_subcell_density,
-        sweep_subcell_ie_density, sweep_subcell_ke_density, subcell_v.x,
-        subcell_v.y, subcell_v.z, gmax_m, gmin_m, gmax_ie, gmin_ie, gmax_ke,
-        gmin_ke, gmax_vx, gmin_vx, gmax_vy, gmin_vy, gmax_vz, gmin_vz, &grad_m,
-        &grad_ie, &grad_ke, &grad_vx, &grad_vy, &grad_vz, &m_limiter,
-        &ie_limiter, &ke_limiter, &vx_limiter, &vy_limiter, &vz_limiter);
-  }
-
-  grad_m.x *= m_limiter;
-  grad_m.y *= m_limiter;
-  grad_m.z *= m_limiter;
-  grad_ie.x *= ie_limiter;
-  grad_ie.y *= ie_limiter;
-  grad_ie.z *= ie_limiter;
-  grad_ke.x *= ke_limiter;
-  grad_ke.y *= ke_limiter;
-  grad_ke.z *= ke_limiter;
-  grad_vx.x *= vx_limiter;
-  grad_vx.y *= vx_limiter;
-  grad_vx.z *= vx_limiter;
-  grad_vy.x *= vy_limiter;
-  grad_vy.y *= vy_limiter;
-  grad_vy.z *= vy_limiter;
-  grad_vz.x *= vz_limiter;
-  grad_vz.y *= vz_limiter;
-  grad_vz.z *= vz_limiter;
-
-  const double dx = swept_edge_c.x - sweep_subcell_c.x;
-  const double dy = swept_edge_c.y - sweep_subcell_c.y;
-  const double dz = swept_edge_c.z - sweep_subcell_c.z;
+    limit_sweep_gradients(half_edge, sweep, limiter);
+  }
 
-  // Calculate the fluxes for the different quantities
-  const double local_mass_flux =
-      swept_edge_vol *
-      (sweep_subcell_density + grad_m.x * dx + grad_m.y * dy + grad_m.z * dz);
-  const double local_ie_flux =
-      swept_edge_vol * (sweep_subcell_ie_density + grad_ie.x * dx +
-                        grad_ie.y * dy + grad_ie.z * dz);
-  const double local_ke_flux =
-      swept_edge_vol * (sweep_subcell_ke_density + grad_ke.x * dx +
-                        grad_ke.y * dy + grad_ke.z * dz);
-  const double local_x_momentum_flux =
-      swept_edge_vol *
-      (subcell_v.x + grad_vx.x * dx + grad_vx.y * dy + grad_vx.z * dz);
-  const double local_y_momentum_flux =
-      swept_edge_vol *
-      (subcell_v.y + grad_vy.x * dx + grad_vy.y * dy + grad_vy.z * dz);
-  const double local_z_momentum_flux =
-      swept_edge_vol *
-      (subcell_v.z + grad_vz.x * dx + grad_vz.y * dy + grad_vz.z * dz);
+  sweep->grad_m.x *= limiter[(SWEEP_M)];
+  sweep->grad_m.y *= limiter[(SWEEP_M)];
+  sweep->grad_m.z *= limiter[(SWEEP_M)];
+  sweep->grad_ie.x *= limiter[(SWEEP_IE)];
+  sweep->grad_ie.y *= limiter[(SWEEP_IE)];
+  sweep->grad_ie.z *= limiter[(SWEEP_IE)];
+  sweep->grad_ke.x *= limiter[(SWEEP_KE)];
+  sweep->grad_ke.y *= limiter[(SWEEP_KE)];
+  sweep->grad_ke.z *= limiter[(SWEEP_KE)];
+  sweep->grad_vx.x *= limiter[(SWEEP_VX)];
+  sweep->grad_vx.y *= limiter[(SWEEP_VX)];
+  sweep->grad_vx.z *= limiter[(SWEEP_VX)];
+  sweep->grad_vy.x *= limiter[(SWEEP_VY)];
+  sweep->grad_vy.y *= limiter[(SWEEP_VY)];
+  sweep->grad_vy.z *= limiter[(SWEEP_VY)];
+  sweep->grad_vz.x *= limiter[(SWEEP_VZ)];
+  sweep->grad_vz.y *= limiter[(SWEEP_VZ)];
+  sweep->grad_vz.z *= limiter[(SWEEP_VZ)];
+}
 
-  // Mass and energy are either flowing into or out of the subcell
-  if (is_outflux) {
-    subcell_mass_flux[(subcell_index)] += local_mass_flux;
-    subcell_ie_mass_flux[(subcell_index)] += local_ie_flux;
-    subcell_ke_mass_flux[(subcell_index)] += local_ke_flux;
-    subcell_momentum_flux_x[(subcell_index)] += local_x_momentum_flux;
-    subcell_momentum_flux_y[(subcell_index)] += local_y_momentum_flux;
-    subcell_momentum_flux_z[(subcell_index)] += local_z_momentum_flux;
-  } else {
-    subcell_mass_flux[(subcell_index)] -= local_mass_flux;
-    subcell_ie_mass_flux[(subcell_index)] -= local_ie_flux;
-    subcell_ke_mass_flux[(subcell_index)] -= local_ke_flux;
-    subcell_momentum_flux_x[(subcell_index)] -= local_x_momentum_flux;
-    subcell_momentum_flux_y[(subcell_index)] -= local_y_momentum_flux;
-    subcell_momentum_flux_z[(subcell_index)] -= local_z_momentum_flux;
+// Limits the gradients of a sweep subcell at a point in the subcell, recording
+// the point
+void limit_sweep_gradients(vec_t point, SweepSubcell* sweep, double* limiter) {
+  if (sweep->nlimit_points == MAX_SWEEP_LIMIT_POINTS) {
+    TERMINATE("The sweep subcell has more than %d limiting points.\n",
+              MAX_SWEEP_LIMIT_POINTS);
+  }
+  sweep->limit_points[(sweep->nlimit_points++)] = point;
+
+  limit_mass_gradients(
+      point, &sweep->c, sweep->density, sweep->ie_density, sweep->ke_density,
+      sweep->v.x, sweep->v.y, sweep->v.z, sweep->gmax[(SWEEP_M)],
+      sweep->gmin[(SWEEP_M)], sweep->gmax[(SWEEP_IE)], sweep->gmin[(SWEEP_IE)],
+      sweep->gmax[(SWEEP_KE)], sweep->gmin[(SWEEP_KE)],
+      sweep->gmax[(SWEEP_VX)], sweep->gmin[(SWEEP_VX)],
+      sweep->gmax[(SWEEP_VY)], sweep->gmin[(SWEEP_VY)],
+      sweep->gmax[(SWEEP_VZ)], sweep->gmin[(SWEEP_VZ)], &sweep->grad_m,
+      &sweep->grad_ie, &sweep->grad_ke, &sweep->grad_vx, &sweep->grad_vy,
+      &sweep->grad_vz, &limiter[(SWEEP_M)], &limiter[(SWEEP_IE)],
+      &limiter[(SWEEP_KE)], &limiter[(SWEEP_VX)], &limiter[(SWEEP_VY)],
+      &limiter[(SWEEP_VZ)]);
+}
+
+// Contributes the flux of the passive tracers through a swept edge region,
+// reconstructed in the sweep subcell that the mass was taken from. The swept
+// region, the sweep subcell, its least squares system and its limiting points
+// are all shared with the mass, so only the right hand sides, extrema and
+// limiters are found for each tracer, over the contiguous tracers of a subcell.
+void flux_sweep_tracers(const int ntracers, const int subcell_index,
+                        const int is_outflux, const double swept_edge_vol,
+                        const vec_t* swept_edge_c, const SweepSubcell* sweep,
+                        const double* subcell_volume,
+                        const double* subcell_centroids_x,
+                        const double* subcell_centroids_y,
+                        const double* subcell_centroids_z,
+                        const int* subcells_to_subcells_offsets,
+                        const int* subcells_to_subcells,
+                        const double* subcell_tracer_mass,
+                        double* subcell_tracer_flux) {
+
+  const int sweep_subcell_index = sweep->index;
+  const double sweep_subcell_vol = subcell_volume[(sweep_subcell_index)];
+  const double* sweep_tracer_mass =
+      &subcell_tracer_mass[(sweep_subcell_index * ntracers)];
+  const double sign = is_outflux ? 1.0 : -1.0;
+  double* tracer_flux = &subcell_tracer_flux[(subcell_index * ntracers)];
+
+  // The first order remap takes the tracers as constant across the subcell
+  if (sweep->piecewise_constant) {
+#pragma omp simd
+    for (int tt = 0; tt < ntracers; ++tt) {
+      tracer_flux[(tt)] += sign * swept_edge_vol *
+                           (sweep_tracer_mass[(tt)] / sweep_subcell_vol);
+    }
+    return;
+  }
+
+  double density[MAX_TRACERS];
+  double rhs_x[MAX_TRACERS];
+  double rhs_y[MAX_TRACERS];
+  double rhs_z[MAX_TRACERS];
+  double gmax[MAX_TRACERS];
+  double gmin[MAX_TRACERS];
+#pragma omp simd
+  for (int tt = 0; tt < ntracers; ++tt) {
+    density[(tt)] = sweep_tracer_mass[(tt)] / sweep_subcell_vol;
+    rhs_x[(tt)] = 0.0;
+    rhs_y[(tt)] = 0.0;
+    rhs_z[(tt)] = 0.0;
+    gmax[(tt)] = -DBL_MAX;
+    gmin[(tt)] = DBL_MAX;
+  }
+
+  const int sweep_subcell_to_subcells_off =
+      subcells_to_subcells_offsets[(sweep_subcell_index)];
+  const int nsubcell_neighbours =
+      subcells_to_subcells_offsets[(sweep_subcell_index + 1)] -
+      sweep_subcell_to_subcells_off;
+
+  for (int ss = 0; ss < nsubcell_neighbours; ++ss) {
+    const int sweep_neighbour_index =
+        subcells_to_subcells[(sweep_subcell_to_subcells_off + ss)];
+
+    // Ignore boundary neighbours
+    if (sweep_neighbour_index == -1) {
+      continue;
+    }
+
+    const double neighbour_vol = subcell_volume[(sweep_neighbour_index)];
+    const double ix =
+        (subcell_centroids_x[(sweep_neighbour_index)] - sweep->c.x) *
+        neighbour_vol;
+    const double iy =
+        (subcell_centroids_y[(sweep_neighbour_index)] - sweep->c.y) *
+        neighbour_vol;
+    const double iz =
+        (subcell_centroids_z[(sweep_neighbour_index)] - sweep->c.z) *
+        neighbour_vol;
+
+    const double* neighbour_tracer_mass =
+        &subcell_tracer_mass[(sweep_neighbour_index * ntracers)];
+#pragma omp simd
+    for (int tt = 0; tt < ntracers; ++tt) {
+      const double neighbour_density =
+          neighbour_tracer_mass[(tt)] / neighbour_vol;
+      const double dneighbour_density = neighbour_density - density[(tt)];
+      rhs_x[(tt)] += 2.0 * dneighbour_density * ix / neighbour_vol;
+      rhs_y[(tt)] += 2.0 * dneighbour_density * iy / neighbour_vol;
+      rhs_z[(tt)] += 2.0 * dneighbour_density * iz / neighbour_vol;
+      gmax[(tt)] = max(gmax[(tt)], neighbour_density);
+      gmin[(tt)] = min(gmin[(tt)], neighbour_density);
+    }
+  }
+
+  // The system was already solved, and counted, for the mass
+  double grad_x[MAX_TRACERS];
+  double grad_y[MAX_TRACERS];
+  double grad_z[MAX_TRACERS];
+  solve_sym_3x3_batch(1, 1, ntracers, sweep->coeff, rhs_x, rhs_y, rhs_z,
+                      grad_x, grad_y, grad_z, NULL);
+
+  // Limit the gradients at the points that the mass was limited at
+  double limiter[MAX_TRACERS];
+#pragma omp simd
+  for (int tt = 0; tt < ntracers; ++tt) {
+    limiter[(tt)] = 1.0;
+  }
+  for (int pp = 0; pp < sweep->nlimit_points; ++pp) {
+    const double dx = sweep->limit_points[(pp)].x - sweep->c.x;
+    const double dy = sweep->limit_points[(pp)].y - sweep->c.y;
+    const double dz = sweep->limit_points[(pp)].z - sweep->c.z;
+#pragma omp simd
+    for (int tt = 0; tt < ntracers; ++tt) {
+      const double dg = grad_x[(tt)] * dx + grad_y[(tt)] * dy +
+                        grad_z[(tt)] * dz;
+      double point_limiter = 1.0;
+      if (dg > 0.0) {
+        point_limiter = (gmax[(tt)] - density[(tt)]) / dg;
+      } else if (dg < 0.0) {
+        point_limiter = (gmin[(tt)] - density[(tt)]) / dg;
+      }
+      limiter[(tt)] = min(limiter[(tt)], max(point_limiter, 0.0));
+    }
+  }
+
+  // Evaluate the reconstructions at the centroid of the swept region
+  const double dx = swept_edge_c->x - sweep->c.x;
+  const double dy = swept_edge_c->y - sweep->c.y;
+  const double dz = swept_edge_c->z - sweep->c.z;
+#pragma omp simd
+  for (int tt = 0; tt < ntracers; ++tt) {
+    const double dg = grad_x[(tt)] * dx + grad_y[(tt)] * dy +
+                      grad_z[(tt)] * dz;
+    tracer_flux[(tt)] +=
+        sign * swept_edge_vol * (density[(tt)] + limiter[(tt)] * dg);
+  }
+}
+
+// Unpacks the gradients of a sweep subcell from the solutions of a batch
+void unpack_sweep_gradients(const int stride, const int mm,
+                            const double* grad_x, const double* grad_y,
+                            const double* grad_z, SweepSubcell* sweep) {
+
+  vec_t* grads[NSWEEP_QUANTITIES] = {&sweep->grad_m,  &sweep->grad_ie,
+                                     &sweep->grad_ke, &sweep->grad_vx,
+                                     &sweep->grad_vy, &sweep->grad_vz};
+  for (int qq = 0; qq < NSWEEP_QUANTITIES; ++qq) {
+    grads[(qq)]->x = grad_x[(qq * stride + mm)];
+    grads[(qq)]->y = grad_y[(qq * stride + mm)];
+    grads[(qq)]->z = grad_z[(qq * stride + mm)];
   }
 }
 
@@ -772,22 +1906,6 @@ void calc_volume(const int cell_to_faces_off, const int nfaces_by_cell,
   *vol = fabs(*vol);
 }
 
-// Stores the rezoned mesh specification as the original mesh. Until we
-// determine a reasonable rezoning algorithm, this makes us Eulerian
-void store_rezoned_mesh(const int nnodes, const double* nodes_x,
-                        const double* nodes_y, const double* nodes_z,
-                        double* rezoned_nodes_x, double* rezoned_nodes_y,
-                        double* rezoned_nodes_z) {
-
-// Store the rezoned nodes
-#pragma omp parallel for
-  for (int nn = 0; nn < nnodes; ++nn) {
-    rezoned_nodes_x[(nn)] = nodes_x[(nn)];
-    rezoned_nodes_y[(nn)] = nodes_y[(nn)];
-    rezoned_nodes_z[(nn)] = nodes_z[(nn)];
-  }
-}
-
 // Calculate the centroid
 void calc_centroid(const int nnodes, const double* nodes_x,
                    const double* nodes_y, const double* nodes_z,
@@ -804,33 +1922,6 @@ void calc_centroid(const int nnodes, const double* nodes_x,
   }
 }
 
-// Calculates the inverse of a 3x3 matrix, out-of-place
-void calc_3x3_inverse(vec_t (*a)[3], vec_t (*inv)[3]) {
-  // Calculate the determinant of the 3x3
-  const double det =
-      (*a)[0].x * ((*a)[1].y * (*a)[2].z - (*a)[1].z * (*a)[2].y) -
-      (*a)[0].y * ((*a)[1].x * (*a)[2].z - (*a)[1].z * (*a)[2].x) +
-      (*a)[0].z * ((*a)[1].x * (*a)[2].y - (*a)[1].y * (*a)[2].x);
-
-  // Check if the matrix is singular
-  if (det == 0.0) {
-    TERMINATE("singular coefficient matrix");
-  } else {
-    // Perform the simple and fast 3x3 matrix inverstion
-    (*inv)[0].x = ((*a)[1].y * (*a)[2].z - (*a)[1].z * (*a)[2].y) / det;
-    (*inv)[0].y = ((*a)[0].z * (*a)[2].y - (*a)[0].y * (*a)[2].z) / det;
-    (*inv)[0].z = ((*a)[0].y * (*a)[1].z - (*a)[0].z * (*a)[1].y) / det;
-
-    (*inv)[1].x = ((*a)[1].z * (*a)[2].x - (*a)[1].x * (*a)[2].z) / det;
-    (*inv)[1].y = ((*a)[0].x * (*a)[2].z - (*a)[0].z * (*a)[2].x) / det;
-    (*inv)[1].z = ((*a)[0].z * (*a)[1].x - (*a)[0].x * (*a)[1].z) / det;
-
-    (*inv)[2].x = ((*a)[1].x * (*a)[2].y - (*a)[1].y * (*a)[2].x) / det;
-    (*inv)[2].y = ((*a)[0].y * (*a)[2].x - (*a)[0].x * (*a)[2].y) / det;
-    (*inv)[2].z = ((*a)[0].x * (*a)[1].y - (*a)[0].y * (*a)[1].x) / det;
-  }
-}
-
 // Calculates the local limiter for a cell
 double calc_cell_limiter(const double rho, const double gmax, const double gmin,
                          vec_t* grad, const double node_x, const double node_y,
@@ -874,18 +1965,15 @@ double apply_cell_limiter(const int nnodes_by_cell, const int cell_to_nodes_off,
   return limiter;
 }
 
-// Applies the mesh rezoning strategy. This is a pure Eulerian strategy.
-void apply_mesh_rezoning(const int nnodes, const double* rezoned_nodes_x,
-                         const double* rezoned_nodes_y,
-                         const double* rezoned_nodes_z, double* nodes_x,
-                         double* nodes_y, double* nodes_z) {
-
-// Apply the rezoned mesh into the main mesh
-#pragma omp parallel for
-  for (int nn = 0; nn < nnodes; ++nn) {
-    nodes_x[(nn)] = rezoned_nodes_x[(nn)];
-    nodes_y[(nn)] = rezoned_nodes_y[(nn)];
-    nodes_z[(nn)] = rezoned_nodes_z[(nn)];
+// Applies the mesh rezoning strategy. This is a pure Eulerian strategy, where
+// the rezoned mesh is the initial mesh, shared read-only with the node buffer
+// that the Lagrangian step rotated out, so it is restored by rotation
+void apply_mesh_rezoning(const double* rezoned_nodes_x,
+                         UnstructuredMesh* umesh) {
+  rotate_nodes(umesh);
+
+  if (umesh->nodes_x0 != rezoned_nodes_x) {
+    TERMINATE("The rezoned mesh is not in the other node buffer.\n");
   }
 }
 
@@ -0,0 +1,582 @@
+#include "../../comms.h"
+#include "../../shared.h"
+#include "hale.h"
+#include <float.h>
+#include <math.h>
+
+// Finds the subcell of a cell that surrounds one of its nodes
+static inline int find_cell_subcell(const int cell_to_nodes_off,
+                                    const int nnodes_by_cell,
+                                    const int* cells_to_nodes,
+                                    const int node_index) {
+  int nn;
+  for (nn = 0; nn < nnodes_by_cell; ++nn) {
+    if (cells_to_nodes[(cell_to_nodes_off + nn)] == node_index) {
+      break;
+    }
+  }
+  return cell_to_nodes_off + nn;
+}
+
+// Reconstructs the density and energy densities of every cell about its
+// centroid, from the totals of its subcells, so that the cell remap is as
+// conservative as the gathered subcells. The gradients are fitted by least
+// squares to the neighbours across the faces, and limited at the nodes to the
+// extrema of the neighbourhood, while the first order remap leaves them zero.
+void reconstruct_cell_quantities(
+    const int ncells, const int* cells_to_nodes_offsets,
+    const int* cells_to_nodes, const int* cells_to_faces_offsets,
+    const int* cells_to_faces, const int* faces_to_cells0,
+    const int* faces_to_cells1, const double* nodes_x, const double* nodes_y,
+    const double* nodes_z, const double* cell_volume,
+    const double* subcell_mass, const double* subcell_ie_mass,
+    const double* subcell_ke_mass, const int remap_order,
+    double* cell_reconstruction, SolveCounts* solve_counts) {
+
+  OMP_FOR()
+  for (int cc = 0; cc < ncells; ++cc) {
+    const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
+    const int nnodes_by_cell =
+        cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
+
+    double total[NCELL_REMAP_QUANTITIES] = {0.0, 0.0, 0.0};
+    for (int nn = 0; nn < nnodes_by_cell; ++nn) {
+      const int subcell_index = cell_to_nodes_off + nn;
+      total[(CELL_REMAP_M)] += subcell_mass[(subcell_index)];
+      total[(CELL_REMAP_IE)] += subcell_ie_mass[(subcell_index)];
+      total[(CELL_REMAP_KE)] += subcell_ke_mass[(subcell_index)];
+    }
+
+    vec_t cell_c = {0.0, 0.0, 0.0};
+    calc_centroid(nnodes_by_cell, nodes_x, nodes_y, nodes_z, cells_to_nodes,
+                  cell_to_nodes_off, &cell_c);
+
+    for (int qq = 0; qq < NCELL_REMAP_QUANTITIES; ++qq) {
+      CELL_RECONSTRUCTION(cell_reconstruction, cc, 4 * qq) =
+          total[(qq)] / cell_volume[(cc)];
+      for (int dd = 0; dd < 3; ++dd) {
+        CELL_RECONSTRUCTION(cell_reconstruction, cc, 4 * qq + 1 + dd) = 0.0;
+      }
+    }
+    CELL_RECONSTRUCTION(cell_reconstruction, cc, CELL_RECONSTRUCTION_CENTROID) =
+        cell_c.x;
+    CELL_RECONSTRUCTION(cell_reconstruction, cc,
+                        CELL_RECONSTRUCTION_CENTROID + 1) = cell_c.y;
+    CELL_RECONSTRUCTION(cell_reconstruction, cc,
+                        CELL_RECONSTRUCTION_CENTROID + 2) = cell_c.z;
+    CELL_RECONSTRUCTION(cell_reconstruction, cc, CELL_RECONSTRUCTION_VOLUME) =
+        cell_volume[(cc)];
+  }
+  OMP_BARRIER();
+
+  if (remap_order == FIRST_ORDER_REMAP) {
+    return;
+  }
+
+  double nill_conditioned = 0.0;
+  double nsingular = 0.0;
+
+  OMP_FOR_REDUCTION(reduction(+ : nill_conditioned, nsingular))
+  for (int cc = 0; cc < ncells; ++cc) {
+    const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
+    const int nnodes_by_cell =
+        cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
+    const int cell_to_faces_off = cells_to_faces_offsets[(cc)];
+    const int nfaces_by_cell =
+        cells_to_faces_offsets[(cc + 1)] - cell_to_faces_off;
+
+    const vec_t cell_c = {
+        CELL_RECONSTRUCTION(cell_reconstruction, cc,
+                            CELL_RECONSTRUCTION_CENTROID),
+        CELL_RECONSTRUCTION(cell_reconstruction, cc,
+                            CELL_RECONSTRUCTION_CENTROID + 1),
+        CELL_RECONSTRUCTION(cell_reconstruction, cc,
+                            CELL_RECONSTRUCTION_CENTROID + 2)};
+
+    double value[NCELL_REMAP_QUANTITIES];
+    double gmax[NCELL_REMAP_QUANTITIES];
+    double gmin[NCELL_REMAP_QUANTITIES];
+    double rhs_x[NCELL_REMAP_QUANTITIES];
+    double rhs_y[NCELL_REMAP_QUANTITIES];
+    double rhs_z[NCELL_REMAP_QUANTITIES];
+    for (int qq = 0; qq < NCELL_REMAP_QUANTITIES; ++qq) {
+      value[(qq)] = CELL_RECONSTRUCTION(cell_reconstruction, cc, 4 * qq);
+      gmax[(qq)] = -DBL_MAX;
+      gmin[(qq)] = DBL_MAX;
+      rhs_x[(qq)] = 0.0;
+      rhs_y[(qq)] = 0.0;
+      rhs_z[(qq)] = 0.0;
+    }
+
+    double coeff[NSYM_3X3] = {0.0};
+    for (int ff = 0; ff < nfaces_by_cell; ++ff) {
+      const int face_index = cells_to_faces[(cell_to_faces_off + ff)];
+      const int neighbour_index = (faces_to_cells0[(face_index)] == cc)
+                                      ? faces_to_cells1[(face_index)]
+                                      : faces_to_cells0[(face_index)];
+
+      // Check if boundary face
+      if (neighbour_index == -1) {
+        continue;
+      }
+
+      vec_t dist = {
+          CELL_RECONSTRUCTION(cell_reconstruction, neighbour_index,
+                              CELL_RECONSTRUCTION_CENTROID) -
+              cell_c.x,
+          CELL_RECONSTRUCTION(cell_reconstruction, neighbour_index,
+                              CELL_RECONSTRUCTION_CENTROID + 1) -
+              cell_c.y,
+          CELL_RECONSTRUCTION(cell_reconstruction, neighbour_index,
+                              CELL_RECONSTRUCTION_CENTROID + 2) -
+              cell_c.z};
+
+      // Store the neighbouring cell's contribution to the coefficients
+      const double neighbour_vol = CELL_RECONSTRUCTION(
+          cell_reconstruction, neighbour_index, CELL_RECONSTRUCTION_VOLUME);
+      const double vol2 = neighbour_vol * neighbour_vol;
+      coeff[(SYM_XX)] += 2.0 * (dist.x * dist.x) / vol2;
+      coeff[(SYM_XY)] += 2.0 * (dist.x * dist.y) / vol2;
+      coeff[(SYM_XZ)] += 2.0 * (dist.x * dist.z) / vol2;
+      coeff[(SYM_YY)] += 2.0 * (dist.y * dist.y) / vol2;
+      coeff[(SYM_YZ)] += 2.0 * (dist.y * dist.z) / vol2;
+      coeff[(SYM_ZZ)] += 2.0 * (dist.z * dist.z) / vol2;
+
+      for (int qq = 0; qq < NCELL_REMAP_QUANTITIES; ++qq) {
+        const double neighbour_value =
+            CELL_RECONSTRUCTION(cell_reconstruction, neighbour_index, 4 * qq);
+        const double dvalue = neighbour_value - value[(qq)];
+        rhs_x[(qq)] += 2.0 * (dist.x * dvalue) / neighbour_vol;
+        rhs_y[(qq)] += 2.0 * (dist.y * dvalue) / neighbour_vol;
+        rhs_z[(qq)] += 2.0 * (dist.z * dvalue) / neighbour_vol;
+        gmax[(qq)] = max(gmax[(qq)], neighbour_value);
+        gmin[(qq)] = min(gmin[(qq)], neighbour_value);
+      }
+    }
+
+    // Solve for the gradients of all of the quantities at once
+    double grad_x[NCELL_REMAP_QUANTITIES];
+    double grad_y[NCELL_REMAP_QUANTITIES];
+    double grad_z[NCELL_REMAP_QUANTITIES];
+    count_solve_state(solve_sym_3x3_batch(1, 1, NCELL_REMAP_QUANTITIES, coeff,
+                                          rhs_x, rhs_y, rhs_z, grad_x, grad_y,
+                                          grad_z, NULL),
+                      &nill_conditioned, &nsingular);
+
+    for (int qq = 0; qq < NCELL_REMAP_QUANTITIES; ++qq) {
+      vec_t grad = {grad_x[(qq)], grad_y[(qq)], grad_z[(qq)]};
+      apply_cell_limiter(nnodes_by_cell, cell_to_nodes_off, cells_to_nodes,
+                         &grad, &cell_c, nodes_x, nodes_y, nodes_z,
+                         value[(qq)], gmax[(qq)], gmin[(qq)]);
+      CELL_RECONSTRUCTION(cell_reconstruction, cc, 4 * qq + 1) = grad.x;
+      CELL_RECONSTRUCTION(cell_reconstruction, cc, 4 * qq + 2) = grad.y;
+      CELL_RECONSTRUCTION(cell_reconstruction, cc, 4 * qq + 3) = grad.z;
+    }
+  }
+  TEAM_SUM(&nill_conditioned, &nsingular);
+
+  OMP_MASTER()
+  {
+    solve_counts->ncalls++;
+    solve_counts->nill_conditioned += nill_conditioned;
+    solve_counts->nsingular += nsingular;
+  }
+}
+
+// Advects mass and energy through the faces of the cells, and the nodal mass
+// and momentum through the faces of the dual mesh. The mass and energy of a
+// cell only change through its faces, and the mass and momentum of a node
+// only through the faces between its subcells and those of the other nodes of
+// each cell, so the fluxes are reduced into the subcells that the gather and
+// scatter already work with, taking 18 swept regions a cell rather than 48.
+void perform_cell_advection(
+    const int ncells, const int* cells_to_nodes_offsets,
+    const int* cells_to_nodes, const int* cells_to_faces_offsets,
+    const int* cells_to_faces, const int* faces_to_nodes_offsets,
+    const int* faces_to_nodes, const int* faces_to_cells0,
+    const int* faces_to_cells1, const int* faces_cclockwise_cell,
+    const int* subcells_to_faces_offsets, const int* subcells_to_faces,
+    const double* nodes_x, const double* nodes_y, const double* nodes_z,
+    const double* rezoned_nodes_x, const double* rezoned_nodes_y,
+    const double* rezoned_nodes_z, const double* rezoned_cell_centroids_x,
+    const double* rezoned_cell_centroids_y,
+    const double* rezoned_cell_centroids_z,
+    const double* rezoned_face_centroids_x,
+    const double* rezoned_face_centroids_y,
+    const double* rezoned_face_centroids_z, const double* subcell_centroids_x,
+    const double* subcell_centroids_y, const double* subcell_centroids_z,
+    const double* nodal_mass, const double* nodal_volumes,
+    const double* velocity_x, const double* velocity_y,
+    const double* velocity_z, const double* cell_reconstruction,
+    double* subcell_mass_flux, double* subcell_ie_mass_flux,
+    double* subcell_ke_mass_flux, double* subcell_momentum_flux_x,
+    double* subcell_momentum_flux_y, double* subcell_momentum_flux_z,
+    double* face_flux, const int ntracers, const double* subcell_tracer_mass,
+    double* subcell_tracer_flux) {
+
+  // The faces of every swept region, in terms of its 8 vertices
+  const int swept_edge_to_faces[] = {0, 1, 2, 3, 4, 5};
+  const int swept_edge_faces_to_nodes[] = {0, 1, 2, 3, 4, 5, 6, 7,
+                                           0, 3, 7, 4, 7, 6, 2, 3,
+                                           1, 5, 6, 2, 0, 4, 5, 1};
+  const int swept_edge_faces_to_nodes_offsets[] = {0, 4, 8, 12, 16, 20, 24};
+
+  // Boundary cells skip their external fluxes, and small swept volumes return
+  // early, so the cost of a cell varies
+  static KernelSchedule schedule = {"perform_cell_advection",
+                                    SCHEDULE_DYNAMIC};
+  begin_kernel_schedule(&schedule, ncells);
+
+  OMP_FOR_SCHEDULED()
+  for (int cc = 0; cc < ncells; ++cc) {
+    const double cell_start = start_entity_cost(&schedule);
+    const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
+    const int nnodes_by_cell =
+        cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
+    const int cell_to_faces_off = cells_to_faces_offsets[(cc)];
+    const int nfaces_by_cell =
+        cells_to_faces_offsets[(cc + 1)] - cell_to_faces_off;
+
+    vec_t cell_c = {CELL_RECONSTRUCTION(cell_reconstruction, cc,
+                                        CELL_RECONSTRUCTION_CENTROID),
+                    CELL_RECONSTRUCTION(cell_reconstruction, cc,
+                                        CELL_RECONSTRUCTION_CENTROID + 1),
+                    CELL_RECONSTRUCTION(cell_reconstruction, cc,
+                                        CELL_RECONSTRUCTION_CENTROID + 2)};
+    vec_t rz_cell_c = {rezoned_cell_centroids_x[(cc)],
+                       rezoned_cell_centroids_y[(cc)],
+                       rezoned_cell_centroids_z[(cc)]};
+
+    /* CELL FACES */
+
+    for (int ff = 0; ff < nfaces_by_cell; ++ff) {
+      const int face_index = cells_to_faces[(cell_to_faces_off + ff)];
+      const int face_to_nodes_off = faces_to_nodes_offsets[(face_index)];
+      const int neighbour_cc = (faces_to_cells0[(face_index)] == cc)
+                                   ? faces_to_cells1[(face_index)]
+                                   : faces_to_cells0[(face_index)];
+
+      // We explicitly disallow flux on the boundary
+      if (neighbour_cc == -1) {
+        continue;
+      }
+
+      // The face sweeps out a region between the old and rezoned meshes
+      double fnodes_x[2 * NNODES_BY_HEX_FACE];
+      double fnodes_y[2 * NNODES_BY_HEX_FACE];
+      double fnodes_z[2 * NNODES_BY_HEX_FACE];
+      for (int nn = 0; nn < NNODES_BY_HEX_FACE; ++nn) {
+        const int node_index = faces_to_nodes[(face_to_nodes_off + nn)];
+        fnodes_x[(nn)] = nodes_x[(node_index)];
+        fnodes_y[(nn)] = nodes_y[(node_index)];
+        fnodes_z[(nn)] = nodes_z[(node_index)];
+        fnodes_x[(NNODES_BY_HEX_FACE + nn)] = rezoned_nodes_x[(node_index)];
+        fnodes_y[(NNODES_BY_HEX_FACE + nn)] = rezoned_nodes_y[(node_index)];
+        fnodes_z[(NNODES_BY_HEX_FACE + nn)] = rezoned_nodes_z[(node_index)];
+      }
+
+      flux_cell_face(cc, neighbour_cc, face_index, &cell_c, fnodes_x, fnodes_y,
+                     fnodes_z, swept_edge_to_faces, swept_edge_faces_to_nodes,
+                     swept_edge_faces_to_nodes_offsets, cells_to_nodes_offsets,
+                     cells_to_nodes, faces_to_nodes_offsets, faces_to_nodes,
+                     faces_cclockwise_cell, cell_reconstruction,
+                     subcell_mass_flux, subcell_ie_mass_flux,
+                     subcell_ke_mass_flux, face_flux, ntracers,
+                     subcell_tracer_mass, subcell_tracer_flux);
+    }
+
+    /* DUAL FACES */
+
+    // Each dual face crosses an edge of the cell, and is swept once from the
+    // end of the edge with the lower node index
+    for (int nn = 0; nn < nnodes_by_cell; ++nn) {
+      const int node_index = cells_to_nodes[(cell_to_nodes_off + nn)];
+      const int subcell_index = cell_to_nodes_off + nn;
+      const int subcell_to_faces_off =
+          subcells_to_faces_offsets[(subcell_index)];
+      const int nfaces_by_subcell =
+          subcells_to_faces_offsets[(subcell_index + 1)] - subcell_to_faces_off;
+
+      for (int ff = 0; ff < nfaces_by_subcell; ++ff) {
+        const int r_face_off = (ff == nfaces_by_subcell - 1) ? 0 : ff + 1;
+        const int lface_off = (ff == 0) ? nfaces_by_subcell - 1 : ff - 1;
+        const int r_face_index =
+            subcells_to_faces[(subcell_to_faces_off + r_face_off)];
+        const int lface_index =
+            subcells_to_faces[(subcell_to_faces_off + lface_off)];
+        const int r_face_to_nodes_off = faces_to_nodes_offsets[(r_face_index)];
+        const int lface_to_nodes_off = faces_to_nodes_offsets[(lface_index)];
+        const int nnodes_by_r_face =
+            faces_to_nodes_offsets[(r_face_index + 1)] - r_face_to_nodes_off;
+        const int nnodes_by_lface =
+            faces_to_nodes_offsets[(lface_index + 1)] - lface_to_nodes_off;
+        const int r_face_clockwise =
+            (faces_cclockwise_cell[(r_face_index)] != cc);
+
+        // Determine the position of the node in the face list of nodes
+        int nn2;
+        for (nn2 = 0; nn2 < nnodes_by_r_face; ++nn2) {
+          if (faces_to_nodes[(r_face_to_nodes_off + nn2)] == node_index) {
+            break;
+          }
+        }
+
+        const int r_face_next_node =
+            (nn2 == nnodes_by_r_face - 1) ? 0 : nn2 + 1;
+        const int r_face_prev_node =
+            (nn2 == 0) ? nnodes_by_r_face - 1 : nn2 - 1;
+        const int r_face_rnode_off =
+            (r_face_clockwise ? r_face_prev_node : r_face_next_node);
+        const int r_face_rnode_index =
+            faces_to_nodes[(r_face_to_nodes_off + r_face_rnode_off)];
+        if (r_face_rnode_index < node_index) {
+          continue;
+        }
+
+        vec_t r_iface_c = {0.0, 0.0, 0.0};
+        calc_centroid(nnodes_by_r_face, nodes_x, nodes_y, nodes_z,
+                      faces_to_nodes, r_face_to_nodes_off, &r_iface_c);
+        vec_t l_iface_c = {0.0, 0.0, 0.0};
+        calc_centroid(nnodes_by_lface, nodes_x, nodes_y, nodes_z,
+                      faces_to_nodes, lface_to_nodes_off, &l_iface_c);
+        vec_t rz_r_iface_c = {rezoned_face_centroids_x[(r_face_index)],
+                              rezoned_face_centroids_y[(r_face_index)],
+                              rezoned_face_centroids_z[(r_face_index)]};
+        vec_t rz_l_iface_c = {rezoned_face_centroids_x[(lface_index)],
+                              rezoned_face_centroids_y[(lface_index)],
+                              rezoned_face_centroids_z[(lface_index)]};
+
+        double inodes_x[2 * NNODES_BY_SUBCELL_FACE] = {
+            0.5 * (nodes_x[(node_index)] + nodes_x[(r_face_rnode_index)]),
+            r_iface_c.x, cell_c.x, l_iface_c.x,
+            0.5 * (rezoned_nodes_x[(node_index)] +
+                   rezoned_nodes_x[(r_face_rnode_index)]),
+            rz_r_iface_c.x, rz_cell_c.x, rz_l_iface_c.x};
+        double inodes_y[2 * NNODES_BY_SUBCELL_FACE] = {
+            0.5 * (nodes_y[(node_index)] + nodes_y[(r_face_rnode_index)]),
+            r_iface_c.y, cell_c.y, l_iface_c.y,
+            0.5 * (rezoned_nodes_y[(node_index)] +
+                   rezoned_nodes_y[(r_face_rnode_index)]),
+            rz_r_iface_c.y, rz_cell_c.y, rz_l_iface_c.y};
+        double inodes_z[2 * NNODES_BY_SUBCELL_FACE] = {
+            0.5 * (nodes_z[(node_index)] + nodes_z[(r_face_rnode_index)]),
+            r_iface_c.z, cell_c.z, l_iface_c.z,
+            0.5 * (rezoned_nodes_z[(node_index)] +
+                   rezoned_nodes_z[(r_face_rnode_index)]),
+            rz_r_iface_c.z, rz_cell_c.z, rz_l_iface_c.z};
+
+        const int r_subcell_index =
+            find_cell_subcell(cell_to_nodes_off, nnodes_by_cell,
+                              cells_to_nodes, r_face_rnode_index);
+        flux_dual_face(subcell_index, r_subcell_index, node_index,
+                       r_face_rnode_index, inodes_x, inodes_y, inodes_z,
+                       swept_edge_to_faces, swept_edge_faces_to_nodes,
+                       swept_edge_faces_to_nodes_offsets, subcell_centroids_x,
+                       subcell_centroids_y, subcell_centroids_z, nodal_mass,
+                       nodal_volumes, velocity_x, velocity_y, velocity_z,
+                       subcell_mass_flux, subcell_momentum_flux_x,
+                       subcell_momentum_flux_y, subcell_momentum_flux_z);
+      }
+    }
+
+    record_entity_cost(&schedule, cc, cell_start);
+  }
+  OMP_BARRIER();
+  end_kernel_schedule(&schedule);
+}
+
+// Contributes the mass, energy and tracer flux through a face of a cell, from
+// the reconstruction of the upwind cell. The flux is shared equally between
+// the subcells of the cell on the face, which all surround nodes of the face,
+// so it leaves the nodal masses unchanged.
+void flux_cell_face(
+    const int cc, const int neighbour_cc, const int face_index,
+    const vec_t* cell_c, const double* se_nodes_x, const double* se_nodes_y,
+    const double* se_nodes_z, const int* swept_edge_to_faces,
+    const int* swept_edge_faces_to_nodes,
+    const int* swept_edge_faces_to_nodes_offsets,
+    const int* cells_to_nodes_offsets, const int* cells_to_nodes,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const int* faces_cclockwise_cell, const double* cell_reconstruction,
+    double* subcell_mass_flux, double* subcell_ie_mass_flux,
+    double* subcell_ke_mass_flux, double* face_flux, const int ntracers,
+    const double* subcell_tracer_mass, double* subcell_tracer_flux) {
+
+  // Get the centroids for the swept region and faces
+  vec_t face_c = {0.0, 0.0, 0.0};
+  vec_t rz_face_c = {0.0, 0.0, 0.0};
+  vec_t swept_c = {0.0, 0.0, 0.0};
+  calc_centroid(NNODES_BY_HEX_FACE, se_nodes_x, se_nodes_y, se_nodes_z,
+                swept_edge_faces_to_nodes, 0, &face_c);
+  calc_centroid(NNODES_BY_HEX_FACE, se_nodes_x, se_nodes_y, se_nodes_z,
+                swept_edge_faces_to_nodes,
+                swept_edge_faces_to_nodes_offsets[(1)], &rz_face_c);
+  calc_centroid(2 * NNODES_BY_HEX_FACE, se_nodes_x, se_nodes_y, se_nodes_z,
+                swept_edge_faces_to_nodes, 0, &swept_c);
+
+  double swept_vol = 0.0;
+  calc_volume(0, 2 + NNODES_BY_HEX_FACE, swept_edge_to_faces,
+              swept_edge_faces_to_nodes, swept_edge_faces_to_nodes_offsets,
+              se_nodes_x, se_nodes_y, se_nodes_z, &swept_c, &swept_vol);
+
+  // Ignore the special case of an empty swept region
+  if (swept_vol < EPS) {
+    return;
+  }
+
+  vec_t ab = {rz_face_c.x - face_c.x, rz_face_c.y - face_c.y,
+              rz_face_c.z - face_c.z};
+  vec_t ac = {cell_c->x - face_c.x, cell_c->y - face_c.y,
+              cell_c->z - face_c.z};
+  const int is_outflux = (ab.x * ac.x + ab.y * ac.y + ab.z * ac.z > 0.0);
+
+  // The swept region takes its mass and energy from the upwind cell
+  const int donor_cc = (is_outflux ? cc : neighbour_cc);
+  const double dx =
+      swept_c.x - CELL_RECONSTRUCTION(cell_reconstruction, donor_cc,
+                                      CELL_RECONSTRUCTION_CENTROID);
+  const double dy =
+      swept_c.y - CELL_RECONSTRUCTION(cell_reconstruction, donor_cc,
+                                      CELL_RECONSTRUCTION_CENTROID + 1);
+  const double dz =
+      swept_c.z - CELL_RECONSTRUCTION(cell_reconstruction, donor_cc,
+                                      CELL_RECONSTRUCTION_CENTROID + 2);
+
+  double flux[NCELL_REMAP_QUANTITIES];
+  for (int qq = 0; qq < NCELL_REMAP_QUANTITIES; ++qq) {
+    flux[(qq)] =
+        swept_vol *
+        (CELL_RECONSTRUCTION(cell_reconstruction, donor_cc, 4 * qq) +
+         CELL_RECONSTRUCTION(cell_reconstruction, donor_cc, 4 * qq + 1) * dx +
+         CELL_RECONSTRUCTION(cell_reconstruction, donor_cc, 4 * qq + 2) * dy +
+         CELL_RECONSTRUCTION(cell_reconstruction, donor_cc, 4 * qq + 3) * dz);
+  }
+
+  // The tracers are constant across the upwind cell
+  double tracer_flux[MAX_TRACERS];
+  if (ntracers) {
+    const int donor_to_nodes_off = cells_to_nodes_offsets[(donor_cc)];
+    const int nnodes_by_donor =
+        cells_to_nodes_offsets[(donor_cc + 1)] - donor_to_nodes_off;
+    const double donor_vol = CELL_RECONSTRUCTION(
+        cell_reconstruction, donor_cc, CELL_RECONSTRUCTION_VOLUME);
+    for (int tt = 0; tt < ntracers; ++tt) {
+      tracer_flux[(tt)] = 0.0;
+    }
+    for (int nn = 0; nn < nnodes_by_donor; ++nn) {
+      const double* tracer_mass =
+          &subcell_tracer_mass[((donor_to_nodes_off + nn) * ntracers)];
+#pragma omp simd
+      for (int tt = 0; tt < ntracers; ++tt) {
+        tracer_flux[(tt)] += tracer_mass[(tt)];
+      }
+    }
+    for (int tt = 0; tt < ntracers; ++tt) {
+      tracer_flux[(tt)] *= swept_vol / donor_vol;
+    }
+  }
+
+  // The flux is shared between the subcells on the face
+  const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
+  const int nnodes_by_cell =
+      cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
+  const int face_to_nodes_off = faces_to_nodes_offsets[(face_index)];
+  const int nnodes_by_face =
+      faces_to_nodes_offsets[(face_index + 1)] - face_to_nodes_off;
+  const double share = (is_outflux ? 1.0 : -1.0) / nnodes_by_face;
+  for (int nn = 0; nn < nnodes_by_face; ++nn) {
+    const int subcell_index = find_cell_subcell(
+        cell_to_nodes_off, nnodes_by_cell, cells_to_nodes,
+        faces_to_nodes[(face_to_nodes_off + nn)]);
+    subcell_mass_flux[(subcell_index)] += share * flux[(CELL_REMAP_M)];
+    subcell_ie_mass_flux[(subcell_index)] += share * flux[(CELL_REMAP_IE)];
+    subcell_ke_mass_flux[(subcell_index)] += share * flux[(CELL_REMAP_KE)];
+
+    if (ntracers) {
+      double* subcell_tracers =
+          &subcell_tracer_flux[(subcell_index * ntracers)];
+#pragma omp simd
+      for (int tt = 0; tt < ntracers; ++tt) {
+        subcell_tracers[(tt)] += share * tracer_flux[(tt)];
+      }
+    }
+  }
+
+  // The materials are advected with the fluxes that leave the cell
+  if (face_flux && is_outflux) {
+    const int side = (faces_cclockwise_cell[(face_index)] != cc);
+    FACE_FLUX(face_flux, face_index, side, FACE_VOLUME_FLUX) += swept_vol;
+    FACE_FLUX(face_flux, face_index, side, FACE_MASS_FLUX) +=
+        flux[(CELL_REMAP_M)];
+    FACE_FLUX(face_flux, face_index, side, FACE_IE_FLUX) +=
+        flux[(CELL_REMAP_IE)];
+  }
+}
+
+// Contributes the mass and momentum flux through a face of the dual mesh,
+// between the subcells of the two nodes of an edge of a cell. The nodes are
+// constant across their control volumes, and the flux leaves one subcell for
+// the other, so it leaves the masses and energies of the cells unchanged.
+void flux_dual_face(
+    const int subcell_index, const int r_subcell_index, const int node_index,
+    const int r_node_index, const double* se_nodes_x, const double* se_nodes_y,
+    const double* se_nodes_z, const int* swept_edge_to_faces,
+    const int* swept_edge_faces_to_nodes,
+    const int* swept_edge_faces_to_nodes_offsets,
+    const double* subcell_centroids_x, const double* subcell_centroids_y,
+    const double* subcell_centroids_z, const double* nodal_mass,
+    const double* nodal_volumes, const double* velocity_x,
+    const double* velocity_y, const double* velocity_z,
+    double* subcell_mass_flux, double* subcell_momentum_flux_x,
+    double* subcell_momentum_flux_y, double* subcell_momentum_flux_z) {
+
+  // Get the centroids for the swept region and faces
+  vec_t face_c = {0.0, 0.0, 0.0};
+  vec_t rz_face_c = {0.0, 0.0, 0.0};
+  vec_t swept_c = {0.0, 0.0, 0.0};
+  calc_centroid(NNODES_BY_SUBCELL_FACE, se_nodes_x, se_nodes_y, se_nodes_z,
+                swept_edge_faces_to_nodes, 0, &face_c);
+  calc_centroid(NNODES_BY_SUBCELL_FACE, se_nodes_x, se_nodes_y, se_nodes_z,
+                swept_edge_faces_to_nodes,
+                swept_edge_faces_to_nodes_offsets[(1)], &rz_face_c);
+  calc_centroid(2 * NNODES_BY_SUBCELL_FACE, se_nodes_x, se_nodes_y, se_nodes_z,
+                swept_edge_faces_to_nodes, 0, &swept_c);
+
+  double swept_vol = 0.0;
+  calc_volume(0, 2 + NNODES_BY_SUBCELL_FACE, swept_edge_to_faces,
+              swept_edge_faces_to_nodes, swept_edge_faces_to_nodes_offsets,
+              se_nodes_x, se_nodes_y, se_nodes_z, &swept_c, &swept_vol);
+
+  // Ignore the special case of an empty swept region
+  if (swept_vol < EPS) {
+    return;
+  }
+
+  vec_t ab = {rz_face_c.x - face_c.x, rz_face_c.y - face_c.y,
+              rz_face_c.z - face_c.z};
+  vec_t ac = {subcell_centroids_x[(subcell_index)] - face_c.x,
+              subcell_centroids_y[(subcell_index)] - face_c.y,
+              subcell_centroids_z[(subcell_index)] - face_c.z};
+  const int is_outflux = (ab.x * ac.x + ab.y * ac.y + ab.z * ac.z > 0.0);
+
+  // The swept region takes its mass and momentum from the upwind node
+  const int donor_index = (is_outflux ? node_index : r_node_index);
+  const double mass_flux =
+      swept_vol * nodal_mass[(donor_index)] / nodal_volumes[(donor_index)];
+  const double sign = (is_outflux ? 1.0 : -1.0);
+
+  subcell_mass_flux[(subcell_index)] += sign * mass_flux;
+  subcell_momentum_flux_x[(subcell_index)] +=
+      sign * mass_flux * velocity_x[(donor_index)];
+  subcell_momentum_flux_y[(subcell_index)] +=
+      sign * mass_flux * velocity_y[(donor_index)];
+  subcell_momentum_flux_z[(subcell_index)] +=
+      sign * mass_flux * velocity_z[(donor_index)];
+  subcell_mass_flux[(r_subcell_index)] -= sign * mass_flux;
+  subcell_momentum_flux_x[(r_subcell_index)] -=
+      sign * mass_flux * velocity_x[(donor_index)];
+  subcell_momentum_flux_y[(r_subcell_index)] -=
+      sign * mass_flux * velocity_y[(donor_index)];
+  subcell_momentum_flux_z[(r_subcell_index)] -=
+      sign * mass_flux * velocity_z[(donor_index)];
+}
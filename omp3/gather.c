@@ -17,7 +17,8 @@ void gather_subcell_mass_and_energy(
     double* subcell_centroids_z, int* faces_to_cells0, int* faces_to_cells1,
     int* cells_to_faces_offsets, int* cells_to_faces, int* cells_to_nodes,
     int* nodes_to_cells_offsets, int* nodes_to_cells, double* initial_mass,
-    double* initial_ie_mass, double* initial_ke_mass);
+    double* initial_ie_mass, double* initial_ke_mass,
+    SolveCounts* solve_counts);
 
 // Gathers the momentum into the subcells
 void gather_subcell_momentum(
@@ -31,7 +32,51 @@ void gather_subcell_momentum(
     double* subcell_centroids_y, double* subcell_centroids_z,
     int* nodes_to_cells_offsets, int* cells_to_nodes_offsets,
     int* cells_to_nodes, int* nodes_to_nodes_offsets, int* nodes_to_nodes,
-    vec_t* initial_momentum);
+    vec_t* initial_momentum, SolveCounts* solve_counts);
+
+// Gathers the momentum into the subcells, with the least squares systems of
+// each slice of the SELL-C-sigma node adjacency assembled and solved together
+void gather_subcell_momentum_sell(
+    const SellAdjacency* nodes_to_nodes_sell, const double* nodal_volumes,
+    const double* nodal_mass, int* nodes_to_cells, const double* nodes_x,
+    const double* nodes_y, const double* nodes_z, double* velocity_x,
+    double* velocity_y, double* velocity_z, double* subcell_volume,
+    double* cell_centroids_x, double* cell_centroids_y,
+    double* cell_centroids_z, double* subcell_momentum_x,
+    double* subcell_momentum_y, double* subcell_momentum_z,
+    double* subcell_centroids_x, double* subcell_centroids_y,
+    double* subcell_centroids_z, int* nodes_to_cells_offsets,
+    int* cells_to_nodes_offsets, int* cells_to_nodes,
+    vec_t* initial_momentum, SolveCounts* solve_counts);
+
+// Limits the gradients of the momentum density at a node and distributes the
+// momentum into the subcells of the node
+void distribute_nodal_momentum(
+    const int nn, vec_t* node, vec_t* node_mom_density, vec_t* gmax,
+    vec_t* gmin, vec_t* grad_vx, vec_t* grad_vy, vec_t* grad_vz,
+    const double* nodes_x, const double* nodes_y, const double* nodes_z,
+    double* subcell_volume, double* cell_centroids_x, double* cell_centroids_y,
+    double* cell_centroids_z, double* subcell_momentum_x,
+    double* subcell_momentum_y, double* subcell_momentum_z,
+    double* subcell_centroids_x, double* subcell_centroids_y,
+    double* subcell_centroids_z, int* nodes_to_cells_offsets,
+    int* nodes_to_cells, int* cells_to_nodes_offsets, int* cells_to_nodes,
+    double* total_subcell_vx, double* total_subcell_vy,
+    double* total_subcell_vz);
+
+// Gathers the passive tracers into the subcells
+void gather_subcell_tracers(const int ncells,
+                            const int* cells_to_nodes_offsets,
+                            const double* cell_mass,
+                            const double* subcell_mass,
+                            double* subcell_tracer_mass,
+                            TracerRegistry* tracers);
+
+// Gathers the volume, mass and internal energy of the materials of the mixed
+// cells from their fractions of each cell
+void gather_material_quantities(MultiMaterial* mm, const double* cell_mass,
+                                const double* cell_volume,
+                                const double* energy);
 
 // gathers all of the subcell quantities on the mesh
 void gather_subcell_quantities(UnstructuredMesh* umesh, HaleData* hale_data,
@@ -43,18 +88,25 @@ void gather_subcell_quantities(UnstructuredMesh* umesh, HaleData* hale_data,
   *      GATHERING STAGE OF THE REMAP
   */
 
-  // Calculates the cell volume, subcell volume and the subcell centroids
-  calc_volumes_centroids(
-      umesh->ncells, umesh->nnodes, hale_data->nnodes_by_subcell,
-      umesh->cells_to_nodes_offsets, umesh->cells_to_nodes,
-      hale_data->subcells_to_faces_offsets, hale_data->subcells_to_faces,
-      umesh->faces_to_nodes, umesh->faces_to_nodes_offsets,
-      umesh->faces_cclockwise_cell, umesh->nodes_x0, umesh->nodes_y0,
-      umesh->nodes_z0, hale_data->subcell_centroids_x,
-      hale_data->subcell_centroids_y, hale_data->subcell_centroids_z,
-      hale_data->subcell_volume, hale_data->cell_volume,
-      hale_data->nodal_volumes, umesh->nodes_to_cells_offsets,
-      umesh->nodes_to_cells);
+  // Calculates the subcell volume and the subcell centroids, when stale, where
+  // the nodal volumes are only overwritten by the Lagrangian phase, which
+  // always moves the mesh on to a new epoch
+  if (geometry_stale(&hale_data->subcell_geometry_stamp,
+                     hale_data->geometry_epoch)) {
+    calc_volumes_centroids(
+        umesh->ncells, umesh->nnodes, hale_data->nnodes_by_subcell,
+        umesh->cells_to_nodes_offsets, umesh->cells_to_nodes,
+        hale_data->subcells_to_faces_offsets, hale_data->subcells_to_faces,
+        umesh->faces_to_nodes, umesh->faces_to_nodes_offsets,
+        umesh->faces_cclockwise_cell, umesh->nodes_x0, umesh->nodes_y0,
+        umesh->nodes_z0, hale_data->subcell_centroids_x,
+        hale_data->subcell_centroids_y, hale_data->subcell_centroids_z,
+        hale_data->subcell_volume, hale_data->cell_volume,
+        hale_data->nodal_volumes, umesh->nodes_to_cells_offsets,
+        umesh->nodes_to_cells);
+    stamp_geometry(&hale_data->subcell_geometry_stamp,
+                   hale_data->geometry_epoch);
+  }
 
   // Gathers all of the subcell quantities on the mesh
   gather_subcell_mass_and_energy(
@@ -71,9 +123,24 @@ void gather_subcell_quantities(UnstructuredMesh* umesh, HaleData* hale_data,
       umesh->faces_to_cells1, umesh->cells_to_faces_offsets,
       umesh->cells_to_faces, umesh->cells_to_nodes,
       umesh->nodes_to_cells_offsets, umesh->nodes_to_cells, initial_mass,
-      initial_ie_mass, initial_ke_mass);
+      initial_ie_mass, initial_ke_mass,
+      &hale_data->solve_counts[(ENERGY_GATHER_SOLVES)]);
 
   // Gathers the momentum  the subcells
+#ifdef SELL_ADJACENCY
+  gather_subcell_momentum_sell(
+      &hale_data->nodes_to_nodes_sell, hale_data->nodal_volumes,
+      hale_data->nodal_mass, umesh->nodes_to_cells, umesh->nodes_x0,
+      umesh->nodes_y0, umesh->nodes_z0, hale_data->velocity_x0,
+      hale_data->velocity_y0, hale_data->velocity_z0, hale_data->subcell_volume,
+      umesh->cell_centroids_x, umesh->cell_centroids_y,
+      umesh->cell_centroids_z, hale_data->subcell_momentum_x,
+      hale_data->subcell_momentum_y, hale_data->subcell_momentum_z,
+      hale_data->subcell_centroids_x, hale_data->subcell_centroids_y,
+      hale_data->subcell_centroids_z, umesh->nodes_to_cells_offsets,
+      umesh->cells_to_nodes_offsets, umesh->cells_to_nodes, initial_momentum,
+      &hale_data->solve_counts[(MOMENTUM_GATHER_SOLVES)]);
+#else
   gather_subcell_momentum(
       umesh->nnodes, hale_data->nodal_volumes, hale_data->nodal_mass,
       umesh->nodes_to_cells, umesh->nodes_x0, umesh->nodes_y0, umesh->nodes_z0,
@@ -85,7 +152,95 @@ void gather_subcell_quantities(UnstructuredMesh* umesh, HaleData* hale_data,
       hale_data->subcell_centroids_y, hale_data->subcell_centroids_z,
       umesh->nodes_to_cells_offsets, umesh->cells_to_nodes_offsets,
       umesh->cells_to_nodes, umesh->nodes_to_nodes_offsets,
-      umesh->nodes_to_nodes, initial_momentum);
+      umesh->nodes_to_nodes, initial_momentum,
+      &hale_data->solve_counts[(MOMENTUM_GATHER_SOLVES)]);
+#endif
+
+  // Gathers the materials of the mixed cells, which the pure cells take
+  // straight from the cell
+  if (hale_data->multi_material) {
+    gather_material_quantities(&hale_data->materials, hale_data->cell_mass,
+                               hale_data->cell_volume, hale_data->energy0);
+  }
+
+  // Gathers the passive tracers with the mass of each subcell
+  if (hale_data->ntracers) {
+    gather_subcell_tracers(umesh->ncells, umesh->cells_to_nodes_offsets,
+                           hale_data->cell_mass, hale_data->subcell_mass,
+                           hale_data->subcell_tracer_mass,
+                           &hale_data->tracers);
+  }
+}
+
+// Gathers the passive tracers into the subcells, where the concentration of
+// each cell is uniform across its subcells, so that the tracers are carried
+// with the mass
+void gather_subcell_tracers(const int ncells,
+                            const int* cells_to_nodes_offsets,
+                            const double* cell_mass,
+                            const double* subcell_mass,
+                            double* subcell_tracer_mass,
+                            TracerRegistry* tracers) {
+  const int ntracers = tracers->ntracers;
+  const double* concentration = tracers->concentration;
+
+  OMP_FOR()
+  for (int cc = 0; cc < ncells; ++cc) {
+    const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
+    const int nnodes_by_cell =
+        cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
+    const double* cell_tracers = &concentration[(cc * ntracers)];
+
+    for (int nn = 0; nn < nnodes_by_cell; ++nn) {
+      const int subcell_index = cell_to_nodes_off + nn;
+      double* tracer_mass = &subcell_tracer_mass[(subcell_index * ntracers)];
+#pragma omp simd
+      for (int tt = 0; tt < ntracers; ++tt) {
+        tracer_mass[(tt)] = subcell_mass[(subcell_index)] * cell_tracers[(tt)];
+      }
+    }
+  }
+  OMP_BARRIER();
+
+  // The scatter reports the conservation of each tracer
+  double total[MAX_TRACERS];
+  sum_tracers(ncells, ntracers, cell_mass, concentration, total);
+
+  OMP_MASTER()
+  for (int tt = 0; tt < ntracers; ++tt) {
+    tracers->initial_total[(tt)] = total[(tt)];
+  }
+}
+
+// Sums the amount of each tracer over the cells
+void sum_tracers(const int ncells, const int ntracers, const double* cell_mass,
+                 const double* concentration, double* total) {
+  for (int tt = 0; tt < ntracers; ++tt) {
+    double tracer_total = 0.0;
+    OMP_FOR_REDUCTION(reduction(+ : tracer_total))
+    for (int cc = 0; cc < ncells; ++cc) {
+      tracer_total += cell_mass[(cc)] * concentration[(cc * ntracers + tt)];
+    }
+    TEAM_SUM(&tracer_total);
+    total[(tt)] = tracer_total;
+  }
+}
+
+// Gathers the volume, mass and internal energy of the materials of the mixed
+// cells from their fractions of each cell, over the entries of each material
+// in turn
+void gather_material_quantities(MultiMaterial* mm, const double* cell_mass,
+                                const double* cell_volume,
+                                const double* energy) {
+  OMP_FOR()
+  for (int ee = 0; ee < mm->nentries; ++ee) {
+    const int cell_index = mm->entry_cells[(ee)];
+    mm->volume[(ee)] = mm->volume_fraction[(ee)] * cell_volume[(cell_index)];
+    mm->mass[(ee)] = mm->mass_fraction[(ee)] * cell_mass[(cell_index)];
+    mm->ie_mass[(ee)] =
+        mm->ie_fraction[(ee)] * cell_mass[(cell_index)] * energy[(cell_index)];
+  }
+  OMP_BARRIER();
 }
 
 // Gathers all of the subcell quantities on the mesh
@@ -101,14 +256,15 @@ void gather_subcell_mass_and_energy(
     double* subcell_centroids_z, int* faces_to_cells0, int* faces_to_cells1,
     int* cells_to_faces_offsets, int* cells_to_faces, int* cells_to_nodes,
     int* nodes_to_cells_offsets, int* nodes_to_cells, double* initial_mass,
-    double* initial_ie_mass, double* initial_ke_mass) {
+    double* initial_ie_mass, double* initial_ke_mass,
+    SolveCounts* solve_counts) {
 
   double total_mass = 0.0;
   double total_ie_mass = 0.0;
   double total_ke_mass = 0.0;
 
-// We first have to determine the cell centered kinetic energy
-#pragma omp parallel for reduction(+ : total_ke_mass)
+  // We first have to determine the cell centered kinetic energy
+  OMP_FOR_REDUCTION(reduction(+ : total_ke_mass))
   for (int cc = 0; cc < ncells; ++cc) {
     const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
     const int nnodes_by_cell =
@@ -128,14 +284,27 @@ void gather_subcell_mass_and_energy(
 
     total_ke_mass += ke_mass[(cc)];
   }
+  TEAM_SUM(&total_ke_mass);
 
   double total_ie_in_subcells = 0.0;
   double total_ke_in_subcells = 0.0;
-
-// Calculate the sub-cell internal and kinetic energies
-#pragma omp parallel for reduction(+ : total_mass, total_ie_mass,              \
-                                   total_ie_in_subcells, total_ke_in_subcells)
+  double nill_conditioned = 0.0;
+  double nsingular = 0.0;
+
+  // The least squares fit only considers the neighbours of boundary cells that
+  // exist, so the cost of a cell varies
+  static KernelSchedule schedule = {"gather_subcell_mass_and_energy",
+                                    SCHEDULE_GUIDED};
+  begin_kernel_schedule(&schedule, ncells);
+
+  // Calculate the sub-cell internal and kinetic energies
+  OMP_FOR_SCHEDULED_REDUCTION(reduction(+ : total_mass, total_ie_mass,
+                                            total_ie_in_subcells,
+                                            total_ke_in_subcells,
+                                            nill_conditioned, nsingular))
   for (int cc = 0; cc < ncells; ++cc) {
+    const double cell_start = start_entity_cost(&schedule);
+
     // Calculating the volume dist necessary for the least squares
     // regression
     const int cell_to_faces_off = cells_to_faces_offsets[(cc)];
@@ -153,7 +322,7 @@ void gather_subcell_mass_and_energy(
 
     vec_t ie_rhs = {0.0, 0.0, 0.0};
     vec_t ke_rhs = {0.0, 0.0, 0.0};
-    vec_t coeff[3] = {{0.0, 0.0, 0.0}};
+    double coeff[NSYM_3X3] = {0.0};
 
     total_mass += cell_mass[(cc)];
     total_ie_mass += cell_mass[(cc)] * energy[(cc)];
@@ -180,15 +349,13 @@ void gather_subcell_mass_and_energy(
 
       // Store the neighbouring cell's contribution to the coefficients
       double neighbour_vol = cell_volume[(neighbour_index)];
-      coeff[0].x += 2.0 * (dist.x * dist.x) / (neighbour_vol * neighbour_vol);
-      coeff[0].y += 2.0 * (dist.x * dist.y) / (neighbour_vol * neighbour_vol);
-      coeff[0].z += 2.0 * (dist.x * dist.z) / (neighbour_vol * neighbour_vol);
-      coeff[1].x += 2.0 * (dist.y * dist.x) / (neighbour_vol * neighbour_vol);
-      coeff[1].y += 2.0 * (dist.y * dist.y) / (neighbour_vol * neighbour_vol);
-      coeff[1].z += 2.0 * (dist.y * dist.z) / (neighbour_vol * neighbour_vol);
-      coeff[2].x += 2.0 * (dist.z * dist.x) / (neighbour_vol * neighbour_vol);
-      coeff[2].y += 2.0 * (dist.z * dist.y) / (neighbour_vol * neighbour_vol);
-      coeff[2].z += 2.0 * (dist.z * dist.z) / (neighbour_vol * neighbour_vol);
+      const double vol2 = neighbour_vol * neighbour_vol;
+      coeff[(SYM_XX)] += 2.0 * (dist.x * dist.x) / vol2;
+      coeff[(SYM_XY)] += 2.0 * (dist.x * dist.y) / vol2;
+      coeff[(SYM_XZ)] += 2.0 * (dist.x * dist.z) / vol2;
+      coeff[(SYM_YY)] += 2.0 * (dist.y * dist.y) / vol2;
+      coeff[(SYM_YZ)] += 2.0 * (dist.y * dist.z) / vol2;
+      coeff[(SYM_ZZ)] += 2.0 * (dist.z * dist.z) / vol2;
 
       const double neighbour_ie =
           density[(neighbour_index)] * energy[(neighbour_index)];
@@ -210,19 +377,18 @@ void gather_subcell_mass_and_energy(
       ke_rhs.z += 2.0 * (dist.z * dke) / neighbour_vol;
     }
 
-    // Determine the inverse of the coefficient matrix
-    vec_t inv[3];
-    calc_3x3_inverse(&coeff, &inv);
-
     // Solve for the internal and kinetic energy gradients
-    vec_t grad_ie = {
-        inv[0].x * ie_rhs.x + inv[0].y * ie_rhs.y + inv[0].z * ie_rhs.z,
-        inv[1].x * ie_rhs.x + inv[1].y * ie_rhs.y + inv[1].z * ie_rhs.z,
-        inv[2].x * ie_rhs.x + inv[2].y * ie_rhs.y + inv[2].z * ie_rhs.z};
-    vec_t grad_ke = {
-        inv[0].x * ke_rhs.x + inv[0].y * ke_rhs.y + inv[0].z * ke_rhs.z,
-        inv[1].x * ke_rhs.x + inv[1].y * ke_rhs.y + inv[1].z * ke_rhs.z,
-        inv[2].x * ke_rhs.x + inv[2].y * ke_rhs.y + inv[2].z * ke_rhs.z};
+    const double rhs_x[2] = {ie_rhs.x, ke_rhs.x};
+    const double rhs_y[2] = {ie_rhs.y, ke_rhs.y};
+    const double rhs_z[2] = {ie_rhs.z, ke_rhs.z};
+    double grad_x[2];
+    double grad_y[2];
+    double grad_z[2];
+    count_solve_state(solve_sym_3x3_batch(1, 1, 2, coeff, rhs_x, rhs_y, rhs_z,
+                                          grad_x, grad_y, grad_z, NULL),
+                      &nill_conditioned, &nsingular);
+    vec_t grad_ie = {grad_x[0], grad_y[0], grad_z[0]};
+    vec_t grad_ke = {grad_x[1], grad_y[1], grad_z[1]};
 
     // Calculate the limiter for the gradient
     double limiter = 1.0;
@@ -284,18 +450,29 @@ void gather_subcell_mass_and_energy(
                subcell_ke_mass[(subcell_index)]);
       }
     }
+
+    record_entity_cost(&schedule, cc, cell_start);
   }
+  TEAM_SUM(&total_mass, &total_ie_mass, &total_ie_in_subcells,
+           &total_ke_in_subcells, &nill_conditioned, &nsingular);
+  end_kernel_schedule(&schedule);
 
   *initial_mass = total_mass;
   *initial_ie_mass = total_ie_in_subcells;
   *initial_ke_mass = total_ke_in_subcells;
 
-  printf("Total Energy in Cells    %.12f\n", total_ie_mass + total_ke_mass);
-  printf("Total Energy in Subcells %.12f\n",
-         total_ie_in_subcells + total_ke_in_subcells);
-  printf("Difference               %.12f\n\n",
-         (total_ie_mass + total_ke_mass) -
-             (total_ie_in_subcells + total_ke_in_subcells));
+  OMP_MASTER()
+  {
+    solve_counts->ncalls++;
+    solve_counts->nill_conditioned += nill_conditioned;
+    solve_counts->nsingular += nsingular;
+    printf("Total Energy in Cells    %.12f\n", total_ie_mass + total_ke_mass);
+    printf("Total Energy in Subcells %.12f\n",
+           total_ie_in_subcells + total_ke_in_subcells);
+    printf("Difference               %.12f\n\n",
+           (total_ie_mass + total_ke_mass) -
+               (total_ie_in_subcells + total_ke_in_subcells));
+  }
 }
 
 // Gathers the momentum into the subcells
@@ -310,7 +487,7 @@ void gather_subcell_momentum(
     double* subcell_centroids_y, double* subcell_centroids_z,
     int* nodes_to_cells_offsets, int* cells_to_nodes_offsets,
     int* cells_to_nodes, int* nodes_to_nodes_offsets, int* nodes_to_nodes,
-    vec_t* initial_momentum) {
+    vec_t* initial_momentum, SolveCounts* solve_counts) {
 
   double initial_momentum_x = 0.0;
   double initial_momentum_y = 0.0;
@@ -318,17 +495,26 @@ void gather_subcell_momentum(
   double total_subcell_vx = 0.0;
   double total_subcell_vy = 0.0;
   double total_subcell_vz = 0.0;
-
-#pragma omp parallel for reduction(+ : initial_momentum_x, initial_momentum_y, \
-                                   initial_momentum_z, total_subcell_vx,       \
-                                   total_subcell_vy, total_subcell_vz)
+  double nill_conditioned = 0.0;
+  double nsingular = 0.0;
+
+  // The number of neighbours in the fit differs between nodes
+  static KernelSchedule schedule = {"gather_subcell_momentum",
+                                    SCHEDULE_GUIDED};
+  begin_kernel_schedule(&schedule, nnodes);
+
+  OMP_FOR_SCHEDULED_REDUCTION(
+      reduction(+ : initial_momentum_x, initial_momentum_y, initial_momentum_z,
+                    total_subcell_vx, total_subcell_vy, total_subcell_vz,
+                    nill_conditioned, nsingular))
   for (int nn = 0; nn < nnodes; ++nn) {
+    const double node_start = start_entity_cost(&schedule);
 
     // Calculate the gradient for the nodal momentum
     vec_t rhsx = {0.0, 0.0, 0.0};
     vec_t rhsy = {0.0, 0.0, 0.0};
     vec_t rhsz = {0.0, 0.0, 0.0};
-    vec_t coeff[3] = {{0.0, 0.0, 0.0}};
+    double coeff[NSYM_3X3] = {0.0};
     vec_t gmin = {DBL_MAX, DBL_MAX, DBL_MAX};
     vec_t gmax = {-DBL_MAX, -DBL_MAX, -DBL_MAX};
     vec_t node = {nodes_x[(nn)], nodes_y[(nn)], nodes_z[(nn)]};
@@ -360,15 +546,13 @@ void gather_subcell_momentum(
 
       // Store the neighbouring cell's contribution to the coefficients
       double neighbour_vol = nodal_volumes[(neighbour_index)];
-      coeff[0].x += 2.0 * (i.x * i.x) / (neighbour_vol * neighbour_vol);
-      coeff[0].y += 2.0 * (i.x * i.y) / (neighbour_vol * neighbour_vol);
-      coeff[0].z += 2.0 * (i.x * i.z) / (neighbour_vol * neighbour_vol);
-      coeff[1].x += 2.0 * (i.y * i.x) / (neighbour_vol * neighbour_vol);
-      coeff[1].y += 2.0 * (i.y * i.y) / (neighbour_vol * neighbour_vol);
-      coeff[1].z += 2.0 * (i.y * i.z) / (neighbour_vol * neighbour_vol);
-      coeff[2].x += 2.0 * (i.z * i.x) / (neighbour_vol * neighbour_vol);
-      coeff[2].y += 2.0 * (i.z * i.y) / (neighbour_vol * neighbour_vol);
-      coeff[2].z += 2.0 * (i.z * i.z) / (neighbour_vol * neighbour_vol);
+      const double vol2 = neighbour_vol * neighbour_vol;
+      coeff[(SYM_XX)] += 2.0 * (i.x * i.x) / vol2;
+      coeff[(SYM_XY)] += 2.0 * (i.x * i.y) / vol2;
+      coeff[(SYM_XZ)] += 2.0 * (i.x * i.z) / vol2;
+      coeff[(SYM_YY)] += 2.0 * (i.y * i.y) / vol2;
+      coeff[(SYM_YZ)] += 2.0 * (i.y * i.z) / vol2;
+      coeff[(SYM_ZZ)] += 2.0 * (i.z * i.z) / vol2;
 
       const double neighbour_nodal_density =
           nodal_mass[(neighbour_index)] / nodal_volumes[(neighbour_index)];
@@ -400,107 +584,338 @@ void gather_subcell_momentum(
       rhsz.z += 2.0 * i.z * dv.z / neighbour_vol;
     }
 
-    // Determine the inverse of the coefficient matrix
-    vec_t inv[3];
-    calc_3x3_inverse(&coeff, &inv);
-
     // Solve for the velocity density gradients
-    vec_t grad_vx = {inv[0].x * rhsx.x + inv[0].y * rhsx.y + inv[0].z * rhsx.z,
-                     inv[1].x * rhsx.x + inv[1].y * rhsx.y + inv[1].z * rhsx.z,
-                     inv[2].x * rhsx.x + inv[2].y * rhsx.y + inv[2].z * rhsx.z};
-    vec_t grad_vy = {inv[0].x * rhsy.x + inv[0].y * rhsy.y + inv[0].z * rhsy.z,
-                     inv[1].x * rhsy.x + inv[1].y * rhsy.y + inv[1].z * rhsy.z,
-                     inv[2].x * rhsy.x + inv[2].y * rhsy.y + inv[2].z * rhsy.z};
-    vec_t grad_vz = {inv[0].x * rhsz.x + inv[0].y * rhsz.y + inv[0].z * rhsz.z,
-                     inv[1].x * rhsz.x + inv[1].y * rhsz.y + inv[1].z * rhsz.z,
-                     inv[2].x * rhsz.x + inv[2].y * rhsz.y + inv[2].z * rhsz.z};
-
-    // Limit the gradients
-    double vx_limiter = 1.0;
-    double vy_limiter = 1.0;
-    double vz_limiter = 1.0;
-    const int node_to_cells_off = nodes_to_cells_offsets[(nn)];
-    const int ncells_by_node =
-        nodes_to_cells_offsets[(nn + 1)] - node_to_cells_off;
-    for (int cc = 0; cc < ncells_by_node; ++cc) {
-      const int cell_index = nodes_to_cells[(node_to_cells_off + cc)];
-
-      vec_t cell_c = {cell_centroids_x[(cell_index)],
-                      cell_centroids_y[(cell_index)],
-                      cell_centroids_z[(cell_index)]};
-      vx_limiter =
-          min(vx_limiter,
-              calc_cell_limiter(node_mom_density.x, gmax.x, gmin.x, &grad_vx,
-                                cell_c.x, cell_c.y, cell_c.z, &node));
-      vy_limiter =
-          min(vy_limiter,
-              calc_cell_limiter(node_mom_density.y, gmax.y, gmin.y, &grad_vy,
-                                cell_c.x, cell_c.y, cell_c.z, &node));
-      vz_limiter =
-          min(vz_limiter,
-              calc_cell_limiter(node_mom_density.z, gmax.z, gmin.z, &grad_vz,
-                                cell_c.x, cell_c.y, cell_c.z, &node));
+    const double rhs_x[3] = {rhsx.x, rhsy.x, rhsz.x};
+    const double rhs_y[3] = {rhsx.y, rhsy.y, rhsz.y};
+    const double rhs_z[3] = {rhsx.z, rhsy.z, rhsz.z};
+    double grad_x[3];
+    double grad_y[3];
+    double grad_z[3];
+    count_solve_state(solve_sym_3x3_batch(1, 1, 3, coeff, rhs_x, rhs_y, rhs_z,
+                                          grad_x, grad_y, grad_z, NULL),
+                      &nill_conditioned, &nsingular);
+    vec_t grad_vx = {grad_x[0], grad_y[0], grad_z[0]};
+    vec_t grad_vy = {grad_x[1], grad_y[1], grad_z[1]};
+    vec_t grad_vz = {grad_x[2], grad_y[2], grad_z[2]};
+
+    distribute_nodal_momentum(
+        nn, &node, &node_mom_density, &gmax, &gmin, &grad_vx, &grad_vy,
+        &grad_vz, nodes_x, nodes_y, nodes_z, subcell_volume, cell_centroids_x,
+        cell_centroids_y, cell_centroids_z, subcell_momentum_x,
+        subcell_momentum_y, subcell_momentum_z, subcell_centroids_x,
+        subcell_centroids_y, subcell_centroids_z, nodes_to_cells_offsets,
+        nodes_to_cells, cells_to_nodes_offsets, cells_to_nodes,
+        &total_subcell_vx, &total_subcell_vy, &total_subcell_vz);
+
+    record_entity_cost(&schedule, nn, node_start);
+  }
+  TEAM_SUM(&initial_momentum_x, &initial_momentum_y, &initial_momentum_z,
+           &total_subcell_vx, &total_subcell_vy, &total_subcell_vz,
+           &nill_conditioned, &nsingular);
+  end_kernel_schedule(&schedule);
+
+  initial_momentum->x = total_subcell_vx;
+  initial_momentum->y = total_subcell_vy;
+  initial_momentum->z = total_subcell_vz;
+
+  OMP_MASTER()
+  {
+    solve_counts->ncalls++;
+    solve_counts->nill_conditioned += nill_conditioned;
+    solve_counts->nsingular += nsingular;
+    printf("Total Momentum in Cells    (%.12f,%.12f,%.12f)\n",
+           initial_momentum_x, initial_momentum_y, initial_momentum_z);
+    printf("Total Momentum in Subcells (%.12f,%.12f,%.12f)\n",
+           total_subcell_vx, total_subcell_vy, total_subcell_vz);
+    printf("Difference                 (%.12f,%.12f,%.12f)\n\n",
+           initial_momentum_x - total_subcell_vx,
+           initial_momentum_y - total_subcell_vy,
+           initial_momentum_z - total_subcell_vz);
+  }
+}
+
+// Gathers the momentum into the subcells, with the least squares systems of
+// each slice of the SELL-C-sigma node adjacency assembled and solved together
+void gather_subcell_momentum_sell(
+    const SellAdjacency* nodes_to_nodes_sell, const double* nodal_volumes,
+    const double* nodal_mass, int* nodes_to_cells, const double* nodes_x,
+    const double* nodes_y, const double* nodes_z, double* velocity_x,
+    double* velocity_y, double* velocity_z, double* subcell_volume,
+    double* cell_centroids_x, double* cell_centroids_y,
+    double* cell_centroids_z, double* subcell_momentum_x,
+    double* subcell_momentum_y, double* subcell_momentum_z,
+    double* subcell_centroids_x, double* subcell_centroids_y,
+    double* subcell_centroids_z, int* nodes_to_cells_offsets,
+    int* cells_to_nodes_offsets, int* cells_to_nodes,
+    vec_t* initial_momentum, SolveCounts* solve_counts) {
+
+  double initial_momentum_x = 0.0;
+  double initial_momentum_y = 0.0;
+  double initial_momentum_z = 0.0;
+  double total_subcell_vx = 0.0;
+  double total_subcell_vy = 0.0;
+  double total_subcell_vz = 0.0;
+  double nill_conditioned = 0.0;
+  double nsingular = 0.0;
+
+  // The slices are as wide as their widest node, so still differ in cost
+  static KernelSchedule schedule = {"gather_subcell_momentum_sell",
+                                    SCHEDULE_GUIDED};
+  begin_kernel_schedule(&schedule, nodes_to_nodes_sell->nslices);
+
+  OMP_FOR_SCHEDULED_REDUCTION(
+      reduction(+ : initial_momentum_x, initial_momentum_y, initial_momentum_z,
+                    total_subcell_vx, total_subcell_vy, total_subcell_vz,
+                    nill_conditioned, nsingular))
+  for (int ss = 0; ss < nodes_to_nodes_sell->nslices; ++ss) {
+    const double slice_start = start_entity_cost(&schedule);
+    const int slice_off = nodes_to_nodes_sell->slice_offsets[(ss)];
+    const int width =
+        (nodes_to_nodes_sell->slice_offsets[(ss + 1)] - slice_off) /
+        SELL_CHUNK;
+    const int* rows = &nodes_to_nodes_sell->rows[(ss * SELL_CHUNK)];
+
+    double node_x[SELL_CHUNK];
+    double node_y[SELL_CHUNK];
+    double node_z[SELL_CHUNK];
+    double mom_density[3][SELL_CHUNK];
+    double gmax[3][SELL_CHUNK];
+    double gmin[3][SELL_CHUNK];
+    double coeff[NSYM_3X3][SELL_CHUNK];
+    double rhs_x[3][SELL_CHUNK];
+    double rhs_y[3][SELL_CHUNK];
+    double rhs_z[3][SELL_CHUNK];
+
+    // The padding lanes load the first node, and are never stored
+#pragma omp simd
+    for (int ll = 0; ll < SELL_CHUNK; ++ll) {
+      const int nn = (rows[(ll)] != -1) ? rows[(ll)] : 0;
+      node_x[(ll)] = nodes_x[(nn)];
+      node_y[(ll)] = nodes_y[(nn)];
+      node_z[(ll)] = nodes_z[(nn)];
+
+      const double nodal_density = nodal_mass[(nn)] / nodal_volumes[(nn)];
+      mom_density[(0)][(ll)] = nodal_density * velocity_x[(nn)];
+      mom_density[(1)][(ll)] = nodal_density * velocity_y[(nn)];
+      mom_density[(2)][(ll)] = nodal_density * velocity_z[(nn)];
+
+      for (int ee = 0; ee < NSYM_3X3; ++ee) {
+        coeff[(ee)][(ll)] = 0.0;
+      }
+      for (int dd = 0; dd < 3; ++dd) {
+        gmax[(dd)][(ll)] = -DBL_MAX;
+        gmin[(dd)][(ll)] = DBL_MAX;
+        rhs_x[(dd)][(ll)] = 0.0;
+        rhs_y[(dd)][(ll)] = 0.0;
+        rhs_z[(dd)][(ll)] = 0.0;
+      }
     }
 
-    // This stops extrema from worsening as part of the gather. Is it
-    // conservative?
-    grad_vx.x *= vx_limiter;
-    grad_vx.y *= vx_limiter;
-    grad_vx.z *= vx_limiter;
-    grad_vy.x *= vy_limiter;
-    grad_vy.y *= vy_limiter;
-    grad_vy.z *= vy_limiter;
-    grad_vz.x *= vz_limiter;
-    grad_vz.y *= vz_limiter;
-    grad_vz.z *= vz_limiter;
-
-    for (int cc = 0; cc < ncells_by_node; ++cc) {
-      const int cell_index = nodes_to_cells[(node_to_cells_off + cc)];
-      const int cell_to_nodes_off = cells_to_nodes_offsets[(cell_index)];
-      const int nnodes_by_cell =
-          cells_to_nodes_offsets[(cell_index + 1)] - cell_to_nodes_off;
-
-      // Determine the position of the node in the cell
-      int nn2;
-      for (nn2 = 0; nn2 < nnodes_by_cell; ++nn2) {
-        if (cells_to_nodes[(cell_to_nodes_off + nn2)] == nn) {
-          break;
+    // Accumulate the least squares systems of every node in the slice, in
+    // the order of the original list, masking the padding
+    for (int kk = 0; kk < width; ++kk) {
+      const int* neighbours =
+          &nodes_to_nodes_sell->entries[(slice_off + kk * SELL_CHUNK)];
+
+#pragma omp simd
+      for (int ll = 0; ll < SELL_CHUNK; ++ll) {
+        // The padding loads the first node and is weighted out, as a select
+        // would leave masked gathers
+        const int valid = (neighbours[(ll)] != -1);
+        const int neighbour_index = valid ? neighbours[(ll)] : 0;
+        const double mask = valid ? 1.0 : 0.0;
+
+        // Calculate the center of mass distance
+        const double ix = nodes_x[(neighbour_index)] - node_x[(ll)];
+        const double iy = nodes_y[(neighbour_index)] - node_y[(ll)];
+        const double iz = nodes_z[(neighbour_index)] - node_z[(ll)];
+
+        // Store the neighbouring cell's contribution to the coefficients
+        const double neighbour_vol = nodal_volumes[(neighbour_index)];
+        const double vol2 = neighbour_vol * neighbour_vol;
+        coeff[(SYM_XX)][(ll)] += mask * (2.0 * (ix * ix) / vol2);
+        coeff[(SYM_XY)][(ll)] += mask * (2.0 * (ix * iy) / vol2);
+        coeff[(SYM_XZ)][(ll)] += mask * (2.0 * (ix * iz) / vol2);
+        coeff[(SYM_YY)][(ll)] += mask * (2.0 * (iy * iy) / vol2);
+        coeff[(SYM_YZ)][(ll)] += mask * (2.0 * (iy * iz) / vol2);
+        coeff[(SYM_ZZ)][(ll)] += mask * (2.0 * (iz * iz) / vol2);
+
+        const double neighbour_nodal_density =
+            nodal_mass[(neighbour_index)] / nodal_volumes[(neighbour_index)];
+        const double neighbour_mom_density[3] = {
+            neighbour_nodal_density * velocity_x[(neighbour_index)],
+            neighbour_nodal_density * velocity_y[(neighbour_index)],
+            neighbour_nodal_density * velocity_z[(neighbour_index)]};
+
+        for (int dd = 0; dd < 3; ++dd) {
+          const double m = neighbour_mom_density[(dd)];
+          const double dv = m - mom_density[(dd)][(ll)];
+          gmax[(dd)][(ll)] = max(gmax[(dd)][(ll)], valid ? m : -DBL_MAX);
+          gmin[(dd)][(ll)] = min(gmin[(dd)][(ll)], valid ? m : DBL_MAX);
+          rhs_x[(dd)][(ll)] += mask * (2.0 * ix * dv / neighbour_vol);
+          rhs_y[(dd)][(ll)] += mask * (2.0 * iy * dv / neighbour_vol);
+          rhs_z[(dd)][(ll)] += mask * (2.0 * iz * dv / neighbour_vol);
         }
       }
+    }
 
-      const int subcell_index = cell_to_nodes_off + nn2;
-
-      const double vol = subcell_volume[(subcell_index)];
-      const double dx = subcell_centroids_x[(subcell_index)] - nodes_x[(nn)];
-      const double dy = subcell_centroids_y[(subcell_index)] - nodes_y[(nn)];
-      const double dz = subcell_centroids_z[(subcell_index)] - nodes_z[(nn)];
-
-      subcell_momentum_x[(subcell_index)] =
-          vol * (node_mom_density.x + grad_vx.x * dx + grad_vx.y * dy +
-                 grad_vx.z * dz);
-      subcell_momentum_y[(subcell_index)] =
-          vol * (node_mom_density.y + grad_vy.x * dx + grad_vy.y * dy +
-                 grad_vy.z * dz);
-      subcell_momentum_z[(subcell_index)] =
-          vol * (node_mom_density.z + grad_vz.x * dx + grad_vz.y * dy +
-                 grad_vz.z * dz);
-
-      total_subcell_vx += subcell_momentum_x[(subcell_index)];
-      total_subcell_vy += subcell_momentum_y[(subcell_index)];
-      total_subcell_vz += subcell_momentum_z[(subcell_index)];
+    // Solve for the velocity density gradients of the whole slice, where the
+    // padding lanes are singular
+    double grad_x[3][SELL_CHUNK];
+    double grad_y[3][SELL_CHUNK];
+    double grad_z[3][SELL_CHUNK];
+    int status[SELL_CHUNK];
+    solve_sym_3x3_batch(SELL_CHUNK, SELL_CHUNK, 3, coeff[0], rhs_x[0],
+                        rhs_y[0], rhs_z[0], grad_x[0], grad_y[0], grad_z[0],
+                        status);
+
+    // Only the end of the last slice is padded
+    const int nlanes =
+        min(SELL_CHUNK, nodes_to_nodes_sell->nrows - ss * SELL_CHUNK);
+
+    for (int ll = 0; ll < nlanes; ++ll) {
+      const int nn = rows[(ll)];
+      count_solve_state(status[(ll)], &nill_conditioned, &nsingular);
+
+      initial_momentum_x += nodal_mass[(nn)] * velocity_x[(nn)];
+      initial_momentum_y += nodal_mass[(nn)] * velocity_y[(nn)];
+      initial_momentum_z += nodal_mass[(nn)] * velocity_z[(nn)];
+
+      vec_t node = {node_x[(ll)], node_y[(ll)], node_z[(ll)]};
+      vec_t node_mom_density = {mom_density[(0)][(ll)],
+                                mom_density[(1)][(ll)],
+                                mom_density[(2)][(ll)]};
+      vec_t gmax_v = {gmax[(0)][(ll)], gmax[(1)][(ll)], gmax[(2)][(ll)]};
+      vec_t gmin_v = {gmin[(0)][(ll)], gmin[(1)][(ll)], gmin[(2)][(ll)]};
+      vec_t grad_vx = {grad_x[(0)][(ll)], grad_y[(0)][(ll)], grad_z[(0)][(ll)]};
+      vec_t grad_vy = {grad_x[(1)][(ll)], grad_y[(1)][(ll)], grad_z[(1)][(ll)]};
+      vec_t grad_vz = {grad_x[(2)][(ll)], grad_y[(2)][(ll)], grad_z[(2)][(ll)]};
+
+      distribute_nodal_momentum(
+          nn, &node, &node_mom_density, &gmax_v, &gmin_v, &grad_vx, &grad_vy,
+          &grad_vz, nodes_x, nodes_y, nodes_z, subcell_volume,
+          cell_centroids_x, cell_centroids_y, cell_centroids_z,
+          subcell_momentum_x, subcell_momentum_y, subcell_momentum_z,
+          subcell_centroids_x, subcell_centroids_y, subcell_centroids_z,
+          nodes_to_cells_offsets, nodes_to_cells, cells_to_nodes_offsets,
+          cells_to_nodes, &total_subcell_vx, &total_subcell_vy,
+          &total_subcell_vz);
     }
+
+    record_entity_cost(&schedule, ss, slice_start);
   }
+  TEAM_SUM(&initial_momentum_x, &initial_momentum_y, &initial_momentum_z,
+           &total_subcell_vx, &total_subcell_vy, &total_subcell_vz,
+           &nill_conditioned, &nsingular);
+  end_kernel_schedule(&schedule);
 
   initial_momentum->x = total_subcell_vx;
   initial_momentum->y = total_subcell_vy;
   initial_momentum->z = total_subcell_vz;
 
-  printf("Total Momentum in Cells    (%.12f,%.12f,%.12f)\n", initial_momentum_x,
-         initial_momentum_y, initial_momentum_z);
-  printf("Total Momentum in Subcells (%.12f,%.12f,%.12f)\n", total_subcell_vx,
-         total_subcell_vy, total_subcell_vz);
-  printf("Difference                 (%.12f,%.12f,%.12f)\n\n",
-         initial_momentum_x - total_subcell_vx,
-         initial_momentum_y - total_subcell_vy,
-         initial_momentum_z - total_subcell_vz);
+  OMP_MASTER()
+  {
+    solve_counts->ncalls++;
+    solve_counts->nill_conditioned += nill_conditioned;
+    solve_counts->nsingular += nsingular;
+    printf("Total Momentum in Cells    (%.12f,%.12f,%.12f)\n",
+           initial_momentum_x, initial_momentum_y, initial_momentum_z);
+    printf("Total Momentum in Subcells (%.12f,%.12f,%.12f)\n",
+           total_subcell_vx, total_subcell_vy, total_subcell_vz);
+    printf("Difference                 (%.12f,%.12f,%.12f)\n\n",
+           initial_momentum_x - total_subcell_vx,
+           initial_momentum_y - total_subcell_vy,
+           initial_momentum_z - total_subcell_vz);
+  }
+}
+
+// Limits the gradients of the momentum density at a node and distributes the
+// momentum into the subcells of the node
+void distribute_nodal_momentum(
+    const int nn, vec_t* node, vec_t* node_mom_density, vec_t* gmax,
+    vec_t* gmin, vec_t* grad_vx, vec_t* grad_vy, vec_t* grad_vz,
+    const double* nodes_x, const double* nodes_y, const double* nodes_z,
+    double* subcell_volume, double* cell_centroids_x, double* cell_centroids_y,
+    double* cell_centroids_z, double* subcell_momentum_x,
+    double* subcell_momentum_y, double* subcell_momentum_z,
+    double* subcell_centroids_x, double* subcell_centroids_y,
+    double* subcell_centroids_z, int* nodes_to_cells_offsets,
+    int* nodes_to_cells, int* cells_to_nodes_offsets, int* cells_to_nodes,
+    double* total_subcell_vx, double* total_subcell_vy,
+    double* total_subcell_vz) {
+
+  // Limit the gradients
+  double vx_limiter = 1.0;
+  double vy_limiter = 1.0;
+  double vz_limiter = 1.0;
+  const int node_to_cells_off = nodes_to_cells_offsets[(nn)];
+  const int ncells_by_node =
+      nodes_to_cells_offsets[(nn + 1)] - node_to_cells_off;
+  for (int cc = 0; cc < ncells_by_node; ++cc) {
+    const int cell_index = nodes_to_cells[(node_to_cells_off + cc)];
+
+    vec_t cell_c = {cell_centroids_x[(cell_index)],
+                    cell_centroids_y[(cell_index)],
+                    cell_centroids_z[(cell_index)]};
+    vx_limiter =
+        min(vx_limiter,
+            calc_cell_limiter(node_mom_density->x, gmax->x, gmin->x, grad_vx,
+                              cell_c.x, cell_c.y, cell_c.z, node));
+    vy_limiter =
+        min(vy_limiter,
+            calc_cell_limiter(node_mom_density->y, gmax->y, gmin->y, grad_vy,
+                              cell_c.x, cell_c.y, cell_c.z, node));
+    vz_limiter =
+        min(vz_limiter,
+            calc_cell_limiter(node_mom_density->z, gmax->z, gmin->z, grad_vz,
+                              cell_c.x, cell_c.y, cell_c.z, node));
+  }
+
+  // This stops extrema from worsening as part of the gather. Is it
+  // conservative?
+  grad_vx->x *= vx_limiter;
+  grad_vx->y *= vx_limiter;
+  grad_vx->z *= vx_limiter;
+  grad_vy->x *= vy_limiter;
+  grad_vy->y *= vy_limiter;
+  grad_vy->z *= vy_limiter;
+  grad_vz->x *= vz_limiter;
+  grad_vz->y *= vz_limiter;
+  grad_vz->z *= vz_limiter;
+
+  for (int cc = 0; cc < ncells_by_node; ++cc) {
+    const int cell_index = nodes_to_cells[(node_to_cells_off + cc)];
+    const int cell_to_nodes_off = cells_to_nodes_offsets[(cell_index)];
+    const int nnodes_by_cell =
+        cells_to_nodes_offsets[(cell_index + 1)] - cell_to_nodes_off;
+
+    // Determine the position of the node in the cell
+    int nn2;
+    for (nn2 = 0; nn2 < nnodes_by_cell; ++nn2) {
+      if (cells_to_nodes[(cell_to_nodes_off + nn2)] == nn) {
+        break;
+      }
+    }
+
+    const int subcell_index = cell_to_nodes_off + nn2;
+
+    const double vol = subcell_volume[(subcell_index)];
+    const double dx = subcell_centroids_x[(subcell_index)] - nodes_x[(nn)];
+    const double dy = subcell_centroids_y[(subcell_index)] - nodes_y[(nn)];
+    const double dz = subcell_centroids_z[(subcell_index)] - nodes_z[(nn)];
+
+    subcell_momentum_x[(subcell_index)] =
+        vol * (node_mom_density->x + grad_vx->x * dx + grad_vx->y * dy +
+               grad_vx->z * dz);
+    subcell_momentum_y[(subcell_index)] =
+        vol * (node_mom_density->y + grad_vy->x * dx + grad_vy->y * dy +
+               grad_vy->z * dz);
+    subcell_momentum_z[(subcell_index)] =
+        vol * (node_mom_density->z + grad_vz->x * dx + grad_vz->y * dy +
+               grad_vz->z * dz);
+
+    *total_subcell_vx += subcell_momentum_x[(subcell_index)];
+    *total_subcell_vy += subcell_momentum_y[(subcell_index)];
+    *total_subcell_vz += subcell_momentum_z[(subcell_index)];
+  }
 }
@@ -0,0 +1,73 @@
+#include "../../shared.h"
+#include "hale.h"
+#include <stdio.h>
+
+// Initialises the stamp of some derived geometry that has never been evaluated
+void init_geometry_stamp(GeometryStamp* stamp, const char* name) {
+  stamp->name = name;
+  stamp->epoch = -1;
+  stamp->nevaluated = 0;
+  stamp->nreused = 0;
+}
+
+// Moves the current mesh on to a new geometry epoch, as its nodes have changed
+void advance_geometry_epoch(HaleData* hale_data) {
+  OMP_SINGLE()
+  hale_data->geometry_epoch = ++hale_data->ngeometry_epochs;
+}
+
+// Returns the current mesh to the epoch of some nodes it has been rotated to
+void restore_geometry_epoch(HaleData* hale_data, const int epoch) {
+  OMP_SINGLE()
+  hale_data->geometry_epoch = epoch;
+}
+
+// Determines whether some derived geometry needs evaluating at an epoch,
+// counting the evaluation that was avoided when it is still fresh
+int geometry_stale(GeometryStamp* stamp, const int epoch) {
+  const int stale = (stamp->epoch != epoch);
+  if (!stale) {
+    OMP_MASTER()
+    stamp->nreused++;
+  }
+  return stale;
+}
+
+// Records that some derived geometry was evaluated at an epoch
+void stamp_geometry(GeometryStamp* stamp, const int epoch) {
+
+  // Every thread has to have checked the stamp before it changes
+  OMP_BARRIER();
+  OMP_SINGLE()
+  {
+    stamp->epoch = epoch;
+    stamp->nevaluated++;
+  }
+}
+
+// Records that some derived geometry was restored from a stored copy
+void reuse_geometry(GeometryStamp* stamp, const int epoch) {
+  OMP_BARRIER();
+  OMP_SINGLE()
+  {
+    stamp->epoch = epoch;
+    stamp->nreused++;
+  }
+}
+
+// Prints the evaluations of the derived geometry since the last report
+void print_geometry_stamps(HaleData* hale_data) {
+  GeometryStamp* stamps[] = {&hale_data->cell_centroids_stamp,
+                             &hale_data->cell_volume_stamp,
+                             &hale_data->subcell_geometry_stamp};
+
+  for (size_t ii = 0; ii < sizeof(stamps) / sizeof(GeometryStamp*); ++ii) {
+    GeometryStamp* stamp = stamps[(ii)];
+    if (stamp->nevaluated || stamp->nreused) {
+      printf("%-32s evaluated %d reused %d\n", stamp->name, stamp->nevaluated,
+             stamp->nreused);
+    }
+    stamp->nevaluated = 0;
+    stamp->nreused = 0;
+  }
+}
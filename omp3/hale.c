@@ -8,38 +8,68 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+// Solves a timestep, with every thread of the team in the persistent mode
+static void solve_timestep(Mesh* mesh, HaleData* hale_data,
+                           UnstructuredMesh* umesh, const int timestep);
+
 // Solve a single timestep on the given mesh
 void solve_unstructured_hydro_3d(Mesh* mesh, HaleData* hale_data,
                                  UnstructuredMesh* umesh, const int timestep) {
 
-  // On the first timestep we need to determine dt, and store the rezoned mesh
-  if (timestep == 0) {
-    printf("\nInitialising timestep and storing initial mesh.\n");
+  set_schedule_policy(hale_data->remap_schedule);
 
+  // The whole timestep is a single parallel region in the persistent mode
+  OMP_PARALLEL()
+  solve_timestep(mesh, hale_data, umesh, timestep);
+
+  print_barrier_time();
+  print_kernel_schedules();
+  print_geometry_stamps(hale_data);
+}
+
+// Solves a timestep, with every thread of the team in the persistent mode
+static void solve_timestep(Mesh* mesh, HaleData* hale_data,
+                           UnstructuredMesh* umesh, const int timestep) {
+
+  // On the first timestep we need to determine dt
+  if (timestep == 0) {
+    OMP_MASTER()
+    printf("\nInitialising timestep.\n");
+
+    const EosTable* eos_table =
+        hale_data->tabulated_eos ? &hale_data->eos_table : NULL;
+    equation_of_state(umesh->ncells, eos_table, hale_data->energy0,
+                      hale_data->density0, hale_data->pressure0,
+                      hale_data->soundspeed0);
+    if (hale_data->multi_material) {
+      mixed_equation_of_state(&hale_data->materials, eos_table,
+                              hale_data->energy0, hale_data->density0,
+                              hale_data->pressure0, hale_data->soundspeed0);
+    }
     set_timestep(umesh->ncells, umesh->nodes_x0, umesh->nodes_y0,
-                 umesh->nodes_z0, hale_data->energy0, &mesh->dt,
+                 umesh->nodes_z0, hale_data->soundspeed0, &mesh->dt,
                  umesh->cells_to_faces_offsets, umesh->cells_to_faces,
                  umesh->faces_to_nodes_offsets, umesh->faces_to_nodes);
-
-    // We are storing our original mesh to allow an Eulerian remap
-    store_rezoned_mesh(umesh->nnodes, umesh->nodes_x0, umesh->nodes_y0,
-                       umesh->nodes_z0, hale_data->rezoned_nodes_x,
-                       hale_data->rezoned_nodes_y, hale_data->rezoned_nodes_z);
   }
 
   // Describe the subcell node layout
+  OMP_MASTER()
   printf("\nPerforming the Lagrangian Phase\n");
 
+#if !defined(PERSISTENT_REGION) && !defined(TASK_GRAPH)
   struct Profile out;
+#endif
 
   // Perform the Lagrangian phase of the ALE algorithm where the mesh will
   // move
   // due to the pressure (ideal gas) and artificial viscous forces
   START_PROFILING(&out);
+  enter_scratch_phase(&hale_data->scratch_pool, PHASE_LAGRANGIAN);
   lagrangian_phase(mesh, umesh, hale_data);
   STOP_PROFILING(&out, "Lagrangian phase");
 
   if (hale_data->visit_dump) {
+    OMP_SINGLE()
     write_unstructured_to_visit_3d(umesh->nnodes, umesh->ncells, timestep * 2,
                                    umesh->nodes_x0, umesh->nodes_y0,
                                    umesh->nodes_z0, umesh->cells_to_nodes,
@@ -47,6 +77,7 @@ void solve_unstructured_hydro_3d(Mesh* mesh, HaleData* hale_data,
   }
 
   if (hale_data->perform_remap) {
+    OMP_MASTER()
     printf("\nPerforming Gathering Phase\n");
 
     double initial_mass = 0.0;
@@ -56,11 +87,13 @@ void solve_unstructured_hydro_3d(Mesh* mesh, HaleData* hale_data,
 
     // gathers all of the subcell quantities on the mesh
     START_PROFILING(&out);
+    enter_scratch_phase(&hale_data->scratch_pool, PHASE_REMAP);
     gather_subcell_quantities(umesh, hale_data, &initial_momentum,
                               &initial_mass, &initial_ie_mass,
                               &initial_ke_mass);
     STOP_PROFILING(&out, "Gather phase");
 
+    OMP_MASTER()
     printf("\nPerforming Advection Phase\n");
 
     // Performs a remap and some scattering of the subcell values
@@ -68,6 +101,7 @@ void solve_unstructured_hydro_3d(Mesh* mesh, HaleData* hale_data,
     advection_phase(umesh, hale_data);
     STOP_PROFILING(&out, "Advection phase");
 
+    OMP_MASTER()
     printf("\nPerforming Eulerian Mesh Rezone\n");
 
     // Performs an Eulerian rezone, returning the mesh and reconciling fluxes
@@ -75,12 +109,22 @@ void solve_unstructured_hydro_3d(Mesh* mesh, HaleData* hale_data,
     eulerian_rezone(umesh, hale_data);
     STOP_PROFILING(&out, "Rezone phase");
 
-    printf("\nPerforming Repair Phase\n");
+    // Fixes any extrema introduced by the advection, which the first order
+    // remap can't introduce
+    const int repair = (hale_data->remap_order != FIRST_ORDER_REMAP);
 
-    // Fixes any extrema introduced by the advection
-    START_PROFILING(&out);
-    mass_repair_phase(umesh, hale_data);
-    STOP_PROFILING(&out, "Repair phase");
+    // The subcells of the cell remap only share out the fluxes of the cells
+    // and nodes, so their masses aren't a reconstruction to repair
+    if (repair && !hale_data->cell_remap) {
+      OMP_MASTER()
+      printf("\nPerforming Repair Phase\n");
+
+      START_PROFILING(&out);
+      mass_repair_phase(umesh, hale_data);
+      STOP_PROFILING(&out, "Repair phase");
+    }
+
+    OMP_MASTER()
     printf("\nPerforming the Scattering Phase\n");
 
     // Perform the scatter step of the ALE remapping algorithm
@@ -90,10 +134,12 @@ void solve_unstructured_hydro_3d(Mesh* mesh, HaleData* hale_data,
     STOP_PROFILING(&out, "Scatter phase");
 
     // Fixes any extrema introduced by the advection
-    START_PROFILING(&out);
-    velocity_repair_phase(umesh, hale_data);
-    energy_repair_phase(umesh, hale_data);
-    STOP_PROFILING(&out, "Repair phase");
+    if (repair) {
+      START_PROFILING(&out);
+      velocity_repair_phase(umesh, hale_data);
+      energy_repair_phase(umesh, hale_data);
+      STOP_PROFILING(&out, "Repair phase");
+    }
 
     PRINT_PROFILING_RESULTS(&out);
   }
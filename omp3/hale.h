@@ -1,15 +1,104 @@
 #include "../../mesh.h"
 #include "../hale_data.h"
+#include "../small_matrix.h"
+#include "region.h"
+#include "schedule.h"
+
+// The number of swept edge prisms evaluated together, one in each double
+// precision lane of the vector unit
+#ifndef SWEPT_EDGE_BATCH
+#if defined(__AVX512F__)
+#define SWEPT_EDGE_BATCH 8
+#else
+#define SWEPT_EDGE_BATCH 4
+#endif
+#endif
+
+// The density, energy densities and velocity are reconstructed in a sweep
+// subcell
+enum {
+  SWEEP_M,
+  SWEEP_IE,
+  SWEEP_KE,
+  SWEEP_VX,
+  SWEEP_VY,
+  SWEEP_VZ,
+  NSWEEP_QUANTITIES
+};
+
+// The points of a sweep subcell that its gradients are limited at, which are
+// its node, its cell centre, and a face centre and half edge for each face
+#define MAX_SWEEP_LIMIT_POINTS (2 + 2 * NSUBCELL_FACES_BY_NODE)
+
+// The limited linear reconstruction of the quantities in a sweep subcell
+typedef struct {
+  int index;
+
+  // The quantities are constant across the subcell in a first order remap
+  int piecewise_constant;
+
+  vec_t c;
+  double density;
+  double ie_density;
+  double ke_density;
+  vec_t v;
+  vec_t grad_m;
+  vec_t grad_ie;
+  vec_t grad_ke;
+  vec_t grad_vx;
+  vec_t grad_vy;
+  vec_t grad_vz;
+
+  // The least squares system for the gradients, and the extrema that limit
+  // them, with the quantities in the order of the enumeration
+  double coeff[NSYM_3X3];
+  double rhs_x[NSWEEP_QUANTITIES];
+  double rhs_y[NSWEEP_QUANTITIES];
+  double rhs_z[NSWEEP_QUANTITIES];
+  double gmax[NSWEEP_QUANTITIES];
+  double gmin[NSWEEP_QUANTITIES];
+
+  // The points that the gradients were limited at, which the passive tracers
+  // reconstructed in the same subcell are limited at in turn
+  int nlimit_points;
+  vec_t limit_points[MAX_SWEEP_LIMIT_POINTS];
+} SweepSubcell;
+
+// A batch of swept edge prisms, with the vertices of each prism gathered into
+// a lane of the tiles
+typedef struct {
+  double x[2 * NNODES_BY_SUBCELL_FACE][SWEPT_EDGE_BATCH];
+  double y[2 * NNODES_BY_SUBCELL_FACE][SWEPT_EDGE_BATCH];
+  double z[2 * NNODES_BY_SUBCELL_FACE][SWEPT_EDGE_BATCH];
+  int subcell_index[SWEPT_EDGE_BATCH];
+  int ff[SWEPT_EDGE_BATCH];
+  int neighbour_cc[SWEPT_EDGE_BATCH];
+  int internal[SWEPT_EDGE_BATCH];
+  int nprisms;
+} SweptEdgeBatch;
 
 // Performs the Lagrangian step of the hydro solve
 void lagrangian_phase(Mesh* mesh, UnstructuredMesh* umesh, HaleData* hale_data);
 
+// Evaluates the pressure and soundspeed of each cell from the equation of
+// state, which is the ideal gas unless a table is given
+void equation_of_state(const int ncells, const EosTable* eos_table,
+                       const double* energy, const double* density,
+                       double* pressure, double* soundspeed);
+
+// Evaluates the pressure and soundspeed of the mixed cells from the equation
+// of state of each of their materials
+void mixed_equation_of_state(const MultiMaterial* mm,
+                             const EosTable* eos_table, const double* energy,
+                             const double* density, double* pressure,
+                             double* soundspeed);
+
 // Controls the timestep for the simulation
 void set_timestep(const int ncells, const double* nodes_x,
                   const double* nodes_y, const double* nodes_z,
-                  const double* energy, double* dt, int* cells_to_faces_offsets,
-                  int* cells_to_faces, int* faces_to_nodes_offsets,
-                  int* faces_to_nodes);
+                  const double* soundspeed, double* dt,
+                  int* cells_to_faces_offsets, int* cells_to_faces,
+                  int* faces_to_nodes_offsets, int* faces_to_nodes);
 
 // gathers all of the subcell quantities on the mesh
 void gather_subcell_quantities(UnstructuredMesh* umesh, HaleData* hale_data,
@@ -17,6 +106,10 @@ void gather_subcell_quantities(UnstructuredMesh* umesh, HaleData* hale_data,
                                double* initial_ie_mass,
                                double* initial_ke_mass);
 
+// Sums the amount of each tracer over the cells
+void sum_tracers(const int ncells, const int ntracers, const double* cell_mass,
+                 const double* concentration, double* total);
+
 // Performs a remap and some scattering of the subcell values
 void advection_phase(UnstructuredMesh* umesh, HaleData* hale_data);
 
@@ -47,12 +140,30 @@ void calc_volume(const int cell_to_faces_off, const int nfaces_by_cell,
                  const double* nodes_y, const double* nodes_z,
                  const vec_t* cell_centroid, double* vol);
 
-// Stores the rezoned mesh specification as the original mesh. Until we
-// determine a reasonable rezoning algorithm, this makes us Eulerian
-void store_rezoned_mesh(const int nnodes, const double* nodes_x,
-                        const double* nodes_y, const double* nodes_z,
-                        double* rezoned_nodes_x, double* rezoned_nodes_y,
-                        double* rezoned_nodes_z);
+// Rotates the node buffers, so the other buffer becomes the current mesh
+void rotate_nodes(UnstructuredMesh* umesh);
+
+// Swaps a pair of double buffers
+void swap_buffers(double** buf0, double** buf1);
+
+// Moves the current mesh on to a new geometry epoch, as its nodes have changed
+void advance_geometry_epoch(HaleData* hale_data);
+
+// Returns the current mesh to the epoch of some nodes it has been rotated to
+void restore_geometry_epoch(HaleData* hale_data, const int epoch);
+
+// Determines whether some derived geometry needs evaluating at an epoch,
+// counting the evaluation that was avoided when it is still fresh
+int geometry_stale(GeometryStamp* stamp, const int epoch);
+
+// Records that some derived geometry was evaluated at an epoch
+void stamp_geometry(GeometryStamp* stamp, const int epoch);
+
+// Records that some derived geometry was restored from a stored copy
+void reuse_geometry(GeometryStamp* stamp, const int epoch);
+
+// Prints the evaluations of the derived geometry since the last report
+void print_geometry_stamps(HaleData* hale_data);
 
 // Calculate the centroid
 void calc_centroid(const int nnodes, const double* nodes_x,
@@ -68,9 +179,6 @@ void calc_inverse_coefficient_matrix(
     const int nsubcells_by_subcell, const int subcell_to_subcells_off,
     vec_t (*inv)[3]);
 
-// Calculates the inverse of a 3x3 matrix, out-of-place
-void calc_3x3_inverse(vec_t (*a)[3], vec_t (*inv)[3]);
-
 // Calculate the gradient for the
 void calc_gradient(const int subcell_index, const int nsubcells_by_subcell,
                    const int subcell_to_subcells_off,
@@ -100,10 +208,9 @@ void calc_volumes_centroids(
     double* subcell_volume, double* cell_volume, double* nodal_volumes,
     int* nodes_offsets, int* nodes_to_cells);
 
-void apply_mesh_rezoning(const int nnodes, const double* rezoned_nodes_x,
-                         const double* rezoned_nodes_y,
-                         const double* rezoned_nodes_z, double* nodes_x0,
-                         double* nodes_y0, double* nodes_z0);
+// Applies the mesh rezoning strategy
+void apply_mesh_rezoning(const double* rezoned_nodes_x,
+                         UnstructuredMesh* umesh);
 
 // Contributes a face to the volume of some cell
 void contribute_face_volume(const int nnodes_by_face, const int* faces_to_nodes,
@@ -145,7 +252,13 @@ void perform_advection(
     const int ncells, const int* cells_offsets, const double* nodes_x,
     const double* nodes_y, const double* nodes_z, const double* rezoned_nodes_x,
     const double* rezoned_nodes_y, const double* rezoned_nodes_z,
-    const int* cells_to_nodes, const int* faces_to_nodes_offsets,
+    const double* rezoned_cell_centroids_x,
+    const double* rezoned_cell_centroids_y,
+    const double* rezoned_cell_centroids_z,
+    const double* rezoned_face_centroids_x,
+    const double* rezoned_face_centroids_y,
+    const double* rezoned_face_centroids_z, const int* cells_to_nodes,
+    const int* faces_to_nodes_offsets,
     const int* faces_to_nodes, const int* faces_cclockwise_cell,
     const int* subcells_to_faces_offsets, const int* subcells_to_faces,
     const int* subcells_to_subcells_offsets, const int* subcells_to_subcells,
@@ -157,7 +270,79 @@ void perform_advection(
     const double* subcell_momentum_y, const double* subcell_momentum_z,
     const double* subcell_mass, double* subcell_mass_flux,
     const double* subcell_ie_mass, double* subcell_ie_mass_flux,
-    const double* subcell_ke_mass, double* subcell_ke_mass_flux);
+    const double* subcell_ke_mass, double* subcell_ke_mass_flux,
+    double* face_flux, const int ntracers, const double* subcell_tracer_mass,
+    double* subcell_tracer_flux, const int remap_order,
+    SolveCounts* solve_counts);
+
+// Reconstructs the density and energy densities of every cell about its
+// centroid, from the totals of its subcells
+void reconstruct_cell_quantities(
+    const int ncells, const int* cells_to_nodes_offsets,
+    const int* cells_to_nodes, const int* cells_to_faces_offsets,
+    const int* cells_to_faces, const int* faces_to_cells0,
+    const int* faces_to_cells1, const double* nodes_x, const double* nodes_y,
+    const double* nodes_z, const double* cell_volume,
+    const double* subcell_mass, const double* subcell_ie_mass,
+    const double* subcell_ke_mass, const int remap_order,
+    double* cell_reconstruction, SolveCounts* solve_counts);
+
+// Advects mass and energy through the faces of the cells, and the nodal mass
+// and momentum through the faces of the dual mesh
+void perform_cell_advection(
+    const int ncells, const int* cells_to_nodes_offsets,
+    const int* cells_to_nodes, const int* cells_to_faces_offsets,
+    const int* cells_to_faces, const int* faces_to_nodes_offsets,
+    const int* faces_to_nodes, const int* faces_to_cells0,
+    const int* faces_to_cells1, const int* faces_cclockwise_cell,
+    const int* subcells_to_faces_offsets, const int* subcells_to_faces,
+    const double* nodes_x, const double* nodes_y, const double* nodes_z,
+    const double* rezoned_nodes_x, const double* rezoned_nodes_y,
+    const double* rezoned_nodes_z, const double* rezoned_cell_centroids_x,
+    const double* rezoned_cell_centroids_y,
+    const double* rezoned_cell_centroids_z,
+    const double* rezoned_face_centroids_x,
+    const double* rezoned_face_centroids_y,
+    const double* rezoned_face_centroids_z, const double* subcell_centroids_x,
+    const double* subcell_centroids_y, const double* subcell_centroids_z,
+    const double* nodal_mass, const double* nodal_volumes,
+    const double* velocity_x, const double* velocity_y,
+    const double* velocity_z, const double* cell_reconstruction,
+    double* subcell_mass_flux, double* subcell_ie_mass_flux,
+    double* subcell_ke_mass_flux, double* subcell_momentum_flux_x,
+    double* subcell_momentum_flux_y, double* subcell_momentum_flux_z,
+    double* face_flux, const int ntracers, const double* subcell_tracer_mass,
+    double* subcell_tracer_flux);
+
+// Contributes the mass, energy and tracer flux through a face of a cell, from
+// the reconstruction of the upwind cell
+void flux_cell_face(
+    const int cc, const int neighbour_cc, const int face_index,
+    const vec_t* cell_c, const double* se_nodes_x, const double* se_nodes_y,
+    const double* se_nodes_z, const int* swept_edge_to_faces,
+    const int* swept_edge_faces_to_nodes,
+    const int* swept_edge_faces_to_nodes_offsets,
+    const int* cells_to_nodes_offsets, const int* cells_to_nodes,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const int* faces_cclockwise_cell, const double* cell_reconstruction,
+    double* subcell_mass_flux, double* subcell_ie_mass_flux,
+    double* subcell_ke_mass_flux, double* face_flux, const int ntracers,
+    const double* subcell_tracer_mass, double* subcell_tracer_flux);
+
+// Contributes the mass and momentum flux through a face of the dual mesh,
+// between the subcells of the two nodes of an edge of a cell
+void flux_dual_face(
+    const int subcell_index, const int r_subcell_index, const int node_index,
+    const int r_node_index, const double* se_nodes_x, const double* se_nodes_y,
+    const double* se_nodes_z, const int* swept_edge_to_faces,
+    const int* swept_edge_faces_to_nodes,
+    const int* swept_edge_faces_to_nodes_offsets,
+    const double* subcell_centroids_x, const double* subcell_centroids_y,
+    const double* subcell_centroids_z, const double* nodal_mass,
+    const double* nodal_volumes, const double* velocity_x,
+    const double* velocity_y, const double* velocity_z,
+    double* subcell_mass_flux, double* subcell_momentum_flux_x,
+    double* subcell_momentum_flux_y, double* subcell_momentum_flux_z);
 
 // Contributes the local mass, energy and momentum flux for a given subcell face
 void flux_mass_energy_momentum(
@@ -179,14 +364,141 @@ void flux_mass_energy_momentum(
     const int* faces_to_nodes_offsets, const int* faces_to_nodes,
     const int* cells_offsets, const int* cells_to_nodes,
     const int* faces_cclockwise_cell, const double* nodes_x,
-    const double* nodes_y, const double* nodes_z, const int internal);
+    const double* nodes_y, const double* nodes_z, double* face_flux,
+    const int ntracers, const double* subcell_tracer_mass,
+    double* subcell_tracer_flux, const int remap_order, const int internal,
+    double* nill_conditioned, double* nsingular);
+
+// Gathers the vertices of a swept edge prism into the next lane of a batch
+void add_swept_edge_prism(SweptEdgeBatch* batch, const double* se_nodes_x,
+                          const double* se_nodes_y, const double* se_nodes_z,
+                          const int subcell_index, const int ff,
+                          const int neighbour_cc, const int internal);
+
+// Contributes the local mass, energy and momentum flux for a batch of swept
+// edge prisms, evaluating the prisms across the vector lanes
+void flux_swept_edge_batch(
+    const int cc, vec_t* cell_c, SweptEdgeBatch* batch,
+    const double* subcell_mass, double* subcell_mass_flux,
+    const double* subcell_ie_mass, double* subcell_ie_mass_flux,
+    const double* subcell_ke_mass, double* subcell_ke_mass_flux,
+    const double* subcell_volume, const double* subcell_momentum_x,
+    const double* subcell_momentum_y, const double* subcell_momentum_z,
+    double* subcell_momentum_flux_x, double* subcell_momentum_flux_y,
+    double* subcell_momentum_flux_z, const int* swept_edge_faces_to_nodes,
+    const double* subcell_centroids_x, const double* subcell_centroids_y,
+    const double* subcell_centroids_z, const int* swept_edge_to_faces,
+    const int* swept_edge_faces_to_nodes_offsets,
+    const int* subcells_to_subcells_offsets, const int* subcells_to_subcells,
+    const int* subcells_to_faces_offsets, const int* subcells_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const int* cells_offsets, const int* cells_to_nodes,
+    const int* faces_cclockwise_cell, const double* nodes_x,
+    const double* nodes_y, const double* nodes_z, double* face_flux,
+    const int ntracers, const double* subcell_tracer_mass,
+    double* subcell_tracer_flux, const int remap_order,
+    double* nill_conditioned, double* nsingular);
+
+// Records the flux leaving a cell through the external face of a subcell
+void record_face_flux(const int cc, const int ff, const int subcell_index,
+                      const double volume_flux, const double mass_flux,
+                      const double ie_flux,
+                      const int* subcells_to_faces_offsets,
+                      const int* subcells_to_faces,
+                      const int* faces_cclockwise_cell, double* face_flux);
+
+// Reconstructs the quantities in the subcell that a swept edge region is
+// taking its mass, energy and momentum from, with least squares gradients
+// limited to the extrema of the neighbourhood, returning the state of the solve
+int reconstruct_sweep_subcell(
+    const int cc, const int neighbour_cc, const int ff, const int subcell_index,
+    const int internal, const int is_outflux, const double swept_edge_vol,
+    vec_t* cell_c, const double* subcell_mass, const double* subcell_ie_mass,
+    const double* subcell_ke_mass, const double* subcell_volume,
+    const double* subcell_momentum_x, const double* subcell_momentum_y,
+    const double* subcell_momentum_z, const double* subcell_centroids_x,
+    const double* subcell_centroids_y, const double* subcell_centroids_z,
+    const int* subcells_to_subcells_offsets, const int* subcells_to_subcells,
+    const int* subcells_to_faces_offsets, const int* subcells_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const int* cells_offsets, const int* cells_to_nodes,
+    const int* faces_cclockwise_cell, const double* nodes_x,
+    const double* nodes_y, const double* nodes_z, SweepSubcell* sweep);
+
+// Finds the subcell that a swept edge region is taking its mass, energy and
+// momentum from
+int find_sweep_subcell(const int ff, const int subcell_index,
+                       const int internal, const int is_outflux,
+                       const double swept_edge_vol,
+                       const int* subcells_to_subcells_offsets,
+                       const int* subcells_to_subcells);
+
+// Selects the subcell that a swept edge region is taking its mass, energy and
+// momentum from for a first order donor cell remap, without gradients
+void select_donor_subcell(
+    const int ff, const int subcell_index, const int internal,
+    const int is_outflux, const double swept_edge_vol,
+    const double* subcell_mass, const double* subcell_ie_mass,
+    const double* subcell_ke_mass, const double* subcell_volume,
+    const double* subcell_momentum_x, const double* subcell_momentum_y,
+    const double* subcell_momentum_z, const double* subcell_centroids_x,
+    const double* subcell_centroids_y, const double* subcell_centroids_z,
+    const int* subcells_to_subcells_offsets, const int* subcells_to_subcells,
+    SweepSubcell* sweep);
+
+// Assembles the least squares system for the gradients in the subcell that a
+// swept edge region is taking its mass, energy and momentum from
+void assemble_sweep_subcell(
+    const int ff, const int subcell_index, const int internal,
+    const int is_outflux, const double swept_edge_vol,
+    const double* subcell_mass, const double* subcell_ie_mass,
+    const double* subcell_ke_mass, const double* subcell_volume,
+    const double* subcell_momentum_x, const double* subcell_momentum_y,
+    const double* subcell_momentum_z, const double* subcell_centroids_x,
+    const double* subcell_centroids_y, const double* subcell_centroids_z,
+    const int* subcells_to_subcells_offsets, const int* subcells_to_subcells,
+    SweepSubcell* sweep);
+
+// Limits the gradients in the subcell that a swept edge region is taking its
+// mass, energy and momentum from, to the extrema of the neighbourhood
+void limit_sweep_subcell(
+    const int cc, const int neighbour_cc, const int ff, const int internal,
+    const int is_outflux, vec_t* cell_c, const int* subcells_to_faces_offsets,
+    const int* subcells_to_faces, const int* faces_to_nodes_offsets,
+    const int* faces_to_nodes, const int* cells_to_nodes_offsets,
+    const int* cells_to_nodes, const int* faces_cclockwise_cell,
+    const double* nodes_x, const double* nodes_y, const double* nodes_z,
+    SweepSubcell* sweep);
+
+// Contributes the flux of the passive tracers through a swept edge region,
+// reconstructed in the sweep subcell that the mass was taken from
+void flux_sweep_tracers(const int ntracers, const int subcell_index,
+                        const int is_outflux, const double swept_edge_vol,
+                        const vec_t* swept_edge_c, const SweepSubcell* sweep,
+                        const double* subcell_volume,
+                        const double* subcell_centroids_x,
+                        const double* subcell_centroids_y,
+                        const double* subcell_centroids_z,
+                        const int* subcells_to_subcells_offsets,
+                        const int* subcells_to_subcells,
+                        const double* subcell_tracer_mass,
+                        double* subcell_tracer_flux);
+
+// Limits the gradients of a sweep subcell at a point in the subcell, recording
+// the point
+void limit_sweep_gradients(vec_t point, SweepSubcell* sweep, double* limiter);
+
+// Unpacks the gradients of a sweep subcell from the solutions of a batch
+void unpack_sweep_gradients(const int stride, const int mm,
+                            const double* grad_x, const double* grad_y,
+                            const double* grad_z, SweepSubcell* sweep);
 
 // Controls the timestep for the simulation
 void set_timestep(const int ncells, const double* nodes_x,
                   const double* nodes_y, const double* nodes_z,
-                  const double* energy, double* dt, int* cells_to_faces_offsets,
-                  int* cells_to_faces, int* faces_to_nodes_offsets,
-                  int* faces_to_nodes);
+                  const double* soundspeed, double* dt,
+                  int* cells_to_faces_offsets, int* cells_to_faces,
+                  int* faces_to_nodes_offsets, int* faces_to_nodes);
 
 // Limits all of the gradients during flux determination
 void limit_mass_gradients(
@@ -209,3 +521,11 @@ void limit_momentum_gradients(
     const double gmin_vx, const double gmax_vy, const double gmin_vy,
     const double gmax_vz, const double gmin_vz, vec_t* grad_vx, vec_t* grad_vy,
     vec_t* grad_vz, double* vx_limiter, double* vy_limiter, double* vz_limiter);
+
+// Sums subcell quantities into the nodes of a slice of the SELL-C-sigma node
+// to subcell adjacency, in the order of the original list, where the padding
+// is masked rather than branched around
+void sum_sell_subcells(const SellAdjacency* nodes_to_cells_sell,
+                       const int* nodes_to_subcells_sell, const int ss,
+                       const int nquantities, const double** subcell_quantity,
+                       double (*node_sum)[SELL_CHUNK]);
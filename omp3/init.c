@@ -1,7 +1,10 @@
 #include "../../shared.h"
 #include "../hale_data.h"
 #include "hale.h"
+#include "lagrange.h"
 #include <math.h>
+#include <omp.h>
+#include <stdio.h>
 
 // Initialises the cell mass, sub-cell mass and sub-cell volume
 void init_mesh_mass(const int ncells, const int nnodes,
@@ -21,6 +24,7 @@ void init_mesh_mass(const int ncells, const int nnodes,
   printf("Performing Initialisation.\n");
 
   // Calculates the cell volume, subcell volume and the subcell centroids
+  OMP_PARALLEL()
   calc_volumes_centroids(
       ncells, nnodes, nnodes_by_subcell, cells_to_nodes_offsets, cells_to_nodes,
       subcells_to_faces_offsets, subcells_to_faces, faces_to_nodes,
@@ -102,7 +106,7 @@ void calc_volumes_centroids(
     int* nodes_to_cells_offsets, int* nodes_to_cells) {
 
   double total_subcell_volume = 0.0;
-#pragma omp parallel for reduction(+ : total_subcell_volume)
+  OMP_FOR_REDUCTION(reduction(+ : total_subcell_volume))
   for (int cc = 0; cc < ncells; ++cc) {
     const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
     const int nnodes_by_cell =
@@ -294,8 +298,9 @@ void calc_volumes_centroids(
       total_subcell_volume += subcell_volume[(subcell_index)];
     }
   }
+  TEAM_SUM(&total_subcell_volume);
 
-#pragma omp parallel for
+  OMP_FOR()
   for (int nn = 0; nn < nnodes; ++nn) {
     const int node_to_cells_off = nodes_to_cells_offsets[(nn)];
     const int ncells_by_node =
@@ -318,10 +323,34 @@ void calc_volumes_centroids(
       }
     }
   }
+  OMP_BARRIER();
 
+  OMP_MASTER()
   printf("Total Subcell Volume   %.12f\n", total_subcell_volume);
 }
 
+// Calculates the centroid of a cell
+static inline void init_cell_centroid(const int cc,
+                                      const int* cells_to_nodes_offsets,
+                                      const int* cells_to_nodes,
+                                      const double* nodes_x,
+                                      const double* nodes_y,
+                                      const double* nodes_z,
+                                      double* cell_centroids_x,
+                                      double* cell_centroids_y,
+                                      double* cell_centroids_z) {
+  const int cells_off = cells_to_nodes_offsets[(cc)];
+  const int nnodes_by_cell = cells_to_nodes_offsets[(cc + 1)] - cells_off;
+
+  vec_t cell_c = {0.0, 0.0, 0.0};
+  calc_centroid(nnodes_by_cell, nodes_x, nodes_y, nodes_z, cells_to_nodes,
+                cells_off, &cell_c);
+
+  cell_centroids_x[(cc)] = cell_c.x;
+  cell_centroids_y[(cc)] = cell_c.y;
+  cell_centroids_z[(cc)] = cell_c.z;
+}
+
 // Initialises the centroids for each cell
 void init_cell_centroids(const int ncells, const int* cells_to_nodes_offsets,
                          const int* cells_to_nodes, const double* nodes_x,
@@ -331,22 +360,436 @@ void init_cell_centroids(const int ncells, const int* cells_to_nodes_offsets,
 
   // Calculate the cell centroids
   START_PROFILING(&compute_profile);
-#pragma omp parallel for
+  OMP_FOR()
   for (int cc = 0; cc < ncells; ++cc) {
-    const int cells_off = cells_to_nodes_offsets[(cc)];
-    const int nnodes_by_cell = cells_to_nodes_offsets[(cc + 1)] - cells_off;
+    init_cell_centroid(cc, cells_to_nodes_offsets, cells_to_nodes, nodes_x,
+                       nodes_y, nodes_z, cell_centroids_x, cell_centroids_y,
+                       cell_centroids_z);
+  }
+  OMP_BARRIER();
+  STOP_PROFILING(&compute_profile, __func__);
+}
+
+// Calculates the centroids of the listed cells
+void init_cell_centroids_active(const int nlisted, const int* cell_list,
+                                const int* cells_to_nodes_offsets,
+                                const int* cells_to_nodes,
+                                const double* nodes_x, const double* nodes_y,
+                                const double* nodes_z,
+                                double* cell_centroids_x,
+                                double* cell_centroids_y,
+                                double* cell_centroids_z) {
+
+  START_PROFILING(&compute_profile);
+  OMP_FOR()
+  for (int ii = 0; ii < nlisted; ++ii) {
+    init_cell_centroid(cell_list[(ii)], cells_to_nodes_offsets, cells_to_nodes,
+                       nodes_x, nodes_y, nodes_z, cell_centroids_x,
+                       cell_centroids_y, cell_centroids_z);
+  }
+  OMP_BARRIER();
+  STOP_PROFILING(&compute_profile, "init_cell_centroids");
+}
+
+// Initialises the centroids for each face
+void init_face_centroids(const int nfaces, const int* faces_to_nodes_offsets,
+                         const int* faces_to_nodes, const double* nodes_x,
+                         const double* nodes_y, const double* nodes_z,
+                         double* face_centroids_x, double* face_centroids_y,
+                         double* face_centroids_z) {
+
+  START_PROFILING(&compute_profile);
+  OMP_FOR()
+  for (int ff = 0; ff < nfaces; ++ff) {
+    const int face_to_nodes_off = faces_to_nodes_offsets[(ff)];
+    const int nnodes_by_face =
+        faces_to_nodes_offsets[(ff + 1)] - face_to_nodes_off;
+
+    vec_t face_c = {0.0, 0.0, 0.0};
+    calc_centroid(nnodes_by_face, nodes_x, nodes_y, nodes_z, faces_to_nodes,
+                  face_to_nodes_off, &face_c);
+
+    face_centroids_x[(ff)] = face_c.x;
+    face_centroids_y[(ff)] = face_c.y;
+    face_centroids_z[(ff)] = face_c.z;
+  }
+  OMP_BARRIER();
+  STOP_PROFILING(&compute_profile, __func__);
+}
+
+// Initialises the volume of each cell
+void init_cell_volumes(const int ncells, const int* cells_to_nodes_offsets,
+                       const int* cells_to_nodes,
+                       const int* cells_to_faces_offsets,
+                       const int* cells_to_faces,
+                       const int* faces_to_nodes_offsets,
+                       const int* faces_to_nodes, const double* nodes_x,
+                       const double* nodes_y, const double* nodes_z,
+                       double* cell_volume) {
+
+  START_PROFILING(&compute_profile);
+  OMP_FOR()
+  for (int cc = 0; cc < ncells; ++cc) {
+    const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
+    const int nnodes_by_cell =
+        cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
+    const int cell_to_faces_off = cells_to_faces_offsets[(cc)];
+    const int nfaces_by_cell =
+        cells_to_faces_offsets[(cc + 1)] - cell_to_faces_off;
 
     vec_t cell_c = {0.0, 0.0, 0.0};
     calc_centroid(nnodes_by_cell, nodes_x, nodes_y, nodes_z, cells_to_nodes,
-                  cells_off, &cell_c);
+                  cell_to_nodes_off, &cell_c);
+    calc_volume(cell_to_faces_off, nfaces_by_cell, cells_to_faces,
+                faces_to_nodes, faces_to_nodes_offsets, nodes_x, nodes_y,
+                nodes_z, &cell_c, &cell_volume[(cc)]);
+  }
+  OMP_BARRIER();
+  STOP_PROFILING(&compute_profile, __func__);
+}
+
+// Points the rezoned mesh at the initial mesh, which is shared read-only with
+// the node buffer that the Lagrangian phase rotates out
+void init_rezoned_mesh(HaleData* hale_data, UnstructuredMesh* umesh) {
+  hale_data->rezoned_nodes_x = umesh->nodes_x0;
+  hale_data->rezoned_nodes_y = umesh->nodes_y0;
+  hale_data->rezoned_nodes_z = umesh->nodes_z0;
+}
+
+// Stores the geometry of the rezoned mesh, which must be called again by any
+// rezone that moves the rezoned nodes
+void store_rezoned_geometry(HaleData* hale_data, UnstructuredMesh* umesh) {
+  init_cell_centroids(umesh->ncells, umesh->cells_to_nodes_offsets,
+                      umesh->cells_to_nodes, hale_data->rezoned_nodes_x,
+                      hale_data->rezoned_nodes_y, hale_data->rezoned_nodes_z,
+                      hale_data->rezoned_cell_centroids_x,
+                      hale_data->rezoned_cell_centroids_y,
+                      hale_data->rezoned_cell_centroids_z);
+  init_face_centroids(umesh->nfaces, umesh->faces_to_nodes_offsets,
+                      umesh->faces_to_nodes, hale_data->rezoned_nodes_x,
+                      hale_data->rezoned_nodes_y, hale_data->rezoned_nodes_z,
+                      hale_data->rezoned_face_centroids_x,
+                      hale_data->rezoned_face_centroids_y,
+                      hale_data->rezoned_face_centroids_z);
+  init_cell_volumes(umesh->ncells, umesh->cells_to_nodes_offsets,
+                    umesh->cells_to_nodes, umesh->cells_to_faces_offsets,
+                    umesh->cells_to_faces, umesh->faces_to_nodes_offsets,
+                    umesh->faces_to_nodes, hale_data->rezoned_nodes_x,
+                    hale_data->rezoned_nodes_y, hale_data->rezoned_nodes_z,
+                    hale_data->rezoned_cell_volume);
+
+  // The rezoned mesh is a new epoch, unless it is the current mesh
+  hale_data->rezoned_geometry_epoch =
+      (hale_data->rezoned_nodes_x == umesh->nodes_x0)
+          ? hale_data->geometry_epoch
+          : ++hale_data->ngeometry_epochs;
+}
+
+// Copies the nodal vector of each hex into its cell-local block
+void pack_cell_nodes(const int ncells, const int* cells_to_nodes_offsets,
+                     const int* cells_to_nodes, const double* nodes_x,
+                     const double* nodes_y, const double* nodes_z,
+                     double* cell_nodes) {
+
+  START_PROFILING(&compute_profile);
+  OMP_FOR()
+  for (int cc = 0; cc < ncells; ++cc) {
+    const int cells_off = cells_to_nodes_offsets[(cc)];
+    double* block = &cell_nodes[(cc * HEX_BLOCK)];
+    for (int nn = 0; nn < NNODES_BY_HEX; ++nn) {
+      const int node_index = cells_to_nodes[(cells_off + nn)];
+      block[(nn)] = nodes_x[(node_index)];
+      block[(NNODES_BY_HEX + nn)] = nodes_y[(node_index)];
+      block[(2 * NNODES_BY_HEX + nn)] = nodes_z[(node_index)];
+    }
+  }
+  OMP_BARRIER();
+  STOP_PROFILING(&compute_profile, __func__);
+}
+
+// Initialises the centroids for each cell from the cell-local blocks
+void init_cell_centroids_packed(const int ncells, const double* cell_nodes,
+                                double* cell_centroids_x,
+                                double* cell_centroids_y,
+                                double* cell_centroids_z) {
+
+  START_PROFILING(&compute_profile);
+  OMP_FOR()
+  for (int cc = 0; cc < ncells; ++cc) {
+    const double* block = &cell_nodes[(cc * HEX_BLOCK)];
+
+    // Summed in the same order as calc_centroid
+    vec_t cell_c = {0.0, 0.0, 0.0};
+    for (int nn = 0; nn < NNODES_BY_HEX; ++nn) {
+      cell_c.x += block[(nn)] / NNODES_BY_HEX;
+      cell_c.y += block[(NNODES_BY_HEX + nn)] / NNODES_BY_HEX;
+      cell_c.z += block[(2 * NNODES_BY_HEX + nn)] / NNODES_BY_HEX;
+    }
 
     cell_centroids_x[(cc)] = cell_c.x;
     cell_centroids_y[(cc)] = cell_c.y;
     cell_centroids_z[(cc)] = cell_c.z;
   }
+  OMP_BARRIER();
   STOP_PROFILING(&compute_profile, __func__);
 }
 
+// Points the node state at a time level, interleaving a copy of the nodal
+// arrays with AOSOA_NODE_STATE
+void sync_node_state(const int nnodes, const double* nodes_x,
+                     const double* nodes_y, const double* nodes_z,
+                     const double* velocity_x, const double* velocity_y,
+                     const double* velocity_z, const double* nodal_mass,
+                     const double* nodal_volumes, NodeState* node_state) {
+
+#ifdef AOSOA_NODE_STATE
+  const int nblocks = (nnodes + NODE_STATE_BLOCK - 1) / NODE_STATE_BLOCK;
+
+  OMP_FOR()
+  for (int bb = 0; bb < nblocks; ++bb) {
+    const int block_end = min((bb + 1) * NODE_STATE_BLOCK, nnodes);
+    for (int nn = bb * NODE_STATE_BLOCK; nn < block_end; ++nn) {
+      NODE_STATE(node_state, NODE_X, nn) = nodes_x[(nn)];
+      NODE_STATE(node_state, NODE_Y, nn) = nodes_y[(nn)];
+      NODE_STATE(node_state, NODE_Z, nn) = nodes_z[(nn)];
+      NODE_STATE(node_state, NODE_VX, nn) = velocity_x[(nn)];
+      NODE_STATE(node_state, NODE_VY, nn) = velocity_y[(nn)];
+      NODE_STATE(node_state, NODE_VZ, nn) = velocity_z[(nn)];
+      NODE_STATE(node_state, NODE_MASS, nn) = nodal_mass[(nn)];
+      NODE_STATE(node_state, NODE_VOLUME, nn) = nodal_volumes[(nn)];
+    }
+  }
+  OMP_BARRIER();
+#else
+  // The view costs nothing in the default layout
+  OMP_SINGLE()
+  {
+    node_state->field[(NODE_X)] = nodes_x;
+    node_state->field[(NODE_Y)] = nodes_y;
+    node_state->field[(NODE_Z)] = nodes_z;
+    node_state->field[(NODE_VX)] = velocity_x;
+    node_state->field[(NODE_VY)] = velocity_y;
+    node_state->field[(NODE_VZ)] = velocity_z;
+    node_state->field[(NODE_MASS)] = nodal_mass;
+    node_state->field[(NODE_VOLUME)] = nodal_volumes;
+  }
+#endif
+}
+
+// Times the gather-heavy kernels that read the node state, in the layout of
+// the build. The subcell forces are always cleared before they are read, so
+// the kernels can be timed in place.
+void benchmark_node_state(UnstructuredMesh* umesh, HaleData* hale_data) {
+  const double sync_start = omp_get_wtime();
+  for (int ii = 0; ii < LAYOUT_BENCHMARK_REPS; ++ii) {
+    sync_node_state(umesh->nnodes, umesh->nodes_x0, umesh->nodes_y0,
+                    umesh->nodes_z0, hale_data->velocity_x0,
+                    hale_data->velocity_y0, hale_data->velocity_z0,
+                    hale_data->nodal_mass, hale_data->nodal_volumes,
+                    &hale_data->node_state);
+  }
+  const double sync_time = omp_get_wtime() - sync_start;
+
+#ifdef NODE_FORCE_ACCUMULATION
+  // The forces from pressure and viscosity are found in one sweep, and the
+  // node forces are cleared again for the first step
+  const double force_start = omp_get_wtime();
+  for (int ii = 0; ii < LAYOUT_BENCHMARK_REPS; ++ii) {
+    calc_node_forces(
+        hale_data->ncell_colours, hale_data->cell_colours_offsets,
+        hale_data->cells_by_colour, hale_data->visc_coeff1,
+        hale_data->visc_coeff2, umesh->cells_to_faces_offsets,
+        umesh->cells_to_nodes_offsets, umesh->cells_to_faces,
+        umesh->faces_to_nodes_offsets, umesh->faces_to_nodes,
+        umesh->cells_to_nodes, umesh->faces_cclockwise_cell,
+        &hale_data->node_state, umesh->cell_centroids_x,
+        umesh->cell_centroids_y, umesh->cell_centroids_z,
+        hale_data->nodal_soundspeed, hale_data->limiter, hale_data->pressure0,
+        hale_data->node_force_x, hale_data->node_force_y,
+        hale_data->node_force_z);
+  }
+  const double force_time = omp_get_wtime() - force_start;
+
+#pragma omp parallel for
+  for (int nn = 0; nn < umesh->nnodes; ++nn) {
+    hale_data->node_force_x[(nn)] = 0.0;
+    hale_data->node_force_y[(nn)] = 0.0;
+    hale_data->node_force_z[(nn)] = 0.0;
+  }
+
+  printf("Node state %s sync %.4fs, node forces %.4fs\n\n", NODE_STATE_LAYOUT,
+         sync_time / LAYOUT_BENCHMARK_REPS, force_time / LAYOUT_BENCHMARK_REPS);
+#else
+  const double force_start = omp_get_wtime();
+  for (int ii = 0; ii < LAYOUT_BENCHMARK_REPS; ++ii) {
+    calc_subcell_force_from_pressure(
+        umesh->ncells, umesh->cells_to_faces_offsets,
+        umesh->cells_to_nodes_offsets, umesh->cells_to_faces,
+        umesh->faces_to_nodes_offsets, umesh->faces_to_nodes,
+        umesh->cells_to_nodes, umesh->faces_cclockwise_cell,
+        &hale_data->node_state, hale_data->pressure0,
+        hale_data->subcell_force_x, hale_data->subcell_force_y,
+        hale_data->subcell_force_z);
+  }
+  const double force_time = omp_get_wtime() - force_start;
+
+  const double visc_start = omp_get_wtime();
+  for (int ii = 0; ii < LAYOUT_BENCHMARK_REPS; ++ii) {
+    calc_artificial_viscosity(
+        umesh->ncells, hale_data->visc_coeff1, hale_data->visc_coeff2,
+        umesh->cells_to_nodes_offsets, umesh->cells_to_nodes,
+        umesh->faces_cclockwise_cell, &hale_data->node_state,
+        umesh->cell_centroids_x, umesh->cell_centroids_y,
+        umesh->cell_centroids_z, hale_data->nodal_soundspeed,
+        hale_data->limiter, hale_data->subcell_force_x,
+        hale_data->subcell_force_y, hale_data->subcell_force_z,
+        umesh->faces_to_nodes_offsets, umesh->faces_to_nodes,
+        umesh->cells_to_faces_offsets, umesh->cells_to_faces);
+  }
+  const double visc_time = omp_get_wtime() - visc_start;
+
+
+  printf("Node state %s sync %.4fs, force from pressure %.4fs, viscosity "
+         "%.4fs\n\n",
+         NODE_STATE_LAYOUT, sync_time / LAYOUT_BENCHMARK_REPS,
+         force_time / LAYOUT_BENCHMARK_REPS, visc_time / LAYOUT_BENCHMARK_REPS);
+#endif
+}
+
+// Times the tabulated equation of state against the ideal gas, over a table
+// of the ideal gas that spans the initial state. The predicted pressure and
+// soundspeed are always written before they are read, so the kernels can be
+// timed in place.
+void benchmark_equation_of_state(UnstructuredMesh* umesh, HaleData* hale_data) {
+  const int ncells = umesh->ncells;
+
+  double density_lo = hale_data->density0[(0)];
+  double density_hi = hale_data->density0[(0)];
+  double energy_lo = hale_data->energy0[(0)];
+  double energy_hi = hale_data->energy0[(0)];
+  for (int cc = 0; cc < ncells; ++cc) {
+    density_lo = min(density_lo, hale_data->density0[(cc)]);
+    density_hi = max(density_hi, hale_data->density0[(cc)]);
+    energy_lo = min(energy_lo, hale_data->energy0[(cc)]);
+    energy_hi = max(energy_hi, hale_data->energy0[(cc)]);
+  }
+
+  // Tabulate the ideal gas over twice the range of the initial state
+  const int nvalues = EOS_BENCHMARK_TABLE;
+  double* densities;
+  double* energies;
+  double* pressure;
+  double* soundspeed;
+  allocate_data(&densities, nvalues);
+  allocate_data(&energies, nvalues);
+  allocate_data(&pressure, nvalues * nvalues);
+  allocate_data(&soundspeed, nvalues * nvalues);
+  for (int ii = 0; ii < nvalues; ++ii) {
+    const double t = ii / (double)(nvalues - 1);
+    densities[(ii)] =
+        0.5 * density_lo + t * (2.0 * density_hi - 0.5 * density_lo);
+    energies[(ii)] = 0.5 * energy_lo + t * (2.0 * energy_hi - 0.5 * energy_lo);
+  }
+  for (int dd = 0; dd < nvalues; ++dd) {
+    for (int ee = 0; ee < nvalues; ++ee) {
+      calc_eos(energies[(ee)], densities[(dd)], &pressure[(dd * nvalues + ee)],
+               &soundspeed[(dd * nvalues + ee)]);
+    }
+  }
+
+  EosTable eos_table;
+  init_eos_table(&eos_table, nvalues, nvalues, densities, energies, pressure,
+                 soundspeed);
+
+  const double ideal_start = omp_get_wtime();
+  for (int ii = 0; ii < LAYOUT_BENCHMARK_REPS; ++ii) {
+    equation_of_state(ncells, NULL, hale_data->energy0, hale_data->density0,
+                      hale_data->pressure1, hale_data->soundspeed1);
+  }
+  const double ideal_time = omp_get_wtime() - ideal_start;
+
+  const double tabulated_start = omp_get_wtime();
+  for (int ii = 0; ii < LAYOUT_BENCHMARK_REPS; ++ii) {
+    equation_of_state(ncells, &eos_table, hale_data->energy0,
+                      hale_data->density0, hale_data->pressure1,
+                      hale_data->soundspeed1);
+  }
+  const double tabulated_time = omp_get_wtime() - tabulated_start;
+
+  // The interpolation error against the ideal gas it tabulates
+  double max_error = 0.0;
+  for (int cc = 0; cc < ncells; ++cc) {
+    double p;
+    double c;
+    calc_eos(hale_data->energy0[(cc)], hale_data->density0[(cc)], &p, &c);
+    max_error = max(max_error, fabs(hale_data->pressure1[(cc)] - p) / p);
+    max_error = max(max_error, fabs(hale_data->soundspeed1[(cc)] - c) / c);
+  }
+
+  printf("Ideal gas EOS %.4fs, %.3e cells/s\n",
+         ideal_time / LAYOUT_BENCHMARK_REPS,
+         ncells * LAYOUT_BENCHMARK_REPS / ideal_time);
+  printf("Tabulated EOS %dx%d %.4fs, %.3e cells/s, %.2e max relative error\n\n",
+         nvalues, nvalues, tabulated_time / LAYOUT_BENCHMARK_REPS,
+         ncells * LAYOUT_BENCHMARK_REPS / tabulated_time, max_error);
+
+  deallocate_eos_table(&eos_table);
+  deallocate_data(densities);
+  deallocate_data(energies);
+  deallocate_data(pressure);
+  deallocate_data(soundspeed);
+}
+
+// Weighs the memory of the cell-local blocks against the time the density
+// kernels save by reading them. The predicted density is always written before
+// it is read, so the kernels can be timed in place, and the blocks are left
+// holding the initial mesh.
+void benchmark_packed_cell_nodes(UnstructuredMesh* umesh, HaleData* hale_data) {
+  const int ncells = umesh->ncells;
+
+  const double gather_start = omp_get_wtime();
+  for (int ii = 0; ii < LAYOUT_BENCHMARK_REPS; ++ii) {
+    calc_predicted_density(
+        ncells, umesh->cells_to_faces_offsets, umesh->cells_to_faces,
+        umesh->faces_to_nodes_offsets, umesh->faces_to_nodes, umesh->nodes_x0,
+        umesh->nodes_y0, umesh->nodes_z0, umesh->cell_centroids_x,
+        umesh->cell_centroids_y, umesh->cell_centroids_z, hale_data->cell_mass,
+        hale_data->density1);
+  }
+  const double gather_time = omp_get_wtime() - gather_start;
+
+  const double pack_start = omp_get_wtime();
+  for (int ii = 0; ii < LAYOUT_BENCHMARK_REPS; ++ii) {
+    pack_cell_nodes(ncells, umesh->cells_to_nodes_offsets,
+                    umesh->cells_to_nodes, umesh->nodes_x0, umesh->nodes_y0,
+                    umesh->nodes_z0, hale_data->cell_nodes);
+  }
+  const double pack_time = omp_get_wtime() - pack_start;
+
+  const double packed_start = omp_get_wtime();
+  for (int ii = 0; ii < LAYOUT_BENCHMARK_REPS; ++ii) {
+    calc_predicted_density_packed(
+        ncells, hale_data->cells_to_local_face_nodes, hale_data->cell_nodes,
+        umesh->cell_centroids_x, umesh->cell_centroids_y,
+        umesh->cell_centroids_z, hale_data->cell_mass, hale_data->density1);
+  }
+  const double packed_time = omp_get_wtime() - packed_start;
+
+  // Both vector blocks and the face table, against the node coordinates
+  const size_t block_bytes =
+      (size_t)ncells * (2 * HEX_BLOCK * sizeof(double) +
+                        NFACES_BY_HEX * NNODES_BY_HEX_FACE * sizeof(int));
+  const size_t node_bytes = (size_t)umesh->nnodes * 3 * sizeof(double);
+
+  printf("Packed cell nodes %.3fMB, %.2fx the node coordinates\n",
+         1024.0 * block_bytes / GB, block_bytes / (double)node_bytes);
+  printf("Density from gathered nodes %.4fs, from packed nodes %.4fs + %.4fs "
+         "packing\n\n",
+         gather_time / LAYOUT_BENCHMARK_REPS,
+         packed_time / LAYOUT_BENCHMARK_REPS,
+         pack_time / LAYOUT_BENCHMARK_REPS);
+}
+
 void init_subcells_to_faces(
     const int ncells, const int nsubcells, const int* cells_to_nodes_offsets,
     const int* nodes_to_faces_offsets, const int* cells_to_nodes,
@@ -5,74 +5,338 @@
 #include <float.h>
 #include <math.h>
 
+// The bodies of the kernels for a single node or cell, which are shared by the
+// kernels over the whole mesh and over the listed nodes or cells
+
+// Calculates the volume and sound speed of a node
+static inline void calc_node_vol_and_c(
+    const int nn, const int* nodes_to_faces_offsets, const int* nodes_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const int* faces_to_cells0, const int* faces_to_cells1,
+    const double* nodes_x, const double* nodes_y, const double* nodes_z,
+    const double* cell_centroids_x, const double* cell_centroids_y,
+    const double* cell_centroids_z, const double* soundspeed,
+    double* nodal_volumes, double* nodal_soundspeed);
+
+// Sets the subcell forces of a cell to 0
+static inline void zero_cell_forces(const int cc,
+                                    const int* cells_to_nodes_offsets,
+                                    double* subcell_force_x,
+                                    double* subcell_force_y,
+                                    double* subcell_force_z);
+
+// Sums the forces on the subcells around a node
+static inline vec_t sum_node_force(const int nn,
+                                   const int* nodes_to_cells_offsets,
+                                   const int* nodes_to_cells,
+                                   const int* cells_to_nodes_offsets,
+                                   const int* cells_to_nodes,
+                                   const double* subcell_force_x,
+                                   const double* subcell_force_y,
+                                   const double* subcell_force_z);
+
+// Calculates the time centered evolved velocity of a node
+static inline void calc_node_velocity(
+    const int nn, const double dt, const int* nodes_to_cells_offsets,
+    const int* nodes_to_cells, const int* cells_to_nodes_offsets,
+    const int* cells_to_nodes, const double* subcell_force_x,
+    const double* subcell_force_y, const double* subcell_force_z,
+    const double* nodal_mass, const double* velocity_x0,
+    const double* velocity_y0, const double* velocity_z0, double* velocity_x1,
+    double* velocity_y1, double* velocity_z1);
+
+// Updates and time centers the velocity of a node in the corrector step
+static inline void update_node_velocity(
+    const int nn, const double dt, const int* nodes_to_cells_offsets,
+    const int* nodes_to_cells, const int* cells_to_nodes_offsets,
+    const int* cells_to_nodes, const double* nodal_mass,
+    const double* subcell_force_x, const double* subcell_force_y,
+    const double* subcell_force_z, double* velocity_x0, double* velocity_y0,
+    double* velocity_z0, double* velocity_x1, double* velocity_y1,
+    double* velocity_z1);
+
+// Advances a node over the timestep with the given velocity
+static inline void advance_node(const int nn, const double dt,
+                                const double* velocity_x,
+                                const double* velocity_y,
+                                const double* velocity_z,
+                                const double* nodes_x0, const double* nodes_y0,
+                                const double* nodes_z0, double* nodes_x1,
+                                double* nodes_y1, double* nodes_z1);
+
+// Time centers the position of a node
+static inline void time_center_node(const int nn, const double* nodes_x0,
+                                    const double* nodes_y0,
+                                    const double* nodes_z0, double* nodes_x1,
+                                    double* nodes_y1, double* nodes_z1);
+
+// Calculates the rate of work done on a cell by its subcell forces, where the
+// forces are indexed from the first subcell of the cell
+static inline double calc_cell_work(const int cc,
+                                    const int* cells_to_nodes_offsets,
+                                    const int* cells_to_nodes,
+                                    const double* velocity_x,
+                                    const double* velocity_y,
+                                    const double* velocity_z,
+                                    const double* subcell_force_x,
+                                    const double* subcell_force_y,
+                                    const double* subcell_force_z);
+
+// Calculates the volume of a cell from the offset of its faces
+static inline double calc_cell_volume_by_faces(
+    const int cc, const int* cells_to_faces_offsets, const int* cells_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const double* nodes_x, const double* nodes_y, const double* nodes_z,
+    const double* cell_centroids_x, const double* cell_centroids_y,
+    const double* cell_centroids_z);
+
+// Calculates the timestep that a cell allows
+static inline double calc_cell_dt(const int cc, const double* nodes_x,
+                                  const double* nodes_y, const double* nodes_z,
+                                  const double* soundspeed,
+                                  const int* cells_to_faces_offsets,
+                                  const int* cells_to_faces,
+                                  const int* faces_to_nodes_offsets,
+                                  const int* faces_to_nodes);
+
+// Completes the corrector for a single cell of the advanced mesh, returning
+// the timestep that the cell allows
+static inline double calc_corrected_cell(
+    const int cc, const int* cells_to_nodes_offsets, const int* cells_to_nodes,
+    const int* cells_to_faces_offsets, const int* cells_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const double* nodes_x, const double* nodes_y, const double* nodes_z,
+    const double* velocity_x0, const double* velocity_y0,
+    const double* velocity_z0, const double* subcell_force_x,
+    const double* subcell_force_y, const double* subcell_force_z,
+    const double* soundspeed, const double* cell_mass, double* cell_centroids_x,
+    double* cell_centroids_y, double* cell_centroids_z, double* cell_volume,
+    double* density, double* cell_work);
+
+// Calculates the forces on the subcells of a cell from its pressure gradients
+// and artificial viscosity, into buffers that hold the subcells of the cell
+static inline void calc_cell_forces(
+    const int cc, const double visc_coeff1, const double visc_coeff2,
+    const int* cells_to_faces_offsets, const int* cells_to_nodes_offsets,
+    const int* cells_to_faces, const int* faces_to_nodes_offsets,
+    const int* faces_to_nodes, const int* cells_to_nodes,
+    const int* faces_cclockwise_cell, const NodeState* node_state,
+    const double* cell_centroids_x, const double* cell_centroids_y,
+    const double* cell_centroids_z, const double* nodal_soundspeed,
+    const double* limiter, const double* pressure, double* subcell_force_x,
+    double* subcell_force_y, double* subcell_force_z);
+
 // Performs the Lagrangian step of the hydro solve
 void lagrangian_phase(Mesh* mesh, UnstructuredMesh* umesh,
                       HaleData* hale_data) {
 
-  predictor(mesh, umesh, hale_data);
+  // With TASK_GRAPH the kernels are only issued here, as tasks that declare the
+  // x component of a vector field to stand for all of its components
+  if (hale_data->quiescent_skip) {
+    quiescent_predictor(mesh, umesh, hale_data);
+
+    quiescent_corrector(mesh, umesh, hale_data);
+  } else {
+    predictor(mesh, umesh, hale_data);
+
+    corrector(mesh, umesh, hale_data);
+  }
+
+  OMP_TASKWAIT();
 
-  corrector(mesh, umesh, hale_data);
+  // The other node buffer holds the advanced nodes, and the old nodes are dead
+  rotate_nodes(umesh);
+
+  // The corrector evaluated the cell centroids and volumes of the new mesh
+  advance_geometry_epoch(hale_data);
+  stamp_geometry(&hale_data->cell_centroids_stamp, hale_data->geometry_epoch);
+  stamp_geometry(&hale_data->cell_volume_stamp, hale_data->geometry_epoch);
 }
 
 // Performs the predictor step of the Lagrangian phase
 void predictor(Mesh* mesh, UnstructuredMesh* umesh, HaleData* hale_data) {
+  const EosTable* eos_table =
+      hale_data->tabulated_eos ? &hale_data->eos_table : NULL;
 
-  // Update the pressure
+  // Update the pressure and soundspeed
   START_PROFILING(&compute_profile);
-  equation_of_state(umesh->ncells, hale_data->energy0, hale_data->density0,
-                    hale_data->pressure0);
+  OMP_TASK(depend(in : hale_data->energy0[0], hale_data->density0[0])
+           depend(out : hale_data->pressure0[0], hale_data->soundspeed0[0]))
+  equation_of_state(umesh->ncells, eos_table, hale_data->energy0,
+                    hale_data->density0, hale_data->pressure0,
+                    hale_data->soundspeed0);
   STOP_PROFILING(&compute_profile, "equation_of_state");
 
+  if (hale_data->multi_material) {
+    START_PROFILING(&compute_profile);
+    OMP_TASK(depend(in : hale_data->energy0[0], hale_data->density0[0])
+             depend(inout : hale_data->pressure0[0],
+                            hale_data->soundspeed0[0]))
+    mixed_equation_of_state(&hale_data->materials, eos_table,
+                            hale_data->energy0, hale_data->density0,
+                            hale_data->pressure0, hale_data->soundspeed0);
+    STOP_PROFILING(&compute_profile, "mixed_equation_of_state");
+  }
+
   // Calculate the nodal volume and sound speed
   START_PROFILING(&compute_profile);
+  OMP_TASK(depend(in : umesh->nodes_x0[0], umesh->cell_centroids_x[0],
+                       hale_data->soundspeed0[0])
+           depend(out : hale_data->nodal_volumes[0],
+                        hale_data->nodal_soundspeed[0]))
   calc_nodal_vol_and_c(
       umesh->nnodes, umesh->nodes_to_faces_offsets, umesh->nodes_to_faces,
       umesh->faces_to_nodes_offsets, umesh->faces_to_nodes,
       umesh->faces_to_cells0, umesh->faces_to_cells1, umesh->nodes_x0,
       umesh->nodes_y0, umesh->nodes_z0, umesh->cell_centroids_x,
-      umesh->cell_centroids_y, umesh->cell_centroids_z, hale_data->energy0,
+      umesh->cell_centroids_y, umesh->cell_centroids_z, hale_data->soundspeed0,
       hale_data->nodal_volumes, hale_data->nodal_soundspeed);
   STOP_PROFILING(&compute_profile, "calc_nodal_vol_and_c");
 
+  // Gather the state read through the node indirection
+  START_PROFILING(&compute_profile);
+  OMP_TASK(depend(in : umesh->nodes_x0[0], hale_data->velocity_x0[0],
+                       hale_data->nodal_mass[0], hale_data->nodal_volumes[0])
+           depend(out : hale_data->node_state))
+  sync_node_state(umesh->nnodes, umesh->nodes_x0, umesh->nodes_y0,
+                  umesh->nodes_z0, hale_data->velocity_x0,
+                  hale_data->velocity_y0, hale_data->velocity_z0,
+                  hale_data->nodal_mass, hale_data->nodal_volumes,
+                  &hale_data->node_state);
+  STOP_PROFILING(&compute_profile, "sync_node_state");
+
+#ifndef NODE_FORCE_ACCUMULATION
   // Sets all of the subcell forces to 0
   START_PROFILING(&compute_profile);
+  OMP_TASK(depend(out : hale_data->subcell_force_x[0]))
   zero_subcell_forces(umesh->ncells, umesh->cells_to_nodes_offsets,
                       hale_data->subcell_force_x, hale_data->subcell_force_y,
                       hale_data->subcell_force_z);
   STOP_PROFILING(&compute_profile, "zero_subcell_forces");
 
   START_PROFILING(&compute_profile);
+#ifdef PACKED_CELL_NODES
+  // The blocks hold the nodes from the end of the last timestep
+  OMP_TASK(depend(in : hale_data->cell_nodes[0], hale_data->pressure0[0])
+           depend(inout : hale_data->subcell_force_x[0]))
+  calc_subcell_force_from_pressure_packed(
+      umesh->ncells, umesh->cells_to_faces_offsets,
+      umesh->cells_to_nodes_offsets, umesh->cells_to_faces,
+      umesh->faces_cclockwise_cell, hale_data->cells_to_local_face_nodes,
+      hale_data->cell_nodes, hale_data->pressure0, hale_data->subcell_force_x,
+      hale_data->subcell_force_y, hale_data->subcell_force_z);
+#else
+  OMP_TASK(depend(in : umesh->nodes_x0[0], hale_data->node_state,
+                       hale_data->pressure0[0])
+           depend(inout : hale_data->subcell_force_x[0]))
   calc_subcell_force_from_pressure(
       umesh->ncells, umesh->cells_to_faces_offsets,
       umesh->cells_to_nodes_offsets, umesh->cells_to_faces,
       umesh->faces_to_nodes_offsets, umesh->faces_to_nodes,
-      umesh->cells_to_nodes, umesh->faces_cclockwise_cell, umesh->nodes_x0,
-      umesh->nodes_y0, umesh->nodes_z0, hale_data->pressure0,
+      umesh->cells_to_nodes, umesh->faces_cclockwise_cell,
+      &hale_data->node_state, hale_data->pressure0,
       hale_data->subcell_force_x, hale_data->subcell_force_y,
       hale_data->subcell_force_z);
+#endif
   STOP_PROFILING(&compute_profile, "calc_subcell_force_from_pressure");
+#endif
 
   START_PROFILING(&compute_profile);
+  OMP_TASK(depend(in : hale_data->nodal_volumes[0])
+           depend(inout : hale_data->nodal_soundspeed[0]))
   scale_soundspeed(umesh->nnodes, hale_data->nodal_volumes,
                    hale_data->nodal_soundspeed);
   STOP_PROFILING(&compute_profile, "scale_soundspeed");
 
   START_PROFILING(&compute_profile);
+#ifdef PACKED_CELL_NODES
+  OMP_TASK(depend(in : hale_data->velocity_x0[0])
+           depend(out : hale_data->cell_velocity[0]))
+  pack_cell_nodes(umesh->ncells, umesh->cells_to_nodes_offsets,
+                  umesh->cells_to_nodes, hale_data->velocity_x0,
+                  hale_data->velocity_y0, hale_data->velocity_z0,
+                  hale_data->cell_velocity);
+
+  OMP_TASK(depend(in : hale_data->cell_nodes[0], umesh->cell_centroids_x[0],
+                       hale_data->cell_velocity[0],
+                       hale_data->nodal_soundspeed[0],
+                       hale_data->nodal_mass[0], hale_data->nodal_volumes[0],
+                       hale_data->limiter[0])
+           depend(inout : hale_data->subcell_force_x[0]))
+  calc_artificial_viscosity_packed(
+      umesh->ncells, hale_data->visc_coeff1, hale_data->visc_coeff2,
+      umesh->cells_to_faces_offsets, umesh->cells_to_nodes_offsets,
+      umesh->cells_to_faces, umesh->cells_to_nodes,
+      umesh->faces_cclockwise_cell, hale_data->cells_to_local_face_nodes,
+      hale_data->cell_nodes, hale_data->cell_velocity, umesh->cell_centroids_x,
+      umesh->cell_centroids_y, umesh->cell_centroids_z,
+      hale_data->nodal_soundspeed, hale_data->nodal_mass,
+      hale_data->nodal_volumes, hale_data->limiter, hale_data->subcell_force_x,
+      hale_data->subcell_force_y, hale_data->subcell_force_z);
+#elif defined(NODE_FORCE_ACCUMULATION)
+  // The pressure and viscous forces are accumulated into the nodes together
+  OMP_TASK(depend(in : umesh->nodes_x0[0], umesh->cell_centroids_x[0],
+                       hale_data->velocity_x0[0], hale_data->node_state,
+                       hale_data->nodal_soundspeed[0],
+                       hale_data->nodal_mass[0], hale_data->nodal_volumes[0],
+                       hale_data->limiter[0], hale_data->pressure0[0])
+           depend(inout : hale_data->node_force_x[0]))
+  calc_node_forces(
+      hale_data->ncell_colours, hale_data->cell_colours_offsets,
+      hale_data->cells_by_colour, hale_data->visc_coeff1,
+      hale_data->visc_coeff2, umesh->cells_to_faces_offsets,
+      umesh->cells_to_nodes_offsets, umesh->cells_to_faces,
+      umesh->faces_to_nodes_offsets, umesh->faces_to_nodes,
+      umesh->cells_to_nodes, umesh->faces_cclockwise_cell,
+      &hale_data->node_state, umesh->cell_centroids_x,
+      umesh->cell_centroids_y, umesh->cell_centroids_z,
+      hale_data->nodal_soundspeed, hale_data->limiter, hale_data->pressure0,
+      hale_data->node_force_x, hale_data->node_force_y,
+      hale_data->node_force_z);
+#else
+  OMP_TASK(depend(in : umesh->nodes_x0[0], umesh->cell_centroids_x[0],
+                       hale_data->velocity_x0[0], hale_data->node_state,
+                       hale_data->nodal_soundspeed[0],
+                       hale_data->nodal_mass[0], hale_data->nodal_volumes[0],
+                       hale_data->limiter[0])
+           depend(inout : hale_data->subcell_force_x[0]))
   calc_artificial_viscosity(
       umesh->ncells, hale_data->visc_coeff1, hale_data->visc_coeff2,
       umesh->cells_to_nodes_offsets, umesh->cells_to_nodes,
-      umesh->faces_cclockwise_cell, umesh->nodes_x0, umesh->nodes_y0,
-      umesh->nodes_z0, umesh->cell_centroids_x, umesh->cell_centroids_y,
-      umesh->cell_centroids_z, hale_data->velocity_x0, hale_data->velocity_y0,
-      hale_data->velocity_z0, hale_data->nodal_soundspeed,
-      hale_data->nodal_mass, hale_data->nodal_volumes, hale_data->limiter,
+      umesh->faces_cclockwise_cell, &hale_data->node_state,
+      umesh->cell_centroids_x, umesh->cell_centroids_y,
+      umesh->cell_centroids_z, hale_data->nodal_soundspeed, hale_data->limiter,
       hale_data->subcell_force_x, hale_data->subcell_force_y,
       hale_data->subcell_force_z, umesh->faces_to_nodes_offsets,
       umesh->faces_to_nodes, umesh->cells_to_faces_offsets,
       umesh->cells_to_faces);
+#endif
   STOP_PROFILING(&compute_profile, "calc_artificial_viscosity");
 
   START_PROFILING(&compute_profile);
+#ifdef NODE_FORCE_ACCUMULATION
+  OMP_TASK(depend(in : mesh->dt, hale_data->nodal_mass[0],
+                       hale_data->velocity_x0[0])
+           depend(inout : hale_data->node_force_x[0])
+           depend(out : hale_data->velocity_x1[0]))
+  calc_new_velocity_from_node_force(
+      umesh->nnodes, mesh->dt, hale_data->nodal_mass, hale_data->velocity_x0,
+      hale_data->velocity_y0, hale_data->velocity_z0, hale_data->node_force_x,
+      hale_data->node_force_y, hale_data->node_force_z, hale_data->velocity_x1,
+      hale_data->velocity_y1, hale_data->velocity_z1);
+#else
+  OMP_TASK(depend(in : mesh->dt, hale_data->subcell_force_x[0],
+                       hale_data->nodal_mass[0], hale_data->velocity_x0[0])
+           depend(out : hale_data->velocity_x1[0]))
+#ifdef SELL_ADJACENCY
+  calc_new_velocity_sell(
+      mesh->dt, &hale_data->nodes_to_cells_sell,
+      hale_data->nodes_to_subcells_sell, hale_data->subcell_force_x,
+      hale_data->subcell_force_y, hale_data->subcell_force_z,
+      hale_data->nodal_mass, hale_data->velocity_x0, hale_data->velocity_y0,
+      hale_data->velocity_z0, hale_data->velocity_x1, hale_data->velocity_y1,
+      hale_data->velocity_z1);
+#else
   calc_new_velocity(umesh->nnodes, mesh->dt, umesh->nodes_to_cells_offsets,
                     umesh->nodes_to_cells, umesh->cells_to_nodes_offsets,
                     umesh->cells_to_nodes, hale_data->subcell_force_x,
@@ -81,9 +345,13 @@ void predictor(Mesh* mesh, UnstructuredMesh* umesh, HaleData* hale_data) {
                     hale_data->velocity_y0, hale_data->velocity_z0,
                     hale_data->velocity_x1, hale_data->velocity_y1,
                     hale_data->velocity_z1);
+#endif
+#endif
   STOP_PROFILING(&compute_profile, "calc_new_velocity");
 
   // TODO: NEED TO WORK OUT HOW TO HANDLE BOUNDARY CONDITIONS REASONABLY
+  OMP_SINGLE()
+  OMP_TASK(depend(inout : hale_data->velocity_x1[0]))
   handle_unstructured_reflect_3d(
       umesh->nnodes, umesh->boundary_index, umesh->boundary_type,
       umesh->boundary_normal_x, umesh->boundary_normal_y,
@@ -92,110 +360,312 @@ void predictor(Mesh* mesh, UnstructuredMesh* umesh, HaleData* hale_data) {
 
   // Move the nodes by the predicted velocity
   START_PROFILING(&compute_profile);
+  OMP_TASK(depend(in : mesh->dt, umesh->nodes_x0[0], hale_data->velocity_x1[0])
+           depend(out : umesh->nodes_x1[0]))
   move_nodes(umesh->nnodes, mesh->dt, umesh->nodes_x0, umesh->nodes_y0,
              umesh->nodes_z0, hale_data->velocity_x1, hale_data->velocity_y1,
              hale_data->velocity_z1, umesh->nodes_x1, umesh->nodes_y1,
              umesh->nodes_z1);
   STOP_PROFILING(&compute_profile, "move_nodes");
 
-  init_cell_centroids(umesh->ncells, umesh->cells_to_nodes_offsets,
-                      umesh->cells_to_nodes, umesh->nodes_x1, umesh->nodes_y1,
-                      umesh->nodes_z1, umesh->cell_centroids_x,
-                      umesh->cell_centroids_y, umesh->cell_centroids_z);
-
+  OMP_TASK(depend(in : umesh->nodes_x1[0], hale_data->soundspeed0[0])
+           depend(out : mesh->dt))
   set_timestep(umesh->ncells, umesh->nodes_x1, umesh->nodes_y1, umesh->nodes_z1,
-               hale_data->energy0, &mesh->dt, umesh->cells_to_faces_offsets,
+               hale_data->soundspeed0, &mesh->dt, umesh->cells_to_faces_offsets,
                umesh->cells_to_faces, umesh->faces_to_nodes_offsets,
                umesh->faces_to_nodes);
 
   // Calculate the predicted energy
   START_PROFILING(&compute_profile);
+#ifdef NODE_FORCE_ACCUMULATION
+  // The subcell forces are found again before the centroids are moved
+  OMP_TASK(depend(in : mesh->dt, umesh->nodes_x0[0],
+                       umesh->cell_centroids_x[0], hale_data->velocity_x0[0],
+                       hale_data->velocity_x1[0], hale_data->node_state,
+                       hale_data->nodal_soundspeed[0],
+                       hale_data->nodal_mass[0], hale_data->nodal_volumes[0],
+                       hale_data->limiter[0], hale_data->pressure0[0],
+                       hale_data->energy0[0], hale_data->cell_mass[0])
+           depend(out : hale_data->energy1[0]))
+  calc_predicted_energy_from_cell_forces(
+      umesh->ncells, mesh->dt, hale_data->visc_coeff1, hale_data->visc_coeff2,
+      umesh->cells_to_faces_offsets, umesh->cells_to_nodes_offsets,
+      umesh->cells_to_faces, umesh->faces_to_nodes_offsets,
+      umesh->faces_to_nodes, umesh->cells_to_nodes,
+      umesh->faces_cclockwise_cell, &hale_data->node_state,
+      umesh->cell_centroids_x, umesh->cell_centroids_y,
+      umesh->cell_centroids_z, hale_data->nodal_soundspeed, hale_data->limiter,
+      hale_data->pressure0, hale_data->velocity_x1, hale_data->velocity_y1,
+      hale_data->velocity_z1, hale_data->energy0, hale_data->cell_mass,
+      hale_data->energy1);
+#else
+  OMP_TASK(depend(in : mesh->dt, hale_data->velocity_x1[0],
+                       hale_data->subcell_force_x[0], hale_data->energy0[0],
+                       hale_data->cell_mass[0])
+           depend(out : hale_data->energy1[0]))
   calc_predicted_energy(umesh->ncells, mesh->dt, umesh->cells_to_nodes_offsets,
                         umesh->cells_to_nodes, hale_data->velocity_x1,
                         hale_data->velocity_y1, hale_data->velocity_z1,
                         hale_data->subcell_force_x, hale_data->subcell_force_y,
                         hale_data->subcell_force_z, hale_data->energy0,
                         hale_data->cell_mass, hale_data->energy1);
+#endif
   STOP_PROFILING(&compute_profile, "calc_predicted_energy");
 
+#ifdef PACKED_CELL_NODES
+  OMP_TASK(depend(in : umesh->nodes_x1[0])
+           depend(out : hale_data->cell_nodes[0]))
+  pack_cell_nodes(umesh->ncells, umesh->cells_to_nodes_offsets,
+                  umesh->cells_to_nodes, umesh->nodes_x1, umesh->nodes_y1,
+                  umesh->nodes_z1, hale_data->cell_nodes);
+
+  OMP_TASK(depend(in : hale_data->cell_nodes[0])
+           depend(out : umesh->cell_centroids_x[0]))
+  init_cell_centroids_packed(umesh->ncells, hale_data->cell_nodes,
+                             umesh->cell_centroids_x, umesh->cell_centroids_y,
+                             umesh->cell_centroids_z);
+#else
+  OMP_TASK(depend(in : umesh->nodes_x1[0])
+           depend(out : umesh->cell_centroids_x[0]))
+  init_cell_centroids(umesh->ncells, umesh->cells_to_nodes_offsets,
+                      umesh->cells_to_nodes, umesh->nodes_x1, umesh->nodes_y1,
+                      umesh->nodes_z1, umesh->cell_centroids_x,
+                      umesh->cell_centroids_y, umesh->cell_centroids_z);
+#endif
+
   // Using the new volume, calculate the predicted density
   START_PROFILING(&compute_profile);
+#ifdef PACKED_CELL_NODES
+  OMP_TASK(depend(in : hale_data->cell_nodes[0], umesh->cell_centroids_x[0],
+                       hale_data->cell_mass[0])
+           depend(out : hale_data->density1[0]))
+  calc_predicted_density_packed(
+      umesh->ncells, hale_data->cells_to_local_face_nodes,
+      hale_data->cell_nodes, umesh->cell_centroids_x, umesh->cell_centroids_y,
+      umesh->cell_centroids_z, hale_data->cell_mass, hale_data->density1);
+#else
+  OMP_TASK(depend(in : umesh->nodes_x1[0], umesh->cell_centroids_x[0],
+                       hale_data->cell_mass[0])
+           depend(out : hale_data->density1[0]))
   calc_predicted_density(
       umesh->ncells, umesh->cells_to_faces_offsets, umesh->cells_to_faces,
       umesh->faces_to_nodes_offsets, umesh->faces_to_nodes, umesh->nodes_x1,
       umesh->nodes_y1, umesh->nodes_z1, umesh->cell_centroids_x,
       umesh->cell_centroids_y, umesh->cell_centroids_z, hale_data->cell_mass,
       hale_data->density1);
+#endif
   STOP_PROFILING(&compute_profile, "calc_predicted_density");
 
+  // Calculate the predicted pressure and soundspeed
+  START_PROFILING(&compute_profile);
+  OMP_TASK(depend(in : hale_data->energy1[0], hale_data->density1[0])
+           depend(out : hale_data->pressure1[0], hale_data->soundspeed1[0]))
+  equation_of_state(umesh->ncells, eos_table, hale_data->energy1,
+                    hale_data->density1, hale_data->pressure1,
+                    hale_data->soundspeed1);
+  STOP_PROFILING(&compute_profile, "equation_of_state");
+
+  if (hale_data->multi_material) {
+    START_PROFILING(&compute_profile);
+    OMP_TASK(depend(in : hale_data->energy1[0], hale_data->density1[0])
+             depend(inout : hale_data->pressure1[0],
+                            hale_data->soundspeed1[0]))
+    mixed_equation_of_state(&hale_data->materials, eos_table,
+                            hale_data->energy1, hale_data->density1,
+                            hale_data->pressure1, hale_data->soundspeed1);
+    STOP_PROFILING(&compute_profile, "mixed_equation_of_state");
+  }
+
   // Calculate the time centered pressure from mid point between rezoned and
   // predicted pressures
   START_PROFILING(&compute_profile);
-  time_center_pressure(umesh->ncells, hale_data->energy1, hale_data->density1,
-                       hale_data->pressure0, hale_data->pressure1);
+  OMP_TASK(depend(in : hale_data->pressure0[0])
+           depend(inout : hale_data->pressure1[0]))
+  time_center_pressure(umesh->ncells, hale_data->pressure0,
+                       hale_data->pressure1);
   STOP_PROFILING(&compute_profile, "time_center_pressure");
 
   // Prepare time centered variables for the corrector step
   START_PROFILING(&compute_profile);
+  OMP_TASK(depend(in : umesh->nodes_x0[0])
+           depend(inout : umesh->nodes_x1[0]))
   time_center_nodes(umesh->nnodes, umesh->nodes_x0, umesh->nodes_y0,
                     umesh->nodes_z0, umesh->nodes_x1, umesh->nodes_y1,
                     umesh->nodes_z1);
   STOP_PROFILING(&compute_profile, "time_center_nodes");
+
+#ifdef PACKED_CELL_NODES
+  OMP_TASK(depend(in : umesh->nodes_x1[0])
+           depend(out : hale_data->cell_nodes[0]))
+  pack_cell_nodes(umesh->ncells, umesh->cells_to_nodes_offsets,
+                  umesh->cells_to_nodes, umesh->nodes_x1, umesh->nodes_y1,
+                  umesh->nodes_z1, hale_data->cell_nodes);
+#endif
 }
 
 // Performs the corrector step of the Lagrangian phase
 void corrector(Mesh* mesh, UnstructuredMesh* umesh, HaleData* hale_data) {
 
+#ifndef NODE_FORCE_ACCUMULATION
   // Sets all of the subcell forces to 0
   START_PROFILING(&compute_profile);
+  OMP_TASK(depend(out : hale_data->subcell_force_x[0]))
   zero_subcell_forces(umesh->ncells, umesh->cells_to_nodes_offsets,
                       hale_data->subcell_force_x, hale_data->subcell_force_y,
                       hale_data->subcell_force_z);
   STOP_PROFILING(&compute_profile, "calc_nodal_mass_vol");
+#endif
 
   // Calculate the nodal mass
   START_PROFILING(&compute_profile);
+  OMP_TASK(depend(in : umesh->nodes_x1[0], umesh->cell_centroids_x[0],
+                       hale_data->soundspeed1[0])
+           depend(out : hale_data->nodal_volumes[0],
+                        hale_data->nodal_soundspeed[0]))
   calc_nodal_vol_and_c(
       umesh->nnodes, umesh->nodes_to_faces_offsets, umesh->nodes_to_faces,
       umesh->faces_to_nodes_offsets, umesh->faces_to_nodes,
       umesh->faces_to_cells0, umesh->faces_to_cells1, umesh->nodes_x1,
       umesh->nodes_y1, umesh->nodes_z1, umesh->cell_centroids_x,
-      umesh->cell_centroids_y, umesh->cell_centroids_z, hale_data->energy1,
+      umesh->cell_centroids_y, umesh->cell_centroids_z, hale_data->soundspeed1,
       hale_data->nodal_volumes, hale_data->nodal_soundspeed);
   STOP_PROFILING(&compute_profile, "calc_nodal_vol_and_c");
 
+  // Gather the state read through the node indirection
+  START_PROFILING(&compute_profile);
+  OMP_TASK(depend(in : umesh->nodes_x1[0], hale_data->velocity_x1[0],
+                       hale_data->nodal_mass[0], hale_data->nodal_volumes[0])
+           depend(out : hale_data->node_state))
+  sync_node_state(umesh->nnodes, umesh->nodes_x1, umesh->nodes_y1,
+                  umesh->nodes_z1, hale_data->velocity_x1,
+                  hale_data->velocity_y1, hale_data->velocity_z1,
+                  hale_data->nodal_mass, hale_data->nodal_volumes,
+                  &hale_data->node_state);
+  STOP_PROFILING(&compute_profile, "sync_node_state");
+
   START_PROFILING(&compute_profile);
+  OMP_TASK(depend(in : hale_data->nodal_volumes[0])
+           depend(inout : hale_data->nodal_soundspeed[0]))
   scale_soundspeed(umesh->nnodes, hale_data->nodal_volumes,
                    hale_data->nodal_soundspeed);
   STOP_PROFILING(&compute_profile, "scale_soundspeed");
 
+#ifndef NODE_FORCE_ACCUMULATION
   // Calculate the pressure gradients
   START_PROFILING(&compute_profile);
+#ifdef PACKED_CELL_NODES
+  OMP_TASK(depend(in : hale_data->cell_nodes[0], hale_data->pressure1[0])
+           depend(inout : hale_data->subcell_force_x[0]))
+  calc_subcell_force_from_pressure_packed(
+      umesh->ncells, umesh->cells_to_faces_offsets,
+      umesh->cells_to_nodes_offsets, umesh->cells_to_faces,
+      umesh->faces_cclockwise_cell, hale_data->cells_to_local_face_nodes,
+      hale_data->cell_nodes, hale_data->pressure1, hale_data->subcell_force_x,
+      hale_data->subcell_force_y, hale_data->subcell_force_z);
+#else
+  OMP_TASK(depend(in : umesh->nodes_x1[0], hale_data->node_state,
+                       hale_data->pressure1[0])
+           depend(inout : hale_data->subcell_force_x[0]))
   calc_subcell_force_from_pressure(
       umesh->ncells, umesh->cells_to_faces_offsets,
       umesh->cells_to_nodes_offsets, umesh->cells_to_faces,
       umesh->faces_to_nodes_offsets, umesh->faces_to_nodes,
-      umesh->cells_to_nodes, umesh->faces_cclockwise_cell, umesh->nodes_x1,
-      umesh->nodes_y1, umesh->nodes_z1, hale_data->pressure1,
+      umesh->cells_to_nodes, umesh->faces_cclockwise_cell,
+      &hale_data->node_state, hale_data->pressure1,
       hale_data->subcell_force_x, hale_data->subcell_force_y,
       hale_data->subcell_force_z);
+#endif
   STOP_PROFILING(&compute_profile, "node_force_from_pressure");
-
+#endif
+
+#ifdef PACKED_CELL_NODES
+  OMP_TASK(depend(in : hale_data->velocity_x1[0])
+           depend(out : hale_data->cell_velocity[0]))
+  pack_cell_nodes(umesh->ncells, umesh->cells_to_nodes_offsets,
+                  umesh->cells_to_nodes, hale_data->velocity_x1,
+                  hale_data->velocity_y1, hale_data->velocity_z1,
+                  hale_data->cell_velocity);
+
+  OMP_TASK(depend(in : hale_data->cell_nodes[0], umesh->cell_centroids_x[0],
+                       hale_data->cell_velocity[0],
+                       hale_data->nodal_soundspeed[0],
+                       hale_data->nodal_mass[0], hale_data->nodal_volumes[0],
+                       hale_data->limiter[0])
+           depend(inout : hale_data->subcell_force_x[0]))
+  calc_artificial_viscosity_packed(
+      umesh->ncells, hale_data->visc_coeff1, hale_data->visc_coeff2,
+      umesh->cells_to_faces_offsets, umesh->cells_to_nodes_offsets,
+      umesh->cells_to_faces, umesh->cells_to_nodes,
+      umesh->faces_cclockwise_cell, hale_data->cells_to_local_face_nodes,
+      hale_data->cell_nodes, hale_data->cell_velocity, umesh->cell_centroids_x,
+      umesh->cell_centroids_y, umesh->cell_centroids_z,
+      hale_data->nodal_soundspeed, hale_data->nodal_mass,
+      hale_data->nodal_volumes, hale_data->limiter, hale_data->subcell_force_x,
+      hale_data->subcell_force_y, hale_data->subcell_force_z);
+#elif defined(NODE_FORCE_ACCUMULATION)
+  // The pressure and viscous forces are accumulated into the nodes together
+  OMP_TASK(depend(in : umesh->nodes_x1[0], umesh->cell_centroids_x[0],
+                       hale_data->velocity_x1[0], hale_data->node_state,
+                       hale_data->nodal_soundspeed[0],
+                       hale_data->nodal_mass[0], hale_data->nodal_volumes[0],
+                       hale_data->limiter[0], hale_data->pressure1[0])
+           depend(inout : hale_data->node_force_x[0]))
+  calc_node_forces(
+      hale_data->ncell_colours, hale_data->cell_colours_offsets,
+      hale_data->cells_by_colour, hale_data->visc_coeff1,
+      hale_data->visc_coeff2, umesh->cells_to_faces_offsets,
+      umesh->cells_to_nodes_offsets, umesh->cells_to_faces,
+      umesh->faces_to_nodes_offsets, umesh->faces_to_nodes,
+      umesh->cells_to_nodes, umesh->faces_cclockwise_cell,
+      &hale_data->node_state, umesh->cell_centroids_x,
+      umesh->cell_centroids_y, umesh->cell_centroids_z,
+      hale_data->nodal_soundspeed, hale_data->limiter, hale_data->pressure1,
+      hale_data->node_force_x, hale_data->node_force_y,
+      hale_data->node_force_z);
+#else
+  OMP_TASK(depend(in : umesh->nodes_x1[0], umesh->cell_centroids_x[0],
+                       hale_data->velocity_x1[0], hale_data->node_state,
+                       hale_data->nodal_soundspeed[0],
+                       hale_data->nodal_mass[0], hale_data->nodal_volumes[0],
+                       hale_data->limiter[0])
+           depend(inout : hale_data->subcell_force_x[0]))
   calc_artificial_viscosity(
       umesh->ncells, hale_data->visc_coeff1, hale_data->visc_coeff2,
       umesh->cells_to_nodes_offsets, umesh->cells_to_nodes,
-      umesh->faces_cclockwise_cell, umesh->nodes_x1, umesh->nodes_y1,
-      umesh->nodes_z1, umesh->cell_centroids_x, umesh->cell_centroids_y,
-      umesh->cell_centroids_z, hale_data->velocity_x1, hale_data->velocity_y1,
-      hale_data->velocity_z1, hale_data->nodal_soundspeed,
-      hale_data->nodal_mass, hale_data->nodal_volumes, hale_data->limiter,
+      umesh->faces_cclockwise_cell, &hale_data->node_state,
+      umesh->cell_centroids_x, umesh->cell_centroids_y,
+      umesh->cell_centroids_z, hale_data->nodal_soundspeed, hale_data->limiter,
       hale_data->subcell_force_x, hale_data->subcell_force_y,
       hale_data->subcell_force_z, umesh->faces_to_nodes_offsets,
       umesh->faces_to_nodes, umesh->cells_to_faces_offsets,
       umesh->cells_to_faces);
+#endif
 
   START_PROFILING(&compute_profile);
   // Updates and time center velocity in the corrector step
+#ifdef NODE_FORCE_ACCUMULATION
+  OMP_TASK(depend(in : mesh->dt, hale_data->nodal_mass[0],
+                       hale_data->velocity_x1[0])
+           depend(inout : hale_data->node_force_x[0],
+                          hale_data->velocity_x0[0]))
+  update_and_time_center_velocity_from_node_force(
+      umesh->nnodes, mesh->dt, hale_data->nodal_mass, hale_data->node_force_x,
+      hale_data->node_force_y, hale_data->node_force_z, hale_data->velocity_x0,
+      hale_data->velocity_y0, hale_data->velocity_z0, hale_data->velocity_x1,
+      hale_data->velocity_y1, hale_data->velocity_z1);
+#else
+  OMP_TASK(depend(in : mesh->dt, hale_data->nodal_mass[0],
+                       hale_data->subcell_force_x[0])
+           depend(inout : hale_data->velocity_x0[0], hale_data->velocity_x1[0]))
+#ifdef SELL_ADJACENCY
+  update_and_time_center_velocity_sell(
+      mesh->dt, &hale_data->nodes_to_cells_sell,
+      hale_data->nodes_to_subcells_sell, hale_data->nodal_mass,
+      hale_data->subcell_force_x, hale_data->subcell_force_y,
+      hale_data->subcell_force_z, hale_data->velocity_x0,
+      hale_data->velocity_y0, hale_data->velocity_z0, hale_data->velocity_x1,
+      hale_data->velocity_y1, hale_data->velocity_z1);
+#else
   update_and_time_center_velocity(
       umesh->nnodes, mesh->dt, umesh->nodes_to_cells_offsets,
       umesh->nodes_to_cells, umesh->cells_to_nodes_offsets,
@@ -203,28 +673,64 @@ void corrector(Mesh* mesh, UnstructuredMesh* umesh, HaleData* hale_data) {
       hale_data->subcell_force_y, hale_data->subcell_force_z,
       hale_data->velocity_x0, hale_data->velocity_y0, hale_data->velocity_z0,
       hale_data->velocity_x1, hale_data->velocity_y1, hale_data->velocity_z1);
+#endif
+#endif
   STOP_PROFILING(&compute_profile, "calc_new_velocity");
 
+  OMP_SINGLE()
+  OMP_TASK(depend(inout : hale_data->velocity_x0[0]))
   handle_unstructured_reflect_3d(
       umesh->nnodes, umesh->boundary_index, umesh->boundary_type,
       umesh->boundary_normal_x, umesh->boundary_normal_y,
       umesh->boundary_normal_z, hale_data->velocity_x0, hale_data->velocity_y0,
       hale_data->velocity_z0);
 
-  // Advances the nodes using the corrected velocity
+#ifdef NODE_FORCE_ACCUMULATION
+  // The subcell forces are found again before the nodes are advanced
+  START_PROFILING(&compute_profile);
+  OMP_TASK(depend(in : umesh->nodes_x1[0], umesh->cell_centroids_x[0],
+                       hale_data->velocity_x0[0], hale_data->velocity_x1[0],
+                       hale_data->node_state, hale_data->nodal_soundspeed[0],
+                       hale_data->nodal_mass[0], hale_data->nodal_volumes[0],
+                       hale_data->limiter[0], hale_data->pressure1[0])
+           depend(out : hale_data->cell_work[0]))
+  calc_corrected_work_from_cell_forces(
+      umesh->ncells, hale_data->visc_coeff1, hale_data->visc_coeff2,
+      umesh->cells_to_faces_offsets, umesh->cells_to_nodes_offsets,
+      umesh->cells_to_faces, umesh->faces_to_nodes_offsets,
+      umesh->faces_to_nodes, umesh->cells_to_nodes,
+      umesh->faces_cclockwise_cell, &hale_data->node_state,
+      umesh->cell_centroids_x, umesh->cell_centroids_y,
+      umesh->cell_centroids_z, hale_data->nodal_soundspeed, hale_data->limiter,
+      hale_data->pressure1, hale_data->velocity_x0, hale_data->velocity_y0,
+      hale_data->velocity_z0, hale_data->cell_work);
+  STOP_PROFILING(&compute_profile, "calc_corrected_energy");
+#endif
+
+  // Advances the nodes using the corrected velocity, into the buffer of the
+  // time centered nodes, which becomes the current mesh once the step is done
   START_PROFILING(&compute_profile);
+  OMP_TASK(depend(in : mesh->dt, umesh->nodes_x0[0], hale_data->velocity_x0[0])
+           depend(out : umesh->nodes_x1[0]))
   advance_nodes_corrected(umesh->nnodes, mesh->dt, hale_data->velocity_x0,
                           hale_data->velocity_y0, hale_data->velocity_z0,
-                          umesh->nodes_x0, umesh->nodes_y0, umesh->nodes_z0);
+                          umesh->nodes_x0, umesh->nodes_y0, umesh->nodes_z0,
+                          umesh->nodes_x1, umesh->nodes_y1, umesh->nodes_z1);
   STOP_PROFILING(&compute_profile, "advance_nodes_corrected");
 
-  set_timestep(umesh->ncells, umesh->nodes_x0, umesh->nodes_y0, umesh->nodes_z0,
-               hale_data->energy1, &mesh->dt, umesh->cells_to_faces_offsets,
+#ifdef PACKED_CELL_NODES
+  OMP_TASK(depend(in : umesh->nodes_x1[0], hale_data->soundspeed1[0])
+           depend(out : mesh->dt))
+  set_timestep(umesh->ncells, umesh->nodes_x1, umesh->nodes_y1, umesh->nodes_z1,
+               hale_data->soundspeed1, &mesh->dt, umesh->cells_to_faces_offsets,
                umesh->cells_to_faces, umesh->faces_to_nodes_offsets,
                umesh->faces_to_nodes);
 
   // Calculate the corrected energy
   START_PROFILING(&compute_profile);
+  OMP_TASK(depend(in : mesh->dt, hale_data->velocity_x0[0],
+                       hale_data->subcell_force_x[0], hale_data->cell_mass[0])
+           depend(inout : hale_data->energy0[0]))
   calc_corrected_energy(umesh->ncells, mesh->dt, umesh->cells_to_nodes_offsets,
                         umesh->cells_to_nodes, hale_data->velocity_x0,
                         hale_data->velocity_y0, hale_data->velocity_z0,
@@ -233,29 +739,213 @@ void corrector(Mesh* mesh, UnstructuredMesh* umesh, HaleData* hale_data) {
                         hale_data->energy0);
   STOP_PROFILING(&compute_profile, "calc_corrected_energy");
 
+  OMP_TASK(depend(in : umesh->nodes_x1[0])
+           depend(out : hale_data->cell_nodes[0]))
+  pack_cell_nodes(umesh->ncells, umesh->cells_to_nodes_offsets,
+                  umesh->cells_to_nodes, umesh->nodes_x1, umesh->nodes_y1,
+                  umesh->nodes_z1, hale_data->cell_nodes);
+
+  OMP_TASK(depend(in : hale_data->cell_nodes[0])
+           depend(out : umesh->cell_centroids_x[0]))
+  init_cell_centroids_packed(umesh->ncells, hale_data->cell_nodes,
+                             umesh->cell_centroids_x, umesh->cell_centroids_y,
+                             umesh->cell_centroids_z);
+
+  // Using the new corrected volume, calculate the density
+  START_PROFILING(&compute_profile);
+  OMP_TASK(depend(in : hale_data->cell_nodes[0], umesh->cell_centroids_x[0],
+                       hale_data->cell_mass[0])
+           depend(out : hale_data->cell_volume[0], hale_data->density0[0]))
+  calc_corrected_density_packed(
+      umesh->ncells, hale_data->cells_to_local_face_nodes,
+      hale_data->cell_nodes, umesh->cell_centroids_x, umesh->cell_centroids_y,
+      umesh->cell_centroids_z, hale_data->cell_mass, hale_data->cell_volume,
+      hale_data->density0);
+  STOP_PROFILING(&compute_profile, "calc_corrected_density");
+#elif defined(NODE_FORCE_ACCUMULATION)
+  OMP_TASK(depend(in : umesh->nodes_x1[0], hale_data->soundspeed1[0])
+           depend(out : mesh->dt))
+  set_timestep(umesh->ncells, umesh->nodes_x1, umesh->nodes_y1, umesh->nodes_z1,
+               hale_data->soundspeed1, &mesh->dt, umesh->cells_to_faces_offsets,
+               umesh->cells_to_faces, umesh->faces_to_nodes_offsets,
+               umesh->faces_to_nodes);
+
+  OMP_TASK(depend(in : umesh->nodes_x1[0])
+           depend(out : umesh->cell_centroids_x[0]))
   init_cell_centroids(umesh->ncells, umesh->cells_to_nodes_offsets,
-                      umesh->cells_to_nodes, umesh->nodes_x0, umesh->nodes_y0,
-                      umesh->nodes_z0, umesh->cell_centroids_x,
+                      umesh->cells_to_nodes, umesh->nodes_x1, umesh->nodes_y1,
+                      umesh->nodes_z1, umesh->cell_centroids_x,
                       umesh->cell_centroids_y, umesh->cell_centroids_z);
 
   // Using the new corrected volume, calculate the density
   START_PROFILING(&compute_profile);
+  OMP_TASK(depend(in : umesh->nodes_x1[0], umesh->cell_centroids_x[0],
+                       hale_data->cell_mass[0])
+           depend(out : hale_data->cell_volume[0], hale_data->density0[0]))
   calc_corrected_density(
       umesh->ncells, umesh->cells_to_faces_offsets, umesh->cells_to_faces,
-      umesh->faces_to_nodes_offsets, umesh->faces_to_nodes, umesh->nodes_x0,
-      umesh->nodes_y0, umesh->nodes_z0, umesh->cell_centroids_x,
+      umesh->faces_to_nodes_offsets, umesh->faces_to_nodes, umesh->nodes_x1,
+      umesh->nodes_y1, umesh->nodes_z1, umesh->cell_centroids_x,
       umesh->cell_centroids_y, umesh->cell_centroids_z, hale_data->cell_mass,
       hale_data->cell_volume, hale_data->density0);
   STOP_PROFILING(&compute_profile, "calc_corrected_density");
+
+  // The work is applied once the new timestep is known
+  START_PROFILING(&compute_profile);
+  OMP_TASK(depend(in : mesh->dt, hale_data->cell_work[0],
+                       hale_data->cell_mass[0])
+           depend(inout : hale_data->energy0[0]))
+  apply_corrected_energy(umesh->ncells, mesh->dt, hale_data->cell_work,
+                         hale_data->cell_mass, hale_data->energy0);
+  STOP_PROFILING(&compute_profile, "apply_corrected_energy");
+#else
+  // The centroids, volumes, density, timestep and work of the subcell forces
+  // all gather the same nodes of each cell of the advanced mesh
+  OMP_TASK(depend(in : umesh->nodes_x1[0], hale_data->soundspeed1[0],
+                       hale_data->velocity_x0[0], hale_data->subcell_force_x[0],
+                       hale_data->cell_mass[0])
+           depend(out : mesh->dt, umesh->cell_centroids_x[0],
+                        hale_data->cell_volume[0], hale_data->density0[0],
+                        hale_data->cell_work[0]))
+  calc_corrected_cells(
+      umesh->ncells, umesh->cells_to_nodes_offsets, umesh->cells_to_nodes,
+      umesh->cells_to_faces_offsets, umesh->cells_to_faces,
+      umesh->faces_to_nodes_offsets, umesh->faces_to_nodes, umesh->nodes_x1,
+      umesh->nodes_y1, umesh->nodes_z1, hale_data->velocity_x0,
+      hale_data->velocity_y0, hale_data->velocity_z0,
+      hale_data->subcell_force_x, hale_data->subcell_force_y,
+      hale_data->subcell_force_z, hale_data->soundspeed1, hale_data->cell_mass,
+      umesh->cell_centroids_x, umesh->cell_centroids_y,
+      umesh->cell_centroids_z, hale_data->cell_volume, hale_data->density0,
+      hale_data->cell_work, &mesh->dt);
+
+  // The work is applied once the new timestep is known
+  START_PROFILING(&compute_profile);
+  OMP_TASK(depend(in : mesh->dt, hale_data->cell_work[0],
+                       hale_data->cell_mass[0])
+           depend(inout : hale_data->energy0[0]))
+  apply_corrected_energy(umesh->ncells, mesh->dt, hale_data->cell_work,
+                         hale_data->cell_mass, hale_data->energy0);
+  STOP_PROFILING(&compute_profile, "apply_corrected_energy");
+#endif
 }
 
-// A simple ideal gas equation of state
-void equation_of_state(const int ncells, const double* energy,
-                       const double* density, double* pressure) {
-#pragma omp parallel for
+// Evaluates the pressure and soundspeed of each cell from the equation of
+// state, which is the ideal gas unless a table is given
+void equation_of_state(const int ncells, const EosTable* eos_table,
+                       const double* energy, const double* density,
+                       double* pressure, double* soundspeed) {
+  if (eos_table) {
+    // The table is interpolated in batches of cells
+    OMP_FOR()
+    for (int bb = 0; bb < ncells; bb += EOS_BATCH) {
+      eval_eos_table(eos_table, min(EOS_BATCH, ncells - bb), &density[(bb)],
+                     &energy[(bb)], &pressure[(bb)], &soundspeed[(bb)]);
+    }
+    OMP_BARRIER();
+    return;
+  }
+
+  OMP_FOR()
   for (int cc = 0; cc < ncells; ++cc) {
-    pressure[(cc)] = (GAM - 1.0) * energy[(cc)] * density[(cc)];
+    calc_eos(energy[(cc)], density[(cc)], &pressure[(cc)], &soundspeed[(cc)]);
+  }
+  OMP_BARRIER();
+}
+
+// Evaluates the pressure and soundspeed of the listed cells, where the table
+// is interpolated in batches of the listed cells gathered into patches
+void equation_of_state_active(const int nlisted, const int* cell_list,
+                              const EosTable* eos_table, const double* energy,
+                              const double* density, double* pressure,
+                              double* soundspeed) {
+  if (eos_table) {
+    OMP_FOR()
+    for (int bb = 0; bb < nlisted; bb += EOS_BATCH) {
+      const int nlanes = min(EOS_BATCH, nlisted - bb);
+
+      double batch_density[EOS_BATCH];
+      double batch_energy[EOS_BATCH];
+      double batch_pressure[EOS_BATCH];
+      double batch_soundspeed[EOS_BATCH];
+      for (int ll = 0; ll < nlanes; ++ll) {
+        const int cc = cell_list[(bb + ll)];
+        batch_density[(ll)] = density[(cc)];
+        batch_energy[(ll)] = energy[(cc)];
+      }
+
+      eval_eos_table(eos_table, nlanes, batch_density, batch_energy,
+                     batch_pressure, batch_soundspeed);
+
+      for (int ll = 0; ll < nlanes; ++ll) {
+        const int cc = cell_list[(bb + ll)];
+        pressure[(cc)] = batch_pressure[(ll)];
+        soundspeed[(cc)] = batch_soundspeed[(ll)];
+      }
+    }
+    OMP_BARRIER();
+    return;
+  }
+
+  OMP_FOR()
+  for (int ii = 0; ii < nlisted; ++ii) {
+    const int cc = cell_list[(ii)];
+    calc_eos(energy[(cc)], density[(cc)], &pressure[(cc)], &soundspeed[(cc)]);
   }
+  OMP_BARRIER();
+}
+
+// Evaluates the pressure and soundspeed of the mixed cells from the equation
+// of state of each of their materials, where the materials are evaluated in
+// the order of their contiguous entries and then closed with the volume
+// fraction weighted pressure and squared soundspeed
+void mixed_equation_of_state(const MultiMaterial* mm,
+                             const EosTable* eos_table, const double* energy,
+                             const double* density, double* pressure,
+                             double* soundspeed) {
+  if (!mm->nmixed) {
+    return;
+  }
+
+  // Each material compresses with its cell, keeping its fractions of the cell
+  OMP_FOR()
+  for (int ee = 0; ee < mm->nentries; ++ee) {
+    const int cell_index = mm->entry_cells[(ee)];
+    mm->density[(ee)] = mm->mass_fraction[(ee)] * density[(cell_index)] /
+                        mm->volume_fraction[(ee)];
+    mm->energy[(ee)] = mm->ie_fraction[(ee)] * energy[(cell_index)] /
+                       mm->mass_fraction[(ee)];
+  }
+  OMP_BARRIER();
+
+  equation_of_state(mm->nentries, eos_table, mm->energy, mm->density,
+                    mm->pressure, mm->soundspeed);
+
+  OMP_FOR()
+  for (int kk = 0; kk < mm->nmixed; ++kk) {
+    double cell_pressure = 0.0;
+    double cell_soundspeed2 = 0.0;
+    for (int ss = mm->mixed_offsets[(kk)]; ss < mm->mixed_offsets[(kk + 1)];
+         ++ss) {
+      const int ee = mm->mixed_entries[(ss)];
+      cell_pressure += mm->volume_fraction[(ee)] * mm->pressure[(ee)];
+      cell_soundspeed2 += mm->volume_fraction[(ee)] * mm->soundspeed[(ee)] *
+                          mm->soundspeed[(ee)];
+    }
+
+    const int cell_index = mm->mixed_cells[(kk)];
+    pressure[(cell_index)] = cell_pressure;
+    soundspeed[(cell_index)] = sqrt(cell_soundspeed2);
+  }
+  OMP_BARRIER();
+}
+
+// A simple ideal gas, giving the pressure and soundspeed of a cell, which is
+// all that the scheme asks of a material model
+void calc_eos(const double energy, const double density, double* pressure,
+              double* soundspeed) {
+  *pressure = (GAM - 1.0) * energy * density;
+  *soundspeed = sqrt(GAM * (GAM - 1.0) * energy);
 }
 
 // Calculates the nodal volume and sound speed
@@ -267,77 +957,117 @@ void calc_nodal_vol_and_c(const int nnodes, const int* nodes_to_faces_offsets,
                           const double* nodes_y, const double* nodes_z,
                           const double* cell_centroids_x,
                           const double* cell_centroids_y,
-                          const double* cell_centroids_z, const double* energy,
-                          double* nodal_volumes, double* nodal_soundspeed) {
+                          const double* cell_centroids_z,
+                          const double* soundspeed, double* nodal_volumes,
+                          double* nodal_soundspeed) {
 
-#pragma omp parallel for
+  OMP_FOR()
   for (int nn = 0; nn < nnodes; ++nn) {
-    const int node_to_faces_off = nodes_to_faces_offsets[(nn)];
-    const int nfaces_by_node =
-        nodes_to_faces_offsets[(nn + 1)] - node_to_faces_off;
-
-    nodal_volumes[(nn)] = 0.0;
-    nodal_soundspeed[(nn)] = 0.0;
+    calc_node_vol_and_c(nn, nodes_to_faces_offsets, nodes_to_faces,
+                        faces_to_nodes_offsets, faces_to_nodes, faces_to_cells0,
+                        faces_to_cells1, nodes_x, nodes_y, nodes_z,
+                        cell_centroids_x, cell_centroids_y, cell_centroids_z,
+                        soundspeed, nodal_volumes, nodal_soundspeed);
+  }
+  OMP_BARRIER();
+}
 
-    // Consider all faces attached to node
-    for (int ff = 0; ff < nfaces_by_node; ++ff) {
-      const int face_index = nodes_to_faces[(node_to_faces_off + ff)];
-      if (face_index == -1) {
-        continue;
-      }
+// Calculates the nodal volume and sound speed of the listed nodes
+void calc_nodal_vol_and_c_active(
+    const int nlisted, const int* node_list, const int* nodes_to_faces_offsets,
+    const int* nodes_to_faces, const int* faces_to_nodes_offsets,
+    const int* faces_to_nodes, const int* faces_to_cells0,
+    const int* faces_to_cells1, const double* nodes_x, const double* nodes_y,
+    const double* nodes_z, const double* cell_centroids_x,
+    const double* cell_centroids_y, const double* cell_centroids_z,
+    const double* soundspeed, double* nodal_volumes,
+    double* nodal_soundspeed) {
+
+  OMP_FOR()
+  for (int ii = 0; ii < nlisted; ++ii) {
+    calc_node_vol_and_c(node_list[(ii)], nodes_to_faces_offsets,
+                        nodes_to_faces, faces_to_nodes_offsets, faces_to_nodes,
+                        faces_to_cells0, faces_to_cells1, nodes_x, nodes_y,
+                        nodes_z, cell_centroids_x, cell_centroids_y,
+                        cell_centroids_z, soundspeed, nodal_volumes,
+                        nodal_soundspeed);
+  }
+  OMP_BARRIER();
+}
 
-      // Determine the offset into the list of nodes
-      const int face_to_nodes_off = faces_to_nodes_offsets[(face_index)];
-      const int nnodes_by_face =
-          faces_to_nodes_offsets[(face_index + 1)] - face_to_nodes_off;
+// Calculates the volume and sound speed of a node
+static inline void calc_node_vol_and_c(
+    const int nn, const int* nodes_to_faces_offsets, const int* nodes_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const int* faces_to_cells0, const int* faces_to_cells1,
+    const double* nodes_x, const double* nodes_y, const double* nodes_z,
+    const double* cell_centroids_x, const double* cell_centroids_y,
+    const double* cell_centroids_z, const double* soundspeed,
+    double* nodal_volumes, double* nodal_soundspeed) {
+  const int node_to_faces_off = nodes_to_faces_offsets[(nn)];
+  const int nfaces_by_node =
+      nodes_to_faces_offsets[(nn + 1)] - node_to_faces_off;
+
+  nodal_volumes[(nn)] = 0.0;
+  nodal_soundspeed[(nn)] = 0.0;
+
+  // Consider all faces attached to node
+  for (int ff = 0; ff < nfaces_by_node; ++ff) {
+    const int face_index = nodes_to_faces[(node_to_faces_off + ff)];
+    if (face_index == -1) {
+      continue;
+    }
 
-      // Find node center and location of current node on face
-      vec_t face_c = {0.0, 0.0, 0.0};
-      int node_in_face_c;
-      for (int nn2 = 0; nn2 < nnodes_by_face; ++nn2) {
-        const int node_index = faces_to_nodes[(face_to_nodes_off + nn2)];
-        face_c.x += nodes_x[(node_index)] / nnodes_by_face;
-        face_c.y += nodes_y[(node_index)] / nnodes_by_face;
-        face_c.z += nodes_z[(node_index)] / nnodes_by_face;
-
-        // Choose the node in the list of nodes attached to the face
-        if (nn == node_index) {
-          node_in_face_c = nn2;
-        }
-      }
+    // Determine the offset into the list of nodes
+    const int face_to_nodes_off = faces_to_nodes_offsets[(face_index)];
+    const int nnodes_by_face =
+        faces_to_nodes_offsets[(face_index + 1)] - face_to_nodes_off;
 
-      // Fetch the nodes attached to our current node on the current face
-      int local_nodes[2];
-      local_nodes[0] =
-          (node_in_face_c - 1 >= 0)
-              ? faces_to_nodes[(face_to_nodes_off + node_in_face_c - 1)]
-              : faces_to_nodes[(face_to_nodes_off + nnodes_by_face - 1)];
-      local_nodes[1] =
-          (node_in_face_c + 1 < nnodes_by_face)
-              ? faces_to_nodes[(face_to_nodes_off + node_in_face_c + 1)]
-              : faces_to_nodes[(face_to_nodes_off)];
+    // Find node center and location of current node on face
+    vec_t face_c = {0.0, 0.0, 0.0};
+    int node_in_face_c;
+    for (int nn2 = 0; nn2 < nnodes_by_face; ++nn2) {
+      const int node_index = faces_to_nodes[(face_to_nodes_off + nn2)];
+      face_c.x += nodes_x[(node_index)] / nnodes_by_face;
+      face_c.y += nodes_y[(node_index)] / nnodes_by_face;
+      face_c.z += nodes_z[(node_index)] / nnodes_by_face;
 
-      // Fetch the cells attached to our current face
-      int local_cells[2];
-      local_cells[0] = faces_to_cells0[(face_index)];
-      local_cells[1] = faces_to_cells1[(face_index)];
+      // Choose the node in the list of nodes attached to the face
+      if (nn == node_index) {
+        node_in_face_c = nn2;
+      }
+    }
 
-      // Add contributions from both of the cells attached to the face
-      for (int cc = 0; cc < 2; ++cc) {
-        const int cell_index = local_cells[(cc)];
-        if (cell_index == -1) {
-          continue;
-        }
+    // Fetch the nodes attached to our current node on the current face
+    int local_nodes[2];
+    local_nodes[0] =
+        (node_in_face_c - 1 >= 0)
+            ? faces_to_nodes[(face_to_nodes_off + node_in_face_c - 1)]
+            : faces_to_nodes[(face_to_nodes_off + nnodes_by_face - 1)];
+    local_nodes[1] =
+        (node_in_face_c + 1 < nnodes_by_face)
+            ? faces_to_nodes[(face_to_nodes_off + node_in_face_c + 1)]
+            : faces_to_nodes[(face_to_nodes_off)];
+
+    // Fetch the cells attached to our current face
+    int local_cells[2];
+    local_cells[0] = faces_to_cells0[(face_index)];
+    local_cells[1] = faces_to_cells1[(face_index)];
+
+    // Add contributions from both of the cells attached to the face
+    for (int cc = 0; cc < 2; ++cc) {
+      const int cell_index = local_cells[(cc)];
+      if (cell_index == -1) {
+        continue;
+      }
 
-        // Add contributions for both edges attached to our current node
-        for (int nn2 = 0; nn2 < 2; ++nn2) {
-          const double subsubcell_vol = calc_subsubcell_volume(
-              cell_index, local_nodes[(nn2)], nn, face_c, nodes_x, nodes_y,
-              nodes_z, cell_centroids_x, cell_centroids_y, cell_centroids_z);
-          nodal_soundspeed[(nn)] +=
-              sqrt(GAM * (GAM - 1.0) * energy[(cell_index)]) * subsubcell_vol;
-          nodal_volumes[(nn)] += subsubcell_vol;
-        }
+      // Add contributions for both edges attached to our current node
+      for (int nn2 = 0; nn2 < 2; ++nn2) {
+        const double subsubcell_vol = calc_subsubcell_volume(
+            cell_index, local_nodes[(nn2)], nn, face_c, nodes_x, nodes_y,
+            nodes_z, cell_centroids_x, cell_centroids_y, cell_centroids_z);
+        nodal_soundspeed[(nn)] += soundspeed[(cell_index)] * subsubcell_vol;
+        nodal_volumes[(nn)] += subsubcell_vol;
       }
     }
   }
@@ -376,21 +1106,63 @@ double calc_subsubcell_volume(const int cc, const int rnode_index,
   return 0.5 * edge_subcell_vol;
 }
 
+// Calculates the centroid of a set of nodes from the node state
+void calc_node_state_centroid(const int nnodes, const NodeState* node_state,
+                              const int* indirection, const int offset,
+                              vec_t* centroid) {
+
+  // Summed in the same order as calc_centroid
+  centroid->x = 0.0;
+  centroid->y = 0.0;
+  centroid->z = 0.0;
+  for (int nn2 = 0; nn2 < nnodes; ++nn2) {
+    const int node_index = indirection[(offset + nn2)];
+    centroid->x += NODE_STATE(node_state, NODE_X, node_index) / nnodes;
+    centroid->y += NODE_STATE(node_state, NODE_Y, node_index) / nnodes;
+    centroid->z += NODE_STATE(node_state, NODE_Z, node_index) / nnodes;
+  }
+}
+
 // Sets all of the subcell forces to 0
 void zero_subcell_forces(const int ncells, const int* cells_to_nodes_offsets,
                          double* subcell_force_x, double* subcell_force_y,
                          double* subcell_force_z) {
-#pragma omp parallel for
+  OMP_FOR()
   for (int cc = 0; cc < ncells; ++cc) {
-    const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
-    const int nnodes_by_cell =
-        cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
-    for (int nn = 0; nn < nnodes_by_cell; ++nn) {
-      const int subcell_index = cell_to_nodes_off + nn;
-      subcell_force_x[(subcell_index)] = 0.0;
-      subcell_force_y[(subcell_index)] = 0.0;
-      subcell_force_z[(subcell_index)] = 0.0;
-    }
+    zero_cell_forces(cc, cells_to_nodes_offsets, subcell_force_x,
+                     subcell_force_y, subcell_force_z);
+  }
+  OMP_BARRIER();
+}
+
+// Sets the subcell forces of the listed cells to 0
+void zero_subcell_forces_active(const int nlisted, const int* cell_list,
+                                const int* cells_to_nodes_offsets,
+                                double* subcell_force_x,
+                                double* subcell_force_y,
+                                double* subcell_force_z) {
+  OMP_FOR()
+  for (int ii = 0; ii < nlisted; ++ii) {
+    zero_cell_forces(cell_list[(ii)], cells_to_nodes_offsets, subcell_force_x,
+                     subcell_force_y, subcell_force_z);
+  }
+  OMP_BARRIER();
+}
+
+// Sets the subcell forces of a cell to 0
+static inline void zero_cell_forces(const int cc,
+                                    const int* cells_to_nodes_offsets,
+                                    double* subcell_force_x,
+                                    double* subcell_force_y,
+                                    double* subcell_force_z) {
+  const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
+  const int nnodes_by_cell =
+      cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
+  for (int nn = 0; nn < nnodes_by_cell; ++nn) {
+    const int subcell_index = cell_to_nodes_off + nn;
+    subcell_force_x[(subcell_index)] = 0.0;
+    subcell_force_y[(subcell_index)] = 0.0;
+    subcell_force_z[(subcell_index)] = 0.0;
   }
 }
 
@@ -400,42 +1172,166 @@ void calc_subcell_force_from_pressure(
     const int* cells_to_nodes_offsets, const int* cells_to_faces,
     const int* faces_to_nodes_offsets, const int* faces_to_nodes,
     const int* cells_to_nodes, const int* faces_cclockwise_cell,
-    const double* nodes_x, const double* nodes_y, const double* nodes_z,
-    const double* pressure, double* subcell_force_x, double* subcell_force_y,
+    const NodeState* node_state, const double* pressure,
+    double* subcell_force_x, double* subcell_force_y,
+    double* subcell_force_z) {
+
+  OMP_FOR()
+  for (int cc = 0; cc < ncells; ++cc) {
+    const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
+    calc_cell_force_from_pressure(
+        cc, cells_to_faces_offsets, cells_to_nodes_offsets, cells_to_faces,
+        faces_to_nodes_offsets, faces_to_nodes, cells_to_nodes,
+        faces_cclockwise_cell, node_state, pressure,
+        &subcell_force_x[(cell_to_nodes_off)],
+        &subcell_force_y[(cell_to_nodes_off)],
+        &subcell_force_z[(cell_to_nodes_off)]);
+  }
+  OMP_BARRIER();
+}
+
+// Calculate the subcell force from pressure gradients of the listed cells
+void calc_subcell_force_from_pressure_active(
+    const int nlisted, const int* cell_list, const int* cells_to_faces_offsets,
+    const int* cells_to_nodes_offsets, const int* cells_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const int* cells_to_nodes, const int* faces_cclockwise_cell,
+    const NodeState* node_state, const double* pressure,
+    double* subcell_force_x, double* subcell_force_y,
+    double* subcell_force_z) {
+
+  OMP_FOR()
+  for (int ii = 0; ii < nlisted; ++ii) {
+    const int cc = cell_list[(ii)];
+    const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
+    calc_cell_force_from_pressure(
+        cc, cells_to_faces_offsets, cells_to_nodes_offsets, cells_to_faces,
+        faces_to_nodes_offsets, faces_to_nodes, cells_to_nodes,
+        faces_cclockwise_cell, node_state, pressure,
+        &subcell_force_x[(cell_to_nodes_off)],
+        &subcell_force_y[(cell_to_nodes_off)],
+        &subcell_force_z[(cell_to_nodes_off)]);
+  }
+  OMP_BARRIER();
+}
+
+// Calculate the force on the subcells of a cell from its pressure gradients,
+// where the forces are indexed from the first subcell of the cell
+void calc_cell_force_from_pressure(
+    const int cc, const int* cells_to_faces_offsets,
+    const int* cells_to_nodes_offsets, const int* cells_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const int* cells_to_nodes, const int* faces_cclockwise_cell,
+    const NodeState* node_state, const double* pressure,
+    double* subcell_force_x, double* subcell_force_y,
     double* subcell_force_z) {
+  const int cell_to_faces_off = cells_to_faces_offsets[(cc)];
+  const int nfaces_by_cell =
+      cells_to_faces_offsets[(cc + 1)] - cell_to_faces_off;
+  const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
+  const int nnodes_by_cell =
+      cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
+
+  // Look at all of the faces attached to the cell
+  for (int ff = 0; ff < nfaces_by_cell; ++ff) {
+    const int face_index = cells_to_faces[(cell_to_faces_off + ff)];
+    const int face_to_nodes_off = faces_to_nodes_offsets[(face_index)];
+    const int nnodes_by_face =
+        faces_to_nodes_offsets[(face_index + 1)] - face_to_nodes_off;
+
+    // Calculate the face center... SHOULD WE PRECOMPUTE?
+    vec_t face_c = {0.0, 0.0, 0.0};
+    calc_node_state_centroid(nnodes_by_face, node_state, faces_to_nodes,
+                             face_to_nodes_off, &face_c);
+
+    // Now we will sum the contributions at each of the nodes
+    // TODO: THERE IS SOME SYMMETRY HERE THAT MEANS WE MIGHT BE ABLE TO
+    // OPTIMISE
+    for (int nn2 = 0; nn2 < nnodes_by_face; ++nn2) {
+      // Fetch the nodes attached to our current node on the current face
+      const int node_index = faces_to_nodes[(face_to_nodes_off + nn2)];
+      const int face_clockwise = (faces_cclockwise_cell[(face_index)] != cc);
+      const int next_node = (nn2 == nnodes_by_face - 1) ? 0 : nn2 + 1;
+      const int prev_node = (nn2 == 0) ? nnodes_by_face - 1 : nn2 - 1;
+      const int rnode_off = (face_clockwise ? prev_node : next_node);
+      const int rnode_index = faces_to_nodes[(face_to_nodes_off + rnode_off)];
+
+      // Get the halfway point on the right edge
+      const vec_t node = {NODE_STATE(node_state, NODE_X, node_index),
+                          NODE_STATE(node_state, NODE_Y, node_index),
+                          NODE_STATE(node_state, NODE_Z, node_index)};
+      const vec_t rnode = {NODE_STATE(node_state, NODE_X, rnode_index),
+                           NODE_STATE(node_state, NODE_Y, rnode_index),
+                           NODE_STATE(node_state, NODE_Z, rnode_index)};
+      vec_t half_edge = {0.5 * (node.x + rnode.x), 0.5 * (node.y + rnode.y),
+                         0.5 * (node.z + rnode.z)};
+
+      // Setup basis on plane of tetrahedron
+      vec_t a = {(node.x - half_edge.x), (node.y - half_edge.y),
+                 (node.z - half_edge.z)};
+      vec_t b = {(face_c.x - half_edge.x), (face_c.y - half_edge.y),
+                 (face_c.z - half_edge.z)};
+
+      // Calculate the area vector A using cross product
+      vec_t A = {0.5 * (a.y * b.z - a.z * b.y), -0.5 * (a.x * b.z - a.z * b.x),
+                 0.5 * (a.x * b.y - a.y * b.x)};
+
+      int subcell_index;
+      int rsubcell_index;
+      for (int nn3 = 0; nn3 < nnodes_by_cell; ++nn3) {
+        if (cells_to_nodes[(cell_to_nodes_off + nn3)] == node_index) {
+          subcell_index = nn3;
+        } else if (cells_to_nodes[(cell_to_nodes_off + nn3)] == rnode_index) {
+          rsubcell_index = nn3;
+        }
+      }
 
-#pragma omp parallel for
+      subcell_force_x[(subcell_index)] += pressure[(cc)] * A.x;
+      subcell_force_y[(subcell_index)] += pressure[(cc)] * A.y;
+      subcell_force_z[(subcell_index)] += pressure[(cc)] * A.z;
+      subcell_force_x[(rsubcell_index)] += pressure[(cc)] * A.x;
+      subcell_force_y[(rsubcell_index)] += pressure[(cc)] * A.y;
+      subcell_force_z[(rsubcell_index)] += pressure[(cc)] * A.z;
+    }
+  }
+}
+
+// Calculate the subcell force from pressure gradients, reading the nodes of
+// each hex from its cell-local block
+void calc_subcell_force_from_pressure_packed(
+    const int ncells, const int* cells_to_faces_offsets,
+    const int* cells_to_nodes_offsets, const int* cells_to_faces,
+    const int* faces_cclockwise_cell, const int* cells_to_local_face_nodes,
+    const double* cell_nodes, const double* pressure, double* subcell_force_x,
+    double* subcell_force_y, double* subcell_force_z) {
+
+  OMP_FOR()
   for (int cc = 0; cc < ncells; ++cc) {
     const int cell_to_faces_off = cells_to_faces_offsets[(cc)];
-    const int nfaces_by_cell =
-        cells_to_faces_offsets[(cc + 1)] - cell_to_faces_off;
     const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
-    const int nnodes_by_cell =
-        cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
+    const int* local_face_nodes =
+        &cells_to_local_face_nodes[(cc * NFACES_BY_HEX * NNODES_BY_HEX_FACE)];
+    const double* nodes_x = &cell_nodes[(cc * HEX_BLOCK)];
+    const double* nodes_y = &nodes_x[(NNODES_BY_HEX)];
+    const double* nodes_z = &nodes_y[(NNODES_BY_HEX)];
 
-    // Look at all of the faces attached to the cell
-    for (int ff = 0; ff < nfaces_by_cell; ++ff) {
+    for (int ff = 0; ff < NFACES_BY_HEX; ++ff) {
       const int face_index = cells_to_faces[(cell_to_faces_off + ff)];
-      const int face_to_nodes_off = faces_to_nodes_offsets[(face_index)];
-      const int nnodes_by_face =
-          faces_to_nodes_offsets[(face_index + 1)] - face_to_nodes_off;
+      const int face_to_nodes_off = ff * NNODES_BY_HEX_FACE;
 
-      // Calculate the face center... SHOULD WE PRECOMPUTE?
       vec_t face_c = {0.0, 0.0, 0.0};
-      calc_centroid(nnodes_by_face, nodes_x, nodes_y, nodes_z, faces_to_nodes,
-                    face_to_nodes_off, &face_c);
-
-      // Now we will sum the contributions at each of the nodes
-      // TODO: THERE IS SOME SYMMETRY HERE THAT MEANS WE MIGHT BE ABLE TO
-      // OPTIMISE
-      for (int nn2 = 0; nn2 < nnodes_by_face; ++nn2) {
-        // Fetch the nodes attached to our current node on the current face
-        const int node_index = faces_to_nodes[(face_to_nodes_off + nn2)];
+      calc_centroid(NNODES_BY_HEX_FACE, nodes_x, nodes_y, nodes_z,
+                    local_face_nodes, face_to_nodes_off, &face_c);
+
+      for (int nn2 = 0; nn2 < NNODES_BY_HEX_FACE; ++nn2) {
+        // The position of a node in the block is also its subcell
+        const int node_index = local_face_nodes[(face_to_nodes_off + nn2)];
         const int face_clockwise = (faces_cclockwise_cell[(face_index)] != cc);
-        const int next_node = (nn2 == nnodes_by_face - 1) ? 0 : nn2 + 1;
-        const int prev_node = (nn2 == 0) ? nnodes_by_face - 1 : nn2 - 1;
+        const int next_node = (nn2 == NNODES_BY_HEX_FACE - 1) ? 0 : nn2 + 1;
+        const int prev_node = (nn2 == 0) ? NNODES_BY_HEX_FACE - 1 : nn2 - 1;
         const int rnode_off = (face_clockwise ? prev_node : next_node);
-        const int rnode_index = faces_to_nodes[(face_to_nodes_off + rnode_off)];
+        const int rnode_index =
+            local_face_nodes[(face_to_nodes_off + rnode_off)];
 
         // Get the halfway point on the right edge
         vec_t half_edge = {
@@ -455,16 +1351,8 @@ void calc_subcell_force_from_pressure(
                    -0.5 * (a.x * b.z - a.z * b.x),
                    0.5 * (a.x * b.y - a.y * b.x)};
 
-        int subcell_index;
-        int rsubcell_index;
-        for (int nn3 = 0; nn3 < nnodes_by_cell; ++nn3) {
-          if (cells_to_nodes[(cell_to_nodes_off + nn3)] == node_index) {
-            subcell_index = cell_to_nodes_off + nn3;
-          } else if (cells_to_nodes[(cell_to_nodes_off + nn3)] == rnode_index) {
-            rsubcell_index = cell_to_nodes_off + nn3;
-          }
-        }
-
+        const int subcell_index = cell_to_nodes_off + node_index;
+        const int rsubcell_index = cell_to_nodes_off + rnode_index;
         subcell_force_x[(subcell_index)] += pressure[(cc)] * A.x;
         subcell_force_y[(subcell_index)] += pressure[(cc)] * A.y;
         subcell_force_z[(subcell_index)] += pressure[(cc)] * A.z;
@@ -474,16 +1362,31 @@ void calc_subcell_force_from_pressure(
       }
     }
   }
+  OMP_BARRIER();
 }
 
 // Scale the soundspeed by the inverse of the nodal volume
 void scale_soundspeed(const int nnodes, const double* nodal_volumes,
                       double* nodal_soundspeed) {
 
-#pragma omp parallel for
+  OMP_FOR()
   for (int nn = 0; nn < nnodes; ++nn) {
     nodal_soundspeed[(nn)] /= nodal_volumes[(nn)];
   }
+  OMP_BARRIER();
+}
+
+// Scale the soundspeed of the listed nodes by the inverse of the nodal volume
+void scale_soundspeed_active(const int nlisted, const int* node_list,
+                             const double* nodal_volumes,
+                             double* nodal_soundspeed) {
+
+  OMP_FOR()
+  for (int ii = 0; ii < nlisted; ++ii) {
+    const int nn = node_list[(ii)];
+    nodal_soundspeed[(nn)] /= nodal_volumes[(nn)];
+  }
+  OMP_BARRIER();
 }
 
 // Calculate the time centered evolved velocities, by calculating the predicted
@@ -499,46 +1402,209 @@ void calc_new_velocity(const int nnodes, const double dt,
                        const double* velocity_z0, double* velocity_x1,
                        double* velocity_y1, double* velocity_z1) {
 
-#pragma omp parallel for simd
+  OMP_FOR_SIMD()
   for (int nn = 0; nn < nnodes; ++nn) {
-    const int node_to_cells_off = nodes_to_cells_offsets[(nn)];
-    const int ncells_by_node =
-        nodes_to_cells_offsets[(nn + 1)] - node_to_cells_off;
-
-    // Accumulate the force at this node
-    vec_t node_force = {0.0, 0.0, 0.0};
-    for (int cc = 0; cc < ncells_by_node; ++cc) {
-      const int cell_index = nodes_to_cells[(node_to_cells_off + cc)];
-      const int cell_to_nodes_off = cells_to_nodes_offsets[(cell_index)];
-      const int nnodes_by_cell =
-          cells_to_nodes_offsets[(cell_index + 1)] - cell_to_nodes_off;
+    calc_node_velocity(nn, dt, nodes_to_cells_offsets, nodes_to_cells,
+                       cells_to_nodes_offsets, cells_to_nodes, subcell_force_x,
+                       subcell_force_y, subcell_force_z, nodal_mass,
+                       velocity_x0, velocity_y0, velocity_z0, velocity_x1,
+                       velocity_y1, velocity_z1);
+  }
+  OMP_BARRIER();
+}
 
-      // ARRGHHHH
-      int nn2;
-      for (nn2 = 0; nn2 < nnodes_by_cell; ++nn2) {
-        if (cells_to_nodes[(cell_to_nodes_off + nn2)] == nn) {
-          break;
-        }
+// Calculate the time centered evolved velocities of the listed nodes
+void calc_new_velocity_active(
+    const int nlisted, const int* node_list, const double dt,
+    const int* nodes_to_cells_offsets, const int* nodes_to_cells,
+    const int* cells_to_nodes_offsets, const int* cells_to_nodes,
+    const double* subcell_force_x, const double* subcell_force_y,
+    const double* subcell_force_z, const double* nodal_mass,
+    const double* velocity_x0, const double* velocity_y0,
+    const double* velocity_z0, double* velocity_x1, double* velocity_y1,
+    double* velocity_z1) {
+
+  OMP_FOR()
+  for (int ii = 0; ii < nlisted; ++ii) {
+    calc_node_velocity(node_list[(ii)], dt, nodes_to_cells_offsets,
+                       nodes_to_cells, cells_to_nodes_offsets, cells_to_nodes,
+                       subcell_force_x, subcell_force_y, subcell_force_z,
+                       nodal_mass, velocity_x0, velocity_y0, velocity_z0,
+                       velocity_x1, velocity_y1, velocity_z1);
+  }
+  OMP_BARRIER();
+}
+
+// Sums the forces on the subcells around a node
+static inline vec_t sum_node_force(const int nn,
+                                   const int* nodes_to_cells_offsets,
+                                   const int* nodes_to_cells,
+                                   const int* cells_to_nodes_offsets,
+                                   const int* cells_to_nodes,
+                                   const double* subcell_force_x,
+                                   const double* subcell_force_y,
+                                   const double* subcell_force_z) {
+  const int node_to_cells_off = nodes_to_cells_offsets[(nn)];
+  const int ncells_by_node =
+      nodes_to_cells_offsets[(nn + 1)] - node_to_cells_off;
+
+  // Accumulate the force at this node
+  vec_t node_force = {0.0, 0.0, 0.0};
+  for (int cc = 0; cc < ncells_by_node; ++cc) {
+    const int cell_index = nodes_to_cells[(node_to_cells_off + cc)];
+    const int cell_to_nodes_off = cells_to_nodes_offsets[(cell_index)];
+    const int nnodes_by_cell =
+        cells_to_nodes_offsets[(cell_index + 1)] - cell_to_nodes_off;
+
+    // ARRGHHHH
+    int nn2;
+    for (nn2 = 0; nn2 < nnodes_by_cell; ++nn2) {
+      if (cells_to_nodes[(cell_to_nodes_off + nn2)] == nn) {
+        break;
       }
+    }
+
+    const int subcell_index = cell_to_nodes_off + nn2;
+    node_force.x += subcell_force_x[(subcell_index)];
+    node_force.y += subcell_force_y[(subcell_index)];
+    node_force.z += subcell_force_z[(subcell_index)];
+  }
+
+  return node_force;
+}
+
+// Calculates the time centered evolved velocity of a node
+static inline void calc_node_velocity(
+    const int nn, const double dt, const int* nodes_to_cells_offsets,
+    const int* nodes_to_cells, const int* cells_to_nodes_offsets,
+    const int* cells_to_nodes, const double* subcell_force_x,
+    const double* subcell_force_y, const double* subcell_force_z,
+    const double* nodal_mass, const double* velocity_x0,
+    const double* velocity_y0, const double* velocity_z0, double* velocity_x1,
+    double* velocity_y1, double* velocity_z1) {
+  const vec_t node_force = sum_node_force(
+      nn, nodes_to_cells_offsets, nodes_to_cells, cells_to_nodes_offsets,
+      cells_to_nodes, subcell_force_x, subcell_force_y, subcell_force_z);
+
+  // Determine the predicted velocity
+  velocity_x1[(nn)] = velocity_x0[(nn)] + dt * node_force.x / nodal_mass[(nn)];
+  velocity_y1[(nn)] = velocity_y0[(nn)] + dt * node_force.y / nodal_mass[(nn)];
+  velocity_z1[(nn)] = velocity_z0[(nn)] + dt * node_force.z / nodal_mass[(nn)];
+
+  // Calculate the time centered velocity
+  velocity_x1[(nn)] = 0.5 * (velocity_x0[(nn)] + velocity_x1[(nn)]);
+  velocity_y1[(nn)] = 0.5 * (velocity_y0[(nn)] + velocity_y1[(nn)]);
+  velocity_z1[(nn)] = 0.5 * (velocity_z0[(nn)] + velocity_z1[(nn)]);
+}
 
-      const int subcell_index = cell_to_nodes_off + nn2;
-      node_force.x += subcell_force_x[(subcell_index)];
-      node_force.y += subcell_force_y[(subcell_index)];
-      node_force.z += subcell_force_z[(subcell_index)];
+// Calculate the time centered evolved velocities, vectorised across the nodes
+// of each slice of the SELL-C-sigma node to subcell adjacency
+void calc_new_velocity_sell(
+    const double dt, const SellAdjacency* nodes_to_cells_sell,
+    const int* nodes_to_subcells_sell, const double* subcell_force_x,
+    const double* subcell_force_y, const double* subcell_force_z,
+    const double* nodal_mass, const double* velocity_x0,
+    const double* velocity_y0, const double* velocity_z0, double* velocity_x1,
+    double* velocity_y1, double* velocity_z1) {
+
+  OMP_FOR()
+  for (int ss = 0; ss < nodes_to_cells_sell->nslices; ++ss) {
+    const int* rows = &nodes_to_cells_sell->rows[(ss * SELL_CHUNK)];
+
+    // Accumulate the force at the nodes of the slice
+    const double* subcell_force[] = {subcell_force_x, subcell_force_y,
+                                     subcell_force_z};
+    double node_force[3][SELL_CHUNK];
+    sum_sell_subcells(nodes_to_cells_sell, nodes_to_subcells_sell, ss, 3,
+                      subcell_force, node_force);
+
+    // Only the end of the last slice is padded
+    const int nlanes =
+        min(SELL_CHUNK, nodes_to_cells_sell->nrows - ss * SELL_CHUNK);
+
+#pragma omp simd
+    for (int ll = 0; ll < nlanes; ++ll) {
+      const int nn = rows[(ll)];
+
+      // Determine the predicted velocity, and time center it
+      const double vx1 =
+          velocity_x0[(nn)] + dt * node_force[(0)][(ll)] / nodal_mass[(nn)];
+      const double vy1 =
+          velocity_y0[(nn)] + dt * node_force[(1)][(ll)] / nodal_mass[(nn)];
+      const double vz1 =
+          velocity_z0[(nn)] + dt * node_force[(2)][(ll)] / nodal_mass[(nn)];
+      velocity_x1[(nn)] = 0.5 * (velocity_x0[(nn)] + vx1);
+      velocity_y1[(nn)] = 0.5 * (velocity_y0[(nn)] + vy1);
+      velocity_z1[(nn)] = 0.5 * (velocity_z0[(nn)] + vz1);
     }
+  }
+  OMP_BARRIER();
+}
+
+// Calculate the time centered evolved velocities from the forces accumulated
+// at the nodes, clearing the forces for the next accumulation
+void calc_new_velocity_from_node_force(
+    const int nnodes, const double dt, const double* nodal_mass,
+    const double* velocity_x0, const double* velocity_y0,
+    const double* velocity_z0, double* node_force_x, double* node_force_y,
+    double* node_force_z, double* velocity_x1, double* velocity_y1,
+    double* velocity_z1) {
 
+  OMP_FOR_SIMD()
+  for (int nn = 0; nn < nnodes; ++nn) {
     // Determine the predicted velocity
     velocity_x1[(nn)] =
-        velocity_x0[(nn)] + dt * node_force.x / nodal_mass[(nn)];
+        velocity_x0[(nn)] + dt * node_force_x[(nn)] / nodal_mass[(nn)];
     velocity_y1[(nn)] =
-        velocity_y0[(nn)] + dt * node_force.y / nodal_mass[(nn)];
+        velocity_y0[(nn)] + dt * node_force_y[(nn)] / nodal_mass[(nn)];
     velocity_z1[(nn)] =
-        velocity_z0[(nn)] + dt * node_force.z / nodal_mass[(nn)];
+        velocity_z0[(nn)] + dt * node_force_z[(nn)] / nodal_mass[(nn)];
 
     // Calculate the time centered velocity
     velocity_x1[(nn)] = 0.5 * (velocity_x0[(nn)] + velocity_x1[(nn)]);
     velocity_y1[(nn)] = 0.5 * (velocity_y0[(nn)] + velocity_y1[(nn)]);
     velocity_z1[(nn)] = 0.5 * (velocity_z0[(nn)] + velocity_z1[(nn)]);
+
+    node_force_x[(nn)] = 0.0;
+    node_force_y[(nn)] = 0.0;
+    node_force_z[(nn)] = 0.0;
+  }
+  OMP_BARRIER();
+}
+
+// Sums subcell quantities into the nodes of a slice of the SELL-C-sigma node
+// to subcell adjacency, in the order of the original list, where the padding
+// is masked rather than branched around
+void sum_sell_subcells(const SellAdjacency* nodes_to_cells_sell,
+                       const int* nodes_to_subcells_sell, const int ss,
+                       const int nquantities, const double** subcell_quantity,
+                       double (*node_sum)[SELL_CHUNK]) {
+
+  const int slice_off = nodes_to_cells_sell->slice_offsets[(ss)];
+  const int width =
+      (nodes_to_cells_sell->slice_offsets[(ss + 1)] - slice_off) / SELL_CHUNK;
+
+  for (int qq = 0; qq < nquantities; ++qq) {
+    const double* quantity = subcell_quantity[(qq)];
+    double sum[SELL_CHUNK] = {0.0};
+
+    for (int kk = 0; kk < width; ++kk) {
+      const int* subcells =
+          &nodes_to_subcells_sell[(slice_off + kk * SELL_CHUNK)];
+#pragma omp simd
+      for (int ll = 0; ll < SELL_CHUNK; ++ll) {
+        // The padding loads the first subcell and is weighted out, as a
+        // select would leave a masked gather
+        const int subcell_index = (subcells[(ll)] != -1) ? subcells[(ll)] : 0;
+        const double mask = (subcells[(ll)] != -1) ? 1.0 : 0.0;
+        sum[(ll)] += mask * quantity[(subcell_index)];
+      }
+    }
+
+#pragma omp simd
+    for (int ll = 0; ll < SELL_CHUNK; ++ll) {
+      node_sum[(qq)][(ll)] = sum[(ll)];
+    }
   }
 }
 
@@ -549,12 +1615,41 @@ void move_nodes(const int nnodes, const double dt, const double* nodes_x0,
                 const double* velocity_z1, double* nodes_x1, double* nodes_y1,
                 double* nodes_z1) {
 
-#pragma omp parallel for simd
+  OMP_FOR_SIMD()
   for (int nn = 0; nn < nnodes; ++nn) {
-    nodes_x1[(nn)] = nodes_x0[(nn)] + dt * velocity_x1[(nn)];
-    nodes_y1[(nn)] = nodes_y0[(nn)] + dt * velocity_y1[(nn)];
-    nodes_z1[(nn)] = nodes_z0[(nn)] + dt * velocity_z1[(nn)];
+    advance_node(nn, dt, velocity_x1, velocity_y1, velocity_z1, nodes_x0,
+                 nodes_y0, nodes_z0, nodes_x1, nodes_y1, nodes_z1);
+  }
+  OMP_BARRIER();
+}
+
+// Moves the listed nodes to the next time level
+void move_nodes_active(const int nlisted, const int* node_list,
+                       const double dt, const double* nodes_x0,
+                       const double* nodes_y0, const double* nodes_z0,
+                       const double* velocity_x1, const double* velocity_y1,
+                       const double* velocity_z1, double* nodes_x1,
+                       double* nodes_y1, double* nodes_z1) {
+
+  OMP_FOR()
+  for (int ii = 0; ii < nlisted; ++ii) {
+    advance_node(node_list[(ii)], dt, velocity_x1, velocity_y1, velocity_z1,
+                 nodes_x0, nodes_y0, nodes_z0, nodes_x1, nodes_y1, nodes_z1);
   }
+  OMP_BARRIER();
+}
+
+// Advances a node over the timestep with the given velocity
+static inline void advance_node(const int nn, const double dt,
+                                const double* velocity_x,
+                                const double* velocity_y,
+                                const double* velocity_z,
+                                const double* nodes_x0, const double* nodes_y0,
+                                const double* nodes_z0, double* nodes_x1,
+                                double* nodes_y1, double* nodes_z1) {
+  nodes_x1[(nn)] = nodes_x0[(nn)] + dt * velocity_x[(nn)];
+  nodes_y1[(nn)] = nodes_y0[(nn)] + dt * velocity_y[(nn)];
+  nodes_z1[(nn)] = nodes_z0[(nn)] + dt * velocity_z[(nn)];
 }
 
 // calculates a new density from the pressure gradients
@@ -568,33 +1663,94 @@ void calc_predicted_density(const int ncells, const int* cells_to_faces_offsets,
                             const double* cell_centroids_z,
                             const double* cell_mass, double* density1) {
 
-#pragma omp parallel for
+  OMP_FOR()
   for (int cc = 0; cc < ncells; ++cc) {
-    const int cell_to_faces_off = cells_to_faces_offsets[(cc)];
-    const int nfaces_by_cell =
-        cells_to_faces_offsets[(cc + 1)] - cell_to_faces_off;
-
-    const double cell_volume = calc_cell_volume(
-        cc, nfaces_by_cell, cell_to_faces_off, cells_to_faces,
-        faces_to_nodes_offsets, faces_to_nodes, nodes_x1, nodes_y1, nodes_z1,
-        cell_centroids_x, cell_centroids_y, cell_centroids_z);
+    const double cell_volume = calc_cell_volume_by_faces(
+        cc, cells_to_faces_offsets, cells_to_faces, faces_to_nodes_offsets,
+        faces_to_nodes, nodes_x1, nodes_y1, nodes_z1, cell_centroids_x,
+        cell_centroids_y, cell_centroids_z);
 
     density1[(cc)] = cell_mass[(cc)] / cell_volume;
   }
+  OMP_BARRIER();
 }
 
-// Time centers the pressure
-void time_center_pressure(const int ncells, const double* energy1,
-                          const double* density1, const double* pressure0,
-                          double* pressure1) {
-#pragma omp parallel for
-  for (int cc = 0; cc < ncells; ++cc) {
-    // Calculate the predicted pressure from the equation of state
-    pressure1[(cc)] = (GAM - 1.0) * energy1[(cc)] * density1[(cc)];
+// Calculates a new density for the listed cells
+void calc_predicted_density_active(
+    const int nlisted, const int* cell_list, const int* cells_to_faces_offsets,
+    const int* cells_to_faces, const int* faces_to_nodes_offsets,
+    const int* faces_to_nodes, const double* nodes_x1, const double* nodes_y1,
+    const double* nodes_z1, const double* cell_centroids_x,
+    const double* cell_centroids_y, const double* cell_centroids_z,
+    const double* cell_mass, double* density1) {
 
-    // Determine the time centered pressure
-    pressure1[(cc)] = 0.5 * (pressure0[(cc)] + pressure1[(cc)]);
+  OMP_FOR()
+  for (int ii = 0; ii < nlisted; ++ii) {
+    const int cc = cell_list[(ii)];
+    const double cell_volume = calc_cell_volume_by_faces(
+        cc, cells_to_faces_offsets, cells_to_faces, faces_to_nodes_offsets,
+        faces_to_nodes, nodes_x1, nodes_y1, nodes_z1, cell_centroids_x,
+        cell_centroids_y, cell_centroids_z);
+
+    density1[(cc)] = cell_mass[(cc)] / cell_volume;
   }
+  OMP_BARRIER();
+}
+
+// Calculates the volume of a cell from the offset of its faces
+static inline double calc_cell_volume_by_faces(
+    const int cc, const int* cells_to_faces_offsets, const int* cells_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const double* nodes_x, const double* nodes_y, const double* nodes_z,
+    const double* cell_centroids_x, const double* cell_centroids_y,
+    const double* cell_centroids_z) {
+  const int cell_to_faces_off = cells_to_faces_offsets[(cc)];
+  const int nfaces_by_cell =
+      cells_to_faces_offsets[(cc + 1)] - cell_to_faces_off;
+
+  return calc_cell_volume(cc, nfaces_by_cell, cell_to_faces_off,
+                          cells_to_faces, faces_to_nodes_offsets,
+                          faces_to_nodes, nodes_x, nodes_y, nodes_z,
+                          cell_centroids_x, cell_centroids_y, cell_centroids_z);
+}
+
+// Calculates a new density from the cell-local blocks of the predicted nodes
+void calc_predicted_density_packed(
+    const int ncells, const int* cells_to_local_face_nodes,
+    const double* cell_nodes, const double* cell_centroids_x,
+    const double* cell_centroids_y, const double* cell_centroids_z,
+    const double* cell_mass, double* density1) {
+
+  OMP_FOR()
+  for (int cc = 0; cc < ncells; ++cc) {
+    const double cell_volume = calc_cell_volume_packed(
+        cc, cells_to_local_face_nodes, cell_nodes, cell_centroids_x,
+        cell_centroids_y, cell_centroids_z);
+
+    density1[(cc)] = cell_mass[(cc)] / cell_volume;
+  }
+  OMP_BARRIER();
+}
+
+// Time centers the pressure between the rezoned and predicted pressures
+void time_center_pressure(const int ncells, const double* pressure0,
+                          double* pressure1) {
+  OMP_FOR()
+  for (int cc = 0; cc < ncells; ++cc) {
+    pressure1[(cc)] = 0.5 * (pressure0[(cc)] + pressure1[(cc)]);
+  }
+  OMP_BARRIER();
+}
+
+// Time centers the pressure of the listed cells
+void time_center_pressure_active(const int nlisted, const int* cell_list,
+                                 const double* pressure0, double* pressure1) {
+  OMP_FOR()
+  for (int ii = 0; ii < nlisted; ++ii) {
+    const int cc = cell_list[(ii)];
+    pressure1[(cc)] = 0.5 * (pressure0[(cc)] + pressure1[(cc)]);
+  }
+  OMP_BARRIER();
 }
 
 // Time centers the nodal positions
@@ -602,12 +1758,36 @@ void time_center_nodes(const int nnodes, const double* nodes_x0,
                        const double* nodes_y0, const double* nodes_z0,
                        double* nodes_x1, double* nodes_y1, double* nodes_z1) {
 
-#pragma omp parallel for
+  OMP_FOR()
   for (int nn = 0; nn < nnodes; ++nn) {
-    nodes_x1[(nn)] = 0.5 * (nodes_x1[(nn)] + nodes_x0[(nn)]);
-    nodes_y1[(nn)] = 0.5 * (nodes_y1[(nn)] + nodes_y0[(nn)]);
-    nodes_z1[(nn)] = 0.5 * (nodes_z1[(nn)] + nodes_z0[(nn)]);
+    time_center_node(nn, nodes_x0, nodes_y0, nodes_z0, nodes_x1, nodes_y1,
+                     nodes_z1);
+  }
+  OMP_BARRIER();
+}
+
+// Time centers the positions of the listed nodes
+void time_center_nodes_active(const int nlisted, const int* node_list,
+                              const double* nodes_x0, const double* nodes_y0,
+                              const double* nodes_z0, double* nodes_x1,
+                              double* nodes_y1, double* nodes_z1) {
+
+  OMP_FOR()
+  for (int ii = 0; ii < nlisted; ++ii) {
+    time_center_node(node_list[(ii)], nodes_x0, nodes_y0, nodes_z0, nodes_x1,
+                     nodes_y1, nodes_z1);
   }
+  OMP_BARRIER();
+}
+
+// Time centers the position of a node
+static inline void time_center_node(const int nn, const double* nodes_x0,
+                                    const double* nodes_y0,
+                                    const double* nodes_z0, double* nodes_x1,
+                                    double* nodes_y1, double* nodes_z1) {
+  nodes_x1[(nn)] = 0.5 * (nodes_x1[(nn)] + nodes_x0[(nn)]);
+  nodes_y1[(nn)] = 0.5 * (nodes_y1[(nn)] + nodes_y0[(nn)]);
+  nodes_z1[(nn)] = 0.5 * (nodes_z1[(nn)] + nodes_z0[(nn)]);
 }
 
 // Updates and time center velocity in the corrector step
@@ -620,58 +1800,187 @@ void update_and_time_center_velocity(
     double* velocity_z0, double* velocity_x1, double* velocity_y1,
     double* velocity_z1) {
 
-#pragma omp parallel for simd
+  OMP_FOR_SIMD()
   for (int nn = 0; nn < nnodes; ++nn) {
-    const int node_to_cells_off = nodes_to_cells_offsets[(nn)];
-    const int ncells_by_node =
-        nodes_to_cells_offsets[(nn + 1)] - node_to_cells_off;
-
-    // Consider all faces attached to node
-    vec_t node_force = {0.0, 0.0, 0.0};
-    for (int cc = 0; cc < ncells_by_node; ++cc) {
-      const int cell_index = nodes_to_cells[(node_to_cells_off + cc)];
-      const int cell_to_nodes_off = cells_to_nodes_offsets[(cell_index)];
-      const int nnodes_by_cell =
-          cells_to_nodes_offsets[(cell_index + 1)] - cell_to_nodes_off;
+    update_node_velocity(nn, dt, nodes_to_cells_offsets, nodes_to_cells,
+                         cells_to_nodes_offsets, cells_to_nodes, nodal_mass,
+                         subcell_force_x, subcell_force_y, subcell_force_z,
+                         velocity_x0, velocity_y0, velocity_z0, velocity_x1,
+                         velocity_y1, velocity_z1);
+  }
+  OMP_BARRIER();
+}
 
-      int nn2;
-      for (nn2 = 0; nn2 < nnodes_by_cell; ++nn2) {
-        if (cells_to_nodes[(cell_to_nodes_off + nn2)] == nn) {
-          break;
-        }
-      }
+// Updates and time center velocity of the listed nodes in the corrector step
+void update_and_time_center_velocity_active(
+    const int nlisted, const int* node_list, const double dt,
+    const int* nodes_to_cells_offsets, const int* nodes_to_cells,
+    const int* cells_to_nodes_offsets, const int* cells_to_nodes,
+    const double* nodal_mass, const double* subcell_force_x,
+    const double* subcell_force_y, const double* subcell_force_z,
+    double* velocity_x0, double* velocity_y0, double* velocity_z0,
+    double* velocity_x1, double* velocity_y1, double* velocity_z1) {
+
+  OMP_FOR()
+  for (int ii = 0; ii < nlisted; ++ii) {
+    update_node_velocity(node_list[(ii)], dt, nodes_to_cells_offsets,
+                         nodes_to_cells, cells_to_nodes_offsets,
+                         cells_to_nodes, nodal_mass, subcell_force_x,
+                         subcell_force_y, subcell_force_z, velocity_x0,
+                         velocity_y0, velocity_z0, velocity_x1, velocity_y1,
+                         velocity_z1);
+  }
+  OMP_BARRIER();
+}
+
+// Updates and time centers the velocity of a node in the corrector step
+static inline void update_node_velocity(
+    const int nn, const double dt, const int* nodes_to_cells_offsets,
+    const int* nodes_to_cells, const int* cells_to_nodes_offsets,
+    const int* cells_to_nodes, const double* nodal_mass,
+    const double* subcell_force_x, const double* subcell_force_y,
+    const double* subcell_force_z, double* velocity_x0, double* velocity_y0,
+    double* velocity_z0, double* velocity_x1, double* velocity_y1,
+    double* velocity_z1) {
+  const vec_t node_force = sum_node_force(
+      nn, nodes_to_cells_offsets, nodes_to_cells, cells_to_nodes_offsets,
+      cells_to_nodes, subcell_force_x, subcell_force_y, subcell_force_z);
+
+  // TODO: Do we actually need to update the velocities back here??
+  // Calculate the new velocities
+  velocity_x1[(nn)] += dt * node_force.x / nodal_mass[(nn)];
+  velocity_y1[(nn)] += dt * node_force.y / nodal_mass[(nn)];
+  velocity_z1[(nn)] += dt * node_force.z / nodal_mass[(nn)];
+
+  // Calculate the corrected time centered velocities
+  velocity_x0[(nn)] = 0.5 * (velocity_x1[(nn)] + velocity_x0[(nn)]);
+  velocity_y0[(nn)] = 0.5 * (velocity_y1[(nn)] + velocity_y0[(nn)]);
+  velocity_z0[(nn)] = 0.5 * (velocity_z1[(nn)] + velocity_z0[(nn)]);
+}
 
-      node_force.x += subcell_force_x[(cell_to_nodes_off + nn2)];
-      node_force.y += subcell_force_y[(cell_to_nodes_off + nn2)];
-      node_force.z += subcell_force_z[(cell_to_nodes_off + nn2)];
+// Updates and time center velocity in the corrector step, vectorised across
+// the nodes of each slice of the SELL-C-sigma node to subcell adjacency
+void update_and_time_center_velocity_sell(
+    const double dt, const SellAdjacency* nodes_to_cells_sell,
+    const int* nodes_to_subcells_sell, const double* nodal_mass,
+    const double* subcell_force_x, const double* subcell_force_y,
+    const double* subcell_force_z, double* velocity_x0, double* velocity_y0,
+    double* velocity_z0, double* velocity_x1, double* velocity_y1,
+    double* velocity_z1) {
+
+  OMP_FOR()
+  for (int ss = 0; ss < nodes_to_cells_sell->nslices; ++ss) {
+    const int* rows = &nodes_to_cells_sell->rows[(ss * SELL_CHUNK)];
+
+    const double* subcell_force[] = {subcell_force_x, subcell_force_y,
+                                     subcell_force_z};
+    double node_force[3][SELL_CHUNK];
+    sum_sell_subcells(nodes_to_cells_sell, nodes_to_subcells_sell, ss, 3,
+                      subcell_force, node_force);
+
+    // Only the end of the last slice is padded
+    const int nlanes =
+        min(SELL_CHUNK, nodes_to_cells_sell->nrows - ss * SELL_CHUNK);
+
+#pragma omp simd
+    for (int ll = 0; ll < nlanes; ++ll) {
+      const int nn = rows[(ll)];
+
+      // Calculate the new velocities
+      velocity_x1[(nn)] += dt * node_force[(0)][(ll)] / nodal_mass[(nn)];
+      velocity_y1[(nn)] += dt * node_force[(1)][(ll)] / nodal_mass[(nn)];
+      velocity_z1[(nn)] += dt * node_force[(2)][(ll)] / nodal_mass[(nn)];
+
+      // Calculate the corrected time centered velocities
+      velocity_x0[(nn)] = 0.5 * (velocity_x1[(nn)] + velocity_x0[(nn)]);
+      velocity_y0[(nn)] = 0.5 * (velocity_y1[(nn)] + velocity_y0[(nn)]);
+      velocity_z0[(nn)] = 0.5 * (velocity_z1[(nn)] + velocity_z0[(nn)]);
     }
+  }
+  OMP_BARRIER();
+}
 
-    // TODO: Do we actually need to update the velocities back here??
-    // Calculate the new velocities
-    velocity_x1[(nn)] += dt * node_force.x / nodal_mass[(nn)];
-    velocity_y1[(nn)] += dt * node_force.y / nodal_mass[(nn)];
-    velocity_z1[(nn)] += dt * node_force.z / nodal_mass[(nn)];
+// Updates and time center velocity in the corrector step from the forces
+// accumulated at the nodes, clearing the forces for the next accumulation
+void update_and_time_center_velocity_from_node_force(
+    const int nnodes, const double dt, const double* nodal_mass,
+    double* node_force_x, double* node_force_y, double* node_force_z,
+    double* velocity_x0, double* velocity_y0, double* velocity_z0,
+    const double* velocity_x1, const double* velocity_y1,
+    const double* velocity_z1) {
+
+  OMP_FOR_SIMD()
+  for (int nn = 0; nn < nnodes; ++nn) {
+    // Calculate the new velocities, leaving the velocities that the forces
+    // were found from for the work done on the cells
+    const double new_velocity_x =
+        velocity_x1[(nn)] + dt * node_force_x[(nn)] / nodal_mass[(nn)];
+    const double new_velocity_y =
+        velocity_y1[(nn)] + dt * node_force_y[(nn)] / nodal_mass[(nn)];
+    const double new_velocity_z =
+        velocity_z1[(nn)] + dt * node_force_z[(nn)] / nodal_mass[(nn)];
 
     // Calculate the corrected time centered velocities
-    velocity_x0[(nn)] = 0.5 * (velocity_x1[(nn)] + velocity_x0[(nn)]);
-    velocity_y0[(nn)] = 0.5 * (velocity_y1[(nn)] + velocity_y0[(nn)]);
-    velocity_z0[(nn)] = 0.5 * (velocity_z1[(nn)] + velocity_z0[(nn)]);
+    velocity_x0[(nn)] = 0.5 * (new_velocity_x + velocity_x0[(nn)]);
+    velocity_y0[(nn)] = 0.5 * (new_velocity_y + velocity_y0[(nn)]);
+    velocity_z0[(nn)] = 0.5 * (new_velocity_z + velocity_z0[(nn)]);
+
+    node_force_x[(nn)] = 0.0;
+    node_force_y[(nn)] = 0.0;
+    node_force_z[(nn)] = 0.0;
   }
+  OMP_BARRIER();
 }
 
 // Advances the nodes using the corrected velocity
 void advance_nodes_corrected(const int nnodes, const double dt,
                              const double* velocity_x0,
                              const double* velocity_y0,
-                             const double* velocity_z0, double* nodes_x0,
-                             double* nodes_y0, double* nodes_z0) {
+                             const double* velocity_z0, const double* nodes_x0,
+                             const double* nodes_y0, const double* nodes_z0,
+                             double* nodes_x1, double* nodes_y1,
+                             double* nodes_z1) {
 
-#pragma omp parallel for
+  OMP_FOR()
   for (int nn = 0; nn < nnodes; ++nn) {
-    nodes_x0[(nn)] += dt * velocity_x0[(nn)];
-    nodes_y0[(nn)] += dt * velocity_y0[(nn)];
-    nodes_z0[(nn)] += dt * velocity_z0[(nn)];
+    advance_node(nn, dt, velocity_x0, velocity_y0, velocity_z0, nodes_x0,
+                 nodes_y0, nodes_z0, nodes_x1, nodes_y1, nodes_z1);
   }
+  OMP_BARRIER();
+}
+
+// Advances the listed nodes using the corrected velocity
+void advance_nodes_corrected_active(
+    const int nlisted, const int* node_list, const double dt,
+    const double* velocity_x0, const double* velocity_y0,
+    const double* velocity_z0, const double* nodes_x0, const double* nodes_y0,
+    const double* nodes_z0, double* nodes_x1, double* nodes_y1,
+    double* nodes_z1) {
+
+  OMP_FOR()
+  for (int ii = 0; ii < nlisted; ++ii) {
+    advance_node(node_list[(ii)], dt, velocity_x0, velocity_y0, velocity_z0,
+                 nodes_x0, nodes_y0, nodes_z0, nodes_x1, nodes_y1, nodes_z1);
+  }
+  OMP_BARRIER();
+}
+
+// Rotates the node buffers, so that the nodes written into the other buffer
+// become the current mesh without being copied
+void rotate_nodes(UnstructuredMesh* umesh) {
+  OMP_SINGLE()
+  {
+    swap_buffers(&umesh->nodes_x0, &umesh->nodes_x1);
+    swap_buffers(&umesh->nodes_y0, &umesh->nodes_y1);
+    swap_buffers(&umesh->nodes_z0, &umesh->nodes_z1);
+  }
+}
+
+// Swaps the storage of the two time levels of a quantity
+void swap_buffers(double** buf0, double** buf1) {
+  double* tmp = *buf0;
+  *buf0 = *buf1;
+  *buf1 = tmp;
 }
 
 // Calculate the new energy base on subcell forces
@@ -684,23 +1993,65 @@ void calc_predicted_energy(const int ncells, const double dt,
                            const double* subcell_force_z, const double* energy0,
                            const double* cell_mass, double* energy1) {
 
-#pragma omp parallel for
+  OMP_FOR()
   for (int cc = 0; cc < ncells; ++cc) {
     const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
-    const int nnodes_by_cell =
-        cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
-
-    double cell_force = 0.0;
-    for (int nn = 0; nn < nnodes_by_cell; ++nn) {
-      const int node_index = cells_to_nodes[(cell_to_nodes_off + nn)];
-      const int subcell_index = cell_to_nodes_off + nn;
-      cell_force +=
-          (velocity_x1[(node_index)] * subcell_force_x[(subcell_index)] +
-           velocity_y1[(node_index)] * subcell_force_y[(subcell_index)] +
-           velocity_z1[(node_index)] * subcell_force_z[(subcell_index)]);
-    }
+    const double cell_force = calc_cell_work(
+        cc, cells_to_nodes_offsets, cells_to_nodes, velocity_x1, velocity_y1,
+        velocity_z1, &subcell_force_x[(cell_to_nodes_off)],
+        &subcell_force_y[(cell_to_nodes_off)],
+        &subcell_force_z[(cell_to_nodes_off)]);
     energy1[(cc)] = energy0[(cc)] - dt * cell_force / cell_mass[(cc)];
   }
+  OMP_BARRIER();
+}
+
+// Calculate the new energy of the listed cells base on subcell forces
+void calc_predicted_energy_active(
+    const int nlisted, const int* cell_list, const double dt,
+    const int* cells_to_nodes_offsets, const int* cells_to_nodes,
+    const double* velocity_x1, const double* velocity_y1,
+    const double* velocity_z1, const double* subcell_force_x,
+    const double* subcell_force_y, const double* subcell_force_z,
+    const double* energy0, const double* cell_mass, double* energy1) {
+
+  OMP_FOR()
+  for (int ii = 0; ii < nlisted; ++ii) {
+    const int cc = cell_list[(ii)];
+    const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
+    const double cell_force = calc_cell_work(
+        cc, cells_to_nodes_offsets, cells_to_nodes, velocity_x1, velocity_y1,
+        velocity_z1, &subcell_force_x[(cell_to_nodes_off)],
+        &subcell_force_y[(cell_to_nodes_off)],
+        &subcell_force_z[(cell_to_nodes_off)]);
+    energy1[(cc)] = energy0[(cc)] - dt * cell_force / cell_mass[(cc)];
+  }
+  OMP_BARRIER();
+}
+
+// Calculates the rate of work done on a cell by its subcell forces, where the
+// forces are indexed from the first subcell of the cell
+static inline double calc_cell_work(const int cc,
+                                    const int* cells_to_nodes_offsets,
+                                    const int* cells_to_nodes,
+                                    const double* velocity_x,
+                                    const double* velocity_y,
+                                    const double* velocity_z,
+                                    const double* subcell_force_x,
+                                    const double* subcell_force_y,
+                                    const double* subcell_force_z) {
+  const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
+  const int nnodes_by_cell =
+      cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
+
+  double cell_force = 0.0;
+  for (int nn = 0; nn < nnodes_by_cell; ++nn) {
+    const int node_index = cells_to_nodes[(cell_to_nodes_off + nn)];
+    cell_force += (velocity_x[(node_index)] * subcell_force_x[(nn)] +
+                   velocity_y[(node_index)] * subcell_force_y[(nn)] +
+                   velocity_z[(node_index)] * subcell_force_z[(nn)]);
+  }
+  return cell_force;
 }
 
 // Calculates the energy from the correct subcell pressures and velocity
@@ -713,24 +2064,17 @@ void calc_corrected_energy(const int ncells, const double dt,
                            const double* subcell_force_z,
                            const double* cell_mass, double* energy0) {
 
-#pragma omp parallel for
+  OMP_FOR()
   for (int cc = 0; cc < ncells; ++cc) {
     const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
-    const int nnodes_by_cell =
-        cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
-
-    double cell_force = 0.0;
-    for (int nn = 0; nn < nnodes_by_cell; ++nn) {
-      const int node_index = cells_to_nodes[(cell_to_nodes_off + nn)];
-      const int subcell_index = cell_to_nodes_off + nn;
-      cell_force +=
-          (velocity_x0[(node_index)] * subcell_force_x[(subcell_index)] +
-           velocity_y0[(node_index)] * subcell_force_y[(subcell_index)] +
-           velocity_z0[(node_index)] * subcell_force_z[(subcell_index)]);
-    }
-
+    const double cell_force = calc_cell_work(
+        cc, cells_to_nodes_offsets, cells_to_nodes, velocity_x0, velocity_y0,
+        velocity_z0, &subcell_force_x[(cell_to_nodes_off)],
+        &subcell_force_y[(cell_to_nodes_off)],
+        &subcell_force_z[(cell_to_nodes_off)]);
     energy0[(cc)] -= dt * cell_force / cell_mass[(cc)];
   }
+  OMP_BARRIER();
 }
 
 // Calculates the density from the corrected volume
@@ -742,20 +2086,221 @@ void calc_corrected_density(
     const double* cell_centroids_y, const double* cell_centroids_z,
     const double* cell_mass, double* cell_volume, double* density) {
 
-#pragma omp parallel for
+  OMP_FOR()
   for (int cc = 0; cc < ncells; ++cc) {
-    const int cell_to_faces_off = cells_to_faces_offsets[(cc)];
-    const int nfaces_by_cell =
-        cells_to_faces_offsets[(cc + 1)] - cell_to_faces_off;
+    cell_volume[(cc)] = calc_cell_volume_by_faces(
+        cc, cells_to_faces_offsets, cells_to_faces, faces_to_nodes_offsets,
+        faces_to_nodes, nodes_x, nodes_y, nodes_z, cell_centroids_x,
+        cell_centroids_y, cell_centroids_z);
+
+    // Update the density using the new volume
+    density[(cc)] = cell_mass[(cc)] / cell_volume[(cc)];
+  }
+  OMP_BARRIER();
+}
+
+// Completes the corrector in a single sweep over the cells of the advanced
+// mesh, determining the centroid, volume and density of each cell, the rate of
+// work done on it by the subcell forces, and the new timestep
+void calc_corrected_cells(
+    const int ncells, const int* cells_to_nodes_offsets,
+    const int* cells_to_nodes, const int* cells_to_faces_offsets,
+    const int* cells_to_faces, const int* faces_to_nodes_offsets,
+    const int* faces_to_nodes, const double* nodes_x, const double* nodes_y,
+    const double* nodes_z, const double* velocity_x0,
+    const double* velocity_y0, const double* velocity_z0,
+    const double* subcell_force_x, const double* subcell_force_y,
+    const double* subcell_force_z, const double* soundspeed,
+    const double* cell_mass, double* cell_centroids_x, double* cell_centroids_y,
+    double* cell_centroids_z, double* cell_volume, double* density,
+    double* cell_work, double* dt) {
+
+  double local_dt = DBL_MAX;
+  START_PROFILING(&compute_profile);
+  OMP_FOR_REDUCTION(reduction(min : local_dt))
+  for (int cc = 0; cc < ncells; ++cc) {
+    const double cell_dt = calc_corrected_cell(
+        cc, cells_to_nodes_offsets, cells_to_nodes, cells_to_faces_offsets,
+        cells_to_faces, faces_to_nodes_offsets, faces_to_nodes, nodes_x,
+        nodes_y, nodes_z, velocity_x0, velocity_y0, velocity_z0,
+        subcell_force_x, subcell_force_y, subcell_force_z, soundspeed,
+        cell_mass, cell_centroids_x, cell_centroids_y, cell_centroids_z,
+        cell_volume, density, cell_work);
+    local_dt = min(local_dt, cell_dt);
+  }
+  TEAM_MIN(&local_dt);
+  STOP_PROFILING(&compute_profile, __func__);
+
+  OMP_SINGLE()
+  {
+    *dt = CFL * local_dt;
+
+    printf("Timestep %.8fs\n", *dt);
+  }
+}
+
+// Completes the corrector over the listed cells, where the cells that are not
+// listed allow the given timestep
+void calc_corrected_cells_active(
+    const int nlisted, const int* cell_list, const double unlisted_dt,
+    const int* cells_to_nodes_offsets, const int* cells_to_nodes,
+    const int* cells_to_faces_offsets, const int* cells_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const double* nodes_x, const double* nodes_y, const double* nodes_z,
+    const double* velocity_x0, const double* velocity_y0,
+    const double* velocity_z0, const double* subcell_force_x,
+    const double* subcell_force_y, const double* subcell_force_z,
+    const double* soundspeed, const double* cell_mass, double* cell_centroids_x,
+    double* cell_centroids_y, double* cell_centroids_z, double* cell_volume,
+    double* density, double* cell_work, double* dt) {
+
+  double local_dt = unlisted_dt;
+  START_PROFILING(&compute_profile);
+  OMP_FOR_REDUCTION(reduction(min : local_dt))
+  for (int ii = 0; ii < nlisted; ++ii) {
+    const double cell_dt = calc_corrected_cell(
+        cell_list[(ii)], cells_to_nodes_offsets, cells_to_nodes,
+        cells_to_faces_offsets, cells_to_faces, faces_to_nodes_offsets,
+        faces_to_nodes, nodes_x, nodes_y, nodes_z, velocity_x0, velocity_y0,
+        velocity_z0, subcell_force_x, subcell_force_y, subcell_force_z,
+        soundspeed, cell_mass, cell_centroids_x, cell_centroids_y,
+        cell_centroids_z, cell_volume, density, cell_work);
+    local_dt = min(local_dt, cell_dt);
+  }
+  TEAM_MIN(&local_dt);
+  STOP_PROFILING(&compute_profile, "calc_corrected_cells");
+
+  OMP_SINGLE()
+  {
+    *dt = CFL * local_dt;
+
+    printf("Timestep %.8fs\n", *dt);
+  }
+}
+
+// Completes the corrector for a single cell of the advanced mesh, returning
+// the timestep that the cell allows
+static inline double calc_corrected_cell(
+    const int cc, const int* cells_to_nodes_offsets, const int* cells_to_nodes,
+    const int* cells_to_faces_offsets, const int* cells_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const double* nodes_x, const double* nodes_y, const double* nodes_z,
+    const double* velocity_x0, const double* velocity_y0,
+    const double* velocity_z0, const double* subcell_force_x,
+    const double* subcell_force_y, const double* subcell_force_z,
+    const double* soundspeed, const double* cell_mass, double* cell_centroids_x,
+    double* cell_centroids_y, double* cell_centroids_z, double* cell_volume,
+    double* density, double* cell_work) {
+  const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
+  const int nnodes_by_cell =
+      cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
+  const int cell_to_faces_off = cells_to_faces_offsets[(cc)];
+  const int nfaces_by_cell =
+      cells_to_faces_offsets[(cc + 1)] - cell_to_faces_off;
+
+  // The centroid and the work of the subcell forces gather the same nodes
+  vec_t cell_c = {0.0, 0.0, 0.0};
+  double cell_force = 0.0;
+  for (int nn = 0; nn < nnodes_by_cell; ++nn) {
+    const int node_index = cells_to_nodes[(cell_to_nodes_off + nn)];
+    const int subcell_index = cell_to_nodes_off + nn;
+    cell_c.x += nodes_x[(node_index)] / nnodes_by_cell;
+    cell_c.y += nodes_y[(node_index)] / nnodes_by_cell;
+    cell_c.z += nodes_z[(node_index)] / nnodes_by_cell;
+    cell_force +=
+        (velocity_x0[(node_index)] * subcell_force_x[(subcell_index)] +
+         velocity_y0[(node_index)] * subcell_force_y[(subcell_index)] +
+         velocity_z0[(node_index)] * subcell_force_z[(subcell_index)]);
+  }
+
+  cell_centroids_x[(cc)] = cell_c.x;
+  cell_centroids_y[(cc)] = cell_c.y;
+  cell_centroids_z[(cc)] = cell_c.z;
+
+  // The volume and the shortest edge both walk the edges of the faces
+  double cell_vol = 0.0;
+  double shortest_edge = DBL_MAX;
+  for (int ff = 0; ff < nfaces_by_cell; ++ff) {
+    const int face_index = cells_to_faces[(cell_to_faces_off + ff)];
+    const int face_to_nodes_off = faces_to_nodes_offsets[(face_index)];
+    const int nnodes_by_face =
+        faces_to_nodes_offsets[(face_index + 1)] - face_to_nodes_off;
+
+    vec_t face_c = {0.0, 0.0, 0.0};
+    calc_centroid(nnodes_by_face, nodes_x, nodes_y, nodes_z, faces_to_nodes,
+                  face_to_nodes_off, &face_c);
+
+    for (int nn2 = 0; nn2 < nnodes_by_face; ++nn2) {
+      const int node_index = faces_to_nodes[(face_to_nodes_off + nn2)];
+      const int rnode_index =
+          (nn2 + 1 < nnodes_by_face)
+              ? faces_to_nodes[(face_to_nodes_off + nn2 + 1)]
+              : faces_to_nodes[(face_to_nodes_off)];
+
+      cell_vol += 2.0 * calc_subsubcell_volume(
+                            cc, rnode_index, node_index, face_c, nodes_x,
+                            nodes_y, nodes_z, cell_centroids_x,
+                            cell_centroids_y, cell_centroids_z);
+
+      const double x_component =
+          nodes_x[(node_index)] - nodes_x[(rnode_index)];
+      const double y_component =
+          nodes_y[(node_index)] - nodes_y[(rnode_index)];
+      const double z_component =
+          nodes_z[(node_index)] - nodes_z[(rnode_index)];
+      shortest_edge = min(shortest_edge, sqrt(x_component * x_component +
+                                              y_component * y_component +
+                                              z_component * z_component));
+    }
+  }
+
+  cell_volume[(cc)] = cell_vol;
+  density[(cc)] = cell_mass[(cc)] / cell_volume[(cc)];
+  cell_work[(cc)] = cell_force;
+
+  return shortest_edge / soundspeed[(cc)];
+}
+
+// Applies the work done on each cell over the new timestep to the energy
+void apply_corrected_energy(const int ncells, const double dt,
+                            const double* cell_work, const double* cell_mass,
+                            double* energy0) {
+  OMP_FOR()
+  for (int cc = 0; cc < ncells; ++cc) {
+    energy0[(cc)] -= dt * cell_work[(cc)] / cell_mass[(cc)];
+  }
+  OMP_BARRIER();
+}
 
-    cell_volume[(cc)] = calc_cell_volume(
-        cc, nfaces_by_cell, cell_to_faces_off, cells_to_faces,
-        faces_to_nodes_offsets, faces_to_nodes, nodes_x, nodes_y, nodes_z,
-        cell_centroids_x, cell_centroids_y, cell_centroids_z);
+// Applies the work done on each listed cell over the new timestep
+void apply_corrected_energy_active(const int nlisted, const int* cell_list,
+                                   const double dt, const double* cell_work,
+                                   const double* cell_mass, double* energy0) {
+  OMP_FOR()
+  for (int ii = 0; ii < nlisted; ++ii) {
+    const int cc = cell_list[(ii)];
+    energy0[(cc)] -= dt * cell_work[(cc)] / cell_mass[(cc)];
+  }
+  OMP_BARRIER();
+}
+
+// Calculates the density from the cell-local blocks of the corrected nodes
+void calc_corrected_density_packed(
+    const int ncells, const int* cells_to_local_face_nodes,
+    const double* cell_nodes, const double* cell_centroids_x,
+    const double* cell_centroids_y, const double* cell_centroids_z,
+    const double* cell_mass, double* cell_volume, double* density) {
+
+  OMP_FOR()
+  for (int cc = 0; cc < ncells; ++cc) {
+    cell_volume[(cc)] = calc_cell_volume_packed(
+        cc, cells_to_local_face_nodes, cell_nodes, cell_centroids_x,
+        cell_centroids_y, cell_centroids_z);
 
     // Update the density using the new volume
     density[(cc)] = cell_mass[(cc)] / cell_volume[(cc)];
   }
+  OMP_BARRIER();
 }
 
 // Calculates the volume in a cell by tetrahedral decomposition
@@ -800,113 +2345,561 @@ double calc_cell_volume(const int cc, const int nfaces_by_cell,
   return cell_vol;
 }
 
+// Calculates the volume of a hex by tetrahedral decomposition, from its
+// cell-local block
+double calc_cell_volume_packed(const int cc,
+                               const int* cells_to_local_face_nodes,
+                               const double* cell_nodes,
+                               const double* cell_centroids_x,
+                               const double* cell_centroids_y,
+                               const double* cell_centroids_z) {
+
+  const int* local_face_nodes =
+      &cells_to_local_face_nodes[(cc * NFACES_BY_HEX * NNODES_BY_HEX_FACE)];
+  const double* nodes_x = &cell_nodes[(cc * HEX_BLOCK)];
+  const double* nodes_y = &nodes_x[(NNODES_BY_HEX)];
+  const double* nodes_z = &nodes_y[(NNODES_BY_HEX)];
+
+  double cell_vol = 0.0;
+  for (int ff = 0; ff < NFACES_BY_HEX; ++ff) {
+    const int face_to_nodes_off = ff * NNODES_BY_HEX_FACE;
+
+    vec_t face_c = {0.0, 0.0, 0.0};
+    calc_centroid(NNODES_BY_HEX_FACE, nodes_x, nodes_y, nodes_z,
+                  local_face_nodes, face_to_nodes_off, &face_c);
+
+    for (int nn2 = 0; nn2 < NNODES_BY_HEX_FACE; ++nn2) {
+      const int node_index = local_face_nodes[(face_to_nodes_off + nn2)];
+      const int rnode_index =
+          (nn2 + 1 < NNODES_BY_HEX_FACE)
+              ? local_face_nodes[(face_to_nodes_off + nn2 + 1)]
+              : local_face_nodes[(face_to_nodes_off)];
+
+      cell_vol += 2.0 * calc_subsubcell_volume(
+                            cc, rnode_index, node_index, face_c, nodes_x,
+                            nodes_y, nodes_z, cell_centroids_x,
+                            cell_centroids_y, cell_centroids_z);
+    }
+  }
+
+  return cell_vol;
+}
+
 // Controls the timestep for the simulation
 void set_timestep(const int ncells, const double* nodes_x,
                   const double* nodes_y, const double* nodes_z,
-                  const double* energy, double* dt, int* cells_to_faces_offsets,
-                  int* cells_to_faces, int* faces_to_nodes_offsets,
-                  int* faces_to_nodes) {
+                  const double* soundspeed, double* dt,
+                  int* cells_to_faces_offsets, int* cells_to_faces,
+                  int* faces_to_nodes_offsets, int* faces_to_nodes) {
 
   // Calculate the timestep based on the computational mesh and CFL
   // condition
   double local_dt = DBL_MAX;
   START_PROFILING(&compute_profile);
-#pragma omp parallel for reduction(min : local_dt)
+  OMP_FOR_REDUCTION(reduction(min : local_dt))
   for (int cc = 0; cc < ncells; ++cc) {
-    const int cell_to_faces_off = cells_to_faces_offsets[(cc)];
-    const int nfaces_by_cell =
-        cells_to_faces_offsets[(cc + 1)] - cell_to_faces_off;
+    const double cell_dt =
+        calc_cell_dt(cc, nodes_x, nodes_y, nodes_z, soundspeed,
+                     cells_to_faces_offsets, cells_to_faces,
+                     faces_to_nodes_offsets, faces_to_nodes);
+    local_dt = min(local_dt, cell_dt);
+  }
+  TEAM_MIN(&local_dt);
+  STOP_PROFILING(&compute_profile, __func__);
 
-    double shortest_edge = DBL_MAX;
+  OMP_SINGLE()
+  {
+    *dt = CFL * local_dt;
 
-    // Look at all of the faces attached to the cell
-    for (int ff = 0; ff < nfaces_by_cell; ++ff) {
-      const int face_index = cells_to_faces[(cell_to_faces_off + ff)];
-      const int face_to_nodes_off = faces_to_nodes_offsets[(face_index)];
-      const int nnodes_by_face =
-          faces_to_nodes_offsets[(face_index + 1)] - face_to_nodes_off;
+    printf("Timestep %.8fs\n", *dt);
+  }
+}
 
-      for (int nn = 0; nn < nnodes_by_face; ++nn) {
-        // Fetch the nodes attached to our current node on the current face
-        const int node_index = faces_to_nodes[(face_to_nodes_off + nn)];
+// Controls the timestep over the listed cells, where the cells that are not
+// listed allow the given timestep
+void set_timestep_active(const int nlisted, const int* cell_list,
+                         const double unlisted_dt, const double* nodes_x,
+                         const double* nodes_y, const double* nodes_z,
+                         const double* soundspeed, double* dt,
+                         const int* cells_to_faces_offsets,
+                         const int* cells_to_faces,
+                         const int* faces_to_nodes_offsets,
+                         const int* faces_to_nodes) {
+
+  double local_dt = unlisted_dt;
+  START_PROFILING(&compute_profile);
+  OMP_FOR_REDUCTION(reduction(min : local_dt))
+  for (int ii = 0; ii < nlisted; ++ii) {
+    const double cell_dt =
+        calc_cell_dt(cell_list[(ii)], nodes_x, nodes_y, nodes_z, soundspeed,
+                     cells_to_faces_offsets, cells_to_faces,
+                     faces_to_nodes_offsets, faces_to_nodes);
+    local_dt = min(local_dt, cell_dt);
+  }
+  TEAM_MIN(&local_dt);
+  STOP_PROFILING(&compute_profile, "set_timestep");
 
-        const int rnode_index =
-            (nn + 1 < nnodes_by_face)
-                ? faces_to_nodes[(face_to_nodes_off + nn + 1)]
-                : faces_to_nodes[(face_to_nodes_off)];
-        const double x_component =
-            nodes_x[(node_index)] - nodes_x[(rnode_index)];
-        const double y_component =
-            nodes_y[(node_index)] - nodes_y[(rnode_index)];
-        const double z_component =
-            nodes_z[(node_index)] - nodes_z[(rnode_index)];
-
-        // Find the shortest edge of this cell
-        shortest_edge = min(shortest_edge, sqrt(x_component * x_component +
-                                                y_component * y_component +
-                                                z_component * z_component));
-      }
-    }
+  OMP_SINGLE()
+  {
+    *dt = CFL * local_dt;
 
-    const double soundspeed = sqrt(GAM * (GAM - 1.0) * energy[(cc)]);
-    local_dt = min(local_dt, shortest_edge / soundspeed);
+    printf("Timestep %.8fs\n", *dt);
   }
-  STOP_PROFILING(&compute_profile, __func__);
+}
+
+// Calculates the timestep that a cell allows
+static inline double calc_cell_dt(const int cc, const double* nodes_x,
+                                  const double* nodes_y, const double* nodes_z,
+                                  const double* soundspeed,
+                                  const int* cells_to_faces_offsets,
+                                  const int* cells_to_faces,
+                                  const int* faces_to_nodes_offsets,
+                                  const int* faces_to_nodes) {
+  const double shortest_edge = calc_shortest_edge(
+      cc, nodes_x, nodes_y, nodes_z, cells_to_faces_offsets, cells_to_faces,
+      faces_to_nodes_offsets, faces_to_nodes);
+  return shortest_edge / soundspeed[(cc)];
+}
+
+// Finds the shortest edge of a cell, which limits its timestep
+double calc_shortest_edge(const int cc, const double* nodes_x,
+                          const double* nodes_y, const double* nodes_z,
+                          const int* cells_to_faces_offsets,
+                          const int* cells_to_faces,
+                          const int* faces_to_nodes_offsets,
+                          const int* faces_to_nodes) {
+  const int cell_to_faces_off = cells_to_faces_offsets[(cc)];
+  const int nfaces_by_cell =
+      cells_to_faces_offsets[(cc + 1)] - cell_to_faces_off;
+
+  double shortest_edge = DBL_MAX;
+
+  // Look at all of the faces attached to the cell
+  for (int ff = 0; ff < nfaces_by_cell; ++ff) {
+    const int face_index = cells_to_faces[(cell_to_faces_off + ff)];
+    const int face_to_nodes_off = faces_to_nodes_offsets[(face_index)];
+    const int nnodes_by_face =
+        faces_to_nodes_offsets[(face_index + 1)] - face_to_nodes_off;
+
+    for (int nn = 0; nn < nnodes_by_face; ++nn) {
+      // Fetch the nodes attached to our current node on the current face
+      const int node_index = faces_to_nodes[(face_to_nodes_off + nn)];
 
-  *dt = CFL * local_dt;
+      const int rnode_index =
+          (nn + 1 < nnodes_by_face)
+              ? faces_to_nodes[(face_to_nodes_off + nn + 1)]
+              : faces_to_nodes[(face_to_nodes_off)];
+      const double x_component =
+          nodes_x[(node_index)] - nodes_x[(rnode_index)];
+      const double y_component =
+          nodes_y[(node_index)] - nodes_y[(rnode_index)];
+      const double z_component =
+          nodes_z[(node_index)] - nodes_z[(rnode_index)];
+
+      // Find the shortest edge of this cell
+      shortest_edge = min(shortest_edge, sqrt(x_component * x_component +
+                                              y_component * y_component +
+                                              z_component * z_component));
+    }
+  }
 
-  printf("Timestep %.8fs\n", *dt);
+  return shortest_edge;
 }
 
 // Calculates the artificial viscous forces for momentum acceleration
 void calc_artificial_viscosity(
     const int ncells, const double visc_coeff1, const double visc_coeff2,
     const int* cells_to_nodes_offsets, const int* cells_to_nodes,
-    const int* faces_cclockwise_cell, const double* nodes_x,
-    const double* nodes_y, const double* nodes_z,
+    const int* faces_cclockwise_cell, const NodeState* node_state,
     const double* cell_centroids_x, const double* cell_centroids_y,
-    const double* cell_centroids_z, const double* velocity_x,
-    const double* velocity_y, const double* velocity_z,
-    const double* nodal_soundspeed, const double* nodal_mass,
-    const double* nodal_volumes, const double* limiter, double* subcell_force_x,
-    double* subcell_force_y, double* subcell_force_z,
-    int* faces_to_nodes_offsets, int* faces_to_nodes,
+    const double* cell_centroids_z, const double* nodal_soundspeed,
+    const double* limiter, double* subcell_force_x, double* subcell_force_y,
+    double* subcell_force_z, int* faces_to_nodes_offsets, int* faces_to_nodes,
     int* cells_to_faces_offsets, int* cells_to_faces) {
 
-#pragma omp parallel for
+  OMP_FOR()
   for (int cc = 0; cc < ncells; ++cc) {
-    const int cell_to_faces_off = cells_to_faces_offsets[(cc)];
-    const int nfaces_by_cell =
-        cells_to_faces_offsets[(cc + 1)] - cell_to_faces_off;
     const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
-    const int nnodes_by_cell =
-        cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
+    calc_cell_artificial_viscosity(
+        cc, visc_coeff1, visc_coeff2, cells_to_nodes_offsets, cells_to_nodes,
+        faces_cclockwise_cell, node_state, cell_centroids_x, cell_centroids_y,
+        cell_centroids_z, nodal_soundspeed, limiter,
+        &subcell_force_x[(cell_to_nodes_off)],
+        &subcell_force_y[(cell_to_nodes_off)],
+        &subcell_force_z[(cell_to_nodes_off)], faces_to_nodes_offsets,
+        faces_to_nodes, cells_to_faces_offsets, cells_to_faces);
+  }
+  OMP_BARRIER();
+}
+
+// Calculates the artificial viscous forces of the listed cells
+void calc_artificial_viscosity_active(
+    const int nlisted, const int* cell_list, const double visc_coeff1,
+    const double visc_coeff2, const int* cells_to_nodes_offsets,
+    const int* cells_to_nodes, const int* faces_cclockwise_cell,
+    const NodeState* node_state, const double* cell_centroids_x,
+    const double* cell_centroids_y, const double* cell_centroids_z,
+    const double* nodal_soundspeed, const double* limiter,
+    double* subcell_force_x, double* subcell_force_y, double* subcell_force_z,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const int* cells_to_faces_offsets, const int* cells_to_faces) {
+
+  OMP_FOR()
+  for (int ii = 0; ii < nlisted; ++ii) {
+    const int cc = cell_list[(ii)];
+    const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
+    calc_cell_artificial_viscosity(
+        cc, visc_coeff1, visc_coeff2, cells_to_nodes_offsets, cells_to_nodes,
+        faces_cclockwise_cell, node_state, cell_centroids_x, cell_centroids_y,
+        cell_centroids_z, nodal_soundspeed, limiter,
+        &subcell_force_x[(cell_to_nodes_off)],
+        &subcell_force_y[(cell_to_nodes_off)],
+        &subcell_force_z[(cell_to_nodes_off)], faces_to_nodes_offsets,
+        faces_to_nodes, cells_to_faces_offsets, cells_to_faces);
+  }
+  OMP_BARRIER();
+}
+
+// Calculates the artificial viscous forces on the subcells of a cell, where the
+// forces are indexed from the first subcell of the cell
+void calc_cell_artificial_viscosity(
+    const int cc, const double visc_coeff1, const double visc_coeff2,
+    const int* cells_to_nodes_offsets, const int* cells_to_nodes,
+    const int* faces_cclockwise_cell, const NodeState* node_state,
+    const double* cell_centroids_x, const double* cell_centroids_y,
+    const double* cell_centroids_z, const double* nodal_soundspeed,
+    const double* limiter, double* subcell_force_x, double* subcell_force_y,
+    double* subcell_force_z, const int* faces_to_nodes_offsets,
+    const int* faces_to_nodes, const int* cells_to_faces_offsets,
+    const int* cells_to_faces) {
+  const int cell_to_faces_off = cells_to_faces_offsets[(cc)];
+  const int nfaces_by_cell =
+      cells_to_faces_offsets[(cc + 1)] - cell_to_faces_off;
+  const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
+  const int nnodes_by_cell =
+      cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
 
-    // Look at all of the faces attached to the cell
-    for (int ff = 0; ff < nfaces_by_cell; ++ff) {
+  // Look at all of the faces attached to the cell
+  for (int ff = 0; ff < nfaces_by_cell; ++ff) {
+    const int face_index = cells_to_faces[(cell_to_faces_off + ff)];
+    const int face_to_nodes_off = faces_to_nodes_offsets[(face_index)];
+    const int nnodes_by_face =
+        faces_to_nodes_offsets[(face_index + 1)] - face_to_nodes_off;
+
+    vec_t face_c = {0.0, 0.0, 0.0};
+    calc_node_state_centroid(nnodes_by_face, node_state, faces_to_nodes,
+                             face_to_nodes_off, &face_c);
+
+    // Now we will sum the contributions at each of the nodes
+    for (int nn2 = 0; nn2 < nnodes_by_face; ++nn2) {
+      const int node_index = faces_to_nodes[(face_to_nodes_off + nn2)];
+      const int face_clockwise = (faces_cclockwise_cell[(face_index)] != cc);
+      const int next_node = (nn2 == nnodes_by_face - 1) ? 0 : nn2 + 1;
+      const int prev_node = (nn2 == 0) ? nnodes_by_face - 1 : nn2 - 1;
+      const int rnode_off = (face_clockwise ? prev_node : next_node);
+      const int rnode_index = faces_to_nodes[(face_to_nodes_off + rnode_off)];
+
+      // Get the halfway point on the right edge
+      vec_t half_edge = {0.5 * (NODE_STATE(node_state, NODE_X, node_index) +
+                                NODE_STATE(node_state, NODE_X, rnode_index)),
+                         0.5 * (NODE_STATE(node_state, NODE_Y, node_index) +
+                                NODE_STATE(node_state, NODE_Y, rnode_index)),
+                         0.5 * (NODE_STATE(node_state, NODE_Z, node_index) +
+                                NODE_STATE(node_state, NODE_Z, rnode_index))};
+
+      // Setup basis on plane of tetrahedron
+      vec_t a = {(cell_centroids_x[(cc)] - face_c.x),
+                 (cell_centroids_y[(cc)] - face_c.y),
+                 (cell_centroids_z[(cc)] - face_c.z)};
+      vec_t b = {(half_edge.x - face_c.x), (half_edge.y - face_c.y),
+                 (half_edge.z - face_c.z)};
+
+      vec_t S = {0.5 * (a.y * b.z - a.z * b.y), -0.5 * (a.x * b.z - a.z * b.x),
+                 0.5 * (a.x * b.y - a.y * b.x)};
+
+      // Calculate the velocity gradients
+      vec_t dvel = {NODE_STATE(node_state, NODE_VX, node_index) -
+                        NODE_STATE(node_state, NODE_VX, rnode_index),
+                    NODE_STATE(node_state, NODE_VY, node_index) -
+                        NODE_STATE(node_state, NODE_VY, rnode_index),
+                    NODE_STATE(node_state, NODE_VZ, node_index) -
+                        NODE_STATE(node_state, NODE_VZ, rnode_index)};
+
+      const double dvel_mag =
+          sqrt(dvel.x * dvel.x + dvel.y * dvel.y + dvel.z * dvel.z);
+
+      // Calculate the unit vectors of the velocity gradients
+      vec_t dvel_unit = {(dvel_mag != 0.0) ? dvel.x / dvel_mag : 0.0,
+                         (dvel_mag != 0.0) ? dvel.y / dvel_mag : 0.0,
+                         (dvel_mag != 0.0) ? dvel.z / dvel_mag : 0.0};
+
+      // Get the edge-centered density
+      double nodal_density = NODE_STATE(node_state, NODE_MASS, node_index) /
+                             NODE_STATE(node_state, NODE_VOLUME, node_index);
+      double rnodal_density = NODE_STATE(node_state, NODE_MASS, rnode_index) /
+                              NODE_STATE(node_state, NODE_VOLUME, rnode_index);
+      const double density_edge = (2.0 * nodal_density * rnodal_density) /
+                                  (nodal_density + rnodal_density);
+
+      // Calculate the artificial viscous force term for the edge
+      double expansion_term = (dvel.x * S.x + dvel.y * S.y + dvel.z * S.z);
+
+      // If the cell is compressing, calculate the edge forces and add
+      // their contributions to the node forces
+      if (expansion_term <= 0.0) {
+        // Calculate the minimum soundspeed
+        const double cs = min(nodal_soundspeed[(node_index)],
+                              nodal_soundspeed[(rnode_index)]);
+        const double t = 0.25 * (GAM + 1.0);
+        const double edge_visc_force_x =
+            density_edge *
+            (visc_coeff2 * t * fabs(dvel.x) +
+             sqrt(visc_coeff2 * visc_coeff2 * t * t * dvel.x * dvel.x +
+                  visc_coeff1 * visc_coeff1 * cs * cs)) *
+            (1.0 - limiter[(node_index)]) * expansion_term * dvel_unit.x;
+        const double edge_visc_force_y =
+            density_edge *
+            (visc_coeff2 * t * fabs(dvel.y) +
+             sqrt(visc_coeff2 * visc_coeff2 * t * t * dvel.y * dvel.y +
+                  visc_coeff1 * visc_coeff1 * cs * cs)) *
+            (1.0 - limiter[(node_index)]) * expansion_term * dvel_unit.y;
+        const double edge_visc_force_z =
+            density_edge *
+            (visc_coeff2 * t * fabs(dvel.z) +
+             sqrt(visc_coeff2 * visc_coeff2 * t * t * dvel.z * dvel.z +
+                  visc_coeff1 * visc_coeff1 * cs * cs)) *
+            (1.0 - limiter[(node_index)]) * expansion_term * dvel_unit.z;
+
+        int subcell_index;
+        int rsubcell_index;
+        for (int nn3 = 0; nn3 < nnodes_by_cell; ++nn3) {
+          if (cells_to_nodes[(cell_to_nodes_off + nn3)] == node_index) {
+            subcell_index = nn3;
+          } else if (cells_to_nodes[(cell_to_nodes_off + nn3)] == rnode_index) {
+            rsubcell_index = nn3;
+          }
+        }
+
+        // Add the contributions of the edge based artifical viscous terms
+        // to the main force terms
+        subcell_force_x[(subcell_index)] += edge_visc_force_x;
+        subcell_force_y[(subcell_index)] += edge_visc_force_y;
+        subcell_force_z[(subcell_index)] += edge_visc_force_z;
+        subcell_force_x[(rsubcell_index)] -= edge_visc_force_x;
+        subcell_force_y[(rsubcell_index)] -= edge_visc_force_y;
+        subcell_force_z[(rsubcell_index)] -= edge_visc_force_z;
+      }
+    }
+  }
+}
+
+// Calculates the forces on the subcells of each cell from its pressure
+// gradients and artificial viscosity, and accumulates them straight into the
+// nodes. The cells are swept a colour at a time, so that no two threads update
+// the same node.
+void calc_node_forces(
+    const int ncell_colours, const int* cell_colours_offsets,
+    const int* cells_by_colour, const double visc_coeff1,
+    const double visc_coeff2, const int* cells_to_faces_offsets,
+    const int* cells_to_nodes_offsets, const int* cells_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const int* cells_to_nodes, const int* faces_cclockwise_cell,
+    const NodeState* node_state, const double* cell_centroids_x,
+    const double* cell_centroids_y, const double* cell_centroids_z,
+    const double* nodal_soundspeed, const double* limiter,
+    const double* pressure, double* node_force_x, double* node_force_y,
+    double* node_force_z) {
+
+  for (int cl = 0; cl < ncell_colours; ++cl) {
+    OMP_FOR()
+    for (int ii = cell_colours_offsets[(cl)];
+         ii < cell_colours_offsets[(cl + 1)]; ++ii) {
+      const int cc = cells_by_colour[(ii)];
+      const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
+      const int nnodes_by_cell =
+          cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
+
+      double subcell_force_x[NSUBCELLS_BY_CELL];
+      double subcell_force_y[NSUBCELLS_BY_CELL];
+      double subcell_force_z[NSUBCELLS_BY_CELL];
+      calc_cell_forces(cc, visc_coeff1, visc_coeff2, cells_to_faces_offsets,
+                       cells_to_nodes_offsets, cells_to_faces,
+                       faces_to_nodes_offsets, faces_to_nodes, cells_to_nodes,
+                       faces_cclockwise_cell, node_state, cell_centroids_x,
+                       cell_centroids_y, cell_centroids_z, nodal_soundspeed,
+                       limiter, pressure, subcell_force_x, subcell_force_y,
+                       subcell_force_z);
+
+      for (int nn = 0; nn < nnodes_by_cell; ++nn) {
+        const int node_index = cells_to_nodes[(cell_to_nodes_off + nn)];
+        node_force_x[(node_index)] += subcell_force_x[(nn)];
+        node_force_y[(node_index)] += subcell_force_y[(nn)];
+        node_force_z[(node_index)] += subcell_force_z[(nn)];
+      }
+    }
+    OMP_BARRIER();
+  }
+}
+
+// Calculate the new energy from the forces on the subcells of each cell, which
+// are found again from the state that the node forces were found from
+void calc_predicted_energy_from_cell_forces(
+    const int ncells, const double dt, const double visc_coeff1,
+    const double visc_coeff2, const int* cells_to_faces_offsets,
+    const int* cells_to_nodes_offsets, const int* cells_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const int* cells_to_nodes, const int* faces_cclockwise_cell,
+    const NodeState* node_state, const double* cell_centroids_x,
+    const double* cell_centroids_y, const double* cell_centroids_z,
+    const double* nodal_soundspeed, const double* limiter,
+    const double* pressure, const double* velocity_x1,
+    const double* velocity_y1, const double* velocity_z1,
+    const double* energy0, const double* cell_mass, double* energy1) {
+
+  OMP_FOR()
+  for (int cc = 0; cc < ncells; ++cc) {
+    double subcell_force_x[NSUBCELLS_BY_CELL];
+    double subcell_force_y[NSUBCELLS_BY_CELL];
+    double subcell_force_z[NSUBCELLS_BY_CELL];
+    calc_cell_forces(cc, visc_coeff1, visc_coeff2, cells_to_faces_offsets,
+                     cells_to_nodes_offsets, cells_to_faces,
+                     faces_to_nodes_offsets, faces_to_nodes, cells_to_nodes,
+                     faces_cclockwise_cell, node_state, cell_centroids_x,
+                     cell_centroids_y, cell_centroids_z, nodal_soundspeed,
+                     limiter, pressure, subcell_force_x, subcell_force_y,
+                     subcell_force_z);
+
+    const double cell_force = calc_cell_work(
+        cc, cells_to_nodes_offsets, cells_to_nodes, velocity_x1, velocity_y1,
+        velocity_z1, subcell_force_x, subcell_force_y, subcell_force_z);
+    energy1[(cc)] = energy0[(cc)] - dt * cell_force / cell_mass[(cc)];
+  }
+  OMP_BARRIER();
+}
+
+// Calculates the rate of work done on each cell by the corrected velocity,
+// from the forces on its subcells found again from the state that the node
+// forces were found from
+void calc_corrected_work_from_cell_forces(
+    const int ncells, const double visc_coeff1, const double visc_coeff2,
+    const int* cells_to_faces_offsets, const int* cells_to_nodes_offsets,
+    const int* cells_to_faces, const int* faces_to_nodes_offsets,
+    const int* faces_to_nodes, const int* cells_to_nodes,
+    const int* faces_cclockwise_cell, const NodeState* node_state,
+    const double* cell_centroids_x, const double* cell_centroids_y,
+    const double* cell_centroids_z, const double* nodal_soundspeed,
+    const double* limiter, const double* pressure, const double* velocity_x0,
+    const double* velocity_y0, const double* velocity_z0, double* cell_work) {
+
+  OMP_FOR()
+  for (int cc = 0; cc < ncells; ++cc) {
+    double subcell_force_x[NSUBCELLS_BY_CELL];
+    double subcell_force_y[NSUBCELLS_BY_CELL];
+    double subcell_force_z[NSUBCELLS_BY_CELL];
+    calc_cell_forces(cc, visc_coeff1, visc_coeff2, cells_to_faces_offsets,
+                     cells_to_nodes_offsets, cells_to_faces,
+                     faces_to_nodes_offsets, faces_to_nodes, cells_to_nodes,
+                     faces_cclockwise_cell, node_state, cell_centroids_x,
+                     cell_centroids_y, cell_centroids_z, nodal_soundspeed,
+                     limiter, pressure, subcell_force_x, subcell_force_y,
+                     subcell_force_z);
+
+    cell_work[(cc)] = calc_cell_work(
+        cc, cells_to_nodes_offsets, cells_to_nodes, velocity_x0, velocity_y0,
+        velocity_z0, subcell_force_x, subcell_force_y, subcell_force_z);
+  }
+  OMP_BARRIER();
+}
+
+// Calculates the forces on the subcells of a cell from its pressure gradients
+// and artificial viscosity, into buffers that hold the subcells of the cell
+static inline void calc_cell_forces(
+    const int cc, const double visc_coeff1, const double visc_coeff2,
+    const int* cells_to_faces_offsets, const int* cells_to_nodes_offsets,
+    const int* cells_to_faces, const int* faces_to_nodes_offsets,
+    const int* faces_to_nodes, const int* cells_to_nodes,
+    const int* faces_cclockwise_cell, const NodeState* node_state,
+    const double* cell_centroids_x, const double* cell_centroids_y,
+    const double* cell_centroids_z, const double* nodal_soundspeed,
+    const double* limiter, const double* pressure, double* subcell_force_x,
+    double* subcell_force_y, double* subcell_force_z) {
+  const int nnodes_by_cell =
+      cells_to_nodes_offsets[(cc + 1)] - cells_to_nodes_offsets[(cc)];
+
+  for (int nn = 0; nn < nnodes_by_cell; ++nn) {
+    subcell_force_x[(nn)] = 0.0;
+    subcell_force_y[(nn)] = 0.0;
+    subcell_force_z[(nn)] = 0.0;
+  }
+
+  calc_cell_force_from_pressure(
+      cc, cells_to_faces_offsets, cells_to_nodes_offsets, cells_to_faces,
+      faces_to_nodes_offsets, faces_to_nodes, cells_to_nodes,
+      faces_cclockwise_cell, node_state, pressure, subcell_force_x,
+      subcell_force_y, subcell_force_z);
+
+  calc_cell_artificial_viscosity(
+      cc, visc_coeff1, visc_coeff2, cells_to_nodes_offsets, cells_to_nodes,
+      faces_cclockwise_cell, node_state, cell_centroids_x, cell_centroids_y,
+      cell_centroids_z, nodal_soundspeed, limiter, subcell_force_x,
+      subcell_force_y, subcell_force_z, faces_to_nodes_offsets, faces_to_nodes,
+      cells_to_faces_offsets, cells_to_faces);
+}
+
+// Calculates the artificial viscous forces for momentum acceleration, reading
+// the nodes and velocities of each hex from its cell-local blocks
+void calc_artificial_viscosity_packed(
+    const int ncells, const double visc_coeff1, const double visc_coeff2,
+    const int* cells_to_faces_offsets, const int* cells_to_nodes_offsets,
+    const int* cells_to_faces, const int* cells_to_nodes,
+    const int* faces_cclockwise_cell, const int* cells_to_local_face_nodes,
+    const double* cell_nodes, const double* cell_velocity,
+    const double* cell_centroids_x, const double* cell_centroids_y,
+    const double* cell_centroids_z, const double* nodal_soundspeed,
+    const double* nodal_mass, const double* nodal_volumes,
+    const double* limiter, double* subcell_force_x, double* subcell_force_y,
+    double* subcell_force_z) {
+
+  OMP_FOR()
+  for (int cc = 0; cc < ncells; ++cc) {
+    const int cell_to_faces_off = cells_to_faces_offsets[(cc)];
+    const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
+    const int* local_face_nodes =
+        &cells_to_local_face_nodes[(cc * NFACES_BY_HEX * NNODES_BY_HEX_FACE)];
+    const double* nodes_x = &cell_nodes[(cc * HEX_BLOCK)];
+    const double* nodes_y = &nodes_x[(NNODES_BY_HEX)];
+    const double* nodes_z = &nodes_y[(NNODES_BY_HEX)];
+    const double* velocity_x = &cell_velocity[(cc * HEX_BLOCK)];
+    const double* velocity_y = &velocity_x[(NNODES_BY_HEX)];
+    const double* velocity_z = &velocity_y[(NNODES_BY_HEX)];
+
+    for (int ff = 0; ff < NFACES_BY_HEX; ++ff) {
       const int face_index = cells_to_faces[(cell_to_faces_off + ff)];
-      const int face_to_nodes_off = faces_to_nodes_offsets[(face_index)];
-      const int nnodes_by_face =
-          faces_to_nodes_offsets[(face_index + 1)] - face_to_nodes_off;
+      const int face_to_nodes_off = ff * NNODES_BY_HEX_FACE;
 
       vec_t face_c = {0.0, 0.0, 0.0};
-      calc_centroid(nnodes_by_face, nodes_x, nodes_y, nodes_z, faces_to_nodes,
-                    face_to_nodes_off, &face_c);
+      calc_centroid(NNODES_BY_HEX_FACE, nodes_x, nodes_y, nodes_z,
+                    local_face_nodes, face_to_nodes_off, &face_c);
 
-      // Now we will sum the contributions at each of the nodes
-      for (int nn2 = 0; nn2 < nnodes_by_face; ++nn2) {
-        const int node_index = faces_to_nodes[(face_to_nodes_off + nn2)];
+      for (int nn2 = 0; nn2 < NNODES_BY_HEX_FACE; ++nn2) {
+        // The position of a node in the block is also its subcell
+        const int local_index = local_face_nodes[(face_to_nodes_off + nn2)];
         const int face_clockwise = (faces_cclockwise_cell[(face_index)] != cc);
-        const int next_node = (nn2 == nnodes_by_face - 1) ? 0 : nn2 + 1;
-        const int prev_node = (nn2 == 0) ? nnodes_by_face - 1 : nn2 - 1;
+        const int next_node = (nn2 == NNODES_BY_HEX_FACE - 1) ? 0 : nn2 + 1;
+        const int prev_node = (nn2 == 0) ? NNODES_BY_HEX_FACE - 1 : nn2 - 1;
         const int rnode_off = (face_clockwise ? prev_node : next_node);
-        const int rnode_index = faces_to_nodes[(face_to_nodes_off + rnode_off)];
+        const int rlocal_index =
+            local_face_nodes[(face_to_nodes_off + rnode_off)];
+        const int subcell_index = cell_to_nodes_off + local_index;
+        const int rsubcell_index = cell_to_nodes_off + rlocal_index;
+        const int node_index = cells_to_nodes[(subcell_index)];
+        const int rnode_index = cells_to_nodes[(rsubcell_index)];
 
         // Get the halfway point on the right edge
         vec_t half_edge = {
-            0.5 * (nodes_x[(node_index)] + nodes_x[(rnode_index)]),
-            0.5 * (nodes_y[(node_index)] + nodes_y[(rnode_index)]),
-            0.5 * (nodes_z[(node_index)] + nodes_z[(rnode_index)])};
+            0.5 * (nodes_x[(local_index)] + nodes_x[(rlocal_index)]),
+            0.5 * (nodes_y[(local_index)] + nodes_y[(rlocal_index)]),
+            0.5 * (nodes_z[(local_index)] + nodes_z[(rlocal_index)])};
 
         // Setup basis on plane of tetrahedron
         vec_t a = {(cell_centroids_x[(cc)] - face_c.x),
@@ -920,9 +2913,9 @@ void calc_artificial_viscosity(
                    0.5 * (a.x * b.y - a.y * b.x)};
 
         // Calculate the velocity gradients
-        vec_t dvel = {velocity_x[(node_index)] - velocity_x[(rnode_index)],
-                      velocity_y[(node_index)] - velocity_y[(rnode_index)],
-                      velocity_z[(node_index)] - velocity_z[(rnode_index)]};
+        vec_t dvel = {velocity_x[(local_index)] - velocity_x[(rlocal_index)],
+                      velocity_y[(local_index)] - velocity_y[(rlocal_index)],
+                      velocity_z[(local_index)] - velocity_z[(rlocal_index)]};
 
         const double dvel_mag =
             sqrt(dvel.x * dvel.x + dvel.y * dvel.y + dvel.z * dvel.z);
@@ -969,17 +2962,6 @@ void calc_artificial_viscosity(
                     visc_coeff1 * visc_coeff1 * cs * cs)) *
               (1.0 - limiter[(node_index)]) * expansion_term * dvel_unit.z;
 
-          int subcell_index;
-          int rsubcell_index;
-          for (int nn3 = 0; nn3 < nnodes_by_cell; ++nn3) {
-            if (cells_to_nodes[(cell_to_nodes_off + nn3)] == node_index) {
-              subcell_index = cell_to_nodes_off + nn3;
-            } else if (cells_to_nodes[(cell_to_nodes_off + nn3)] ==
-                       rnode_index) {
-              rsubcell_index = cell_to_nodes_off + nn3;
-            }
-          }
-
           // Add the contributions of the edge based artifical viscous terms
           // to the main force terms
           subcell_force_x[(subcell_index)] += edge_visc_force_x;
@@ -992,4 +2974,5 @@ void calc_artificial_viscosity(
       }
     }
   }
+  OMP_BARRIER();
 }
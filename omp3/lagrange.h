@@ -6,9 +6,10 @@ void predictor(Mesh* mesh, UnstructuredMesh* umesh, HaleData* hale_data);
 // Performs the corrector step of the Lagrangian phase
 void corrector(Mesh* mesh, UnstructuredMesh* umesh, HaleData* hale_data);
 
-// A simple ideal gas equation of state
-void equation_of_state(const int ncells, const double* energy,
-                       const double* density, double* pressure);
+// A simple ideal gas, giving the pressure and soundspeed of a cell, which is
+// all that the scheme asks of a material model
+void calc_eos(const double energy, const double density, double* pressure,
+              double* soundspeed);
 
 // Calculates the nodal volume and sound speed
 void calc_nodal_vol_and_c(const int nnodes, const int* nodes_to_faces_offsets,
@@ -19,8 +20,9 @@ void calc_nodal_vol_and_c(const int nnodes, const int* nodes_to_faces_offsets,
                           const double* nodes_y, const double* nodes_z,
                           const double* cell_centroids_x,
                           const double* cell_centroids_y,
-                          const double* cell_centroids_z, const double* energy,
-                          double* nodal_volumes, double* nodal_soundspeed);
+                          const double* cell_centroids_z,
+                          const double* soundspeed, double* nodal_volumes,
+                          double* nodal_soundspeed);
 
 // Sets all of the subcell forces to 0
 void zero_subcell_forces(const int ncells, const int* cells_offsets,
@@ -32,10 +34,30 @@ void calc_subcell_force_from_pressure(
     const int* cells_offsets, const int* cells_to_faces,
     const int* faces_to_nodes_offsets, const int* faces_to_nodes,
     const int* cells_to_nodes, const int* face_cclockwise_cell,
-    const double* nodes_x, const double* nodes_y, const double* nodes_z,
-    const double* pressure, double* subcell_force_x, double* subcell_force_y,
+    const NodeState* node_state, const double* pressure,
+    double* subcell_force_x, double* subcell_force_y,
+    double* subcell_force_z);
+
+// Calculate the force on the subcells of a cell from its pressure gradients,
+// where the forces are indexed from the first subcell of the cell
+void calc_cell_force_from_pressure(
+    const int cc, const int* cells_to_faces_offsets,
+    const int* cells_to_nodes_offsets, const int* cells_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const int* cells_to_nodes, const int* faces_cclockwise_cell,
+    const NodeState* node_state, const double* pressure,
+    double* subcell_force_x, double* subcell_force_y,
     double* subcell_force_z);
 
+// Calculate the subcell force from pressure gradients, reading the nodes of
+// each hex from its cell-local block
+void calc_subcell_force_from_pressure_packed(
+    const int ncells, const int* cells_to_faces_offsets,
+    const int* cells_to_nodes_offsets, const int* cells_to_faces,
+    const int* faces_cclockwise_cell, const int* cells_to_local_face_nodes,
+    const double* cell_nodes, const double* pressure, double* subcell_force_x,
+    double* subcell_force_y, double* subcell_force_z);
+
 // Scale the soundspeed by the inverse of the nodal volume
 void scale_soundspeed(const int nnodes, const double* nodal_volumes,
                       double* nodal_soundspeed);
@@ -52,6 +74,25 @@ void calc_new_velocity(const int nnodes, const double dt,
                        const double* velocity_z0, double* velocity_x1,
                        double* velocity_y1, double* velocity_z1);
 
+// Calculate the time centered evolved velocities, vectorised across the nodes
+// of each slice of the SELL-C-sigma node to subcell adjacency
+void calc_new_velocity_sell(
+    const double dt, const SellAdjacency* nodes_to_cells_sell,
+    const int* nodes_to_subcells_sell, const double* subcell_force_x,
+    const double* subcell_force_y, const double* subcell_force_z,
+    const double* nodal_mass, const double* velocity_x0,
+    const double* velocity_y0, const double* velocity_z0, double* velocity_x1,
+    double* velocity_y1, double* velocity_z1);
+
+// Calculate the time centered evolved velocities from the forces accumulated
+// at the nodes, clearing the forces for the next accumulation
+void calc_new_velocity_from_node_force(
+    const int nnodes, const double dt, const double* nodal_mass,
+    const double* velocity_x0, const double* velocity_y0,
+    const double* velocity_z0, double* node_force_x, double* node_force_y,
+    double* node_force_z, double* velocity_x1, double* velocity_y1,
+    double* velocity_z1);
+
 // Moves the nodes to the next time level
 void move_nodes(const int nnodes, const double dt, const double* nodes_x0,
                 const double* nodes_y0, const double* nodes_z0,
@@ -70,9 +111,15 @@ void calc_predicted_density(const int ncells, const int* cells_to_faces_offsets,
                             const double* cell_centroids_z,
                             const double* cell_mass, double* density1);
 
-// Time centers the pressure
-void time_center_pressure(const int ncells, const double* energy1,
-                          const double* density1, const double* pressure0,
+// Calculates a new density from the cell-local blocks of the predicted nodes
+void calc_predicted_density_packed(
+    const int ncells, const int* cells_to_local_face_nodes,
+    const double* cell_nodes, const double* cell_centroids_x,
+    const double* cell_centroids_y, const double* cell_centroids_z,
+    const double* cell_mass, double* density1);
+
+// Time centers the pressure between the rezoned and predicted pressures
+void time_center_pressure(const int ncells, const double* pressure0,
                           double* pressure1);
 
 // Time centers the nodal positions
@@ -90,12 +137,33 @@ void update_and_time_center_velocity(
     double* velocity_z0, double* velocity_x1, double* velocity_y1,
     double* velocity_z1);
 
+// Updates and time center velocity in the corrector step, vectorised across
+// the nodes of each slice of the SELL-C-sigma node to subcell adjacency
+void update_and_time_center_velocity_sell(
+    const double dt, const SellAdjacency* nodes_to_cells_sell,
+    const int* nodes_to_subcells_sell, const double* nodal_mass,
+    const double* subcell_force_x, const double* subcell_force_y,
+    const double* subcell_force_z, double* velocity_x0, double* velocity_y0,
+    double* velocity_z0, double* velocity_x1, double* velocity_y1,
+    double* velocity_z1);
+
+// Updates and time center velocity in the corrector step from the forces
+// accumulated at the nodes, clearing the forces for the next accumulation
+void update_and_time_center_velocity_from_node_force(
+    const int nnodes, const double dt, const double* nodal_mass,
+    double* node_force_x, double* node_force_y, double* node_force_z,
+    double* velocity_x0, double* velocity_y0, double* velocity_z0,
+    const double* velocity_x1, const double* velocity_y1,
+    const double* velocity_z1);
+
 // Advances the nodes using the corrected velocity
 void advance_nodes_corrected(const int nnodes, const double dt,
                              const double* velocity_x0,
                              const double* velocity_y0,
-                             const double* velocity_z0, double* nodes_x0,
-                             double* nodes_y0, double* nodes_z0);
+                             const double* velocity_z0, const double* nodes_x0,
+                             const double* nodes_y0, const double* nodes_z0,
+                             double* nodes_x1, double* nodes_y1,
+                             double* nodes_z1);
 
 // Calculate the new energy base on subcell forces
 void calc_predicted_energy(const int ncells, const double dt,
@@ -126,21 +194,118 @@ void calc_corrected_density(
     const double* cell_centroids_y, const double* cell_centroids_z,
     const double* cell_mass, double* cell_volume, double* density);
 
+// Completes the corrector in a single sweep over the cells of the advanced
+// mesh, determining the centroid, volume and density of each cell, the rate of
+// work done on it by the subcell forces, and the new timestep
+void calc_corrected_cells(
+    const int ncells, const int* cells_to_nodes_offsets,
+    const int* cells_to_nodes, const int* cells_to_faces_offsets,
+    const int* cells_to_faces, const int* faces_to_nodes_offsets,
+    const int* faces_to_nodes, const double* nodes_x, const double* nodes_y,
+    const double* nodes_z, const double* velocity_x0,
+    const double* velocity_y0, const double* velocity_z0,
+    const double* subcell_force_x, const double* subcell_force_y,
+    const double* subcell_force_z, const double* soundspeed,
+    const double* cell_mass, double* cell_centroids_x, double* cell_centroids_y,
+    double* cell_centroids_z, double* cell_volume, double* density,
+    double* cell_work, double* dt);
+
+// Applies the work done on each cell over the new timestep to the energy
+void apply_corrected_energy(const int ncells, const double dt,
+                            const double* cell_work, const double* cell_mass,
+                            double* energy0);
+
+// Calculates the density from the cell-local blocks of the corrected nodes
+void calc_corrected_density_packed(
+    const int ncells, const int* cells_to_local_face_nodes,
+    const double* cell_nodes, const double* cell_centroids_x,
+    const double* cell_centroids_y, const double* cell_centroids_z,
+    const double* cell_mass, double* cell_volume, double* density);
+
 // Calculates the artificial viscous forces for momentum acceleration
 void calc_artificial_viscosity(
     const int ncells, const double visc_coeff1, const double visc_coeff2,
     const int* cells_offsets, const int* cells_to_nodes,
-    const int* face_cclockwise_cell, const double* nodes_x,
-    const double* nodes_y, const double* nodes_z,
+    const int* face_cclockwise_cell, const NodeState* node_state,
     const double* cell_centroids_x, const double* cell_centroids_y,
-    const double* cell_centroids_z, const double* velocity_x,
-    const double* velocity_y, const double* velocity_z,
-    const double* nodal_soundspeed, const double* nodal_mass,
-    const double* nodal_volumes, const double* limiter, double* subcell_force_x,
-    double* subcell_force_y, double* subcell_force_z,
-    int* faces_to_nodes_offsets, int* faces_to_nodes,
+    const double* cell_centroids_z, const double* nodal_soundspeed,
+    const double* limiter, double* subcell_force_x, double* subcell_force_y,
+    double* subcell_force_z, int* faces_to_nodes_offsets, int* faces_to_nodes,
     int* cells_to_faces_offsets, int* cells_to_faces);
 
+// Calculates the artificial viscous forces on the subcells of a cell, where the
+// forces are indexed from the first subcell of the cell
+void calc_cell_artificial_viscosity(
+    const int cc, const double visc_coeff1, const double visc_coeff2,
+    const int* cells_to_nodes_offsets, const int* cells_to_nodes,
+    const int* faces_cclockwise_cell, const NodeState* node_state,
+    const double* cell_centroids_x, const double* cell_centroids_y,
+    const double* cell_centroids_z, const double* nodal_soundspeed,
+    const double* limiter, double* subcell_force_x, double* subcell_force_y,
+    double* subcell_force_z, const int* faces_to_nodes_offsets,
+    const int* faces_to_nodes, const int* cells_to_faces_offsets,
+    const int* cells_to_faces);
+
+// Calculates the forces on the subcells of each cell from its pressure
+// gradients and artificial viscosity, and accumulates them straight into the
+// nodes. The cells are swept a colour at a time, so that no two threads update
+// the same node.
+void calc_node_forces(
+    const int ncell_colours, const int* cell_colours_offsets,
+    const int* cells_by_colour, const double visc_coeff1,
+    const double visc_coeff2, const int* cells_to_faces_offsets,
+    const int* cells_to_nodes_offsets, const int* cells_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const int* cells_to_nodes, const int* faces_cclockwise_cell,
+    const NodeState* node_state, const double* cell_centroids_x,
+    const double* cell_centroids_y, const double* cell_centroids_z,
+    const double* nodal_soundspeed, const double* limiter,
+    const double* pressure, double* node_force_x, double* node_force_y,
+    double* node_force_z);
+
+// Calculate the new energy from the forces on the subcells of each cell, which
+// are found again from the state that the node forces were found from
+void calc_predicted_energy_from_cell_forces(
+    const int ncells, const double dt, const double visc_coeff1,
+    const double visc_coeff2, const int* cells_to_faces_offsets,
+    const int* cells_to_nodes_offsets, const int* cells_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const int* cells_to_nodes, const int* faces_cclockwise_cell,
+    const NodeState* node_state, const double* cell_centroids_x,
+    const double* cell_centroids_y, const double* cell_centroids_z,
+    const double* nodal_soundspeed, const double* limiter,
+    const double* pressure, const double* velocity_x1,
+    const double* velocity_y1, const double* velocity_z1,
+    const double* energy0, const double* cell_mass, double* energy1);
+
+// Calculates the rate of work done on each cell by the corrected velocity,
+// from the forces on its subcells found again from the state that the node
+// forces were found from
+void calc_corrected_work_from_cell_forces(
+    const int ncells, const double visc_coeff1, const double visc_coeff2,
+    const int* cells_to_faces_offsets, const int* cells_to_nodes_offsets,
+    const int* cells_to_faces, const int* faces_to_nodes_offsets,
+    const int* faces_to_nodes, const int* cells_to_nodes,
+    const int* faces_cclockwise_cell, const NodeState* node_state,
+    const double* cell_centroids_x, const double* cell_centroids_y,
+    const double* cell_centroids_z, const double* nodal_soundspeed,
+    const double* limiter, const double* pressure, const double* velocity_x0,
+    const double* velocity_y0, const double* velocity_z0, double* cell_work);
+
+// Calculates the artificial viscous forces for momentum acceleration, reading
+// the nodes and velocities of each hex from its cell-local blocks
+void calc_artificial_viscosity_packed(
+    const int ncells, const double visc_coeff1, const double visc_coeff2,
+    const int* cells_to_faces_offsets, const int* cells_to_nodes_offsets,
+    const int* cells_to_faces, const int* cells_to_nodes,
+    const int* faces_cclockwise_cell, const int* cells_to_local_face_nodes,
+    const double* cell_nodes, const double* cell_velocity,
+    const double* cell_centroids_x, const double* cell_centroids_y,
+    const double* cell_centroids_z, const double* nodal_soundspeed,
+    const double* nodal_mass, const double* nodal_volumes,
+    const double* limiter, double* subcell_force_x, double* subcell_force_y,
+    double* subcell_force_z);
+
 // Calculates the volume in a cell by tetrahedral decomposition
 double calc_cell_volume(const int cc, const int nfaces_by_cell,
                         const int cell_to_faces_off, const int* cells_to_faces,
@@ -151,6 +316,23 @@ double calc_cell_volume(const int cc, const int nfaces_by_cell,
                         const double* cell_centroids_y,
                         const double* cell_centroids_z);
 
+// Calculates the volume of a hex by tetrahedral decomposition, from its
+// cell-local block
+double calc_cell_volume_packed(const int cc,
+                               const int* cells_to_local_face_nodes,
+                               const double* cell_nodes,
+                               const double* cell_centroids_x,
+                               const double* cell_centroids_y,
+                               const double* cell_centroids_z);
+
+// Finds the shortest edge of a cell, which limits its timestep
+double calc_shortest_edge(const int cc, const double* nodes_x,
+                          const double* nodes_y, const double* nodes_z,
+                          const int* cells_to_faces_offsets,
+                          const int* cells_to_faces,
+                          const int* faces_to_nodes_offsets,
+                          const int* faces_to_nodes);
+
 // Calculates the volume of a subsubcell
 double calc_subsubcell_volume(const int cc, const int next_node,
                               const int current_node, vec_t face_c,
@@ -159,3 +341,222 @@ double calc_subsubcell_volume(const int cc, const int next_node,
                               const double* cell_centroids_x,
                               const double* cell_centroids_y,
                               const double* cell_centroids_z);
+
+// Calculates the centroid of a set of nodes from the node state
+void calc_node_state_centroid(const int nnodes, const NodeState* node_state,
+                              const int* indirection, const int offset,
+                              vec_t* centroid);
+
+// Performs the predictor step of the Lagrangian phase over the cells within
+// reach of the activity front
+void quiescent_predictor(Mesh* mesh, UnstructuredMesh* umesh,
+                         HaleData* hale_data);
+
+// Performs the corrector step of the Lagrangian phase over the cells within
+// reach of the activity front
+void quiescent_corrector(Mesh* mesh, UnstructuredMesh* umesh,
+                         HaleData* hale_data);
+
+// Finds the cells within two rings of the activity front, and the nodes that
+// they gather and move. The nodes of the quiescent region are held in place
+// by making both time levels their current position and velocity, and the
+// predicted state of the quiescent cells their current state.
+void build_activity_front(UnstructuredMesh* umesh, HaleData* hale_data);
+
+// Marks the cells that are moving, or that have a jump in pressure across one
+// of their faces, beyond the roundoff of the quiescent state
+void seed_activity_front(const int ncells, const int* cells_to_nodes_offsets,
+                         const int* cells_to_nodes,
+                         const int* cells_to_faces_offsets,
+                         const int* cells_to_faces, const int* faces_to_cells0,
+                         const int* faces_to_cells1, const double* velocity_x,
+                         const double* velocity_y, const double* velocity_z,
+                         const double* pressure, const double* soundspeed,
+                         int* cell_front);
+
+// Marks the nodes of the marked cells
+void mark_front_nodes(const int nnodes, const int* nodes_to_cells_offsets,
+                      const int* nodes_to_cells, const int* cell_front,
+                      int* node_front);
+
+// Marks the cells of the marked nodes
+void mark_front_cells(const int ncells, const int* cells_to_nodes_offsets,
+                      const int* cells_to_nodes, const int* node_front,
+                      int* cell_front);
+
+// Makes the predicted state of each quiescent cell its current state, and
+// finds the timestep that the quiescent cells allow. The nodes of a quiescent
+// cell don't move, so its shortest edge and volume are only found when it
+// falls quiet, where the corrector would otherwise have found its volume.
+void settle_quiescent_cells(
+    const int ncells, const int* cell_front, const double* nodes_x,
+    const double* nodes_y, const double* nodes_z,
+    const int* cells_to_faces_offsets, const int* cells_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const double* cell_centroids_x, const double* cell_centroids_y,
+    const double* cell_centroids_z, const double* energy0,
+    const double* density0, const double* pressure0, const double* soundspeed0,
+    int* cell_quiescent, double* quiescent_edge, double* cell_volume,
+    double* energy1, double* density1, double* pressure1, double* soundspeed1,
+    double* quiescent_dt);
+
+// Classifies the nodes by the activity of their cells, holding the nodes that
+// don't move at their current position and velocity in both time levels
+void settle_quiescent_nodes(
+    const int nnodes, const int* nodes_to_cells_offsets,
+    const int* nodes_to_cells, const int* cell_front, const double* nodes_x0,
+    const double* nodes_y0, const double* nodes_z0, const double* velocity_x0,
+    const double* velocity_y0, const double* velocity_z0, int* node_front,
+    double* nodes_x1, double* nodes_y1, double* nodes_z1, double* velocity_x1,
+    double* velocity_y1, double* velocity_z1);
+
+// Lists the indices whose flags reach a class, in order
+void compact_flagged(const int n, const int* flags, const int min_flag,
+                     int* block_offsets, int* list, int* nlisted);
+
+// Calculates the nodal volume and sound speed of the listed nodes
+void calc_nodal_vol_and_c_active(
+    const int nlisted, const int* node_list, const int* nodes_to_faces_offsets,
+    const int* nodes_to_faces, const int* faces_to_nodes_offsets,
+    const int* faces_to_nodes, const int* faces_to_cells0,
+    const int* faces_to_cells1, const double* nodes_x, const double* nodes_y,
+    const double* nodes_z, const double* cell_centroids_x,
+    const double* cell_centroids_y, const double* cell_centroids_z,
+    const double* soundspeed, double* nodal_volumes,
+    double* nodal_soundspeed);
+
+// Scale the soundspeed of the listed nodes by the inverse of the nodal volume
+void scale_soundspeed_active(const int nlisted, const int* node_list,
+                             const double* nodal_volumes,
+                             double* nodal_soundspeed);
+
+// Calculate the time centered evolved velocities of the listed nodes
+void calc_new_velocity_active(
+    const int nlisted, const int* node_list, const double dt,
+    const int* nodes_to_cells_offsets, const int* nodes_to_cells,
+    const int* cells_to_nodes_offsets, const int* cells_to_nodes,
+    const double* subcell_force_x, const double* subcell_force_y,
+    const double* subcell_force_z, const double* nodal_mass,
+    const double* velocity_x0, const double* velocity_y0,
+    const double* velocity_z0, double* velocity_x1, double* velocity_y1,
+    double* velocity_z1);
+
+// Updates and time center velocity of the listed nodes in the corrector step
+void update_and_time_center_velocity_active(
+    const int nlisted, const int* node_list, const double dt,
+    const int* nodes_to_cells_offsets, const int* nodes_to_cells,
+    const int* cells_to_nodes_offsets, const int* cells_to_nodes,
+    const double* nodal_mass, const double* subcell_force_x,
+    const double* subcell_force_y, const double* subcell_force_z,
+    double* velocity_x0, double* velocity_y0, double* velocity_z0,
+    double* velocity_x1, double* velocity_y1, double* velocity_z1);
+
+// Moves the listed nodes to the next time level
+void move_nodes_active(const int nlisted, const int* node_list,
+                       const double dt, const double* nodes_x0,
+                       const double* nodes_y0, const double* nodes_z0,
+                       const double* velocity_x1, const double* velocity_y1,
+                       const double* velocity_z1, double* nodes_x1,
+                       double* nodes_y1, double* nodes_z1);
+
+// Time centers the positions of the listed nodes
+void time_center_nodes_active(const int nlisted, const int* node_list,
+                              const double* nodes_x0, const double* nodes_y0,
+                              const double* nodes_z0, double* nodes_x1,
+                              double* nodes_y1, double* nodes_z1);
+
+// Advances the listed nodes using the corrected velocity
+void advance_nodes_corrected_active(
+    const int nlisted, const int* node_list, const double dt,
+    const double* velocity_x0, const double* velocity_y0,
+    const double* velocity_z0, const double* nodes_x0, const double* nodes_y0,
+    const double* nodes_z0, double* nodes_x1, double* nodes_y1,
+    double* nodes_z1);
+
+// Evaluates the pressure and soundspeed of the listed cells
+void equation_of_state_active(const int nlisted, const int* cell_list,
+                              const EosTable* eos_table, const double* energy,
+                              const double* density, double* pressure,
+                              double* soundspeed);
+
+// Sets the subcell forces of the listed cells to 0
+void zero_subcell_forces_active(const int nlisted, const int* cell_list,
+                                const int* cells_to_nodes_offsets,
+                                double* subcell_force_x,
+                                double* subcell_force_y,
+                                double* subcell_force_z);
+
+// Calculate the subcell force of the listed cells from pressure gradients
+void calc_subcell_force_from_pressure_active(
+    const int nlisted, const int* cell_list, const int* cells_to_faces_offsets,
+    const int* cells_to_nodes_offsets, const int* cells_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const int* cells_to_nodes, const int* faces_cclockwise_cell,
+    const NodeState* node_state, const double* pressure,
+    double* subcell_force_x, double* subcell_force_y,
+    double* subcell_force_z);
+
+// Calculates the artificial viscous forces of the listed cells
+void calc_artificial_viscosity_active(
+    const int nlisted, const int* cell_list, const double visc_coeff1,
+    const double visc_coeff2, const int* cells_to_nodes_offsets,
+    const int* cells_to_nodes, const int* faces_cclockwise_cell,
+    const NodeState* node_state, const double* cell_centroids_x,
+    const double* cell_centroids_y, const double* cell_centroids_z,
+    const double* nodal_soundspeed, const double* limiter,
+    double* subcell_force_x, double* subcell_force_y, double* subcell_force_z,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const int* cells_to_faces_offsets, const int* cells_to_faces);
+
+// Controls the timestep from the listed cells, and the timestep that the rest
+// of the cells allow
+void set_timestep_active(const int nlisted, const int* cell_list,
+                         const double unlisted_dt, const double* nodes_x,
+                         const double* nodes_y, const double* nodes_z,
+                         const double* soundspeed, double* dt,
+                         const int* cells_to_faces_offsets,
+                         const int* cells_to_faces,
+                         const int* faces_to_nodes_offsets,
+                         const int* faces_to_nodes);
+
+// Calculate the new energy of the listed cells based on subcell forces
+void calc_predicted_energy_active(
+    const int nlisted, const int* cell_list, const double dt,
+    const int* cells_to_nodes_offsets, const int* cells_to_nodes,
+    const double* velocity_x1, const double* velocity_y1,
+    const double* velocity_z1, const double* subcell_force_x,
+    const double* subcell_force_y, const double* subcell_force_z,
+    const double* energy0, const double* cell_mass, double* energy1);
+
+// Calculates a new density of the listed cells from the predicted volume
+void calc_predicted_density_active(
+    const int nlisted, const int* cell_list, const int* cells_to_faces_offsets,
+    const int* cells_to_faces, const int* faces_to_nodes_offsets,
+    const int* faces_to_nodes, const double* nodes_x1, const double* nodes_y1,
+    const double* nodes_z1, const double* cell_centroids_x,
+    const double* cell_centroids_y, const double* cell_centroids_z,
+    const double* cell_mass, double* density1);
+
+// Time centers the pressure of the listed cells
+void time_center_pressure_active(const int nlisted, const int* cell_list,
+                                 const double* pressure0, double* pressure1);
+
+// Completes the corrector over the listed cells, where the rest of the cells
+// allow the given timestep
+void calc_corrected_cells_active(
+    const int nlisted, const int* cell_list, const double unlisted_dt,
+    const int* cells_to_nodes_offsets, const int* cells_to_nodes,
+    const int* cells_to_faces_offsets, const int* cells_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const double* nodes_x, const double* nodes_y, const double* nodes_z,
+    const double* velocity_x0, const double* velocity_y0,
+    const double* velocity_z0, const double* subcell_force_x,
+    const double* subcell_force_y, const double* subcell_force_z,
+    const double* soundspeed, const double* cell_mass, double* cell_centroids_x,
+    double* cell_centroids_y, double* cell_centroids_z, double* cell_volume,
+    double* density, double* cell_work, double* dt);
+
+// Applies the work done on each listed cell over the new timestep
+void apply_corrected_energy_active(const int nlisted, const int* cell_list,
+                                   const double dt, const double* cell_work,
+                                   const double* cell_mass, double* energy0);
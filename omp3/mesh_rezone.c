@@ -13,6 +13,18 @@ void correct_for_fluxes(const int ncells, const int* cells_to_nodes_offsets,
                         double* subcell_momentum_z,
                         double* subcell_momentum_flux_z);
 
+// Copies a set of stored cell centroids
+void copy_cell_centroids(const int ncells, const double* stored_x,
+                         const double* stored_y, const double* stored_z,
+                         double* cell_centroids_x, double* cell_centroids_y,
+                         double* cell_centroids_z);
+
+// Corrects the subcell tracers by their fluxes
+void correct_tracers_for_fluxes(const int ncells, const int ntracers,
+                                const int* cells_to_nodes_offsets,
+                                double* subcell_tracer_mass,
+                                const double* subcell_tracer_flux);
+
 // Performs an Eulerian rezone of the mesh
 void eulerian_rezone(UnstructuredMesh* umesh, HaleData* hale_data) {
 
@@ -26,16 +38,47 @@ void eulerian_rezone(UnstructuredMesh* umesh, HaleData* hale_data) {
       hale_data->subcell_momentum_flux_y, hale_data->subcell_momentum_z,
       hale_data->subcell_momentum_flux_z);
 
+  if (hale_data->ntracers) {
+    correct_tracers_for_fluxes(umesh->ncells, hale_data->ntracers,
+                               umesh->cells_to_nodes_offsets,
+                               hale_data->subcell_tracer_mass,
+                               hale_data->subcell_tracer_flux);
+  }
+
   // Finalise the mesh rezone
-  apply_mesh_rezoning(umesh->nnodes, hale_data->rezoned_nodes_x,
-                      hale_data->rezoned_nodes_y, hale_data->rezoned_nodes_z,
-                      umesh->nodes_x0, umesh->nodes_y0, umesh->nodes_z0);
-
-  // Determine the new cell centroids
-  init_cell_centroids(umesh->ncells, umesh->cells_to_nodes_offsets,
-                      umesh->cells_to_nodes, umesh->nodes_x0, umesh->nodes_y0,
-                      umesh->nodes_z0, umesh->cell_centroids_x,
-                      umesh->cell_centroids_y, umesh->cell_centroids_z);
+  apply_mesh_rezoning(hale_data->rezoned_nodes_x, umesh);
+  restore_geometry_epoch(hale_data, hale_data->rezoned_geometry_epoch);
+
+#ifdef PACKED_CELL_NODES
+  pack_cell_nodes(umesh->ncells, umesh->cells_to_nodes_offsets,
+                  umesh->cells_to_nodes, umesh->nodes_x0, umesh->nodes_y0,
+                  umesh->nodes_z0, hale_data->cell_nodes);
+#endif
+
+  // The new cell centroids are stored with the rezoned mesh
+  if (geometry_stale(&hale_data->cell_centroids_stamp,
+                     hale_data->geometry_epoch)) {
+    copy_cell_centroids(umesh->ncells, hale_data->rezoned_cell_centroids_x,
+                        hale_data->rezoned_cell_centroids_y,
+                        hale_data->rezoned_cell_centroids_z,
+                        umesh->cell_centroids_x, umesh->cell_centroids_y,
+                        umesh->cell_centroids_z);
+    reuse_geometry(&hale_data->cell_centroids_stamp, hale_data->geometry_epoch);
+  }
+}
+
+// Copies a set of stored cell centroids
+void copy_cell_centroids(const int ncells, const double* stored_x,
+                         const double* stored_y, const double* stored_z,
+                         double* cell_centroids_x, double* cell_centroids_y,
+                         double* cell_centroids_z) {
+  OMP_FOR()
+  for (int cc = 0; cc < ncells; ++cc) {
+    cell_centroids_x[(cc)] = stored_x[(cc)];
+    cell_centroids_y[(cc)] = stored_y[(cc)];
+    cell_centroids_z[(cc)] = stored_z[(cc)];
+  }
+  OMP_BARRIER();
 }
 
 // Correct the subcell data by the determined fluxes
@@ -57,7 +100,7 @@ void correct_for_fluxes(const int ncells, const int* cells_to_nodes_offsets,
   double dmom_y = 0.0;
   double dmom_z = 0.0;
 
-#pragma omp parallel for reduction(+ : dm, die, dmom_x, dmom_y, dmom_z)
+  OMP_FOR_REDUCTION(reduction(+ : dm, die, dmom_x, dmom_y, dmom_z))
   for (int cc = 0; cc < ncells; ++cc) {
     const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
     const int nnodes_by_cell =
@@ -100,4 +143,27 @@ void correct_for_fluxes(const int ncells, const int* cells_to_nodes_offsets,
       subcell_momentum_flux_z[(subcell_index)] = 0.0;
     }
   }
+  OMP_BARRIER();
+}
+
+// Corrects the subcell tracers by their fluxes, where the tracers of the
+// subcells of a cell are contiguous, and the fluxes are cleared as the next
+// remap begins
+void correct_tracers_for_fluxes(const int ncells, const int ntracers,
+                                const int* cells_to_nodes_offsets,
+                                double* subcell_tracer_mass,
+                                const double* subcell_tracer_flux) {
+  OMP_FOR()
+  for (int cc = 0; cc < ncells; ++cc) {
+    const int cell_tracers_off = cells_to_nodes_offsets[(cc)] * ntracers;
+    const int ntracers_by_cell =
+        cells_to_nodes_offsets[(cc + 1)] * ntracers - cell_tracers_off;
+
+#pragma omp simd
+    for (int ii = 0; ii < ntracers_by_cell; ++ii) {
+      subcell_tracer_mass[(cell_tracers_off + ii)] -=
+          subcell_tracer_flux[(cell_tracers_off + ii)];
+    }
+  }
+  OMP_BARRIER();
 }
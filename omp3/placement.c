@@ -0,0 +1,174 @@
+#include "../first_touch.h"
+#include "../hale_data.h"
+#include <stdio.h>
+
+// First touches the hale arrays with the partitioning of their kernels
+void place_hale_data(HaleData* hale_data, UnstructuredMesh* umesh) {
+  const size_t ncells = umesh->ncells;
+  const size_t nnodes = umesh->nnodes;
+
+  // Cell centred arrays are consumed by loops over cells
+  double* cell_arrays[] = {
+      hale_data->pressure0,   hale_data->energy1,
+      hale_data->ke_mass,     hale_data->density1,
+      hale_data->pressure1,   hale_data->cell_mass,
+      hale_data->cell_volume, hale_data->rezoned_cell_centroids_x,
+      hale_data->rezoned_cell_centroids_y,
+      hale_data->rezoned_cell_centroids_z,
+      hale_data->rezoned_cell_volume, hale_data->soundspeed0,
+      hale_data->soundspeed1};
+  for (size_t ii = 0; ii < sizeof(cell_arrays) / sizeof(double*); ++ii) {
+    first_touch_data(cell_arrays[(ii)], ncells, sizeof(double));
+  }
+
+  // Nodal arrays are consumed by loops over nodes
+  double* node_arrays[] = {
+      hale_data->velocity_x0,     hale_data->velocity_y0,
+      hale_data->velocity_z0,     hale_data->velocity_x1,
+      hale_data->velocity_y1,     hale_data->velocity_z1,
+      hale_data->nodal_mass,      hale_data->nodal_volumes,
+      hale_data->nodal_soundspeed, hale_data->limiter,
+      hale_data->node_force_x,    hale_data->node_force_y,
+      hale_data->node_force_z};
+  for (size_t ii = 0; ii < sizeof(node_arrays) / sizeof(double*); ++ii) {
+    first_touch_data(node_arrays[(ii)], nnodes, sizeof(double));
+  }
+
+  // Subcell arrays are indexed from within the loops over cells
+  double* subcell_arrays[] = {
+      hale_data->subcell_momentum_x,      hale_data->subcell_momentum_y,
+      hale_data->subcell_momentum_z,      hale_data->subcell_momentum_flux_x,
+      hale_data->subcell_momentum_flux_y, hale_data->subcell_momentum_flux_z,
+      hale_data->subcell_mass,            hale_data->subcell_mass_flux,
+      hale_data->subcell_ie_mass,         hale_data->subcell_ie_mass_flux,
+      hale_data->subcell_ke_mass,         hale_data->subcell_ke_mass_flux,
+      hale_data->subcell_volume,          hale_data->subcell_force_x,
+      hale_data->subcell_force_y,         hale_data->subcell_force_z,
+      hale_data->subcell_centroids_x,     hale_data->subcell_centroids_y,
+      hale_data->subcell_centroids_z};
+  for (size_t ii = 0; ii < sizeof(subcell_arrays) / sizeof(double*); ++ii) {
+    first_touch_data(subcell_arrays[(ii)], ncells,
+                     NSUBCELLS_BY_CELL * sizeof(double));
+  }
+
+  // The cell-local blocks are streamed by the loops over cells
+  first_touch_data(hale_data->cell_nodes, ncells, HEX_BLOCK * sizeof(double));
+  first_touch_data(hale_data->cell_velocity, ncells,
+                   HEX_BLOCK * sizeof(double));
+  first_touch_data(hale_data->cells_to_local_face_nodes, ncells,
+                   NFACES_BY_HEX * NNODES_BY_HEX_FACE * sizeof(int));
+
+#ifdef AOSOA_NODE_STATE
+  // The node state is gathered by a loop over its blocks
+  first_touch_data(hale_data->node_state.data,
+                   (nnodes + NODE_STATE_BLOCK - 1) / NODE_STATE_BLOCK,
+                   NNODE_FIELDS * NODE_STATE_BLOCK * sizeof(double));
+#endif
+
+  first_touch_data(hale_data->subcells_to_faces_offsets, ncells,
+                   NSUBCELLS_BY_CELL * sizeof(int));
+  first_touch_data(hale_data->subcells_to_subcells_offsets, ncells,
+                   NSUBCELLS_BY_CELL * sizeof(int));
+  first_touch_data(hale_data->subcells_to_faces, ncells,
+                   NSUBCELLS_BY_CELL * NSUBCELL_FACES_BY_NODE * sizeof(int));
+  first_touch_data(hale_data->subcells_to_subcells, ncells,
+                   NSUBCELLS_BY_CELL * NSUBCELL_FACES_BY_NODE * 2 *
+                       sizeof(int));
+
+  // The material fluxes are written by the cells on either side of a face
+  first_touch_data(hale_data->face_flux, umesh->nfaces,
+                   2 * NFACE_FLUXES * sizeof(double));
+
+  // The tracers of a cell or subcell are indexed together from the loops over
+  // cells
+  first_touch_data(hale_data->tracers.concentration, ncells,
+                   hale_data->ntracers * sizeof(double));
+  first_touch_data(hale_data->subcell_tracer_mass, ncells,
+                   NSUBCELLS_BY_CELL * hale_data->ntracers * sizeof(double));
+  first_touch_data(hale_data->subcell_tracer_flux, ncells,
+                   NSUBCELLS_BY_CELL * hale_data->ntracers * sizeof(double));
+
+  // The reconstruction of a cell is written by the loops over cells
+  first_touch_data(hale_data->cell_reconstruction, ncells,
+                   CELL_RECONSTRUCTION_STRIDE * sizeof(double));
+
+  // The activity front is marked by the loops over cells and nodes, and a
+  // cell is only quiescent once its shortest edge is cached
+  first_touch_data(hale_data->cell_front, ncells, sizeof(int));
+  first_touch_data(hale_data->node_front, nnodes, sizeof(int));
+  first_touch_data(hale_data->active_cells, ncells, sizeof(int));
+  first_touch_data(hale_data->front_nodes, nnodes, sizeof(int));
+  first_touch_data(hale_data->moving_nodes, nnodes, sizeof(int));
+  first_touch_data(hale_data->cell_quiescent, ncells, sizeof(int));
+  first_touch_data(hale_data->quiescent_edge, ncells, sizeof(double));
+}
+
+// Migrates the mesh arrays to the threads that consume them
+void place_mesh_data(HaleData* hale_data, UnstructuredMesh* umesh) {
+  const size_t ncells = umesh->ncells;
+  const size_t nnodes = umesh->nnodes;
+  const size_t nfaces = umesh->nfaces;
+
+  // The mesh and the initial state were touched by the serial setup
+  const double* cell_arrays[] = {
+      hale_data->density0,     hale_data->energy0,
+      umesh->cell_centroids_x, umesh->cell_centroids_y,
+      umesh->cell_centroids_z};
+  for (size_t ii = 0; ii < sizeof(cell_arrays) / sizeof(double*); ++ii) {
+    migrate_data(cell_arrays[(ii)], ncells, sizeof(double));
+  }
+
+  const double* node_arrays[] = {umesh->nodes_x0, umesh->nodes_y0,
+                                 umesh->nodes_z0, umesh->nodes_x1,
+                                 umesh->nodes_y1, umesh->nodes_z1};
+  for (size_t ii = 0; ii < sizeof(node_arrays) / sizeof(double*); ++ii) {
+    migrate_data(node_arrays[(ii)], nnodes, sizeof(double));
+  }
+
+  migrate_data(umesh->cells_to_nodes_offsets, ncells, sizeof(int));
+  migrate_data(umesh->cells_to_faces_offsets, ncells, sizeof(int));
+  migrate_data(umesh->nodes_to_cells_offsets, nnodes, sizeof(int));
+  migrate_data(umesh->nodes_to_nodes_offsets, nnodes, sizeof(int));
+  migrate_data(umesh->nodes_to_faces_offsets, nnodes, sizeof(int));
+  migrate_data(umesh->faces_to_nodes_offsets, nfaces, sizeof(int));
+  migrate_data(umesh->boundary_index, nnodes, sizeof(int));
+  migrate_data(umesh->faces_to_cells0, nfaces, sizeof(int));
+  migrate_data(umesh->faces_to_cells1, nfaces, sizeof(int));
+  migrate_data(umesh->faces_cclockwise_cell, nfaces, sizeof(int));
+
+  migrate_list_data(umesh->cells_to_nodes, umesh->cells_to_nodes_offsets,
+                    ncells);
+  migrate_list_data(umesh->cells_to_faces, umesh->cells_to_faces_offsets,
+                    ncells);
+  migrate_list_data(umesh->nodes_to_cells, umesh->nodes_to_cells_offsets,
+                    nnodes);
+  migrate_list_data(umesh->nodes_to_nodes, umesh->nodes_to_nodes_offsets,
+                    nnodes);
+  migrate_list_data(umesh->nodes_to_faces, umesh->nodes_to_faces_offsets,
+                    nnodes);
+  migrate_list_data(umesh->faces_to_nodes, umesh->faces_to_nodes_offsets,
+                    nfaces);
+}
+
+// Reports the NUMA placement of a representative set of arrays
+void print_hale_placement(HaleData* hale_data, UnstructuredMesh* umesh) {
+  const size_t ncells = umesh->ncells;
+  const size_t nnodes = umesh->nnodes;
+  const size_t nsubcells = hale_data->nsubcells;
+
+  printf("Page placement by NUMA node\n");
+  print_page_placement("nodes_x0", umesh->nodes_x0, nnodes * sizeof(double));
+  print_page_placement("cells_to_nodes", umesh->cells_to_nodes,
+                       umesh->cells_to_nodes_offsets[(ncells)] * sizeof(int));
+  print_page_placement("density0", hale_data->density0,
+                       ncells * sizeof(double));
+  print_page_placement("velocity_x0", hale_data->velocity_x0,
+                       nnodes * sizeof(double));
+  print_page_placement("cell_mass", hale_data->cell_mass,
+                       ncells * sizeof(double));
+  print_page_placement("subcell_mass", hale_data->subcell_mass,
+                       nsubcells * sizeof(double));
+  print_page_placement("subcells_to_faces", hale_data->subcells_to_faces,
+                       nsubcells * NSUBCELL_FACES_BY_NODE * sizeof(int));
+  printf("\n");
+}
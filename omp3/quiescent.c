@@ -0,0 +1,573 @@
+#include "lagrange.h"
+#include "../../comms.h"
+#include "../../shared.h"
+#include "hale.h"
+#include <float.h>
+#include <math.h>
+
+// The classes of the nodes around the activity front, where a node only moves
+// when every cell around it is active, and the nodes of the active cells are
+// gathered by them whether or not they move. The classes are ordered, so that
+// the front nodes are those of at least FRONT_NODE.
+enum { QUIESCENT_NODE, FRONT_NODE, MOVING_NODE };
+
+// Performs the predictor step of the Lagrangian phase over the cells within
+// reach of the activity front
+void quiescent_predictor(Mesh* mesh, UnstructuredMesh* umesh,
+                         HaleData* hale_data) {
+  const EosTable* eos_table =
+      hale_data->tabulated_eos ? &hale_data->eos_table : NULL;
+
+  // The front is found from the pressure of every cell
+  START_PROFILING(&compute_profile);
+  equation_of_state(umesh->ncells, eos_table, hale_data->energy0,
+                    hale_data->density0, hale_data->pressure0,
+                    hale_data->soundspeed0);
+  STOP_PROFILING(&compute_profile, "equation_of_state");
+
+  if (hale_data->multi_material) {
+    START_PROFILING(&compute_profile);
+    mixed_equation_of_state(&hale_data->materials, eos_table,
+                            hale_data->energy0, hale_data->density0,
+                            hale_data->pressure0, hale_data->soundspeed0);
+    STOP_PROFILING(&compute_profile, "mixed_equation_of_state");
+  }
+
+  build_activity_front(umesh, hale_data);
+
+  START_PROFILING(&compute_profile);
+  calc_nodal_vol_and_c_active(
+      hale_data->nfront_nodes, hale_data->front_nodes,
+      umesh->nodes_to_faces_offsets, umesh->nodes_to_faces,
+      umesh->faces_to_nodes_offsets, umesh->faces_to_nodes,
+      umesh->faces_to_cells0, umesh->faces_to_cells1, umesh->nodes_x0,
+      umesh->nodes_y0, umesh->nodes_z0, umesh->cell_centroids_x,
+      umesh->cell_centroids_y, umesh->cell_centroids_z, hale_data->soundspeed0,
+      hale_data->nodal_volumes, hale_data->nodal_soundspeed);
+  STOP_PROFILING(&compute_profile, "calc_nodal_vol_and_c");
+
+  START_PROFILING(&compute_profile);
+  sync_node_state(umesh->nnodes, umesh->nodes_x0, umesh->nodes_y0,
+                  umesh->nodes_z0, hale_data->velocity_x0,
+                  hale_data->velocity_y0, hale_data->velocity_z0,
+                  hale_data->nodal_mass, hale_data->nodal_volumes,
+                  &hale_data->node_state);
+  STOP_PROFILING(&compute_profile, "sync_node_state");
+
+  START_PROFILING(&compute_profile);
+  zero_subcell_forces_active(
+      hale_data->nactive_cells, hale_data->active_cells,
+      umesh->cells_to_nodes_offsets, hale_data->subcell_force_x,
+      hale_data->subcell_force_y, hale_data->subcell_force_z);
+  STOP_PROFILING(&compute_profile, "zero_subcell_forces");
+
+  START_PROFILING(&compute_profile);
+  calc_subcell_force_from_pressure_active(
+      hale_data->nactive_cells, hale_data->active_cells,
+      umesh->cells_to_faces_offsets, umesh->cells_to_nodes_offsets,
+      umesh->cells_to_faces, umesh->faces_to_nodes_offsets,
+      umesh->faces_to_nodes, umesh->cells_to_nodes,
+      umesh->faces_cclockwise_cell, &hale_data->node_state,
+      hale_data->pressure0, hale_data->subcell_force_x,
+      hale_data->subcell_force_y, hale_data->subcell_force_z);
+  STOP_PROFILING(&compute_profile, "calc_subcell_force_from_pressure");
+
+  START_PROFILING(&compute_profile);
+  scale_soundspeed_active(hale_data->nfront_nodes, hale_data->front_nodes,
+                          hale_data->nodal_volumes,
+                          hale_data->nodal_soundspeed);
+  STOP_PROFILING(&compute_profile, "scale_soundspeed");
+
+  START_PROFILING(&compute_profile);
+  calc_artificial_viscosity_active(
+      hale_data->nactive_cells, hale_data->active_cells,
+      hale_data->visc_coeff1, hale_data->visc_coeff2,
+      umesh->cells_to_nodes_offsets, umesh->cells_to_nodes,
+      umesh->faces_cclockwise_cell, &hale_data->node_state,
+      umesh->cell_centroids_x, umesh->cell_centroids_y,
+      umesh->cell_centroids_z, hale_data->nodal_soundspeed, hale_data->limiter,
+      hale_data->subcell_force_x, hale_data->subcell_force_y,
+      hale_data->subcell_force_z, umesh->faces_to_nodes_offsets,
+      umesh->faces_to_nodes, umesh->cells_to_faces_offsets,
+      umesh->cells_to_faces);
+  STOP_PROFILING(&compute_profile, "calc_artificial_viscosity");
+
+  START_PROFILING(&compute_profile);
+  calc_new_velocity_active(
+      hale_data->nmoving_nodes, hale_data->moving_nodes, mesh->dt,
+      umesh->nodes_to_cells_offsets, umesh->nodes_to_cells,
+      umesh->cells_to_nodes_offsets, umesh->cells_to_nodes,
+      hale_data->subcell_force_x, hale_data->subcell_force_y,
+      hale_data->subcell_force_z, hale_data->nodal_mass,
+      hale_data->velocity_x0, hale_data->velocity_y0, hale_data->velocity_z0,
+      hale_data->velocity_x1, hale_data->velocity_y1, hale_data->velocity_z1);
+  STOP_PROFILING(&compute_profile, "calc_new_velocity");
+
+  OMP_SINGLE()
+  handle_unstructured_reflect_3d(
+      umesh->nnodes, umesh->boundary_index, umesh->boundary_type,
+      umesh->boundary_normal_x, umesh->boundary_normal_y,
+      umesh->boundary_normal_z, hale_data->velocity_x1, hale_data->velocity_y1,
+      hale_data->velocity_z1);
+
+  START_PROFILING(&compute_profile);
+  move_nodes_active(hale_data->nmoving_nodes, hale_data->moving_nodes,
+                    mesh->dt, umesh->nodes_x0, umesh->nodes_y0,
+                    umesh->nodes_z0, hale_data->velocity_x1,
+                    hale_data->velocity_y1, hale_data->velocity_z1,
+                    umesh->nodes_x1, umesh->nodes_y1, umesh->nodes_z1);
+  STOP_PROFILING(&compute_profile, "move_nodes");
+
+  init_cell_centroids_active(
+      hale_data->nactive_cells, hale_data->active_cells,
+      umesh->cells_to_nodes_offsets, umesh->cells_to_nodes, umesh->nodes_x1,
+      umesh->nodes_y1, umesh->nodes_z1, umesh->cell_centroids_x,
+      umesh->cell_centroids_y, umesh->cell_centroids_z);
+
+  set_timestep_active(hale_data->nactive_cells, hale_data->active_cells,
+                      hale_data->quiescent_dt, umesh->nodes_x1,
+                      umesh->nodes_y1, umesh->nodes_z1, hale_data->soundspeed0,
+                      &mesh->dt, umesh->cells_to_faces_offsets,
+                      umesh->cells_to_faces, umesh->faces_to_nodes_offsets,
+                      umesh->faces_to_nodes);
+
+  START_PROFILING(&compute_profile);
+  calc_predicted_energy_active(
+      hale_data->nactive_cells, hale_data->active_cells, mesh->dt,
+      umesh->cells_to_nodes_offsets, umesh->cells_to_nodes,
+      hale_data->velocity_x1, hale_data->velocity_y1, hale_data->velocity_z1,
+      hale_data->subcell_force_x, hale_data->subcell_force_y,
+      hale_data->subcell_force_z, hale_data->energy0, hale_data->cell_mass,
+      hale_data->energy1);
+  STOP_PROFILING(&compute_profile, "calc_predicted_energy");
+
+  START_PROFILING(&compute_profile);
+  calc_predicted_density_active(
+      hale_data->nactive_cells, hale_data->active_cells,
+      umesh->cells_to_faces_offsets, umesh->cells_to_faces,
+      umesh->faces_to_nodes_offsets, umesh->faces_to_nodes, umesh->nodes_x1,
+      umesh->nodes_y1, umesh->nodes_z1, umesh->cell_centroids_x,
+      umesh->cell_centroids_y, umesh->cell_centroids_z, hale_data->cell_mass,
+      hale_data->density1);
+  STOP_PROFILING(&compute_profile, "calc_predicted_density");
+
+  START_PROFILING(&compute_profile);
+  equation_of_state_active(hale_data->nactive_cells, hale_data->active_cells,
+                           eos_table, hale_data->energy1, hale_data->density1,
+                           hale_data->pressure1, hale_data->soundspeed1);
+  STOP_PROFILING(&compute_profile, "equation_of_state");
+
+  // The predicted state of the quiescent mixed cells is their current state
+  if (hale_data->multi_material) {
+    START_PROFILING(&compute_profile);
+    mixed_equation_of_state(&hale_data->materials, eos_table,
+                            hale_data->energy1, hale_data->density1,
+                            hale_data->pressure1, hale_data->soundspeed1);
+    STOP_PROFILING(&compute_profile, "mixed_equation_of_state");
+  }
+
+  START_PROFILING(&compute_profile);
+  time_center_pressure_active(hale_data->nactive_cells,
+                              hale_data->active_cells, hale_data->pressure0,
+                              hale_data->pressure1);
+  STOP_PROFILING(&compute_profile, "time_center_pressure");
+
+  START_PROFILING(&compute_profile);
+  time_center_nodes_active(hale_data->nmoving_nodes, hale_data->moving_nodes,
+                           umesh->nodes_x0, umesh->nodes_y0, umesh->nodes_z0,
+                           umesh->nodes_x1, umesh->nodes_y1, umesh->nodes_z1);
+  STOP_PROFILING(&compute_profile, "time_center_nodes");
+}
+
+// Performs the corrector step of the Lagrangian phase over the cells within
+// reach of the activity front
+void quiescent_corrector(Mesh* mesh, UnstructuredMesh* umesh,
+                         HaleData* hale_data) {
+
+  START_PROFILING(&compute_profile);
+  zero_subcell_forces_active(
+      hale_data->nactive_cells, hale_data->active_cells,
+      umesh->cells_to_nodes_offsets, hale_data->subcell_force_x,
+      hale_data->subcell_force_y, hale_data->subcell_force_z);
+  STOP_PROFILING(&compute_profile, "zero_subcell_forces");
+
+  START_PROFILING(&compute_profile);
+  calc_nodal_vol_and_c_active(
+      hale_data->nfront_nodes, hale_data->front_nodes,
+      umesh->nodes_to_faces_offsets, umesh->nodes_to_faces,
+      umesh->faces_to_nodes_offsets, umesh->faces_to_nodes,
+      umesh->faces_to_cells0, umesh->faces_to_cells1, umesh->nodes_x1,
+      umesh->nodes_y1, umesh->nodes_z1, umesh->cell_centroids_x,
+      umesh->cell_centroids_y, umesh->cell_centroids_z, hale_data->soundspeed1,
+      hale_data->nodal_volumes, hale_data->nodal_soundspeed);
+  STOP_PROFILING(&compute_profile, "calc_nodal_vol_and_c");
+
+  START_PROFILING(&compute_profile);
+  sync_node_state(umesh->nnodes, umesh->nodes_x1, umesh->nodes_y1,
+                  umesh->nodes_z1, hale_data->velocity_x1,
+                  hale_data->velocity_y1, hale_data->velocity_z1,
+                  hale_data->nodal_mass, hale_data->nodal_volumes,
+                  &hale_data->node_state);
+  STOP_PROFILING(&compute_profile, "sync_node_state");
+
+  START_PROFILING(&compute_profile);
+  scale_soundspeed_active(hale_data->nfront_nodes, hale_data->front_nodes,
+                          hale_data->nodal_volumes,
+                          hale_data->nodal_soundspeed);
+  STOP_PROFILING(&compute_profile, "scale_soundspeed");
+
+  START_PROFILING(&compute_profile);
+  calc_subcell_force_from_pressure_active(
+      hale_data->nactive_cells, hale_data->active_cells,
+      umesh->cells_to_faces_offsets, umesh->cells_to_nodes_offsets,
+      umesh->cells_to_faces, umesh->faces_to_nodes_offsets,
+      umesh->faces_to_nodes, umesh->cells_to_nodes,
+      umesh->faces_cclockwise_cell, &hale_data->node_state,
+      hale_data->pressure1, hale_data->subcell_force_x,
+      hale_data->subcell_force_y, hale_data->subcell_force_z);
+  STOP_PROFILING(&compute_profile, "node_force_from_pressure");
+
+  START_PROFILING(&compute_profile);
+  calc_artificial_viscosity_active(
+      hale_data->nactive_cells, hale_data->active_cells,
+      hale_data->visc_coeff1, hale_data->visc_coeff2,
+      umesh->cells_to_nodes_offsets, umesh->cells_to_nodes,
+      umesh->faces_cclockwise_cell, &hale_data->node_state,
+      umesh->cell_centroids_x, umesh->cell_centroids_y,
+      umesh->cell_centroids_z, hale_data->nodal_soundspeed, hale_data->limiter,
+      hale_data->subcell_force_x, hale_data->subcell_force_y,
+      hale_data->subcell_force_z, umesh->faces_to_nodes_offsets,
+      umesh->faces_to_nodes, umesh->cells_to_faces_offsets,
+      umesh->cells_to_faces);
+  STOP_PROFILING(&compute_profile, "calc_artificial_viscosity");
+
+  START_PROFILING(&compute_profile);
+  update_and_time_center_velocity_active(
+      hale_data->nmoving_nodes, hale_data->moving_nodes, mesh->dt,
+      umesh->nodes_to_cells_offsets, umesh->nodes_to_cells,
+      umesh->cells_to_nodes_offsets, umesh->cells_to_nodes,
+      hale_data->nodal_mass, hale_data->subcell_force_x,
+      hale_data->subcell_force_y, hale_data->subcell_force_z,
+      hale_data->velocity_x0, hale_data->velocity_y0, hale_data->velocity_z0,
+      hale_data->velocity_x1, hale_data->velocity_y1, hale_data->velocity_z1);
+  STOP_PROFILING(&compute_profile, "calc_new_velocity");
+
+  OMP_SINGLE()
+  handle_unstructured_reflect_3d(
+      umesh->nnodes, umesh->boundary_index, umesh->boundary_type,
+      umesh->boundary_normal_x, umesh->boundary_normal_y,
+      umesh->boundary_normal_z, hale_data->velocity_x0, hale_data->velocity_y0,
+      hale_data->velocity_z0);
+
+  START_PROFILING(&compute_profile);
+  advance_nodes_corrected_active(
+      hale_data->nmoving_nodes, hale_data->moving_nodes, mesh->dt,
+      hale_data->velocity_x0, hale_data->velocity_y0, hale_data->velocity_z0,
+      umesh->nodes_x0, umesh->nodes_y0, umesh->nodes_z0, umesh->nodes_x1,
+      umesh->nodes_y1, umesh->nodes_z1);
+  STOP_PROFILING(&compute_profile, "advance_nodes_corrected");
+
+  calc_corrected_cells_active(
+      hale_data->nactive_cells, hale_data->active_cells,
+      hale_data->quiescent_dt, umesh->cells_to_nodes_offsets,
+      umesh->cells_to_nodes, umesh->cells_to_faces_offsets,
+      umesh->cells_to_faces, umesh->faces_to_nodes_offsets,
+      umesh->faces_to_nodes, umesh->nodes_x1, umesh->nodes_y1,
+      umesh->nodes_z1, hale_data->velocity_x0, hale_data->velocity_y0,
+      hale_data->velocity_z0, hale_data->subcell_force_x,
+      hale_data->subcell_force_y, hale_data->subcell_force_z,
+      hale_data->soundspeed1, hale_data->cell_mass, umesh->cell_centroids_x,
+      umesh->cell_centroids_y, umesh->cell_centroids_z, hale_data->cell_volume,
+      hale_data->density0, hale_data->cell_work, &mesh->dt);
+
+  START_PROFILING(&compute_profile);
+  apply_corrected_energy_active(hale_data->nactive_cells,
+                                hale_data->active_cells, mesh->dt,
+                                hale_data->cell_work, hale_data->cell_mass,
+                                hale_data->energy0);
+  STOP_PROFILING(&compute_profile, "apply_corrected_energy");
+}
+
+// Finds the cells within two rings of the activity front, and the nodes that
+// they gather and move. The nodes of the quiescent region are held in place
+// by making both time levels their current position and velocity, and the
+// predicted state of the quiescent cells their current state.
+void build_activity_front(UnstructuredMesh* umesh, HaleData* hale_data) {
+  START_PROFILING(&compute_profile);
+
+  // The front spreads a ring through the nodes on each pass
+  seed_activity_front(umesh->ncells, umesh->cells_to_nodes_offsets,
+                      umesh->cells_to_nodes, umesh->cells_to_faces_offsets,
+                      umesh->cells_to_faces, umesh->faces_to_cells0,
+                      umesh->faces_to_cells1, hale_data->velocity_x0,
+                      hale_data->velocity_y0, hale_data->velocity_z0,
+                      hale_data->pressure0, hale_data->soundspeed0,
+                      hale_data->cell_front);
+  for (int rr = 0; rr < 2; ++rr) {
+    mark_front_nodes(umesh->nnodes, umesh->nodes_to_cells_offsets,
+                     umesh->nodes_to_cells, hale_data->cell_front,
+                     hale_data->node_front);
+    mark_front_cells(umesh->ncells, umesh->cells_to_nodes_offsets,
+                     umesh->cells_to_nodes, hale_data->node_front,
+                     hale_data->cell_front);
+  }
+
+  settle_quiescent_cells(
+      umesh->ncells, hale_data->cell_front, umesh->nodes_x0, umesh->nodes_y0,
+      umesh->nodes_z0, umesh->cells_to_faces_offsets, umesh->cells_to_faces,
+      umesh->faces_to_nodes_offsets, umesh->faces_to_nodes,
+      umesh->cell_centroids_x, umesh->cell_centroids_y,
+      umesh->cell_centroids_z, hale_data->energy0, hale_data->density0,
+      hale_data->pressure0, hale_data->soundspeed0, hale_data->cell_quiescent,
+      hale_data->quiescent_edge, hale_data->cell_volume, hale_data->energy1,
+      hale_data->density1, hale_data->pressure1, hale_data->soundspeed1,
+      &hale_data->quiescent_dt);
+
+  settle_quiescent_nodes(
+      umesh->nnodes, umesh->nodes_to_cells_offsets, umesh->nodes_to_cells,
+      hale_data->cell_front, umesh->nodes_x0, umesh->nodes_y0,
+      umesh->nodes_z0, hale_data->velocity_x0, hale_data->velocity_y0,
+      hale_data->velocity_z0, hale_data->node_front, umesh->nodes_x1,
+      umesh->nodes_y1, umesh->nodes_z1, hale_data->velocity_x1,
+      hale_data->velocity_y1, hale_data->velocity_z1);
+
+  // The lists are compacted in order, so the kernels stream them
+  compact_flagged(umesh->ncells, hale_data->cell_front, 1,
+                  hale_data->compact_offsets, hale_data->active_cells,
+                  &hale_data->nactive_cells);
+  compact_flagged(umesh->nnodes, hale_data->node_front, FRONT_NODE,
+                  hale_data->compact_offsets, hale_data->front_nodes,
+                  &hale_data->nfront_nodes);
+  compact_flagged(umesh->nnodes, hale_data->node_front, MOVING_NODE,
+                  hale_data->compact_offsets, hale_data->moving_nodes,
+                  &hale_data->nmoving_nodes);
+
+  // The skipped work is reported at the end of the run
+  OMP_SINGLE()
+  {
+    hale_data->quiescent_steps++;
+    hale_data->skipped_cells += umesh->ncells - hale_data->nactive_cells;
+    hale_data->skipped_nodes += umesh->nnodes - hale_data->nfront_nodes;
+  }
+  STOP_PROFILING(&compute_profile, __func__);
+}
+
+// Marks the cells that are moving, or that have a jump in pressure across one
+// of their faces, beyond the roundoff of the quiescent state
+void seed_activity_front(const int ncells, const int* cells_to_nodes_offsets,
+                         const int* cells_to_nodes,
+                         const int* cells_to_faces_offsets,
+                         const int* cells_to_faces, const int* faces_to_cells0,
+                         const int* faces_to_cells1, const double* velocity_x,
+                         const double* velocity_y, const double* velocity_z,
+                         const double* pressure, const double* soundspeed,
+                         int* cell_front) {
+
+  OMP_FOR()
+  for (int cc = 0; cc < ncells; ++cc) {
+    const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
+    const int nnodes_by_cell =
+        cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
+    const int cell_to_faces_off = cells_to_faces_offsets[(cc)];
+    const int nfaces_by_cell =
+        cells_to_faces_offsets[(cc + 1)] - cell_to_faces_off;
+
+    // The velocity is measured against the soundspeed of the cell
+    const double vmax = QUIESCENT_TOLERANCE * soundspeed[(cc)];
+    int active = 0;
+    for (int nn = 0; nn < nnodes_by_cell; ++nn) {
+      const int node_index = cells_to_nodes[(cell_to_nodes_off + nn)];
+      active |= (velocity_x[(node_index)] * velocity_x[(node_index)] +
+                     velocity_y[(node_index)] * velocity_y[(node_index)] +
+                     velocity_z[(node_index)] * velocity_z[(node_index)] >
+                 vmax * vmax);
+    }
+
+    for (int ff = 0; ff < nfaces_by_cell; ++ff) {
+      const int face_index = cells_to_faces[(cell_to_faces_off + ff)];
+      const int neighbour_index = (faces_to_cells0[(face_index)] == cc)
+                                      ? faces_to_cells1[(face_index)]
+                                      : faces_to_cells0[(face_index)];
+      if (neighbour_index == -1) {
+        continue;
+      }
+
+      active |= (fabs(pressure[(cc)] - pressure[(neighbour_index)]) >
+                 QUIESCENT_TOLERANCE *
+                     max(pressure[(cc)], pressure[(neighbour_index)]));
+    }
+
+    cell_front[(cc)] = active;
+  }
+  OMP_BARRIER();
+}
+
+// Marks the nodes of the marked cells
+void mark_front_nodes(const int nnodes, const int* nodes_to_cells_offsets,
+                      const int* nodes_to_cells, const int* cell_front,
+                      int* node_front) {
+
+  OMP_FOR()
+  for (int nn = 0; nn < nnodes; ++nn) {
+    const int node_to_cells_off = nodes_to_cells_offsets[(nn)];
+    const int ncells_by_node =
+        nodes_to_cells_offsets[(nn + 1)] - node_to_cells_off;
+
+    int marked = 0;
+    for (int cc = 0; cc < ncells_by_node; ++cc) {
+      marked |= cell_front[(nodes_to_cells[(node_to_cells_off + cc)])];
+    }
+    node_front[(nn)] = marked;
+  }
+  OMP_BARRIER();
+}
+
+// Marks the cells of the marked nodes
+void mark_front_cells(const int ncells, const int* cells_to_nodes_offsets,
+                      const int* cells_to_nodes, const int* node_front,
+                      int* cell_front) {
+
+  OMP_FOR()
+  for (int cc = 0; cc < ncells; ++cc) {
+    const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
+    const int nnodes_by_cell =
+        cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
+
+    int marked = 0;
+    for (int nn = 0; nn < nnodes_by_cell; ++nn) {
+      marked |= node_front[(cells_to_nodes[(cell_to_nodes_off + nn)])];
+    }
+    cell_front[(cc)] = marked;
+  }
+  OMP_BARRIER();
+}
+
+// Makes the predicted state of each quiescent cell its current state, and
+// finds the timestep that the quiescent cells allow. The nodes of a quiescent
+// cell don't move, so its shortest edge and volume are only found when it
+// falls quiet, where the corrector would otherwise have found its volume.
+void settle_quiescent_cells(
+    const int ncells, const int* cell_front, const double* nodes_x,
+    const double* nodes_y, const double* nodes_z,
+    const int* cells_to_faces_offsets, const int* cells_to_faces,
+    const int* faces_to_nodes_offsets, const int* faces_to_nodes,
+    const double* cell_centroids_x, const double* cell_centroids_y,
+    const double* cell_centroids_z, const double* energy0,
+    const double* density0, const double* pressure0, const double* soundspeed0,
+    int* cell_quiescent, double* quiescent_edge, double* cell_volume,
+    double* energy1, double* density1, double* pressure1, double* soundspeed1,
+    double* quiescent_dt) {
+
+  double local_dt = DBL_MAX;
+  OMP_FOR_REDUCTION(reduction(min : local_dt))
+  for (int cc = 0; cc < ncells; ++cc) {
+    if (cell_front[(cc)]) {
+      cell_quiescent[(cc)] = 0;
+      continue;
+    }
+
+    if (!cell_quiescent[(cc)]) {
+      const int cell_to_faces_off = cells_to_faces_offsets[(cc)];
+      const int nfaces_by_cell =
+          cells_to_faces_offsets[(cc + 1)] - cell_to_faces_off;
+
+      cell_quiescent[(cc)] = 1;
+      quiescent_edge[(cc)] = calc_shortest_edge(
+          cc, nodes_x, nodes_y, nodes_z, cells_to_faces_offsets,
+          cells_to_faces, faces_to_nodes_offsets, faces_to_nodes);
+      cell_volume[(cc)] = calc_cell_volume(
+          cc, nfaces_by_cell, cell_to_faces_off, cells_to_faces,
+          faces_to_nodes_offsets, faces_to_nodes, nodes_x, nodes_y, nodes_z,
+          cell_centroids_x, cell_centroids_y, cell_centroids_z);
+    }
+
+    energy1[(cc)] = energy0[(cc)];
+    density1[(cc)] = density0[(cc)];
+    pressure1[(cc)] = pressure0[(cc)];
+    soundspeed1[(cc)] = soundspeed0[(cc)];
+    local_dt = min(local_dt, quiescent_edge[(cc)] / soundspeed0[(cc)]);
+  }
+  TEAM_MIN(&local_dt);
+
+  OMP_SINGLE()
+  *quiescent_dt = local_dt;
+}
+
+// Classifies the nodes by the activity of their cells, holding the nodes that
+// don't move at their current position and velocity in both time levels
+void settle_quiescent_nodes(
+    const int nnodes, const int* nodes_to_cells_offsets,
+    const int* nodes_to_cells, const int* cell_front, const double* nodes_x0,
+    const double* nodes_y0, const double* nodes_z0, const double* velocity_x0,
+    const double* velocity_y0, const double* velocity_z0, int* node_front,
+    double* nodes_x1, double* nodes_y1, double* nodes_z1, double* velocity_x1,
+    double* velocity_y1, double* velocity_z1) {
+
+  OMP_FOR()
+  for (int nn = 0; nn < nnodes; ++nn) {
+    const int node_to_cells_off = nodes_to_cells_offsets[(nn)];
+    const int ncells_by_node =
+        nodes_to_cells_offsets[(nn + 1)] - node_to_cells_off;
+
+    int nactive = 0;
+    for (int cc = 0; cc < ncells_by_node; ++cc) {
+      nactive += cell_front[(nodes_to_cells[(node_to_cells_off + cc)])];
+    }
+
+    if (nactive == ncells_by_node) {
+      node_front[(nn)] = MOVING_NODE;
+      continue;
+    }
+
+    node_front[(nn)] = nactive ? FRONT_NODE : QUIESCENT_NODE;
+    nodes_x1[(nn)] = nodes_x0[(nn)];
+    nodes_y1[(nn)] = nodes_y0[(nn)];
+    nodes_z1[(nn)] = nodes_z0[(nn)];
+    velocity_x1[(nn)] = velocity_x0[(nn)];
+    velocity_y1[(nn)] = velocity_y0[(nn)];
+    velocity_z1[(nn)] = velocity_z0[(nn)];
+  }
+  OMP_BARRIER();
+}
+
+// Lists the indices whose flags reach a class, in order. The range is cut into
+// blocks that are counted and then filled in parallel, from the offsets of the
+// blocks found by a scan over the block counts.
+void compact_flagged(const int n, const int* flags, const int min_flag,
+                     int* block_offsets, int* list, int* nlisted) {
+  const int nblocks = (n + COMPACT_BLOCK - 1) / COMPACT_BLOCK;
+
+  OMP_FOR()
+  for (int bb = 0; bb < nblocks; ++bb) {
+    const int block_end = min(n, (bb + 1) * COMPACT_BLOCK);
+
+    int nflagged = 0;
+    for (int ii = bb * COMPACT_BLOCK; ii < block_end; ++ii) {
+      nflagged += (flags[(ii)] >= min_flag);
+    }
+    block_offsets[(bb + 1)] = nflagged;
+  }
+  OMP_BARRIER();
+
+  OMP_SINGLE()
+  {
+    block_offsets[(0)] = 0;
+    for (int bb = 0; bb < nblocks; ++bb) {
+      block_offsets[(bb + 1)] += block_offsets[(bb)];
+    }
+    *nlisted = block_offsets[(nblocks)];
+  }
+
+  OMP_FOR()
+  for (int bb = 0; bb < nblocks; ++bb) {
+    const int block_end = min(n, (bb + 1) * COMPACT_BLOCK);
+
+    int ll = block_offsets[(bb)];
+    for (int ii = bb * COMPACT_BLOCK; ii < block_end; ++ii) {
+      if (flags[(ii)] >= min_flag) {
+        list[(ll++)] = ii;
+      }
+    }
+  }
+  OMP_BARRIER();
+}
@@ -0,0 +1,136 @@
+#include "region.h"
+#include "../scratch_pool.h"
+#include <float.h>
+#include <omp.h>
+#include <stdio.h>
+
+// Each thread owns a cache line of values to combine, and of timings
+typedef struct {
+  double vals[MAX_TEAM_VALUES];
+} TeamValues;
+
+typedef struct {
+  double wait;
+  int nbarriers;
+  char pad[64 - sizeof(double) - sizeof(int)];
+} BarrierTime;
+
+static TeamValues team_values[MAX_TEAM_THREADS];
+static BarrierTime barrier_time[MAX_TEAM_THREADS];
+static int team_size = 0;
+
+// Publishes the private values of the calling thread to the team
+static void publish_team_values(double** vals, const int nvals);
+
+// Waits for the rest of the team, accumulating the time spent waiting
+void team_barrier() {
+  const int tid = omp_get_thread_num();
+  if (tid >= MAX_TEAM_THREADS) {
+    TERMINATE("The persistent region is limited to %d threads.\n",
+              MAX_TEAM_THREADS);
+  }
+
+  const double start = omp_get_wtime();
+#pragma omp barrier
+  barrier_time[(tid)].wait += omp_get_wtime() - start;
+  barrier_time[(tid)].nbarriers++;
+
+  if (tid == 0) {
+    team_size = omp_get_num_threads();
+  }
+}
+
+// Sums the private values of each thread in the team, in thread order so that
+// every thread receives the same result
+void team_sum(double** vals, const int nvals) {
+  publish_team_values(vals, nvals);
+
+  const int nthreads = omp_get_num_threads();
+  for (int vv = 0; vv < nvals; ++vv) {
+    double sum = 0.0;
+    for (int tt = 0; tt < nthreads; ++tt) {
+      sum += team_values[(tt)].vals[(vv)];
+    }
+    *vals[(vv)] = sum;
+  }
+
+  // The values can't be published again until everyone has read them
+  team_barrier();
+}
+
+// Finds the minimum of the private values of each thread in the team
+void team_min(double** vals, const int nvals) {
+  publish_team_values(vals, nvals);
+
+  const int nthreads = omp_get_num_threads();
+  for (int vv = 0; vv < nvals; ++vv) {
+    double min_val = DBL_MAX;
+    for (int tt = 0; tt < nthreads; ++tt) {
+      min_val = min(min_val, team_values[(tt)].vals[(vv)]);
+    }
+    *vals[(vv)] = min_val;
+  }
+
+  team_barrier();
+}
+
+// The number of tiles each loop is cut into when executed as tasks
+int task_tiles() { return TASK_TILES_PER_THREAD * omp_get_num_threads(); }
+
+// Zeroes a scratch array with the threads, where the phase may be entered
+// from within the region of a timestep
+void zero_scratch_data(double* buf, const size_t len) {
+  if (omp_in_parallel()) {
+#ifdef TASK_GRAPH
+#pragma omp taskloop
+#else
+#pragma omp for
+#endif
+    for (size_t ii = 0; ii < len; ++ii) {
+      buf[(ii)] = 0.0;
+    }
+  } else {
+#pragma omp parallel for
+    for (size_t ii = 0; ii < len; ++ii) {
+      buf[(ii)] = 0.0;
+    }
+  }
+}
+
+// Prints the time the team spent waiting in barriers since the last report
+void print_barrier_time() {
+  if (!team_size) {
+    return;
+  }
+
+  double total_wait = 0.0;
+  double max_wait = 0.0;
+  for (int tt = 0; tt < team_size; ++tt) {
+    total_wait += barrier_time[(tt)].wait;
+    max_wait = max(max_wait, barrier_time[(tt)].wait);
+  }
+
+  printf("\nBarrier wait %.6fs mean %.6fs max over %d barriers\n",
+         total_wait / team_size, max_wait, barrier_time[(0)].nbarriers);
+
+  for (int tt = 0; tt < team_size; ++tt) {
+    barrier_time[(tt)].wait = 0.0;
+    barrier_time[(tt)].nbarriers = 0;
+  }
+  team_size = 0;
+}
+
+// Publishes the private values of the calling thread to the team
+static void publish_team_values(double** vals, const int nvals) {
+  if (nvals > MAX_TEAM_VALUES) {
+    TERMINATE("The team reduction is limited to %d values.\n",
+              MAX_TEAM_VALUES);
+  }
+
+  const int tid = omp_get_thread_num();
+  for (int vv = 0; vv < nvals; ++vv) {
+    team_values[(tid)].vals[(vv)] = *vals[(vv)];
+  }
+
+  team_barrier();
+}
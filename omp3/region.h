@@ -0,0 +1,125 @@
+#ifndef __REGIONHDR
+#define __REGIONHDR
+
+#pragma once
+
+#include "../../shared.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MAX_TEAM_THREADS 256
+#define MAX_TEAM_VALUES 8
+#define TASK_TILES_PER_THREAD 4
+
+#define OMP_PRAGMA(...) _Pragma(#__VA_ARGS__)
+
+#if defined(PERSISTENT_REGION) && defined(TASK_GRAPH)
+#error "PERSISTENT_REGION and TASK_GRAPH are alternative execution modes."
+#endif
+
+// The kernels are written as worksharing loops that open their own parallel
+// region by default. With PERSISTENT_REGION the whole timestep is a single
+// parallel region, and the loops are orphaned so that they share the work of
+// the enclosing team, synchronising at explicit, timed barriers. Reductions
+// are then made over the private values of each thread with TEAM_SUM and
+// TEAM_MIN, which leave the result with every thread. The scheduled loops take
+// their schedule from the runtime, as set by begin_kernel_schedule.
+#ifdef PERSISTENT_REGION
+#define OMP_PARALLEL() OMP_PRAGMA(omp parallel)
+#define OMP_FOR(...) OMP_PRAGMA(omp for nowait __VA_ARGS__)
+#define OMP_FOR_SIMD(...) OMP_PRAGMA(omp for simd nowait __VA_ARGS__)
+#define OMP_FOR_REDUCTION(...) OMP_PRAGMA(omp for nowait)
+#define OMP_FOR_SCHEDULED(...)                                                 \
+  OMP_PRAGMA(omp for schedule(runtime) nowait __VA_ARGS__)
+#define OMP_FOR_SCHEDULED_REDUCTION(...)                                       \
+  OMP_PRAGMA(omp for schedule(runtime) nowait)
+#define OMP_BARRIER() team_barrier()
+#define OMP_MASTER() OMP_PRAGMA(omp master)
+#define OMP_SINGLE() OMP_PRAGMA(omp single)
+#define OMP_TASK(...)
+#define OMP_TASKWAIT()
+#define TEAM_SUM(...)                                                          \
+  {                                                                            \
+    double* vals[] = {__VA_ARGS__};                                            \
+    team_sum(vals, sizeof(vals) / sizeof(*vals));                              \
+  }
+#define TEAM_MIN(...)                                                          \
+  {                                                                            \
+    double* vals[] = {__VA_ARGS__};                                            \
+    team_min(vals, sizeof(vals) / sizeof(*vals));                              \
+  }
+
+// With TASK_GRAPH a single thread walks the timestep, issuing the Lagrangian
+// kernels as tasks that declare the fields they read and write, and each loop
+// is cut into tiles that the team executes as tasks. Independent kernels, and
+// the tiles of kernels that only wait on earlier kernels, then fill the cores
+// that would otherwise idle at the end of a loop.
+#elif defined(TASK_GRAPH)
+#define OMP_PARALLEL() OMP_PRAGMA(omp parallel) OMP_PRAGMA(omp single)
+#define OMP_FOR(...)                                                           \
+  OMP_PRAGMA(omp taskloop num_tasks(task_tiles()) __VA_ARGS__)
+#define OMP_FOR_SIMD(...)                                                      \
+  OMP_PRAGMA(omp taskloop simd num_tasks(task_tiles()) __VA_ARGS__)
+#define OMP_FOR_REDUCTION(...)                                                 \
+  OMP_PRAGMA(omp taskloop num_tasks(task_tiles()) __VA_ARGS__)
+#define OMP_FOR_SCHEDULED(...) OMP_FOR(__VA_ARGS__)
+#define OMP_FOR_SCHEDULED_REDUCTION(...) OMP_FOR_REDUCTION(__VA_ARGS__)
+#define OMP_BARRIER()
+#define OMP_MASTER()
+#define OMP_SINGLE()
+#define OMP_TASK(...) OMP_PRAGMA(omp task __VA_ARGS__)
+#define OMP_TASKWAIT() OMP_PRAGMA(omp taskwait)
+#define TEAM_SUM(...)
+#define TEAM_MIN(...)
+#else
+#define OMP_PARALLEL()
+#define OMP_FOR(...) OMP_PRAGMA(omp parallel for __VA_ARGS__)
+#define OMP_FOR_SIMD(...) OMP_PRAGMA(omp parallel for simd __VA_ARGS__)
+#define OMP_FOR_REDUCTION(...) OMP_PRAGMA(omp parallel for __VA_ARGS__)
+#define OMP_FOR_SCHEDULED(...)                                                 \
+  OMP_PRAGMA(omp parallel for schedule(runtime) __VA_ARGS__)
+#define OMP_FOR_SCHEDULED_REDUCTION(...)                                       \
+  OMP_PRAGMA(omp parallel for schedule(runtime) __VA_ARGS__)
+#define OMP_BARRIER()
+#define OMP_MASTER()
+#define OMP_SINGLE()
+#define OMP_TASK(...)
+#define OMP_TASKWAIT()
+#define TEAM_SUM(...)
+#define TEAM_MIN(...)
+#endif
+
+// The timers are shared between the threads, and would only time the issue
+// of the tasks, so the individual kernels are not profiled in either mode
+#if defined(PERSISTENT_REGION) || defined(TASK_GRAPH)
+#undef START_PROFILING
+#undef STOP_PROFILING
+#undef PRINT_PROFILING_RESULTS
+#define START_PROFILING(profile)
+#define STOP_PROFILING(profile, name)
+#define PRINT_PROFILING_RESULTS(profile)
+#endif
+
+// Waits for the rest of the team, accumulating the time spent waiting
+void team_barrier();
+
+// Sums the private values of each thread in the team, in thread order so that
+// every thread receives the same result
+void team_sum(double** vals, const int nvals);
+
+// Finds the minimum of the private values of each thread in the team
+void team_min(double** vals, const int nvals);
+
+// The number of tiles each loop is cut into when executed as tasks
+int task_tiles();
+
+// Prints the time the team spent waiting in barriers since the last report
+void print_barrier_time();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
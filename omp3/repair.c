@@ -85,7 +85,7 @@ void repair_velocity_extrema(const int nnodes,
                              const int* nodes_to_nodes, double* velocity_x,
                              double* velocity_y, double* velocity_z) {
 
-#pragma omp parallel for
+  OMP_FOR()
   for (int nn = 0; nn < nnodes; ++nn) {
     const int node_to_nodes_off = nodes_to_nodes_offsets[(nn)];
     const int nnodes_by_node =
@@ -282,6 +282,7 @@ void repair_velocity_extrema(const int nnodes,
       continue;
     }
   }
+  OMP_BARRIER();
 }
 
 // Repairs the subcell extrema for mass
@@ -290,7 +291,7 @@ void repair_energy_extrema(const int ncells, const int* cells_to_faces_offsets,
                            const int* faces_to_cells0,
                            const int* faces_to_cells1, double* energy) {
 
-#pragma omp parallel for
+  OMP_FOR()
   for (int cc = 0; cc < ncells; ++cc) {
     const int cell_to_faces_off = cells_to_faces_offsets[(cc)];
     const int nfaces_by_cell =
@@ -398,6 +399,7 @@ void repair_energy_extrema(const int ncells, const int* cells_to_faces_offsets,
       continue;
     }
   }
+  OMP_BARRIER();
 }
 
 // Repairs the subcell extrema for mass
@@ -406,8 +408,14 @@ void repair_subcell_extrema(const int ncells, const int* cells_to_nodes_offsets,
                             const int* subcells_to_subcells,
                             double* subcell_volume, double* subcell_mass) {
 
-#pragma omp parallel for
+  // Only the subcells outside of the bounds of their neighbours are repaired
+  static KernelSchedule schedule = {"repair_subcell_extrema",
+                                    SCHEDULE_DYNAMIC};
+  begin_kernel_schedule(&schedule, ncells);
+
+  OMP_FOR_SCHEDULED()
   for (int cc = 0; cc < ncells; ++cc) {
+    const double cell_start = start_entity_cost(&schedule);
     const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
     const int nnodes_by_cell =
         cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
@@ -518,7 +526,11 @@ void repair_subcell_extrema(const int ncells, const int* cells_to_nodes_offsets,
         continue;
       }
     }
+
+    record_entity_cost(&schedule, cc, cell_start);
   }
+  OMP_BARRIER();
+  end_kernel_schedule(&schedule);
 }
 
 // Redistributes the mass according to the determined neighbour availability
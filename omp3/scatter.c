@@ -12,7 +12,8 @@ void scatter_energy_and_mass(
     double* cell_mass, double* subcell_mass, double* subcell_ie_mass,
     double* subcell_ke_mass, int* faces_to_nodes, int* faces_to_nodes_offsets,
     int* cells_to_faces_offsets, int* cells_to_faces,
-    int* cells_to_nodes_offsets, int* cells_to_nodes, double initial_mass,
+    int* cells_to_nodes_offsets, int* cells_to_nodes,
+    const double* known_cell_volume, double initial_mass,
     double initial_ie_mass, double initial_ke_mass);
 
 // Scatter the subcell momentum to the node centered velocities
@@ -24,25 +25,44 @@ void scatter_momentum(const int nnodes, vec_t* initial_momentum,
                       double* subcell_mass, double* subcell_momentum_x,
                       double* subcell_momentum_y, double* subcell_momentum_z);
 
+// Scatter the subcell momentum to the node centered velocities, vectorised
+// across the nodes of each slice of the SELL-C-sigma node to subcell adjacency
+void scatter_momentum_sell(const SellAdjacency* nodes_to_cells_sell,
+                           const int* nodes_to_subcells_sell,
+                           vec_t* initial_momentum, double* velocity_x,
+                           double* velocity_y, double* velocity_z,
+                           double* nodal_mass, double* subcell_mass,
+                           double* subcell_momentum_x,
+                           double* subcell_momentum_y,
+                           double* subcell_momentum_z);
+
+// Scatters the remapped volume, mass and internal energy of the materials of
+// the mixed cells into their fractions of each cell
+void scatter_material_quantities(MultiMaterial* mm);
+
+// Scatters the subcell tracers back to the concentrations of the cells
+void scatter_tracers(const int ncells, const int* cells_to_nodes_offsets,
+                     const double* cell_mass,
+                     const double* subcell_tracer_mass,
+                     TracerRegistry* tracers);
+
 // Perform the scatter step of the ALE remapping algorithm
 void scatter_phase(UnstructuredMesh* umesh, HaleData* hale_data,
                    vec_t* initial_momentum, double initial_mass,
                    double initial_ie_mass, double initial_ke_mass) {
 
-  // Calculates the cell volume, subcell volume and the subcell centroids
-  calc_volumes_centroids(
-      umesh->ncells, umesh->nnodes, hale_data->nnodes_by_subcell,
-      umesh->cells_to_nodes_offsets, umesh->cells_to_nodes,
-      hale_data->subcells_to_faces_offsets, hale_data->subcells_to_faces,
-      umesh->faces_to_nodes, umesh->faces_to_nodes_offsets,
-      umesh->faces_cclockwise_cell, umesh->nodes_x0, umesh->nodes_y0,
-      umesh->nodes_z0, hale_data->subcell_centroids_x,
-      hale_data->subcell_centroids_y, hale_data->subcell_centroids_z,
-      hale_data->subcell_volume, hale_data->cell_volume,
-      hale_data->nodal_volumes, umesh->nodes_to_cells_offsets,
-      umesh->nodes_to_cells);
+  // The subcell geometry of the rezoned mesh isn't read before the next gather,
+  // which evaluates it lazily for the mesh that it needs
 
   // Scatter the subcell momentum to the node centered velocities
+#ifdef SELL_ADJACENCY
+  scatter_momentum_sell(
+      &hale_data->nodes_to_cells_sell, hale_data->nodes_to_subcells_sell,
+      initial_momentum, hale_data->velocity_x0, hale_data->velocity_y0,
+      hale_data->velocity_z0, hale_data->nodal_mass, hale_data->subcell_mass,
+      hale_data->subcell_momentum_x, hale_data->subcell_momentum_y,
+      hale_data->subcell_momentum_z);
+#else
   scatter_momentum(
       umesh->nnodes, initial_momentum, umesh->nodes_to_cells_offsets,
       umesh->nodes_to_cells, umesh->cells_to_nodes_offsets,
@@ -50,6 +70,20 @@ void scatter_phase(UnstructuredMesh* umesh, HaleData* hale_data,
       hale_data->velocity_z0, hale_data->nodal_mass, hale_data->subcell_mass,
       hale_data->subcell_momentum_x, hale_data->subcell_momentum_y,
       hale_data->subcell_momentum_z);
+#endif
+
+  // The cell volumes are only evaluated when they are stale, and the rezoned
+  // mesh has them stored
+  const int epoch = hale_data->geometry_epoch;
+  const double* known_cell_volume = NULL;
+  if (!geometry_stale(&hale_data->cell_volume_stamp, epoch)) {
+    known_cell_volume = hale_data->cell_volume;
+  } else if (epoch == hale_data->rezoned_geometry_epoch) {
+    known_cell_volume = hale_data->rezoned_cell_volume;
+    reuse_geometry(&hale_data->cell_volume_stamp, epoch);
+  } else {
+    stamp_geometry(&hale_data->cell_volume_stamp, epoch);
+  }
 
   // Scatter the subcell energy and mass quantities back to the cell centers
   scatter_energy_and_mass(
@@ -60,8 +94,92 @@ void scatter_phase(UnstructuredMesh* umesh, HaleData* hale_data,
       hale_data->subcell_ie_mass, hale_data->subcell_ke_mass,
       umesh->faces_to_nodes, umesh->faces_to_nodes_offsets,
       umesh->cells_to_faces_offsets, umesh->cells_to_faces,
-      umesh->cells_to_nodes_offsets, umesh->cells_to_nodes, initial_mass,
-      initial_ie_mass, initial_ke_mass);
+      umesh->cells_to_nodes_offsets, umesh->cells_to_nodes, known_cell_volume,
+      initial_mass, initial_ie_mass, initial_ke_mass);
+
+  // Scatter the materials of the mixed cells into their fractions
+  if (hale_data->multi_material) {
+    scatter_material_quantities(&hale_data->materials);
+  }
+
+  // Scatter the passive tracers with the remapped mass of each cell
+  if (hale_data->ntracers) {
+    scatter_tracers(umesh->ncells, umesh->cells_to_nodes_offsets,
+                    hale_data->cell_mass, hale_data->subcell_tracer_mass,
+                    &hale_data->tracers);
+  }
+}
+
+// Scatters the subcell tracers back to the concentrations of the cells, and
+// prints the conservation of each tracer
+void scatter_tracers(const int ncells, const int* cells_to_nodes_offsets,
+                     const double* cell_mass,
+                     const double* subcell_tracer_mass,
+                     TracerRegistry* tracers) {
+  const int ntracers = tracers->ntracers;
+  double* concentration = tracers->concentration;
+
+  OMP_FOR()
+  for (int cc = 0; cc < ncells; ++cc) {
+    const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
+    const int nnodes_by_cell =
+        cells_to_nodes_offsets[(cc + 1)] - cell_to_nodes_off;
+
+    double total_tracer_mass[MAX_TRACERS];
+#pragma omp simd
+    for (int tt = 0; tt < ntracers; ++tt) {
+      total_tracer_mass[(tt)] = 0.0;
+    }
+    for (int nn = 0; nn < nnodes_by_cell; ++nn) {
+      const double* tracer_mass =
+          &subcell_tracer_mass[((cell_to_nodes_off + nn) * ntracers)];
+#pragma omp simd
+      for (int tt = 0; tt < ntracers; ++tt) {
+        total_tracer_mass[(tt)] += tracer_mass[(tt)];
+      }
+    }
+
+    double* cell_tracers = &concentration[(cc * ntracers)];
+#pragma omp simd
+    for (int tt = 0; tt < ntracers; ++tt) {
+      cell_tracers[(tt)] = total_tracer_mass[(tt)] / cell_mass[(cc)];
+    }
+  }
+  OMP_BARRIER();
+
+  double total[MAX_TRACERS];
+  sum_tracers(ncells, ntracers, cell_mass, concentration, total);
+
+  OMP_MASTER()
+  {
+    for (int tt = 0; tt < ntracers; ++tt) {
+      printf("Tracer %-8s Initial %.12f Rezoned %.12f Difference %.12f\n",
+             tracers->names[(tt)], tracers->initial_total[(tt)], total[(tt)],
+             total[(tt)] - tracers->initial_total[(tt)]);
+    }
+    printf("\n");
+  }
+}
+
+// Scatters the remapped volume, mass and internal energy of the materials of
+// the mixed cells into their fractions of each cell, over the entries of each
+// material in turn
+void scatter_material_quantities(MultiMaterial* mm) {
+  OMP_FOR()
+  for (int ee = 0; ee < mm->nentries; ++ee) {
+    const int kk = mm->entry_mixed[(ee)];
+    mm->volume_fraction[(ee)] = mm->volume[(ee)] / mm->mixed_volume[(kk)];
+    mm->mass_fraction[(ee)] = mm->mass[(ee)] / mm->mixed_mass[(kk)];
+
+    // A cell without internal energy shares it out with the mass
+    mm->ie_fraction[(ee)] = (mm->mixed_ie_mass[(kk)] > 0.0)
+                                ? mm->ie_mass[(ee)] / mm->mixed_ie_mass[(kk)]
+                                : mm->mass_fraction[(ee)];
+  }
+  OMP_BARRIER();
+
+  OMP_MASTER()
+  print_multi_material(mm);
 }
 
 // Scatter the subcell energy and mass quantities back to the cell centers
@@ -72,13 +190,14 @@ void scatter_energy_and_mass(
     double* cell_mass, double* subcell_mass, double* subcell_ie_mass,
     double* subcell_ke_mass, int* faces_to_nodes, int* faces_to_nodes_offsets,
     int* cells_to_faces_offsets, int* cells_to_faces,
-    int* cells_to_nodes_offsets, int* cells_to_nodes, double initial_mass,
+    int* cells_to_nodes_offsets, int* cells_to_nodes,
+    const double* known_cell_volume, double initial_mass,
     double initial_ie_mass, double initial_ke_mass) {
 
   // Scatter energy and density, and print the conservation of mass
   double rz_total_mass = 0.0;
   double rz_total_e_mass = 0.0;
-#pragma omp parallel for reduction(+ : rz_total_mass, rz_total_e_mass)
+  OMP_FOR_REDUCTION(reduction(+ : rz_total_mass, rz_total_e_mass))
   for (int cc = 0; cc < ncells; ++cc) {
     const int cell_to_nodes_off = cells_to_nodes_offsets[(cc)];
     const int nnodes_by_cell =
@@ -104,12 +223,16 @@ void scatter_energy_and_mass(
     }
 
     // Update the volume of the cell to the new rezoned mesh
-    vec_t cell_c = {0.0, 0.0, 0.0};
-    calc_centroid(nnodes_by_cell, nodes_x, nodes_y, nodes_z, cells_to_nodes,
-                  cell_to_nodes_off, &cell_c);
-    calc_volume(cell_to_faces_off, nfaces_by_cell, cells_to_faces,
-                faces_to_nodes, faces_to_nodes_offsets, nodes_x, nodes_y,
-                nodes_z, &cell_c, &cell_volume[(cc)]);
+    if (known_cell_volume) {
+      cell_volume[(cc)] = known_cell_volume[(cc)];
+    } else {
+      vec_t cell_c = {0.0, 0.0, 0.0};
+      calc_centroid(nnodes_by_cell, nodes_x, nodes_y, nodes_z, cells_to_nodes,
+                    cell_to_nodes_off, &cell_c);
+      calc_volume(cell_to_faces_off, nfaces_by_cell, cells_to_faces,
+                  faces_to_nodes, faces_to_nodes_offsets, nodes_x, nodes_y,
+                  nodes_z, &cell_c, &cell_volume[(cc)]);
+    }
 
     // Scatter the energy and density
     cell_mass[(cc)] = total_mass;
@@ -122,16 +245,20 @@ void scatter_energy_and_mass(
     rz_total_mass += total_mass;
     rz_total_e_mass += total_e_mass;
   }
+  TEAM_SUM(&rz_total_mass, &rz_total_e_mass);
 
-  printf("Initial Total Mass %.12f\n", initial_mass);
-  printf("Rezoned Total Mass %.12f\n", rz_total_mass);
-  printf("Difference         %.12f\n\n", rz_total_mass - initial_mass);
+  OMP_MASTER()
+  {
+    printf("Initial Total Mass %.12f\n", initial_mass);
+    printf("Rezoned Total Mass %.12f\n", rz_total_mass);
+    printf("Difference         %.12f\n\n", rz_total_mass - initial_mass);
 
-  printf("Initial Total Energy          %.12f\n",
-         (initial_ie_mass + initial_ke_mass));
-  printf("Rezoned Total Internal Energy %.12f\n", rz_total_e_mass);
-  printf("Difference                    %.12f\n\n",
-         rz_total_e_mass - (initial_ie_mass + initial_ke_mass));
+    printf("Initial Total Energy          %.12f\n",
+           (initial_ie_mass + initial_ke_mass));
+    printf("Rezoned Total Internal Energy %.12f\n", rz_total_e_mass);
+    printf("Difference                    %.12f\n\n",
+           rz_total_e_mass - (initial_ie_mass + initial_ke_mass));
+  }
 }
 
 // Scatter the subcell momentum to the node centered velocities
@@ -147,8 +274,8 @@ void scatter_momentum(const int nnodes, vec_t* initial_momentum,
   double total_momentum_y = 0.0;
   double total_momentum_z = 0.0;
 
-#pragma omp parallel for reduction(+ : total_momentum_x, total_momentum_y,     \
-                                   total_momentum_z)
+  OMP_FOR_REDUCTION(reduction(+ : total_momentum_x, total_momentum_y,
+                                  total_momentum_z))
   for (int nn = 0; nn < nnodes; ++nn) {
     const int node_to_cells_off = nodes_to_cells_offsets[(nn)];
     const int ncells_by_node =
@@ -190,13 +317,75 @@ void scatter_momentum(const int nnodes, vec_t* initial_momentum,
     velocity_y[(nn)] = node_momentum_y / nodal_mass[(nn)];
     velocity_z[(nn)] = node_momentum_z / nodal_mass[(nn)];
   }
+  TEAM_SUM(&total_momentum_x, &total_momentum_y, &total_momentum_z);
+
+  OMP_MASTER()
+  {
+    printf("Initial total momentum %.12f %.12f %.12f\n", initial_momentum->x,
+           initial_momentum->y, initial_momentum->z);
+    printf("Rezoned total momentum %.12f %.12f %.12f\n", total_momentum_x,
+           total_momentum_y, total_momentum_z);
+    printf("Difference             %.12f %.12f %.12f\n\n",
+           initial_momentum->x - total_momentum_x,
+           initial_momentum->y - total_momentum_y,
+           initial_momentum->z - total_momentum_z);
+  }
+}
+
+// Scatter the subcell momentum to the node centered velocities, vectorised
+// across the nodes of each slice of the SELL-C-sigma node to subcell adjacency
+void scatter_momentum_sell(const SellAdjacency* nodes_to_cells_sell,
+                           const int* nodes_to_subcells_sell,
+                           vec_t* initial_momentum, double* velocity_x,
+                           double* velocity_y, double* velocity_z,
+                           double* nodal_mass, double* subcell_mass,
+                           double* subcell_momentum_x,
+                           double* subcell_momentum_y,
+                           double* subcell_momentum_z) {
+
+  double total_momentum_x = 0.0;
+  double total_momentum_y = 0.0;
+  double total_momentum_z = 0.0;
+
+  OMP_FOR_REDUCTION(reduction(+ : total_momentum_x, total_momentum_y,
+                                  total_momentum_z))
+  for (int ss = 0; ss < nodes_to_cells_sell->nslices; ++ss) {
+    const int* rows = &nodes_to_cells_sell->rows[(ss * SELL_CHUNK)];
+
+    const double* subcell_quantity[] = {subcell_momentum_x, subcell_momentum_y,
+                                        subcell_momentum_z, subcell_mass};
+    double node_sum[4][SELL_CHUNK];
+    sum_sell_subcells(nodes_to_cells_sell, nodes_to_subcells_sell, ss, 4,
+                      subcell_quantity, node_sum);
+
+    // Only the end of the last slice is padded
+    const int nlanes =
+        min(SELL_CHUNK, nodes_to_cells_sell->nrows - ss * SELL_CHUNK);
+
+    for (int ll = 0; ll < nlanes; ++ll) {
+      const int nn = rows[(ll)];
+      nodal_mass[(nn)] = node_sum[(3)][(ll)];
+
+      total_momentum_x += node_sum[(0)][(ll)];
+      total_momentum_y += node_sum[(1)][(ll)];
+      total_momentum_z += node_sum[(2)][(ll)];
+
+      velocity_x[(nn)] = node_sum[(0)][(ll)] / nodal_mass[(nn)];
+      velocity_y[(nn)] = node_sum[(1)][(ll)] / nodal_mass[(nn)];
+      velocity_z[(nn)] = node_sum[(2)][(ll)] / nodal_mass[(nn)];
+    }
+  }
+  TEAM_SUM(&total_momentum_x, &total_momentum_y, &total_momentum_z);
 
-  printf("Initial total momentum %.12f %.12f %.12f\n", initial_momentum->x,
-         initial_momentum->y, initial_momentum->z);
-  printf("Rezoned total momentum %.12f %.12f %.12f\n", total_momentum_x,
-         total_momentum_y, total_momentum_z);
-  printf("Difference             %.12f %.12f %.12f\n\n",
-         initial_momentum->x - total_momentum_x,
-         initial_momentum->y - total_momentum_y,
-         initial_momentum->z - total_momentum_z);
+  OMP_MASTER()
+  {
+    printf("Initial total momentum %.12f %.12f %.12f\n", initial_momentum->x,
+           initial_momentum->y, initial_momentum->z);
+    printf("Rezoned total momentum %.12f %.12f %.12f\n", total_momentum_x,
+           total_momentum_y, total_momentum_z);
+    printf("Difference             %.12f %.12f %.12f\n\n",
+           initial_momentum->x - total_momentum_x,
+           initial_momentum->y - total_momentum_y,
+           initial_momentum->z - total_momentum_z);
+  }
 }
@@ -0,0 +1,182 @@
+#include "schedule.h"
+#include <math.h>
+#include <stdio.h>
+
+static KernelSchedule* scheduled_kernels[MAX_SCHEDULED_KERNELS];
+static int nscheduled_kernels = 0;
+static int policy_override = SCHEDULE_KERNEL_DEFAULT;
+
+// Chooses the chunk size for a kernel from the sampled entity costs, and
+// whether to sample this execution
+static void plan_kernel_schedule(KernelSchedule* schedule, const int policy,
+                                 const int nentities, const int nthreads);
+
+// Accumulates the imbalance of a sampled execution of a kernel
+static void measure_kernel_schedule(KernelSchedule* schedule);
+
+// Overrides the policy of every scheduled kernel, unless it is the default
+void set_schedule_policy(const int policy) {
+  if (policy < SCHEDULE_KERNEL_DEFAULT || policy > SCHEDULE_GUIDED) {
+    TERMINATE("The remap schedule %d is not a known policy.\n", policy);
+  }
+  policy_override = policy;
+}
+
+// Sizes the chunks of a kernel from the costs of its last sampled execution,
+// and prepares the calling thread to execute the kernel with schedule(runtime)
+void begin_kernel_schedule(KernelSchedule* schedule, const int nentities) {
+  const int policy =
+      (policy_override == SCHEDULE_KERNEL_DEFAULT) ? schedule->policy
+                                                   : policy_override;
+
+  OMP_MASTER()
+  {
+    const int nthreads =
+        omp_in_parallel() ? omp_get_num_threads() : omp_get_max_threads();
+    plan_kernel_schedule(schedule, policy, nentities, nthreads);
+  }
+  OMP_BARRIER();
+
+  // The runtime schedule is private to each thread of a persistent region
+  const omp_sched_t kinds[] = {omp_sched_static, omp_sched_dynamic,
+                               omp_sched_guided};
+  omp_set_schedule(kinds[(policy)], schedule->chunk);
+}
+
+// Accumulates the load of each thread once the kernel has completed
+void end_kernel_schedule(KernelSchedule* schedule) {
+  OMP_MASTER()
+  {
+    schedule->ncalls++;
+    if (schedule->sampling) {
+      measure_kernel_schedule(schedule);
+    }
+  }
+}
+
+// Prints the load imbalance of each scheduled kernel since the last report
+void print_kernel_schedules() {
+  const char* policies[] = {"static", "dynamic", "guided"};
+
+  for (int kk = 0; kk < nscheduled_kernels; ++kk) {
+    KernelSchedule* schedule = scheduled_kernels[(kk)];
+    if (!schedule->ncalls) {
+      continue;
+    }
+
+    const int policy =
+        (policy_override == SCHEDULE_KERNEL_DEFAULT) ? schedule->policy
+                                                     : policy_override;
+    if (schedule->nsamples) {
+      printf("%-32s %-8s chunk %-6d imbalance %.2f%% over %d of %d calls\n",
+             schedule->name, policies[(policy)], schedule->chunk,
+             100.0 * schedule->imbalance / schedule->nsamples,
+             schedule->nsamples, schedule->ncalls);
+    } else {
+      printf("%-32s %-8s chunk %-6d imbalance unsampled over %d calls\n",
+             schedule->name, policies[(policy)], schedule->chunk,
+             schedule->ncalls);
+    }
+    schedule->imbalance = 0.0;
+    schedule->nsamples = 0;
+    schedule->ncalls = 0;
+  }
+}
+
+// Chooses the chunk size for a kernel from the sampled entity costs, and
+// whether to sample this execution
+static void plan_kernel_schedule(KernelSchedule* schedule, const int policy,
+                                 const int nentities, const int nthreads) {
+  if (schedule->nentities != nentities) {
+    if (schedule->cost) {
+      deallocate_data(schedule->cost);
+    } else if (nscheduled_kernels < MAX_SCHEDULED_KERNELS) {
+      scheduled_kernels[(nscheduled_kernels++)] = schedule;
+    }
+    allocate_data(&schedule->cost, nentities);
+    schedule->nentities = nentities;
+    schedule->chunk = 0;
+    schedule->measured = 0;
+    schedule->nexecutions = 0;
+  }
+
+  // Static chunks don't depend upon the costs, so are never sampled
+  schedule->sampling = 0;
+  if (policy == SCHEDULE_STATIC) {
+    schedule->chunk = 0;
+    return;
+  }
+
+  // The busy times are sized for the team, which is only known at runtime
+  if (schedule->nthreads < nthreads) {
+    if (schedule->thread_busy) {
+      deallocate_data(schedule->thread_busy);
+    }
+    allocate_data(&schedule->thread_busy,
+                  (size_t)nthreads * THREAD_BUSY_STRIDE);
+    schedule->nthreads = nthreads;
+  }
+
+  // The first execution is sampled, and then every so often in case the
+  // costs have moved, with the chunks kept from the last sample in between
+  schedule->sampling =
+      (schedule->nexecutions++ % SCHEDULE_SAMPLE_INTERVAL == 0);
+  if (schedule->sampling) {
+    for (int tt = 0; tt < nthreads; ++tt) {
+      schedule->thread_busy[(tt * THREAD_BUSY_STRIDE)] = 0.0;
+    }
+  }
+
+  // Until a sample has been taken the runtime picks the chunk size
+  if (!schedule->measured || !nentities) {
+    return;
+  }
+  schedule->measured = 0;
+
+  double total_cost = 0.0;
+  double total_cost2 = 0.0;
+  for (int ee = 0; ee < nentities; ++ee) {
+    total_cost += schedule->cost[(ee)];
+    total_cost2 += schedule->cost[(ee)] * schedule->cost[(ee)];
+  }
+
+  const double mean_cost = total_cost / nentities;
+  if (mean_cost <= 0.0) {
+    return;
+  }
+
+  if (policy == SCHEDULE_GUIDED) {
+    // Guided chunks shrink as the loop drains, down to the smallest chunk
+    // that is worth claiming
+    schedule->chunk = max(1, (int)ceil(SCHEDULE_MIN_CHUNK_TIME / mean_cost));
+  } else {
+    // Dynamic chunks are sized so the last chunk claimed by each thread is a
+    // small fraction of its load, which is smaller the more the costs vary
+    const double variance =
+        max(0.0, total_cost2 / nentities - mean_cost * mean_cost);
+    const double chunks_per_thread =
+        SCHEDULE_CHUNKS_PER_THREAD * (1.0 + sqrt(variance) / mean_cost);
+    schedule->chunk =
+        max(1, (int)(nentities / (nthreads * chunks_per_thread)));
+  }
+}
+
+// Accumulates the imbalance of a sampled execution of a kernel
+static void measure_kernel_schedule(KernelSchedule* schedule) {
+  // Threads that didn't take part have no load, and add to the imbalance
+  const int nthreads =
+      omp_in_parallel() ? omp_get_num_threads() : omp_get_max_threads();
+  double total_busy = 0.0;
+  double max_busy = 0.0;
+  for (int tt = 0; tt < nthreads; ++tt) {
+    const double busy = schedule->thread_busy[(tt * THREAD_BUSY_STRIDE)];
+    total_busy += busy;
+    max_busy = max(max_busy, busy);
+  }
+
+  if (total_busy > 0.0) {
+    schedule->imbalance += max_busy * nthreads / total_busy - 1.0;
+    schedule->nsamples++;
+  }
+  schedule->measured = 1;
+}
@@ -0,0 +1,94 @@
+#ifndef __SCHEDULEHDR
+#define __SCHEDULEHDR
+
+#pragma once
+
+#include "region.h"
+#include <omp.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MAX_SCHEDULED_KERNELS 16
+
+// Every thread should be left with a number of chunks to balance the tail of
+// the loop, more so the more the cost varies between entities
+#define SCHEDULE_CHUNKS_PER_THREAD 4
+
+// The smallest chunk is the one that amortises claiming it from the team
+#define SCHEDULE_MIN_CHUNK_TIME 5.0e-6
+
+// The entities of a kernel are only timed in one of this many executions, as
+// the timers would otherwise weigh on every step
+#define SCHEDULE_SAMPLE_INTERVAL 8
+
+// The policies that an irregular kernel can be scheduled with. Dynamic
+// scheduling has the threads claim chunks from a shared counter as they
+// finish, which is the nearest to work stealing that a loop construct offers.
+enum {
+  SCHEDULE_KERNEL_DEFAULT = -1,
+  SCHEDULE_STATIC,
+  SCHEDULE_DYNAMIC,
+  SCHEDULE_GUIDED
+};
+
+// The time spent by each thread on the entities of a kernel sits on its own
+// cache line
+#define THREAD_BUSY_STRIDE (64 / sizeof(double))
+
+// The scheduling state of a kernel, where the cost of each entity measured in
+// a sampled execution sizes the chunks until the next sample. Static kernels
+// are never sampled, as their chunks don't depend upon the costs.
+typedef struct {
+  const char* name;
+  int policy;
+  int chunk;
+  int nentities;
+  int sampling;
+  int measured;
+  int nexecutions;
+  double* cost;
+  double* thread_busy;
+  int nthreads;
+  double imbalance;
+  int nsamples;
+  int ncalls;
+} KernelSchedule;
+
+// Overrides the policy of every scheduled kernel, unless it is the default
+void set_schedule_policy(const int policy);
+
+// Sizes the chunks of a kernel from the costs of its last sampled execution,
+// and prepares the calling thread to execute the kernel with schedule(runtime)
+void begin_kernel_schedule(KernelSchedule* schedule, const int nentities);
+
+// Accumulates the load of each thread once the kernel has completed
+void end_kernel_schedule(KernelSchedule* schedule);
+
+// Prints the load imbalance of each scheduled kernel since the last report
+void print_kernel_schedules();
+
+// Starts timing an entity, if the kernel is being sampled
+static inline double start_entity_cost(const KernelSchedule* schedule) {
+  return schedule->sampling ? omp_get_wtime() : 0.0;
+}
+
+// Records the cost of an entity, given the time it was started, if the kernel
+// is being sampled
+static inline void record_entity_cost(KernelSchedule* schedule, const int ee,
+                                      const double start) {
+  if (!schedule->sampling) {
+    return;
+  }
+
+  const double cost = omp_get_wtime() - start;
+  schedule->cost[(ee)] = cost;
+  schedule->thread_busy[(omp_get_thread_num() * THREAD_BUSY_STRIDE)] += cost;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,105 @@
+#include "scratch_pool.h"
+#include "../shared.h"
+#include <stdio.h>
+
+// Prepares an empty scratch pool
+void init_scratch_pool(ScratchPool* pool) {
+  pool->narrays = 0;
+  pool->nslots = 0;
+}
+
+// Registers an array that is only live in the given phases, optionally to be
+// zeroed every time one of those phases is entered
+size_t scratch_data(ScratchPool* pool, double** buf, const size_t len,
+                    const int phases, const int zero_on_entry) {
+  if (pool->narrays == MAX_SCRATCH_ARRAYS) {
+    TERMINATE("Exceeded the maximum number of scratch arrays.\n");
+  }
+
+  ScratchArray* array = &pool->arrays[(pool->narrays++)];
+  array->buf = buf;
+  array->len = len;
+  array->phases = phases;
+  array->zero_on_entry = zero_on_entry;
+  *buf = NULL;
+  return len * sizeof(double);
+}
+
+// Packs the registered arrays into slots carved out of the arena
+size_t carve_scratch_pool(ScratchPool* pool, Arena* arena) {
+  pool->nslots = 0;
+
+  // Placing the largest arrays first means a slot is never grown, and the
+  // smaller arrays fill in behind them
+  int order[MAX_SCRATCH_ARRAYS];
+  for (int aa = 0; aa < pool->narrays; ++aa) {
+    int pos = aa;
+    for (; pos > 0 && pool->arrays[(order[(pos - 1)])].len <
+                          pool->arrays[(aa)].len;
+         --pos) {
+      order[(pos)] = order[(pos - 1)];
+    }
+    order[(pos)] = aa;
+  }
+
+  // First fit into any slot not already live in one of the array's phases
+  int slot_by_array[MAX_SCRATCH_ARRAYS];
+  for (int oo = 0; oo < pool->narrays; ++oo) {
+    const ScratchArray* array = &pool->arrays[(order[(oo)])];
+    int ss = 0;
+    for (; ss < pool->nslots; ++ss) {
+      if (!(pool->slots[(ss)].phases & array->phases)) {
+        break;
+      }
+    }
+    if (ss == pool->nslots) {
+      pool->slots[(ss)].len = array->len;
+      pool->slots[(ss)].phases = 0;
+      pool->nslots++;
+    }
+    pool->slots[(ss)].phases |= array->phases;
+    slot_by_array[(order[(oo)])] = ss;
+  }
+
+  size_t allocated = 0;
+  for (int ss = 0; ss < pool->nslots; ++ss) {
+    allocated += arena_data(arena, &pool->slots[(ss)].data,
+                            pool->slots[(ss)].len);
+  }
+
+  for (int aa = 0; aa < pool->narrays; ++aa) {
+    *pool->arrays[(aa)].buf = pool->slots[(slot_by_array[(aa)])].data;
+  }
+
+  return allocated;
+}
+
+// Prepares the arrays that are live in a phase that is about to begin
+void enter_scratch_phase(ScratchPool* pool, const int phase) {
+  for (int aa = 0; aa < pool->narrays; ++aa) {
+    const ScratchArray* array = &pool->arrays[(aa)];
+    if (!(array->phases & phase) || !array->zero_on_entry) {
+      continue;
+    }
+
+    zero_scratch_data(*array->buf, array->len);
+  }
+}
+
+// Reports the memory saved by sharing the scratch storage
+void print_scratch_pool(ScratchPool* pool, const size_t allocated) {
+  size_t requested = 0;
+  for (int aa = 0; aa < pool->narrays; ++aa) {
+    requested += pool->arrays[(aa)].len * sizeof(double);
+  }
+  size_t pooled = 0;
+  for (int ss = 0; ss < pool->nslots; ++ss) {
+    pooled += pool->slots[(ss)].len * sizeof(double);
+  }
+
+  printf("Scratch pool shares %d arrays between %d slots\n", pool->narrays,
+         pool->nslots);
+  printf("Peak hale memory %.3fGB without aliasing, %.3fGB with aliasing\n\n",
+         (allocated - pooled + requested) / (double)GB,
+         allocated / (double)GB);
+}
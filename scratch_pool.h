@@ -0,0 +1,67 @@
+#ifndef __SCRATCHPOOLHDR
+#define __SCRATCHPOOLHDR
+
+#pragma once
+
+#include "arena.h"
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MAX_SCRATCH_ARRAYS 64
+
+// The phases of a timestep that scratch arrays can be live in
+enum { PHASE_LAGRANGIAN = 1 << 0, PHASE_REMAP = 1 << 1 };
+
+// An array that is only live within a set of phases
+typedef struct {
+  double** buf;
+  size_t len;
+  int phases;
+  int zero_on_entry;
+} ScratchArray;
+
+// Storage shared by arrays that are never live in the same phase
+typedef struct {
+  size_t len;
+  int phases;
+  double* data;
+} ScratchSlot;
+
+// Arrays are registered with their liveness, and then packed into the
+// minimum number of slots such that no slot is shared within a phase
+typedef struct {
+  ScratchArray arrays[MAX_SCRATCH_ARRAYS];
+  ScratchSlot slots[MAX_SCRATCH_ARRAYS];
+  int narrays;
+  int nslots;
+} ScratchPool;
+
+// Prepares an empty scratch pool
+void init_scratch_pool(ScratchPool* pool);
+
+// Registers an array that is only live in the given phases, optionally to be
+// zeroed every time one of those phases is entered
+size_t scratch_data(ScratchPool* pool, double** buf, const size_t len,
+                    const int phases, const int zero_on_entry);
+
+// Packs the registered arrays into slots carved out of the arena
+size_t carve_scratch_pool(ScratchPool* pool, Arena* arena);
+
+// Prepares the arrays that are live in a phase that is about to begin
+void enter_scratch_phase(ScratchPool* pool, const int phase);
+
+// Zeroes a scratch array where the kernels will read it, which is provided by
+// the kernels
+void zero_scratch_data(double* buf, const size_t len);
+
+// Reports the memory saved by sharing the scratch storage
+void print_scratch_pool(ScratchPool* pool, const size_t allocated);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
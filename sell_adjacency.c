@@ -0,0 +1,126 @@
+#include "sell_adjacency.h"
+#include "../shared.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Counts the entries of a row that aren't -1
+static int count_row_entries(const int* offsets, const int* list,
+                             const int row);
+
+// Scatters the entries of a row that aren't -1 into a lane of a slice
+static void fill_row_entries(const int* offsets, const int* list,
+                             const int row, const int slice_off,
+                             const int lane, int* entries);
+
+// Builds the SELL-C-sigma copy of a list described by offsets
+void init_sell_adjacency(SellAdjacency* sell, const int nrows,
+                         const int* offsets, const int* list) {
+  sell->nrows = nrows;
+  sell->nslices = (nrows + SELL_CHUNK - 1) / SELL_CHUNK;
+
+  const int nlanes = sell->nslices * SELL_CHUNK;
+  allocate_int_data(&sell->slice_offsets, sell->nslices + 1);
+  allocate_int_data(&sell->rows, nlanes);
+  allocate_int_data(&sell->degree, nlanes);
+
+  for (int ll = 0; ll < nlanes; ++ll) {
+    sell->rows[(ll)] = (ll < nrows) ? ll : -1;
+    sell->degree[(ll)] =
+        (ll < nrows) ? count_row_entries(offsets, list, ll) : 0;
+  }
+
+  // Sort each window by descending degree, with an insertion sort that keeps
+  // rows of the same degree in their original order
+  for (int ww = 0; ww < nrows; ww += SELL_SORT_WINDOW) {
+    const int window_end = min(ww + SELL_SORT_WINDOW, nrows);
+    for (int rr = ww + 1; rr < window_end; ++rr) {
+      const int row = sell->rows[(rr)];
+      const int degree = sell->degree[(rr)];
+      int rr2;
+      for (rr2 = rr; rr2 > ww && sell->degree[(rr2 - 1)] < degree; --rr2) {
+        sell->rows[(rr2)] = sell->rows[(rr2 - 1)];
+        sell->degree[(rr2)] = sell->degree[(rr2 - 1)];
+      }
+      sell->rows[(rr2)] = row;
+      sell->degree[(rr2)] = degree;
+    }
+  }
+
+  // Each slice is as wide as its widest row
+  sell->slice_offsets[(0)] = 0;
+  for (int ss = 0; ss < sell->nslices; ++ss) {
+    int width = 0;
+    for (int ll = 0; ll < SELL_CHUNK; ++ll) {
+      width = max(width, sell->degree[(ss * SELL_CHUNK + ll)]);
+    }
+    sell->slice_offsets[(ss + 1)] =
+        sell->slice_offsets[(ss)] + width * SELL_CHUNK;
+  }
+
+  init_sell_values(sell, offsets, list, &sell->entries);
+}
+
+// Lays out a second list exactly as an existing copy, where the list has -1
+// entries in the same places as the list that built the copy
+void init_sell_values(const SellAdjacency* sell, const int* offsets,
+                      const int* list, int** values) {
+  const int nentries = sell->slice_offsets[(sell->nslices)];
+  allocate_int_data(values, max(nentries, 1));
+
+  for (int ss = 0; ss < sell->nslices; ++ss) {
+    const int slice_off = sell->slice_offsets[(ss)];
+    for (int ee = slice_off; ee < sell->slice_offsets[(ss + 1)]; ++ee) {
+      (*values)[(ee)] = -1;
+    }
+
+    for (int ll = 0; ll < SELL_CHUNK; ++ll) {
+      const int row = sell->rows[(ss * SELL_CHUNK + ll)];
+      if (row != -1) {
+        fill_row_entries(offsets, list, row, slice_off, ll, *values);
+      }
+    }
+  }
+}
+
+// Deallocates the SELL-C-sigma copy of a list
+void deallocate_sell_adjacency(SellAdjacency* sell) {
+  deallocate_int_data(sell->slice_offsets);
+  deallocate_int_data(sell->rows);
+  deallocate_int_data(sell->degree);
+  deallocate_int_data(sell->entries);
+}
+
+// Prints the padding overhead of a SELL-C-sigma copy
+void print_sell_adjacency(const char* name, const SellAdjacency* sell) {
+  size_t nentries = 0;
+  for (int ll = 0; ll < sell->nslices * SELL_CHUNK; ++ll) {
+    nentries += sell->degree[(ll)];
+  }
+
+  const size_t nstored = sell->slice_offsets[(sell->nslices)];
+  printf("%-24s SELL-%d-%d %d slices, %.2f%% padding\n", name, SELL_CHUNK,
+         SELL_SORT_WINDOW, sell->nslices,
+         nstored ? 100.0 * (nstored - nentries) / nstored : 0.0);
+}
+
+// Counts the entries of a row that aren't -1
+static int count_row_entries(const int* offsets, const int* list,
+                             const int row) {
+  int nentries = 0;
+  for (int ee = offsets[(row)]; ee < offsets[(row + 1)]; ++ee) {
+    nentries += (list[(ee)] != -1);
+  }
+  return nentries;
+}
+
+// Scatters the entries of a row that aren't -1 into a lane of a slice
+static void fill_row_entries(const int* offsets, const int* list,
+                             const int row, const int slice_off,
+                             const int lane, int* entries) {
+  int kk = 0;
+  for (int ee = offsets[(row)]; ee < offsets[(row + 1)]; ++ee) {
+    if (list[(ee)] != -1) {
+      entries[(slice_off + (kk++) * SELL_CHUNK + lane)] = list[(ee)];
+    }
+  }
+}
@@ -0,0 +1,70 @@
+#ifndef __SELLADJACENCYHDR
+#define __SELLADJACENCYHDR
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The number of rows in a slice, one in each double precision lane of the
+// vector unit
+#ifndef SELL_CHUNK
+#if defined(__AVX512F__)
+#define SELL_CHUNK 8
+#else
+#define SELL_CHUNK 4
+#endif
+#endif
+
+// The number of consecutive rows that are sorted by degree, which trades the
+// padding of the slices against the locality of the original ordering
+#ifndef SELL_SORT_WINDOW
+#define SELL_SORT_WINDOW (32 * SELL_CHUNK)
+#endif
+
+// A SELL-C-sigma copy of a variable degree adjacency list. The rows are sorted
+// by degree within windows and cut into slices of SELL_CHUNK rows, and each
+// slice stores its entries column-major, so that the kth entry of every row in
+// a slice is contiguous. Rows are padded with -1 to the widest row in their
+// slice, and the -1 entries of the original list are dropped, so the entries
+// of a row are always the first degree entries.
+typedef struct {
+  int nrows;
+  int nslices;
+
+  // The offset of the entries of each slice, where the width of a slice is
+  // (slice_offsets[(ss + 1)] - slice_offsets[(ss)]) / SELL_CHUNK
+  int* slice_offsets;
+
+  // The original row in each lane of each slice, or -1 for the padding that
+  // fills the end of the last slice
+  int* rows;
+
+  // The number of entries in each lane of each slice
+  int* degree;
+
+  // The entries of each slice, entries[(slice_off + kk * SELL_CHUNK + ll)]
+  int* entries;
+} SellAdjacency;
+
+// Builds the SELL-C-sigma copy of a list described by offsets
+void init_sell_adjacency(SellAdjacency* sell, const int nrows,
+                         const int* offsets, const int* list);
+
+// Lays out a second list exactly as an existing copy, where the list has -1
+// entries in the same places as the list that built the copy
+void init_sell_values(const SellAdjacency* sell, const int* offsets,
+                      const int* list, int** values);
+
+// Deallocates the SELL-C-sigma copy of a list
+void deallocate_sell_adjacency(SellAdjacency* sell);
+
+// Prints the padding overhead of a SELL-C-sigma copy
+void print_sell_adjacency(const char* name, const SellAdjacency* sell);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,69 @@
+#include "small_matrix.h"
+#include "../shared.h"
+#include <math.h>
+
+// Solves a batch of symmetric 3x3 systems A x = b, each with nrhs right hand
+// sides. The matrices are packed as a[(entry * stride + mm)] and the right
+// hand sides and solutions as b_x[(rhs * stride + mm)]. Singular matrices are
+// given zero solutions. The state of each matrix is stored in status, if it
+// is provided, and the worst state in the batch is returned.
+int solve_sym_3x3_batch(const int nmatrices, const int stride, const int nrhs,
+                        const double* a, const double* b_x,
+                        const double* b_y, const double* b_z, double* x_x,
+                        double* x_y, double* x_z, int* status) {
+
+  const double* xx = &a[(SYM_XX * stride)];
+  const double* xy = &a[(SYM_XY * stride)];
+  const double* xz = &a[(SYM_XZ * stride)];
+  const double* yy = &a[(SYM_YY * stride)];
+  const double* yz = &a[(SYM_YZ * stride)];
+  const double* zz = &a[(SYM_ZZ * stride)];
+
+  int worst = SOLVE_OK;
+
+  // The inverse is formed from the cofactors, expanding the determinant along
+  // the first row, and is symmetric so only 6 entries are needed
+#pragma omp simd reduction(max : worst)
+  for (int mm = 0; mm < nmatrices; ++mm) {
+    const double det = xx[(mm)] * (yy[(mm)] * zz[(mm)] - yz[(mm)] * yz[(mm)]) -
+                       xy[(mm)] * (xy[(mm)] * zz[(mm)] - yz[(mm)] * xz[(mm)]) +
+                       xz[(mm)] * (xy[(mm)] * yz[(mm)] - yy[(mm)] * xz[(mm)]);
+
+    // A singular matrix gives a zero solution rather than propagating
+    const int singular = (det == 0.0);
+    const double diag = fabs(xx[(mm)] * yy[(mm)] * zz[(mm)]);
+    const int ill_conditioned = !(fabs(det) > ILL_CONDITIONED_TOL * diag);
+    const int state = singular ? SOLVE_SINGULAR
+                               : ill_conditioned ? SOLVE_ILL_CONDITIONED
+                                                 : SOLVE_OK;
+    worst = max(worst, state);
+    if (status) {
+      status[(mm)] = state;
+    }
+
+    const double inv_xx =
+        singular ? 0.0 : (yy[(mm)] * zz[(mm)] - yz[(mm)] * yz[(mm)]) / det;
+    const double inv_xy =
+        singular ? 0.0 : (xz[(mm)] * yz[(mm)] - xy[(mm)] * zz[(mm)]) / det;
+    const double inv_xz =
+        singular ? 0.0 : (xy[(mm)] * yz[(mm)] - xz[(mm)] * yy[(mm)]) / det;
+    const double inv_yy =
+        singular ? 0.0 : (xx[(mm)] * zz[(mm)] - xz[(mm)] * xz[(mm)]) / det;
+    const double inv_yz =
+        singular ? 0.0 : (xz[(mm)] * xy[(mm)] - xx[(mm)] * yz[(mm)]) / det;
+    const double inv_zz =
+        singular ? 0.0 : (xx[(mm)] * yy[(mm)] - xy[(mm)] * xy[(mm)]) / det;
+
+    for (int rr = 0; rr < nrhs; ++rr) {
+      const int index = rr * stride + mm;
+      const double bx = b_x[(index)];
+      const double by = b_y[(index)];
+      const double bz = b_z[(index)];
+      x_x[(index)] = inv_xx * bx + inv_xy * by + inv_xz * bz;
+      x_y[(index)] = inv_xy * bx + inv_yy * by + inv_yz * bz;
+      x_z[(index)] = inv_xz * bx + inv_yz * by + inv_zz * bz;
+    }
+  }
+
+  return worst;
+}
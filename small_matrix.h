@@ -0,0 +1,52 @@
+#ifndef __SMALLMATRIXHDR
+#define __SMALLMATRIXHDR
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The determinant of a symmetric positive semi-definite matrix is bounded by
+// the product of its diagonal, and the ratio measures how close it is to
+// singular
+#define ILL_CONDITIONED_TOL 1.0e-12
+
+// The unique entries of a packed symmetric 3x3 matrix
+enum { SYM_XX, SYM_XY, SYM_XZ, SYM_YY, SYM_YZ, SYM_ZZ, NSYM_3X3 };
+
+// The state of a solve, where the worst state is reported for a batch
+enum { SOLVE_OK, SOLVE_ILL_CONDITIONED, SOLVE_SINGULAR };
+
+// The number of ill-conditioned and singular systems solved by a kernel over
+// the calls that it has made, with the counts held as doubles so that they are
+// reduced alongside the other totals of the kernel
+typedef struct {
+  const char* kernel;
+  int ncalls;
+  double nill_conditioned;
+  double nsingular;
+} SolveCounts;
+
+// Counts the state of a solve towards the totals of a kernel
+static inline void count_solve_state(const int state, double* nill_conditioned,
+                                     double* nsingular) {
+  *nill_conditioned += (state == SOLVE_ILL_CONDITIONED);
+  *nsingular += (state == SOLVE_SINGULAR);
+}
+
+// Solves a batch of symmetric 3x3 systems A x = b, each with nrhs right hand
+// sides. The matrices are packed as a[(entry * stride + mm)] and the right
+// hand sides and solutions as b_x[(rhs * stride + mm)]. Singular matrices are
+// given zero solutions. The state of each matrix is stored in status, if it
+// is provided, and the worst state in the batch is returned.
+int solve_sym_3x3_batch(const int nmatrices, const int stride, const int nrhs,
+                        const double* a, const double* b_x,
+                        const double* b_y, const double* b_z, double* x_x,
+                        double* x_y, double* x_z, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,51 @@
+#include "tracers.h"
+#include "../shared.h"
+#include <stdio.h>
+#include <string.h>
+
+// Initialises a registry without any tracers
+void init_tracer_registry(TracerRegistry* tracers, const int ncells) {
+  tracers->ntracers = 0;
+  tracers->ncells = ncells;
+  tracers->concentration = NULL;
+  for (int tt = 0; tt < MAX_TRACERS; ++tt) {
+    tracers->initial_total[(tt)] = 0.0;
+  }
+}
+
+// Registers a tracer, returning its index, before the tracers are carved
+int register_tracer(TracerRegistry* tracers, const char* name) {
+  if (tracers->concentration) {
+    TERMINATE("The tracer %s was registered after the tracers were "
+              "carved.\n",
+              name);
+  }
+  if (tracers->ntracers == MAX_TRACERS) {
+    TERMINATE("The tracer %s is more than the %d supported.\n", name,
+              MAX_TRACERS);
+  }
+
+  const int tt = tracers->ntracers++;
+  strncpy(tracers->names[(tt)], name, MAX_TRACER_NAME - 1);
+  tracers->names[(tt)][(MAX_TRACER_NAME - 1)] = '\0';
+  return tt;
+}
+
+// Carves the concentrations of the registered tracers out of the arena, which
+// begin at zero
+size_t carve_tracers(TracerRegistry* tracers, Arena* arena) {
+  return arena_data(arena, &tracers->concentration,
+                    (size_t)tracers->ncells * tracers->ntracers);
+}
+
+// Prints the registered tracers and the storage that they occupy
+void print_tracers(const TracerRegistry* tracers) {
+  const size_t bytes =
+      (size_t)tracers->ncells * tracers->ntracers * sizeof(double);
+  printf("Tracers %d, %.3fMB of concentrations:", tracers->ntracers,
+         bytes / (1024.0 * 1024.0));
+  for (int tt = 0; tt < tracers->ntracers; ++tt) {
+    printf(" %s", tracers->names[(tt)]);
+  }
+  printf("\n");
+}
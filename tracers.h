@@ -0,0 +1,54 @@
+#ifndef __TRACERSHDR
+#define __TRACERSHDR
+
+#pragma once
+
+#include "arena.h"
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The most passive scalars that can be carried through the remap
+#define MAX_TRACERS 16
+
+// The longest name of a passive scalar, including the terminator
+#define MAX_TRACER_NAME 32
+
+// The passive scalars carried through the remap, such as species fractions and
+// dyes. Each tracer is held as an amount per unit mass of each cell, so the
+// Lagrangian phase leaves it unchanged, with the tracers of a cell contiguous
+// so that the remap kernels vectorise over them.
+typedef struct {
+  int ntracers;
+  int ncells;
+  char names[MAX_TRACERS][MAX_TRACER_NAME];
+  double* concentration;
+
+  // The total amount of each tracer as the remap began
+  double initial_total[MAX_TRACERS];
+} TracerRegistry;
+
+// The concentration of a tracer in a cell
+#define TRACER(tracers, cc, tt)                                                \
+  ((tracers)->concentration[((cc) * (tracers)->ntracers + (tt))])
+
+// Initialises a registry without any tracers
+void init_tracer_registry(TracerRegistry* tracers, const int ncells);
+
+// Registers a tracer, returning its index, before the tracers are carved
+int register_tracer(TracerRegistry* tracers, const char* name);
+
+// Carves the concentrations of the registered tracers out of the arena, which
+// begin at zero
+size_t carve_tracers(TracerRegistry* tracers, Arena* arena);
+
+// Prints the registered tracers and the storage that they occupy
+void print_tracers(const TracerRegistry* tracers);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif